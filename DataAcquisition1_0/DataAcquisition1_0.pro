@@ -1,58 +1,92 @@
-QT += core gui network sql charts
-QT += sql
-
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
-
-CONFIG += c++17
-
-# You can make your code fail to compile if it uses deprecated APIs.
-# In order to do so, uncomment the following line.
-#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
-
-# libiio头文件路径
-#INCLUDEPATH += $$PWD/libiio/include
-
-# libiio库文件路径
-LIBS += -L$$PWD/libiio/Windows-MinGW-W64
-
-# 链接 libiio 库
-LIBS += -llibiio
-
-TARGET = DataAcquisitionSystem
-TEMPLATE = app
-
-DEFINES += QT_DEPRECATED_WARNINGS
-
-SOURCES += \
-    dataanalyzer.cpp \
-    databasemanager.cpp \
-    databuffer.cpp \
-    dataprocessor.cpp \
-    historyviewer.cpp \
-    iioreceiver.cpp \
-    jsonexporter.cpp \
-    main.cpp \
-    mainwindow.cpp \
-    waveformwidget.cpp
-
-HEADERS += \
-    dataanalyzer.h \
-    databasemanager.h \
-    databuffer.h \
-    dataprocessor.h \
-    historyviewer.h \
-    iioreceiver.h \
-    jsonexporter.h \
-    libiio/include/iio.h \
-    mainwindow.h \
-    mainwindow_ui.h \
-    waveformwidget.h
-
-FORMS += \
-    HistoryViewer.ui \
-    mainwindow.ui
-
-# Default rules for deployment.
-qnx: target.path = /tmp/$${TARGET}/bin
-else: unix:!android: target.path = /opt/$${TARGET}/bin
-!isEmpty(target.path): INSTALLS += target
+QT += core gui network sql charts
+QT += sql
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+CONFIG += c++17
+
+# You can make your code fail to compile if it uses deprecated APIs.
+# In order to do so, uncomment the following line.
+#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
+
+# libiio头文件路径
+#INCLUDEPATH += $$PWD/libiio/include
+
+# libiio库文件路径
+LIBS += -L$$PWD/libiio/Windows-MinGW-W64
+
+# 链接 libiio 库
+LIBS += -llibiio
+
+# 共享内存实时流（shm_open）
+unix:!macx: LIBS += -lrt
+
+TARGET = DataAcquisitionSystem
+TEMPLATE = app
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+SOURCES += \
+    analysisresultcache.cpp \
+    batchanalysisjob.cpp \
+    blockindex.cpp \
+    crosschannelanalyzer.cpp \
+    dataanalyzer.cpp \
+    databasemanager.cpp \
+    databuffer.cpp \
+    dataprocessor.cpp \
+    fftplan.cpp \
+    frequencytracker.cpp \
+    historyviewer.cpp \
+    iioreceiver.cpp \
+    jsonexporter.cpp \
+    main.cpp \
+    mainwindow.cpp \
+    npyexporter.cpp \
+    recordingfile.cpp \
+    sharedstreampublisher.cpp \
+    signalstatistics.cpp \
+    spectrogramwidget.cpp \
+    stftengine.cpp \
+    waveformwidget.cpp \
+    welchestimator.cpp \
+    windowfunction.cpp \
+    workstealingpool.cpp
+
+HEADERS += \
+    analysisresultcache.h \
+    batchanalysisjob.h \
+    blockindex.h \
+    crosschannelanalyzer.h \
+    dataanalyzer.h \
+    databasemanager.h \
+    databuffer.h \
+    dataprocessor.h \
+    fftplan.h \
+    frequencytracker.h \
+    historyviewer.h \
+    iioreceiver.h \
+    jsonexporter.h \
+    libiio/include/iio.h \
+    mainwindow.h \
+    mainwindow_ui.h \
+    npyexporter.h \
+    recordingfile.h \
+    sharedstreamlayout.h \
+    sharedstreampublisher.h \
+    signalstatistics.h \
+    spectrogramwidget.h \
+    stftengine.h \
+    waveformwidget.h \
+    welchestimator.h \
+    windowfunction.h \
+    workstealingpool.h
+
+FORMS += \
+    HistoryViewer.ui \
+    mainwindow.ui
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
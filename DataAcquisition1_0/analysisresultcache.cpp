@@ -0,0 +1,113 @@
+#include "analysisresultcache.h"
+#include <QCryptographicHash>
+#include <QMutexLocker>
+#include <QDebug>
+
+QString AnalysisCacheKey::digest() const
+{
+    // 浮点数用17位有效数字，保证不同的区间不会得到相同的文本
+    QString range = wholeRecording
+        ? QString("all")
+        : QString::number(startTime, 'g', 17) + "," + QString::number(endTime, 'g', 17);
+
+    QString text = QString("task=%1;channel=%2;range=%3;algorithm=%4;params=%5;version=%6")
+                       .arg(taskId).arg(channel).arg(range)
+                       .arg(algorithm).arg(parameters).arg(version);
+
+    return QString::fromLatin1(
+        QCryptographicHash::hash(text.toUtf8(), QCryptographicHash::Sha256).toHex());
+}
+
+AnalysisResultCache::AnalysisResultCache(int capacity)
+    : m_cache(capacity)
+    , m_hits(0)
+    , m_misses(0)
+{
+}
+
+AnalysisResultCache* AnalysisResultCache::globalInstance()
+{
+    static AnalysisResultCache instance;
+    return &instance;
+}
+
+bool AnalysisResultCache::lookup(const QString& key, AnalysisResult* result, DatabaseManager* db)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        AnalysisResult* cached = m_cache.object(key);
+        if (cached) {
+            *result = *cached;
+            ++m_hits;
+            return true;
+        }
+    }
+
+    // 数据库查询不持有锁
+    AnalysisResult stored;
+    if (db && db->isConnected() && db->findAnalysisResult(key, &stored)) {
+        QMutexLocker locker(&m_mutex);
+        m_cache.insert(key, new AnalysisResult(stored));
+        ++m_hits;
+        *result = stored;
+        return true;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    ++m_misses;
+    return false;
+}
+
+bool AnalysisResultCache::insert(const QString& key, const AnalysisResult& result,
+                                 DatabaseManager* db)
+{
+    AnalysisResult keyed = result;
+    keyed.cacheKey = key;
+
+    bool saved = true;
+    if (db && db->isConnected()) {
+        saved = db->saveAnalysisResult(keyed);
+        if (!saved) {
+            qWarning() << "分析结果缓存写入数据库失败:" << db->getLastError();
+        }
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_cache.insert(key, new AnalysisResult(keyed));
+    return saved;
+}
+
+void AnalysisResultCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.clear();
+}
+
+void AnalysisResultCache::invalidateTask(int taskId)
+{
+    QMutexLocker locker(&m_mutex);
+    const QList<QString> keys = m_cache.keys();
+    int removed = 0;
+    for (const QString& key : keys) {
+        AnalysisResult* cached = m_cache.object(key);
+        if (cached && cached->taskId == taskId) {
+            m_cache.remove(key);
+            ++removed;
+        }
+    }
+    if (removed > 0) {
+        qDebug() << "分析结果缓存已失效 - 任务:" << taskId << "条数:" << removed;
+    }
+}
+
+int AnalysisResultCache::hitCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_hits;
+}
+
+int AnalysisResultCache::missCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_misses;
+}
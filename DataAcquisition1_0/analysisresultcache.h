@@ -0,0 +1,58 @@
+#ifndef ANALYSISRESULTCACHE_H
+#define ANALYSISRESULTCACHE_H
+
+#include <QString>
+#include <QCache>
+#include <QMutex>
+#include "databasemanager.h"
+
+// 分析结果缓存键 - 同一任务、通道、时间区间、算法、参数和版本的分析结果相同
+struct AnalysisCacheKey {
+    int taskId;
+    int channel;
+    bool wholeRecording;    // true 时忽略 startTime/endTime
+    double startTime;
+    double endTime;
+    QString algorithm;      // 算法名称，如 "block-index"
+    QString parameters;     // 影响结果的参数，按固定顺序序列化
+    int version;            // 算法实现变化时递增，使旧结果失效
+
+    AnalysisCacheKey() : taskId(-1), channel(0), wholeRecording(true),
+        startTime(0), endTime(0), version(1) {}
+
+    // 规范化文本的SHA-256（64位十六进制），作为内存缓存和 analysis_results.cache_key 的键
+    QString digest() const;
+};
+
+// 分析结果缓存 - 内存LRU层加数据库持久层
+// 查询先查内存，未命中再按 cache_key 查数据库并放入内存；保存时同时写入两层
+// 数据库中按键覆盖（INSERT ... ON DUPLICATE KEY UPDATE），重复分析不再产生重复行
+// 线程安全
+class AnalysisResultCache
+{
+public:
+    explicit AnalysisResultCache(int capacity = 4096);
+
+    // 全局共享实例
+    static AnalysisResultCache* globalInstance();
+
+    // db 为空时只查/写内存层
+    bool lookup(const QString& key, AnalysisResult* result, DatabaseManager* db = nullptr);
+    bool insert(const QString& key, const AnalysisResult& result, DatabaseManager* db = nullptr);
+
+    void clear();
+    // 丢弃内存层中该任务的全部结果（任务数据改变或删除时调用）；
+    // 数据库中的结果随任务删除级联删除
+    void invalidateTask(int taskId);
+
+    int hitCount() const;
+    int missCount() const;
+
+private:
+    mutable QMutex m_mutex;
+    QCache<QString, AnalysisResult> m_cache;
+    int m_hits;
+    int m_misses;
+};
+
+#endif // ANALYSISRESULTCACHE_H
@@ -0,0 +1,163 @@
+#include "batchanalysisjob.h"
+#include "blockindex.h"
+#include "workstealingpool.h"
+#include <QElapsedTimer>
+#include <QDebug>
+
+BatchAnalysisJob::BatchAnalysisJob(DatabaseManager* source, WorkStealingPool* pool,
+                                   QObject *parent)
+    : QObject(parent)
+    , m_source(source)
+    , m_db(nullptr)
+    , m_pool(pool)
+    , m_cancelled(false)
+    , m_completed(false)
+{
+}
+
+void BatchAnalysisJob::cancel()
+{
+    m_cancelled.store(true);
+}
+
+bool BatchAnalysisJob::isCancelled() const
+{
+    return m_cancelled.load();
+}
+
+void BatchAnalysisJob::run(int jobId)
+{
+    m_completed = false;
+
+    DatabaseManager db;
+    if (!db.connectLike(m_source, QString("batch_analysis_%1").arg(jobId))) {
+        m_resultMessage = QString("批量分析连接数据库失败: %1").arg(db.getLastError());
+        emit finished(false, m_resultMessage);
+        return;
+    }
+    m_db = &db;
+
+    BatchJobInfo job = db.getBatchJob(jobId);
+    QVector<int> pending = db.getPendingBatchTasks(jobId);
+    int completedTasks = job.completedTasks;
+
+    QElapsedTimer timer;
+    timer.start();
+    qint64 totalSamples = 0;
+
+    for (int taskId : pending) {
+        if (isCancelled()) {
+            break;
+        }
+
+        TaskInfo task = db.getTask(taskId);
+        QVector<AnalysisResult> results;
+        qint64 sampleCount = 0;
+
+        // 任务已被删除时直接标记完成
+        if (task.taskId >= 0 && !analyzeTask(task, &results, &sampleCount)) {
+            if (isCancelled()) {
+                break;
+            }
+            qWarning() << "批量分析任务失败，跳过 - 任务:" << taskId << db.getLastError();
+            continue;
+        }
+
+        if (!db.completeBatchTask(jobId, taskId, results, sampleCount)) {
+            m_resultMessage = QString("保存任务 %1 的分析结果失败: %2")
+                                  .arg(taskId).arg(db.getLastError());
+            m_db = nullptr;
+            emit finished(false, m_resultMessage);
+            return;
+        }
+
+        ++completedTasks;
+        totalSamples += sampleCount;
+        double seconds = timer.elapsed() / 1000.0;
+        double rate = seconds > 0 ? totalSamples / seconds : 0.0;
+        emit progressUpdated(completedTasks, job.totalTasks, totalSamples, rate,
+                             QString("任务 %1 分析完成 (%2/%3)")
+                                 .arg(task.taskName).arg(completedTasks).arg(job.totalTasks));
+    }
+
+    double seconds = timer.elapsed() / 1000.0;
+    double rate = seconds > 0 ? totalSamples / seconds : 0.0;
+    QString throughput = QString("共 %1 个样本，%2 样本/秒")
+                             .arg(totalSamples).arg(rate, 0, 'f', 0);
+
+    // 只有全部任务都已完成才关闭作业，失败或取消的任务留待下次继续
+    if (!isCancelled() && db.getPendingBatchTasks(jobId).isEmpty()) {
+        db.finishBatchJob(jobId);
+        m_completed = true;
+        m_resultMessage = QString("批量分析完成: %1 个任务，%2").arg(completedTasks).arg(throughput);
+    } else {
+        m_resultMessage = QString("批量分析已中断: 已完成 %1/%2 个任务，%3，可稍后继续")
+                              .arg(completedTasks).arg(job.totalTasks).arg(throughput);
+    }
+
+    qDebug() << m_resultMessage << "耗时" << timer.elapsed() << "ms";
+
+    m_db = nullptr;
+    emit finished(m_completed, m_resultMessage);
+}
+
+bool BatchAnalysisJob::analyzeTask(const TaskInfo& task, QVector<AnalysisResult>* results,
+                                   qint64* sampleCount)
+{
+    QVector<int> channels = m_db->getTaskChannels(task.taskId);
+
+    for (int channel : channels) {
+        AnalysisResult result;
+        qint64 channelSamples = 0;
+        if (!analyzeChannel(task, channel, &result, &channelSamples)) {
+            return false;
+        }
+        results->append(result);
+        *sampleCount += channelSamples;
+    }
+
+    return true;
+}
+
+bool BatchAnalysisJob::analyzeChannel(const TaskInfo& task, int channel,
+                                      AnalysisResult* result, qint64* sampleCount)
+{
+    // 相同参数和算法版本的结果已缓存时直接复用
+    AnalysisResultCache* cache = AnalysisResultCache::globalInstance();
+    QString key = BlockIndex::cacheKey(task.taskId, channel).digest();
+    if (cache->lookup(key, result, m_db)) {
+        return true;
+    }
+
+    // 已有索引：合并块摘要即可
+    if (m_db->hasBlockSummaries(task.taskId, channel)) {
+        BlockSummary merged = BlockIndex::merge(m_db->loadBlockSummaries(task.taskId, channel));
+        if (merged.stats.isEmpty()) {
+            return false;
+        }
+        *result = BlockIndex::toAnalysisResult(merged, task.taskId, channel);
+        result->cacheKey = key;
+        cache->insert(key, *result);
+        *sampleCount = merged.stats.count;
+        return true;
+    }
+
+    // 没有索引：按块分页读取原始数据计算摘要
+    QVector<BlockSummary> summaries;
+    if (!BlockIndex::buildFromDatabase(m_db, task.taskId, channel, task.sampleRate, m_pool,
+                                       &summaries, sampleCount, &m_cancelled)
+        || summaries.isEmpty()) {
+        return false;
+    }
+
+    // 顺带补建索引，之后对该任务的分析不再读取原始数据
+    if (!m_db->saveBlockSummaries(summaries)) {
+        qWarning() << "补建分析索引失败 - 任务:" << task.taskId << "通道:" << channel;
+    }
+
+    // 结果随任务完成标记一起写入数据库（按缓存键覆盖），这里只放入内存层
+    *result = BlockIndex::toAnalysisResult(BlockIndex::merge(summaries), task.taskId, channel);
+    result->cacheKey = key;
+    cache->insert(key, *result);
+    return true;
+}
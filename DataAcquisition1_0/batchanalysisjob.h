@@ -0,0 +1,55 @@
+#ifndef BATCHANALYSISJOB_H
+#define BATCHANALYSISJOB_H
+
+#include <QObject>
+#include <QVector>
+#include <atomic>
+#include "databasemanager.h"
+
+class WorkStealingPool;
+
+// 批量分析作业 - 对数据库中已保存的多个任务重新分析并写入分析结果
+// 在独立线程中运行并使用自己的数据库连接：
+//  - 已有块级分析索引的通道直接合并索引，不读取原始数据
+//  - 没有索引的通道按块分页读取原始数据，各块在线程池中并行计算摘要，同时补建索引
+//    同一时间只保留线程数个数据块，内存占用与录制时长无关
+//  - 每个任务的分析结果与完成标记在同一事务中写入，取消或中断后可从未完成的任务继续
+class BatchAnalysisJob : public QObject
+{
+    Q_OBJECT
+
+public:
+    BatchAnalysisJob(DatabaseManager* source, WorkStealingPool* pool,
+                     QObject *parent = nullptr);
+
+    // 请求取消，可在任意线程调用；当前数据块处理完后停止，已完成的任务不受影响
+    void cancel();
+    bool isCancelled() const;
+
+    // 以下在 run() 返回后读取
+    bool isCompleted() const { return m_completed; }
+    QString resultMessage() const { return m_resultMessage; }
+
+public slots:
+    void run(int jobId);
+
+signals:
+    void progressUpdated(int completedTasks, int totalTasks, qint64 sampleCount,
+                         double samplesPerSecond, const QString& message);
+    void finished(bool completed, const QString& message);
+
+private:
+    bool analyzeTask(const TaskInfo& task, QVector<AnalysisResult>* results,
+                     qint64* sampleCount);
+    bool analyzeChannel(const TaskInfo& task, int channel, AnalysisResult* result,
+                        qint64* sampleCount);
+
+    DatabaseManager* m_source;      // 只用于复制连接参数
+    DatabaseManager* m_db;          // run() 期间的独立连接
+    WorkStealingPool* m_pool;
+    std::atomic<bool> m_cancelled;
+    bool m_completed;
+    QString m_resultMessage;
+};
+
+#endif // BATCHANALYSISJOB_H
@@ -0,0 +1,386 @@
+#include "blockindex.h"
+#include "dataanalyzer.h"
+#include "welchestimator.h"
+#include "workstealingpool.h"
+#include <QDateTime>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+AnalysisCacheKey BlockIndex::cacheKey(int taskId, int channel)
+{
+    AnalysisCacheKey key;
+    key.taskId = taskId;
+    key.channel = channel;
+    key.wholeRecording = true;
+    key.algorithm = "block-index";
+    key.parameters = QString("block=%1;segment=%2;window=hann;averaging=mean")
+                         .arg(BLOCK_SIZE).arg(SPECTRUM_SEGMENT_LENGTH);
+    key.version = ALGORITHM_VERSION;
+    return key;
+}
+
+AnalysisCacheKey BlockIndex::cacheKey(int taskId, int channel, double startTime, double endTime)
+{
+    AnalysisCacheKey key = cacheKey(taskId, channel);
+    key.wholeRecording = false;
+    key.startTime = startTime;
+    key.endTime = endTime;
+    return key;
+}
+
+QVector<BlockSummary> BlockIndex::build(const QVector<DataPoint>& data,
+                                        int taskId, int channel, double sampleRate,
+                                        WorkStealingPool* pool)
+{
+    int blockCount = (data.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    QVector<BlockSummary> summaries(blockCount);
+
+    auto buildRange = [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            int start = i * BLOCK_SIZE;
+            int size = qMin(BLOCK_SIZE, data.size() - start);
+            BlockSummary summary = summarize(data.constData() + start, size, sampleRate);
+            summary.taskId = taskId;
+            summary.channel = channel;
+            summary.blockIndex = i;
+            summaries[i] = summary;
+        }
+    };
+
+    if (pool && blockCount > 1) {
+        pool->parallelFor(0, blockCount, 1, buildRange);
+    } else {
+        buildRange(0, blockCount);
+    }
+
+    return summaries;
+}
+
+bool BlockIndex::buildFromDatabase(DatabaseManager* db, int taskId, int channel, double sampleRate,
+                                   WorkStealingPool* pool, QVector<BlockSummary>* summaries,
+                                   qint64* sampleCount, const std::atomic<bool>* cancelled)
+{
+    // 每页正好一个块，每批最多线程数个块并行计算摘要
+    int batchSize = qMax(1, pool ? pool->threadCount() : 1);
+    QVector<QVector<DataPoint>> pages(batchSize);
+    qint64 lastId = 0;
+    bool exhausted = false;
+
+    summaries->clear();
+
+    while (!exhausted) {
+        if (cancelled && cancelled->load()) {
+            return false;
+        }
+
+        int loaded = 0;
+        while (loaded < batchSize) {
+            if (!db->loadRawDataPage(taskId, channel, &lastId, BLOCK_SIZE, &pages[loaded])) {
+                return false;
+            }
+            if (pages[loaded].isEmpty()) {
+                exhausted = true;
+                break;
+            }
+            exhausted = pages[loaded].size() < BLOCK_SIZE;
+            ++loaded;
+            if (exhausted) {
+                break;
+            }
+        }
+
+        int firstBlock = summaries->size();
+        summaries->resize(firstBlock + loaded);
+
+        auto summarizePages = [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                BlockSummary summary = summarize(pages[i].constData(), pages[i].size(), sampleRate);
+                summary.taskId = taskId;
+                summary.channel = channel;
+                summary.blockIndex = firstBlock + i;
+                (*summaries)[firstBlock + i] = summary;
+            }
+        };
+
+        if (pool && loaded > 1) {
+            pool->parallelFor(0, loaded, 1, summarizePages);
+        } else {
+            summarizePages(0, loaded);
+        }
+
+        if (sampleCount) {
+            for (int i = 0; i < loaded; ++i) {
+                *sampleCount += pages[i].size();
+            }
+        }
+    }
+
+    return true;
+}
+
+BlockSummary BlockIndex::summarize(const DataPoint* data, int count, double sampleRate)
+{
+    BlockSummary summary;
+    if (count <= 0) {
+        return summary;
+    }
+
+    summary.startTime = data[0].time;
+    summary.endTime = data[count - 1].time;
+    summary.stats = SignalStatistics::compute(data, count);
+
+    // 不足一段时不做谱估计，否则段长不同的功率谱无法合并
+    if (count < SPECTRUM_SEGMENT_LENGTH || sampleRate <= 0) {
+        return summary;
+    }
+
+    QVector<double> samples(count);
+    for (int i = 0; i < count; ++i) {
+        samples[i] = data[i].amplitude;
+    }
+
+    WelchSettings settings;
+    settings.segmentLength = SPECTRUM_SEGMENT_LENGTH;
+    PsdResult psd = WelchEstimator::estimate(samples.constData(), count, sampleRate, settings);
+
+    summary.spectrum.resize(psd.density.size());
+    for (int k = 0; k < psd.density.size(); ++k) {
+        summary.spectrum[k] = static_cast<float>(psd.density[k]);
+    }
+    summary.spectrumSegments = psd.segmentCount;
+    summary.frequencyResolution = psd.frequencyResolution;
+
+    return summary;
+}
+
+BlockSummary BlockIndex::merge(const QVector<BlockSummary>& blocks)
+{
+    BlockSummary merged;
+    if (blocks.isEmpty()) {
+        return merged;
+    }
+
+    merged.taskId = blocks.first().taskId;
+    merged.channel = blocks.first().channel;
+    merged.blockIndex = blocks.first().blockIndex;
+    merged.startTime = blocks.first().startTime;
+    merged.endTime = blocks.first().endTime;
+
+    QVector<double> spectrumSum;
+    for (const BlockSummary& block : blocks) {
+        if (block.stats.isEmpty()) {
+            continue;
+        }
+
+        merged.stats.merge(block.stats);
+        merged.startTime = qMin(merged.startTime, block.startTime);
+        merged.endTime = qMax(merged.endTime, block.endTime);
+
+        if (block.spectrumSegments <= 0 || block.spectrum.isEmpty()) {
+            continue;
+        }
+        if (spectrumSum.isEmpty()) {
+            spectrumSum.fill(0.0, block.spectrum.size());
+            merged.frequencyResolution = block.frequencyResolution;
+        } else if (block.spectrum.size() != spectrumSum.size()) {
+            continue;
+        }
+
+        // 各块的Welch谱按段数加权，等价于对全部段的周期图取平均
+        for (int k = 0; k < spectrumSum.size(); ++k) {
+            spectrumSum[k] += static_cast<double>(block.spectrum[k]) * block.spectrumSegments;
+        }
+        merged.spectrumSegments += block.spectrumSegments;
+    }
+
+    if (merged.spectrumSegments > 0) {
+        merged.spectrum.resize(spectrumSum.size());
+        for (int k = 0; k < spectrumSum.size(); ++k) {
+            merged.spectrum[k] = static_cast<float>(spectrumSum[k] / merged.spectrumSegments);
+        }
+    }
+
+    return merged;
+}
+
+AnalysisResult BlockIndex::toAnalysisResult(const BlockSummary& merged, int taskId, int channel)
+{
+    AnalysisResult result;
+    result.taskId = taskId;
+    result.channel = channel;
+
+    if (merged.stats.isEmpty()) {
+        return result;
+    }
+
+    result.maxAmplitude = merged.stats.max;
+    result.minAmplitude = merged.stats.min;
+    result.avgAmplitude = merged.stats.average();
+    result.rmsValue = merged.stats.rms();
+
+    const QVector<float>& spectrum = merged.spectrum;
+    if (spectrum.size() >= 2) {
+        // 跳过直流分量
+        int peak = 1;
+        for (int k = 2; k < spectrum.size(); ++k) {
+            if (spectrum[k] > spectrum[peak]) {
+                peak = k;
+            }
+        }
+
+        // 粗粒度谱的分辨率较低，对相邻频点的对数功率做抛物线插值（高斯插值，对Hann窗偏差较小）
+        double offset = 0.0;
+        if (peak + 1 < spectrum.size() && spectrum[peak - 1] > 0.0f && spectrum[peak + 1] > 0.0f) {
+            double a = std::log(spectrum[peak - 1]);
+            double b = std::log(spectrum[peak]);
+            double c = std::log(spectrum[peak + 1]);
+            double denominator = a - 2.0 * b + c;
+            if (denominator < 0.0) {
+                offset = qBound(-0.5, 0.5 * (a - c) / denominator, 0.5);
+            }
+        }
+        result.frequency = (peak + offset) * merged.frequencyResolution;
+    }
+
+    result.analysisTime = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
+    return result;
+}
+
+AnalysisResult BlockIndex::analyzeRecording(DatabaseManager* db, int taskId, int channel,
+                                            double sampleRate, bool* ok)
+{
+    if (ok) {
+        *ok = false;
+    }
+
+    AnalysisResultCache* cache = AnalysisResultCache::globalInstance();
+    QString key = cacheKey(taskId, channel).digest();
+
+    AnalysisResult result;
+    if (cache->lookup(key, &result, db)) {
+        if (ok) {
+            *ok = true;
+        }
+        return result;
+    }
+
+    result.taskId = taskId;
+    result.channel = channel;
+
+    if (!ensureIndex(db, taskId, channel, sampleRate)) {
+        return result;
+    }
+
+    QVector<BlockSummary> blocks = db->loadBlockSummaries(taskId, channel);
+    BlockSummary merged = merge(blocks);
+    if (merged.stats.isEmpty()) {
+        return result;
+    }
+
+    result = toAnalysisResult(merged, taskId, channel);
+    cache->insert(key, result, db);
+
+    if (ok) {
+        *ok = true;
+    }
+    return result;
+}
+
+AnalysisResult BlockIndex::analyzeRange(DatabaseManager* db, int taskId, int channel,
+                                        double sampleRate, double startTime, double endTime,
+                                        bool* ok)
+{
+    if (ok) {
+        *ok = false;
+    }
+
+    AnalysisResult empty;
+    empty.taskId = taskId;
+    empty.channel = channel;
+
+    if (endTime < startTime) {
+        return empty;
+    }
+
+    AnalysisResultCache* cache = AnalysisResultCache::globalInstance();
+    QString key = cacheKey(taskId, channel, startTime, endTime).digest();
+
+    AnalysisResult cached;
+    if (cache->lookup(key, &cached)) {
+        if (ok) {
+            *ok = true;
+        }
+        return cached;
+    }
+
+    if (!ensureIndex(db, taskId, channel, sampleRate)) {
+        return empty;
+    }
+
+    QVector<BlockSummary> blocks = db->loadBlockSummaries(taskId, channel, startTime, endTime);
+    if (blocks.isEmpty()) {
+        return empty;
+    }
+
+    // 完整落在区间内的块直接使用摘要，与区间边界相交的块只重新读取区间内的部分
+    int rescanned = 0;
+    QVector<BlockSummary> parts;
+    parts.reserve(blocks.size());
+    for (const BlockSummary& block : blocks) {
+        if (block.startTime >= startTime && block.endTime <= endTime) {
+            parts.append(block);
+            continue;
+        }
+
+        QVector<DataPoint> data = db->loadRawDataRange(taskId, channel,
+                                                       qMax(startTime, block.startTime),
+                                                       qMin(endTime, block.endTime));
+        parts.append(summarize(data.constData(), data.size(), sampleRate));
+        rescanned += data.size();
+    }
+
+    BlockSummary merged = merge(parts);
+    if (merged.stats.isEmpty()) {
+        return empty;
+    }
+
+    if (ok) {
+        *ok = true;
+    }
+
+    AnalysisResult result;
+    if (merged.spectrumSegments == 0) {
+        // 区间太短、没有可用的功率谱时直接分析区间内的原始数据（样本很少）
+        QVector<DataPoint> data = db->loadRawDataRange(taskId, channel, startTime, endTime);
+        result = DataAnalyzer::analyzeChannel(data, taskId, channel, sampleRate);
+    } else {
+        qDebug() << "区间分析 - 任务:" << taskId << "通道:" << channel
+                 << "块数:" << blocks.size() << "样本数:" << merged.stats.count
+                 << "重新读取:" << rescanned;
+        result = toAnalysisResult(merged, taskId, channel);
+    }
+
+    // 区间结果不写入数据库，避免任务的分析结果列表中混入区间结果
+    cache->insert(key, result);
+    return result;
+}
+
+bool BlockIndex::ensureIndex(DatabaseManager* db, int taskId, int channel, double sampleRate)
+{
+    if (!db || !db->isConnected()) {
+        return false;
+    }
+
+    if (db->hasBlockSummaries(taskId, channel)) {
+        return true;
+    }
+
+    qDebug() << "任务" << taskId << "通道" << channel << "没有分析索引，由原始数据分页补建";
+    QVector<BlockSummary> summaries;
+    if (!buildFromDatabase(db, taskId, channel, sampleRate, WorkStealingPool::globalInstance(),
+                           &summaries) || summaries.isEmpty()) {
+        return false;
+    }
+    return db->saveBlockSummaries(summaries);
+}
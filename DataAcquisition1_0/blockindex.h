@@ -0,0 +1,62 @@
+#ifndef BLOCKINDEX_H
+#define BLOCKINDEX_H
+
+#include <QVector>
+#include <atomic>
+#include "databuffer.h"
+#include "databasemanager.h"
+#include "analysisresultcache.h"
+
+class WorkStealingPool;
+
+// 块级分析索引 - 录制数据按固定块长切分，每块保存可合并的统计量和粗粒度功率谱
+// 整段或任意时间区间的分析只需合并区间内的块摘要，仅区间两端不完整的块需要重新读取原始数据
+// 无内部状态，可在多个线程中同时调用
+class BlockIndex
+{
+public:
+    static const int BLOCK_SIZE = 65536;                // 每块样本数
+    static const int SPECTRUM_SEGMENT_LENGTH = 1024;    // 块内Welch谱估计的段长
+    static const int ALGORITHM_VERSION = 1;             // 摘要或合并算法变化时递增，使缓存的结果失效
+
+    // 分析结果缓存键（整段录制 / 时间区间）
+    static AnalysisCacheKey cacheKey(int taskId, int channel);
+    static AnalysisCacheKey cacheKey(int taskId, int channel, double startTime, double endTime);
+
+    // 切分一个通道的数据并计算各块摘要（保存数据时调用），提供线程池时各块并行计算
+    static QVector<BlockSummary> build(const QVector<DataPoint>& data,
+                                       int taskId, int channel, double sampleRate,
+                                       WorkStealingPool* pool = nullptr);
+
+    // 由数据库中的原始数据按块分页计算摘要，同一时间只保留线程数个数据块，内存占用与录制时长无关
+    // cancelled 置位时在当前批数据块处理完后返回 false
+    static bool buildFromDatabase(DatabaseManager* db, int taskId, int channel, double sampleRate,
+                                  WorkStealingPool* pool, QVector<BlockSummary>* summaries,
+                                  qint64* sampleCount = nullptr,
+                                  const std::atomic<bool>* cancelled = nullptr);
+
+    // 计算一段连续样本的摘要；样本数不足一个谱估计段时只有统计量
+    static BlockSummary summarize(const DataPoint* data, int count, double sampleRate);
+
+    // 合并摘要：统计量按Chan公式合并，功率谱按段数加权平均
+    static BlockSummary merge(const QVector<BlockSummary>& blocks);
+
+    // 由合并后的摘要生成分析结果，主频率取功率谱峰值（抛物线插值）
+    static AnalysisResult toAnalysisResult(const BlockSummary& merged,
+                                           int taskId, int channel);
+
+    // 整段录制的分析；旧任务没有索引时先由原始数据分页补建并保存（耗时，应在工作线程中调用）
+    // 结果经 AnalysisResultCache 缓存在内存并持久化到 analysis_results，重复分析直接返回
+    static AnalysisResult analyzeRecording(DatabaseManager* db, int taskId, int channel,
+                                           double sampleRate, bool* ok = nullptr);
+
+    // 时间区间 [startTime, endTime] 的分析，结果只缓存在内存中
+    static AnalysisResult analyzeRange(DatabaseManager* db, int taskId, int channel,
+                                       double sampleRate, double startTime, double endTime,
+                                       bool* ok = nullptr);
+
+private:
+    static bool ensureIndex(DatabaseManager* db, int taskId, int channel, double sampleRate);
+};
+
+#endif // BLOCKINDEX_H
@@ -0,0 +1,334 @@
+#include "crosschannelanalyzer.h"
+#include "fftplan.h"
+#include "windowfunction.h"
+#include "workstealingpool.h"
+#include <QDateTime>
+#include <QDebug>
+#include <cmath>
+#include <complex>
+
+namespace {
+
+typedef std::complex<double> Complex;
+
+// 超过该长度只取前面的数据计算互相关，限制频谱缓存占用的内存
+const int MAX_CORRELATION_LENGTH = 1 << 20;
+
+struct ChannelPair {
+    int a;      // channels 中的下标
+    int b;
+};
+
+template <typename Fn>
+void runParallel(WorkStealingPool* pool, int count, Fn fn)
+{
+    if (pool && count > 1) {
+        pool->parallelFor(0, count, 1, fn);
+    } else {
+        fn(0, count);
+    }
+}
+
+// 去除均值后的样本
+QVector<double> centeredSamples(const QVector<DataPoint>& data, int length)
+{
+    QVector<double> samples(length);
+    double mean = 0.0;
+    for (int i = 0; i < length; ++i) {
+        samples[i] = data[i].amplitude;
+        mean += samples[i];
+    }
+    mean /= length;
+    for (int i = 0; i < length; ++i) {
+        samples[i] -= mean;
+    }
+    return samples;
+}
+
+// 在峰值附近做抛物线插值，返回相对峰值位置的偏移 (-0.5, 0.5)
+double parabolicOffset(double left, double center, double right)
+{
+    double denominator = left - 2.0 * center + right;
+    if (std::fabs(denominator) < 1e-300) {
+        return 0.0;
+    }
+    return qBound(-0.5, 0.5 * (left - right) / denominator, 0.5);
+}
+
+// 互相关：结果写入 pair 对应的 CorrelationResult
+void correlatePairs(const QVector<QVector<Complex>>& spectra, const QVector<double>& energy,
+                    const ChannelPair* pairs, int pairCount, int fftSize, int maxLag,
+                    double sampleRate, const FftPlan& inversePlan, CorrelationResult* results)
+{
+    int half = fftSize / 2;
+    QVector<Complex> buffer(fftSize);
+    QVector<Complex> output(fftSize);
+
+    // 两个互谱 Y1、Y2 都是厄米对称的，Z = Y1 + jY2 的逆变换实部为 r1、虚部为 r2
+    // 逆变换用 ifft(Z) = conj(fft(conj(Z)))/M 计算
+    for (int k = 0; k <= half; ++k) {
+        Complex y1 = spectra[pairs[0].a][k] * std::conj(spectra[pairs[0].b][k]);
+        Complex y2 = pairCount > 1 ? spectra[pairs[1].a][k] * std::conj(spectra[pairs[1].b][k])
+                                   : Complex(0.0, 0.0);
+        buffer[k] = std::conj(y1 + Complex(0.0, 1.0) * y2);
+        if (k > 0 && k < fftSize - k) {
+            buffer[fftSize - k] = std::conj(std::conj(y1) + Complex(0.0, 1.0) * std::conj(y2));
+        }
+    }
+
+    inversePlan.transform(buffer.constData(), output.data());
+
+    for (int p = 0; p < pairCount; ++p) {
+        const ChannelPair& pair = pairs[p];
+        CorrelationResult& result = results[p];
+
+        // r[k] = Σ a[m+k]·b[m]，负延迟位于数组尾部
+        auto correlation = [&](int lag) {
+            int index = lag >= 0 ? lag : fftSize + lag;
+            double value = p == 0 ? output[index].real() : -output[index].imag();
+            return value / fftSize;
+        };
+
+        int bestLag = 0;
+        double bestValue = correlation(0);
+        for (int lag = -maxLag; lag <= maxLag; ++lag) {
+            double value = correlation(lag);
+            if (std::fabs(value) > std::fabs(bestValue)) {
+                bestValue = value;
+                bestLag = lag;
+            }
+        }
+
+        double offset = 0.0;
+        if (bestLag > -maxLag && bestLag < maxLag) {
+            offset = parabolicOffset(correlation(bestLag - 1), bestValue, correlation(bestLag + 1));
+        }
+
+        double norm = std::sqrt(energy[pair.a] * energy[pair.b]);
+        result.peakCorrelation = norm > 0.0 ? bestValue / norm : 0.0;
+        result.lagSamples = bestLag + offset;
+        result.lagSeconds = result.lagSamples / sampleRate;
+    }
+}
+
+} // namespace
+
+QVector<CorrelationResult> CrossChannelAnalyzer::analyze(const QVector<QVector<DataPoint>>& channelData,
+                                                         const QVector<int>& channels,
+                                                         int taskId, double sampleRate,
+                                                         const CrossChannelSettings& settings,
+                                                         WorkStealingPool* pool,
+                                                         QVector<QVector<double>>* coherenceSpectra)
+{
+    QVector<CorrelationResult> results;
+
+    int channelCount = channels.size();
+    if (channelCount < 2 || sampleRate <= 0.0) {
+        return results;
+    }
+
+    // 各通道按共同长度对齐（从起点开始）
+    int length = -1;
+    for (int channel : channels) {
+        if (channel < 0 || channel >= channelData.size()) {
+            qWarning() << "相关分析: 无效的通道号" << channel;
+            return results;
+        }
+        int size = channelData[channel].size();
+        length = length < 0 ? size : qMin(length, size);
+    }
+    if (length < 2) {
+        qWarning() << "相关分析: 数据点不足";
+        return results;
+    }
+
+    QVector<ChannelPair> pairs;
+    for (int a = 0; a < channelCount; ++a) {
+        for (int b = a + 1; b < channelCount; ++b) {
+            ChannelPair pair = {a, b};
+            pairs.append(pair);
+        }
+    }
+
+    results.resize(pairs.size());
+    QString analysisTime = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
+    for (int p = 0; p < pairs.size(); ++p) {
+        results[p].taskId = taskId;
+        results[p].channelA = channels[pairs[p].a];
+        results[p].channelB = channels[pairs[p].b];
+        results[p].analysisTime = analysisTime;
+    }
+
+    // ========== 互相关 ==========
+    int correlationLength = qMin(length, MAX_CORRELATION_LENGTH);
+    if (correlationLength < length) {
+        qWarning() << "相关分析: 数据过长，互相关只使用前" << correlationLength << "个点";
+    }
+
+    int maxLag = correlationLength - 1;
+    if (settings.maxLagSamples >= 0) {
+        maxLag = qMin(maxLag, settings.maxLagSamples);
+    }
+
+    // 线性相关要求 M >= n + maxLag，取偶数长度以便使用半长实数FFT
+    int fftSize = FftPlan::nextSmoothSize(correlationLength + maxLag);
+    while (fftSize % 2 != 0) {
+        fftSize = FftPlan::nextSmoothSize(fftSize + 1);
+    }
+
+    QSharedPointer<const RealFftPlan> forwardPlan = RealFftPlan::plan(fftSize);
+    QSharedPointer<const FftPlan> inversePlan = FftPlan::plan(fftSize);
+    if (!forwardPlan || !inversePlan) {
+        return QVector<CorrelationResult>();
+    }
+
+    QVector<QVector<Complex>> spectra(channelCount);
+    QVector<double> energy(channelCount, 0.0);
+
+    runParallel(pool, channelCount, [&](int begin, int end) {
+        QVector<double> padded(fftSize, 0.0);
+        for (int c = begin; c < end; ++c) {
+            QVector<double> samples = centeredSamples(channelData[channels[c]], correlationLength);
+            double sum = 0.0;
+            for (int i = 0; i < correlationLength; ++i) {
+                padded[i] = samples[i];
+                sum += samples[i] * samples[i];
+            }
+            energy[c] = sum;
+
+            spectra[c].resize(forwardPlan->spectrumSize());
+            forwardPlan->transform(padded.constData(), spectra[c].data());
+        }
+    });
+
+    int pairTasks = (pairs.size() + 1) / 2;
+    runParallel(pool, pairTasks, [&](int begin, int end) {
+        for (int t = begin; t < end; ++t) {
+            int first = 2 * t;
+            int count = qMin(2, pairs.size() - first);
+            correlatePairs(spectra, energy, pairs.constData() + first, count, fftSize,
+                           maxLag, sampleRate, *inversePlan, results.data() + first);
+        }
+    });
+
+    spectra.clear();
+
+    // ========== 相干函数（Welch互谱） ==========
+    int segmentLength = qMin(qMax(2, settings.coherence.segmentLength), length);
+    double overlap = qBound(0.0, settings.coherence.overlap, 0.99);
+    int step = qMax(1, segmentLength - static_cast<int>(std::round(overlap * segmentLength)));
+    int segmentCount = 1 + (length - segmentLength) / step;
+
+    QSharedPointer<const RealFftPlan> segmentPlan = RealFftPlan::plan(segmentLength);
+    if (!segmentPlan) {
+        return results;
+    }
+    QVector<double> window = WindowFunction::coefficients(settings.coherence.window, segmentLength);
+    int bins = segmentPlan->spectrumSize();
+
+    // 每个任务独立累加自谱和互谱，最后按任务顺序合并
+    int taskCount = 1;
+    if (pool && segmentCount > 1) {
+        taskCount = qMin(segmentCount, pool->threadCount() * 2);
+    }
+    int segmentsPerTask = (segmentCount + taskCount - 1) / taskCount;
+    taskCount = (segmentCount + segmentsPerTask - 1) / segmentsPerTask;
+
+    QVector<QVector<double>> autoSums(taskCount, QVector<double>(channelCount * bins, 0.0));
+    QVector<QVector<Complex>> crossSums(taskCount, QVector<Complex>(pairs.size() * bins));
+
+    runParallel(pool, taskCount, [&](int begin, int end) {
+        QVector<double> buffer(segmentLength);
+        QVector<Complex> segmentSpectra(channelCount * bins);
+
+        for (int task = begin; task < end; ++task) {
+            double* autoSum = autoSums[task].data();
+            Complex* crossSum = crossSums[task].data();
+
+            int firstSegment = task * segmentsPerTask;
+            int lastSegment = qMin(segmentCount, firstSegment + segmentsPerTask);
+            for (int segment = firstSegment; segment < lastSegment; ++segment) {
+                int start = segment * step;
+
+                // 每个通道本段只变换一次
+                for (int c = 0; c < channelCount; ++c) {
+                    const DataPoint* x = channelData[channels[c]].constData() + start;
+                    double mean = 0.0;
+                    if (settings.coherence.removeMean) {
+                        for (int i = 0; i < segmentLength; ++i) {
+                            mean += x[i].amplitude;
+                        }
+                        mean /= segmentLength;
+                    }
+                    for (int i = 0; i < segmentLength; ++i) {
+                        buffer[i] = (x[i].amplitude - mean) * window[i];
+                    }
+
+                    Complex* spectrum = segmentSpectra.data() + c * bins;
+                    segmentPlan->transform(buffer.constData(), spectrum);
+                    for (int k = 0; k < bins; ++k) {
+                        autoSum[c * bins + k] += std::norm(spectrum[k]);
+                    }
+                }
+
+                for (int p = 0; p < pairs.size(); ++p) {
+                    const Complex* sa = segmentSpectra.constData() + pairs[p].a * bins;
+                    const Complex* sb = segmentSpectra.constData() + pairs[p].b * bins;
+                    Complex* sum = crossSum + p * bins;
+                    for (int k = 0; k < bins; ++k) {
+                        sum[k] += sa[k] * std::conj(sb[k]);
+                    }
+                }
+            }
+        }
+    });
+
+    for (int task = 1; task < taskCount; ++task) {
+        for (int i = 0; i < autoSums[0].size(); ++i) {
+            autoSums[0][i] += autoSums[task][i];
+        }
+        for (int i = 0; i < crossSums[0].size(); ++i) {
+            crossSums[0][i] += crossSums[task][i];
+        }
+    }
+
+    if (coherenceSpectra) {
+        coherenceSpectra->clear();
+        coherenceSpectra->resize(pairs.size());
+    }
+
+    // 相干系数 |Pab|²/(Paa·Pbb)，缩放因子在比值中抵消
+    double resolution = sampleRate / segmentLength;
+    for (int p = 0; p < pairs.size(); ++p) {
+        const double* pa = autoSums[0].constData() + pairs[p].a * bins;
+        const double* pb = autoSums[0].constData() + pairs[p].b * bins;
+        const Complex* pab = crossSums[0].constData() + p * bins;
+
+        QVector<double> coherence(bins, 0.0);
+        double sum = 0.0;
+        int counted = 0;
+        int peakBin = 0;
+        for (int k = 1; k < bins; ++k) {
+            double denominator = pa[k] * pb[k];
+            coherence[k] = denominator > 0.0 ? std::norm(pab[k]) / denominator : 0.0;
+            sum += coherence[k];
+            ++counted;
+            if (coherence[k] > coherence[peakBin]) {
+                peakBin = k;
+            }
+        }
+
+        results[p].meanCoherence = counted > 0 ? sum / counted : 0.0;
+        results[p].peakCoherence = coherence[peakBin];
+        results[p].peakCoherenceFrequency = peakBin * resolution;
+
+        if (coherenceSpectra) {
+            (*coherenceSpectra)[p] = coherence;
+        }
+    }
+
+    qDebug() << "通道间分析完成: 通道数" << channelCount << "通道对" << pairs.size()
+             << "相关FFT长度" << fftSize << "相干分段" << segmentCount;
+
+    return results;
+}
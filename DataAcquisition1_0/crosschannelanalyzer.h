@@ -0,0 +1,36 @@
+#ifndef CROSSCHANNELANALYZER_H
+#define CROSSCHANNELANALYZER_H
+
+#include <QVector>
+#include "databuffer.h"
+#include "databasemanager.h"
+#include "welchestimator.h"
+
+class WorkStealingPool;
+
+// 通道间分析参数
+struct CrossChannelSettings {
+    WelchSettings coherence;    // 相干函数的分段/加窗参数
+    int maxLagSamples;          // 互相关搜索的最大延迟（样本），小于0表示不限制
+
+    CrossChannelSettings() : maxLagSamples(-1) {}
+};
+
+// 通道间相关与相干分析
+// 每个通道只做一次FFT，频谱被所有通道对复用：
+//  - 互相关：零填充到 >= n+maxLag 的混合基长度，互谱逆变换得到全部延迟的相关值（每次逆变换同时处理两个通道对）
+//  - 相干函数：Welch分段，每段对各通道各做一次FFT，再累加所有通道对的自谱和互谱
+// 各阶段在线程池中并行，结果按通道对顺序排列，与调度无关
+class CrossChannelAnalyzer
+{
+public:
+    // channels 为参与分析的通道号，channelData 按通道号索引；返回 (a, b)，a < b 的全部通道对
+    static QVector<CorrelationResult> analyze(const QVector<QVector<DataPoint>>& channelData,
+                                              const QVector<int>& channels,
+                                              int taskId, double sampleRate,
+                                              const CrossChannelSettings& settings = CrossChannelSettings(),
+                                              WorkStealingPool* pool = nullptr,
+                                              QVector<QVector<double>>* coherenceSpectra = nullptr);
+};
+
+#endif // CROSSCHANNELANALYZER_H
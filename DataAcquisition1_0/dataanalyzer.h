@@ -1,44 +1,67 @@
-#ifndef DATAANALYZER_H
-#define DATAANALYZER_H
-
-#include <QObject>
-#include <QVector>
-#include <complex>
-#include "databuffer.h"
-#include "databasemanager.h"
-
-class DataAnalyzer : public QObject
-{
-    Q_OBJECT
-
-public:
-    explicit DataAnalyzer(QObject *parent = nullptr);
-    ~DataAnalyzer();
-
-    // 统计分析
-    double calculateMax(const QVector<DataPoint>& data);
-    double calculateMin(const QVector<DataPoint>& data);
-    double calculateMean(const QVector<DataPoint>& data);
-    double calculateRMS(const QVector<DataPoint>& data);
-    double calculateStdDev(const QVector<DataPoint>& data);
-
-    // 频域分析
-    double calculateDominantFrequency(const QVector<DataPoint>& data, double sampleRate);
-    QVector<double> calculateFFT(const QVector<DataPoint>& data);
-    QVector<double> calculatePowerSpectrum(const QVector<DataPoint>& data);
-
-    // 完整分析（生成分析结果结构）
-    AnalysisResult performFullAnalysis(const QVector<DataPoint>& data,
-                                       int taskId, int channel, double sampleRate);
-
-signals:
-    void analysisProgress(int percentage, const QString& message);
-    void analysisCompleted(const AnalysisResult& result);
-
-private:
-    void fft(QVector<std::complex<double>>& data);
-    int reverseBits(int num, int bits);
-    int nextPowerOf2(int n);
-};
-
-#endif // DATAANALYZER_H
+#ifndef DATAANALYZER_H
+#define DATAANALYZER_H
+
+#include <QObject>
+#include <QVector>
+#include "databuffer.h"
+#include "databasemanager.h"
+#include "signalstatistics.h"
+#include "welchestimator.h"
+
+class WorkStealingPool;
+struct AnalysisCacheKey;
+
+class DataAnalyzer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DataAnalyzer(QObject *parent = nullptr);
+    ~DataAnalyzer();
+
+    // 统计分析
+    double calculateMax(const QVector<DataPoint>& data);
+    double calculateMin(const QVector<DataPoint>& data);
+    double calculateMean(const QVector<DataPoint>& data);
+    double calculateRMS(const QVector<DataPoint>& data);
+    double calculateStdDev(const QVector<DataPoint>& data);
+
+    // 频域分析
+    double calculateDominantFrequency(const QVector<DataPoint>& data, double sampleRate);
+    QVector<double> calculateFFT(const QVector<DataPoint>& data);
+    // Welch功率谱密度（V²/Hz），段长、重叠、窗函数由 setWelchSettings 配置
+    PsdResult calculatePowerSpectrum(const QVector<DataPoint>& data, double sampleRate);
+
+    void setWelchSettings(const WelchSettings& settings) { m_welchSettings = settings; }
+    WelchSettings welchSettings() const { return m_welchSettings; }
+
+    // 完整分析（生成分析结果结构）
+    AnalysisResult performFullAnalysis(const QVector<DataPoint>& data,
+                                       int taskId, int channel, double sampleRate);
+
+    // 以下静态函数不发送信号、不持有状态，可在多个线程中同时调用
+    // 统计量：数据较长且提供线程池时按块并行计算后按顺序合并
+    static SignalStatistics computeStatistics(const QVector<DataPoint>& data,
+                                              WorkStealingPool* pool = nullptr);
+    static double findDominantFrequency(const QVector<DataPoint>& data, double sampleRate,
+                                        int* peakIndex = nullptr, double* peakMagnitude = nullptr);
+    static AnalysisResult analyzeChannel(const QVector<DataPoint>& data,
+                                         int taskId, int channel, double sampleRate,
+                                         WorkStealingPool* pool = nullptr);
+    // 实时分析结果的缓存键：按实际分析的时间窗口和样本数区分，
+    // 只有同一窗口的重复保存才覆盖原有结果，不会与整段录制的结果混淆
+    static AnalysisCacheKey liveCacheKey(int taskId, int channel, double sampleRate,
+                                         const QVector<DataPoint>& data);
+
+signals:
+    void analysisProgress(int percentage, const QString& message);
+    void analysisCompleted(const AnalysisResult& result);
+
+private:
+    static QVector<double> realSpectrum(const QVector<DataPoint>& data, bool squared,
+                                        int* fftSizeOut = nullptr);
+
+    WelchSettings m_welchSettings;
+};
+
+#endif // DATAANALYZER_H
@@ -1,623 +1,1569 @@
-#include "databasemanager.h"
-#include <QSqlRecord>
-#include <QVariant>
-#include <QDateTime>
-#include <QDebug>
-
-DatabaseManager::DatabaseManager(QObject *parent)
-    : QObject(parent)
-    , m_isConnected(false)
-{
-}
-
-DatabaseManager::~DatabaseManager()
-{
-    disconnectFromDatabase();
-}
-
-bool DatabaseManager::connectToDatabase(const QString& host, int port,
-                                        const QString& dbName,
-                                        const QString& user,
-                                        const QString& password)
-{
-    if (m_isConnected) {
-        disconnectFromDatabase();
-    }
-
-    m_database = QSqlDatabase::addDatabase("QMYSQL");
-    m_database.setHostName(host);
-    m_database.setPort(port);
-    m_database.setDatabaseName(dbName);
-    m_database.setUserName(user);
-    m_database.setPassword(password);
-
-    if (!m_database.open()) {
-        m_lastError = m_database.lastError().text();
-        qWarning() << "数据库连接失败:" << m_lastError;
-        return false;
-    }
-
-    m_isConnected = true;
-    qDebug() << "数据库连接成功";
-
-    // 创建表
-    if (!createTables()) {
-        m_lastError = "创建表失败";
-        disconnectFromDatabase();
-        return false;
-    }
-
-    return true;
-}
-
-void DatabaseManager::disconnectFromDatabase()
-{
-    if (m_isConnected) {
-        m_database.close();
-        m_isConnected = false;
-        qDebug() << "数据库已断开连接";
-    }
-}
-
-bool DatabaseManager::isConnected() const
-{
-    return m_isConnected && m_database.isOpen();
-}
-
-bool DatabaseManager::createTables()
-{
-    QSqlQuery query(m_database);
-
-    // 创建任务表
-    QString createTaskTable = R"(
-        CREATE TABLE IF NOT EXISTS tasks (
-            task_id INT AUTO_INCREMENT PRIMARY KEY,
-            task_name VARCHAR(255) NOT NULL,
-            sample_rate DOUBLE NOT NULL,
-            duration DOUBLE NOT NULL,
-            channel_count INT DEFAULT 2,
-            create_time DATETIME DEFAULT CURRENT_TIMESTAMP,
-            description TEXT,
-            INDEX idx_task_name (task_name),
-            INDEX idx_create_time (create_time)
-        ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4
-    )";
-
-    if (!query.exec(createTaskTable)) {
-        m_lastError = query.lastError().text();
-        qWarning() << "创建任务表失败:" << m_lastError;
-        return false;
-    }
-
-    // 创建原始数据表
-    QString createRawDataTable = R"(
-        CREATE TABLE IF NOT EXISTS raw_data (
-            data_id BIGINT AUTO_INCREMENT PRIMARY KEY,
-            task_id INT NOT NULL,
-            channel INT NOT NULL,
-            time_value DOUBLE NOT NULL,
-            amplitude DOUBLE NOT NULL,
-            INDEX idx_task_channel (task_id, channel),
-            INDEX idx_time (time_value),
-            FOREIGN KEY (task_id) REFERENCES tasks(task_id) ON DELETE CASCADE
-        ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4
-    )";
-
-    if (!query.exec(createRawDataTable)) {
-        m_lastError = query.lastError().text();
-        qWarning() << "创建原始数据表失败:" << m_lastError;
-        return false;
-    }
-
-    // 创建处理后坐标数据表
-    QString createProcessedTable = R"(
-        CREATE TABLE IF NOT EXISTS processed_coordinates (
-            coord_id BIGINT AUTO_INCREMENT PRIMARY KEY,
-            task_id INT NOT NULL,
-            channel INT NOT NULL,
-            time_value DOUBLE NOT NULL,
-            amplitude DOUBLE NOT NULL,
-            INDEX idx_task_channel (task_id, channel),
-            FOREIGN KEY (task_id) REFERENCES tasks(task_id) ON DELETE CASCADE
-        ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4
-    )";
-
-    if (!query.exec(createProcessedTable)) {
-        m_lastError = query.lastError().text();
-        qWarning() << "创建处理数据表失败:" << m_lastError;
-        return false;
-    }
-
-    // 创建分析结果表
-    QString createAnalysisTable = R"(
-        CREATE TABLE IF NOT EXISTS analysis_results (
-            analysis_id INT AUTO_INCREMENT PRIMARY KEY,
-            task_id INT NOT NULL,
-            channel INT NOT NULL,
-            max_amplitude DOUBLE,
-            min_amplitude DOUBLE,
-            avg_amplitude DOUBLE,
-            rms_value DOUBLE,
-            frequency DOUBLE,
-            analysis_time DATETIME DEFAULT CURRENT_TIMESTAMP,
-            INDEX idx_task (task_id),
-            FOREIGN KEY (task_id) REFERENCES tasks(task_id) ON DELETE CASCADE
-        ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4
-    )";
-
-    if (!query.exec(createAnalysisTable)) {
-        m_lastError = query.lastError().text();
-        qWarning() << "创建分析结果表失败:" << m_lastError;
-        return false;
-    }
-
-    qDebug() << "数据库表创建成功";
-    return true;
-}
-
-int DatabaseManager::createTask(const TaskInfo& info)
-{
-    QSqlQuery query(m_database);
-    query.prepare("INSERT INTO tasks (task_name, sample_rate, duration, "
-                  "channel_count, description) VALUES (?, ?, ?, ?, ?)");
-    query.addBindValue(info.taskName);
-    query.addBindValue(info.sampleRate);
-    query.addBindValue(info.duration);
-    query.addBindValue(info.channelCount);
-    query.addBindValue(info.description);
-
-    if (!executeQuery(query)) {
-        return -1;
-    }
-
-    int taskId = query.lastInsertId().toInt();
-    qDebug() << "任务创建成功，ID:" << taskId;
-    return taskId;
-}
-
-bool DatabaseManager::updateTask(const TaskInfo& info)
-{
-    QSqlQuery query(m_database);
-    query.prepare("UPDATE tasks SET task_name=?, sample_rate=?, duration=?, "
-                  "channel_count=?, description=? WHERE task_id=?");
-    query.addBindValue(info.taskName);
-    query.addBindValue(info.sampleRate);
-    query.addBindValue(info.duration);
-    query.addBindValue(info.channelCount);
-    query.addBindValue(info.description);
-    query.addBindValue(info.taskId);
-
-    return executeQuery(query);
-}
-
-bool DatabaseManager::deleteTask(int taskId)
-{
-    QSqlQuery query(m_database);
-    query.prepare("DELETE FROM tasks WHERE task_id=?");
-    query.addBindValue(taskId);
-
-    bool success = executeQuery(query);
-    if (success) {
-        qDebug() << "任务删除成功，ID:" << taskId;
-    }
-    return success;
-}
-
-TaskInfo DatabaseManager::getTask(int taskId)
-{
-    TaskInfo info;
-
-    QSqlQuery query(m_database);
-    query.prepare("SELECT * FROM tasks WHERE task_id=?");
-    query.addBindValue(taskId);
-
-    if (!executeQuery(query)) {
-        return info;
-    }
-
-    if (query.next()) {
-        info.taskId = query.value("task_id").toInt();
-        info.taskName = query.value("task_name").toString();
-        info.sampleRate = query.value("sample_rate").toDouble();
-        info.duration = query.value("duration").toDouble();
-        info.channelCount = query.value("channel_count").toInt();
-        info.createTime = query.value("create_time").toString();
-        info.description = query.value("description").toString();
-    }
-
-    return info;
-}
-
-QVector<TaskInfo> DatabaseManager::getAllTasks()
-{
-    QVector<TaskInfo> tasks;
-
-    QSqlQuery query(m_database);
-    if (!query.exec("SELECT * FROM tasks ORDER BY create_time DESC")) {
-        m_lastError = query.lastError().text();
-        return tasks;
-    }
-
-    while (query.next()) {
-        TaskInfo info;
-        info.taskId = query.value("task_id").toInt();
-        info.taskName = query.value("task_name").toString();
-        info.sampleRate = query.value("sample_rate").toDouble();
-        info.duration = query.value("duration").toDouble();
-        info.channelCount = query.value("channel_count").toInt();
-        info.createTime = query.value("create_time").toString();
-        info.description = query.value("description").toString();
-        tasks.append(info);
-    }
-
-    return tasks;
-}
-
-QVector<TaskInfo> DatabaseManager::searchTasks(const QString& keyword)
-{
-    QVector<TaskInfo> tasks;
-
-    QSqlQuery query(m_database);
-    query.prepare("SELECT * FROM tasks WHERE task_name LIKE ? OR description LIKE ? "
-                  "ORDER BY create_time DESC");
-    QString searchPattern = "%" + keyword + "%";
-    query.addBindValue(searchPattern);
-    query.addBindValue(searchPattern);
-
-    if (!executeQuery(query)) {
-        return tasks;
-    }
-
-    while (query.next()) {
-        TaskInfo info;
-        info.taskId = query.value("task_id").toInt();
-        info.taskName = query.value("task_name").toString();
-        info.sampleRate = query.value("sample_rate").toDouble();
-        info.duration = query.value("duration").toDouble();
-        info.channelCount = query.value("channel_count").toInt();
-        info.createTime = query.value("create_time").toString();
-        info.description = query.value("description").toString();
-        tasks.append(info);
-    }
-
-    return tasks;
-}
-
-bool DatabaseManager::saveRawData(int taskId, int channel, const QVector<DataPoint>& data)
-{
-    if (data.isEmpty()) {
-        return true;
-    }
-
-    if (!beginTransaction()) {
-        return false;
-    }
-
-    QSqlQuery query(m_database);
-    query.prepare("INSERT INTO raw_data (task_id, channel, time_value, amplitude) "
-                  "VALUES (?, ?, ?, ?)");
-
-    int totalPoints = data.size();
-    int batchSize = 1000;
-
-    for (int i = 0; i < totalPoints; i += batchSize) {
-        int endIndex = qMin(i + batchSize, totalPoints);
-
-        for (int j = i; j < endIndex; ++j) {
-            query.addBindValue(taskId);
-            query.addBindValue(channel);
-            query.addBindValue(data[j].time);
-            query.addBindValue(data[j].amplitude);
-
-            if (!query.exec()) {
-                m_lastError = query.lastError().text();
-                rollbackTransaction();
-                return false;
-            }
-        }
-
-        int percentage = (endIndex * 100) / totalPoints;
-        emit progressUpdated(percentage, QString("保存原始数据: %1/%2").arg(endIndex).arg(totalPoints));
-    }
-
-    if (!commitTransaction()) {
-        return false;
-    }
-
-    qDebug() << "原始数据保存成功 - 任务:" << taskId << "通道:" << channel << "点数:" << data.size();
-    return true;
-}
-
-bool DatabaseManager::saveProcessedCoordinates(int taskId, int channel,
-                                               const QVector<DataPoint>& data)
-{
-    if (data.isEmpty()) {
-        return true;
-    }
-
-    if (!beginTransaction()) {
-        return false;
-    }
-
-    QSqlQuery query(m_database);
-    query.prepare("INSERT INTO processed_coordinates (task_id, channel, time_value, amplitude) "
-                  "VALUES (?, ?, ?, ?)");
-
-    int totalPoints = data.size();
-    int batchSize = 1000;
-
-    for (int i = 0; i < totalPoints; i += batchSize) {
-        int endIndex = qMin(i + batchSize, totalPoints);
-
-        for (int j = i; j < endIndex; ++j) {
-            query.addBindValue(taskId);
-            query.addBindValue(channel);
-            query.addBindValue(data[j].time);
-            query.addBindValue(data[j].amplitude);
-
-            if (!query.exec()) {
-                m_lastError = query.lastError().text();
-                rollbackTransaction();
-                return false;
-            }
-        }
-
-        int percentage = (endIndex * 100) / totalPoints;
-        emit progressUpdated(percentage, QString("保存处理数据: %1/%2").arg(endIndex).arg(totalPoints));
-    }
-
-    if (!commitTransaction()) {
-        return false;
-    }
-
-    qDebug() << "处理数据保存成功 - 任务:" << taskId << "通道:" << channel << "点数:" << data.size();
-    return true;
-}
-
-QVector<DataPoint> DatabaseManager::loadRawData(int taskId, int channel)
-{
-    QVector<DataPoint> data;
-
-    QSqlQuery query(m_database);
-    query.prepare("SELECT time_value, amplitude FROM raw_data "
-                  "WHERE task_id=? AND channel=? ORDER BY time_value ASC");
-    query.addBindValue(taskId);
-    query.addBindValue(channel);
-
-    if (!executeQuery(query)) {
-        return data;
-    }
-
-    while (query.next()) {
-        DataPoint point;
-        point.time = query.value("time_value").toDouble();
-        point.amplitude = query.value("amplitude").toDouble();
-        data.append(point);
-    }
-
-    qDebug() << "原始数据加载成功 - 任务:" << taskId << "通道:" << channel << "点数:" << data.size();
-    return data;
-}
-
-QVector<DataPoint> DatabaseManager::loadProcessedData(int taskId, int channel)
-{
-    QVector<DataPoint> data;
-
-    QSqlQuery query(m_database);
-    query.prepare("SELECT time_value, amplitude FROM processed_coordinates "
-                  "WHERE task_id=? AND channel=? ORDER BY time_value ASC");
-    query.addBindValue(taskId);
-    query.addBindValue(channel);
-
-    if (!executeQuery(query)) {
-        return data;
-    }
-
-    while (query.next()) {
-        DataPoint point;
-        point.time = query.value("time_value").toDouble();
-        point.amplitude = query.value("amplitude").toDouble();
-        data.append(point);
-    }
-
-    qDebug() << "处理数据加载成功 - 任务:" << taskId << "通道:" << channel << "点数:" << data.size();
-    return data;
-}
-
-bool DatabaseManager::saveAnalysisResult(const AnalysisResult& result)
-{
-    QSqlQuery query(m_database);
-    query.prepare("INSERT INTO analysis_results "
-                  "(task_id, channel, max_amplitude, min_amplitude, avg_amplitude, "
-                  "rms_value, frequency) VALUES (?, ?, ?, ?, ?, ?, ?)");
-    query.addBindValue(result.taskId);
-    query.addBindValue(result.channel);
-    query.addBindValue(result.maxAmplitude);
-    query.addBindValue(result.minAmplitude);
-    query.addBindValue(result.avgAmplitude);
-    query.addBindValue(result.rmsValue);
-    query.addBindValue(result.frequency);
-
-    bool success = executeQuery(query);
-    if (success) {
-        qDebug() << "分析结果保存成功 - 任务:" << result.taskId << "通道:" << result.channel;
-    }
-    return success;
-}
-
-QVector<AnalysisResult> DatabaseManager::getAnalysisResults(int taskId)
-{
-    QVector<AnalysisResult> results;
-
-    QSqlQuery query(m_database);
-    query.prepare("SELECT * FROM analysis_results WHERE task_id=? "
-                  "ORDER BY analysis_time DESC");
-    query.addBindValue(taskId);
-
-    if (!executeQuery(query)) {
-        return results;
-    }
-
-    while (query.next()) {
-        AnalysisResult result;
-        result.analysisId = query.value("analysis_id").toInt();
-        result.taskId = query.value("task_id").toInt();
-        result.channel = query.value("channel").toInt();
-        result.maxAmplitude = query.value("max_amplitude").toDouble();
-        result.minAmplitude = query.value("min_amplitude").toDouble();
-        result.avgAmplitude = query.value("avg_amplitude").toDouble();
-        result.rmsValue = query.value("rms_value").toDouble();
-        result.frequency = query.value("frequency").toDouble();
-        result.analysisTime = query.value("analysis_time").toString();
-        results.append(result);
-    }
-
-    return results;
-}
-
-bool DatabaseManager::beginTransaction()
-{
-    if (!m_database.transaction()) {
-        m_lastError = m_database.lastError().text();
-        qWarning() << "开始事务失败:" << m_lastError;
-        return false;
-    }
-    return true;
-}
-
-bool DatabaseManager::commitTransaction()
-{
-    if (!m_database.commit()) {
-        m_lastError = m_database.lastError().text();
-        qWarning() << "提交事务失败:" << m_lastError;
-        return false;
-    }
-    return true;
-}
-
-bool DatabaseManager::rollbackTransaction()
-{
-    if (!m_database.rollback()) {
-        m_lastError = m_database.lastError().text();
-        qWarning() << "回滚事务失败:" << m_lastError;
-        return false;
-    }
-    return true;
-}
-
-bool DatabaseManager::executeQuery(QSqlQuery& query)
-{
-    if (!query.exec()) {
-        m_lastError = query.lastError().text();
-        qWarning() << "SQL执行失败:" << m_lastError;
-        qWarning() << "SQL语句:" << query.lastQuery();
-        return false;
-    }
-    return true;
-}
-
-// 在原有 databasemanager.cpp 的基础上添加以下方法
-
-// 在文件末尾添加这些新方法：
-
-bool DatabaseManager::saveMultiChannelData(int taskId,
-                                           const QVector<QVector<DataPoint>>& channelData,
-                                           const QVector<int>& channelIndices)
-{
-    if (channelData.size() != channelIndices.size()) {
-        qWarning() << "通道数据和索引数量不匹配";
-        return false;
-    }
-
-    if (!beginTransaction()) {
-        return false;
-    }
-
-    for (int i = 0; i < channelData.size(); ++i) {
-        int channel = channelIndices[i];
-        const QVector<DataPoint>& data = channelData[i];
-
-        if (data.isEmpty()) continue;
-
-        QSqlQuery query(m_database);
-        query.prepare("INSERT INTO raw_data (task_id, channel, time_value, amplitude) "
-                      "VALUES (?, ?, ?, ?)");
-
-        int totalPoints = data.size();
-        int batchSize = 1000;
-
-        for (int j = 0; j < totalPoints; j += batchSize) {
-            int endIndex = qMin(j + batchSize, totalPoints);
-
-            for (int k = j; k < endIndex; ++k) {
-                query.addBindValue(taskId);
-                query.addBindValue(channel);
-                query.addBindValue(data[k].time);
-                query.addBindValue(data[k].amplitude);
-
-                if (!query.exec()) {
-                    m_lastError = query.lastError().text();
-                    rollbackTransaction();
-                    return false;
-                }
-            }
-
-            int percentage = ((i * totalPoints + endIndex) * 100) /
-                             (channelData.size() * totalPoints);
-            emit progressUpdated(percentage,
-                                 QString("保存通道 %1 数据: %2/%3").arg(channel).arg(endIndex).arg(totalPoints));
-        }
-    }
-
-    if (!commitTransaction()) {
-        return false;
-    }
-
-    qDebug() << "多通道数据保存成功";
-    return true;
-}
-
-QVector<QVector<DataPoint>> DatabaseManager::loadMultiChannelData(int taskId,
-                                                                  const QVector<int>& channels)
-{
-    QVector<QVector<DataPoint>> allData;
-    allData.reserve(channels.size());
-
-    for (int channel : channels) {
-        QVector<DataPoint> data = loadRawData(taskId, channel);
-        allData.append(data);
-    }
-
-    return allData;
-}
-
-QVector<AnalysisResult> DatabaseManager::getChannelAnalysisResults(int taskId, int channel)
-{
-    QVector<AnalysisResult> results;
-
-    QSqlQuery query(m_database);
-    query.prepare("SELECT * FROM analysis_results WHERE task_id=? AND channel=? "
-                  "ORDER BY analysis_time DESC");
-    query.addBindValue(taskId);
-    query.addBindValue(channel);
-
-    if (!executeQuery(query)) {
-        return results;
-    }
-
-    while (query.next()) {
-        AnalysisResult result;
-        result.analysisId = query.value("analysis_id").toInt();
-        result.taskId = query.value("task_id").toInt();
-        result.channel = query.value("channel").toInt();
-        result.maxAmplitude = query.value("max_amplitude").toDouble();
-        result.minAmplitude = query.value("min_amplitude").toDouble();
-        result.avgAmplitude = query.value("avg_amplitude").toDouble();
-        result.rmsValue = query.value("rms_value").toDouble();
-        result.frequency = query.value("frequency").toDouble();
-        result.analysisTime = query.value("analysis_time").toString();
-        results.append(result);
-    }
-
-    return results;
-}
+#include "databasemanager.h"
+#include <QSqlRecord>
+#include <QVariant>
+#include <QDateTime>
+#include <QDebug>
+#include <QByteArray>
+#include <cstring>
+#include <limits>
+
+DatabaseManager::DatabaseManager(QObject *parent)
+    : QObject(parent)
+    , m_isConnected(false)
+    , m_port(0)
+{
+}
+
+DatabaseManager::~DatabaseManager()
+{
+    disconnectFromDatabase();
+}
+
+bool DatabaseManager::connectToDatabase(const QString& host, int port,
+                                        const QString& dbName,
+                                        const QString& user,
+                                        const QString& password,
+                                        const QString& connectionName)
+{
+    if (m_isConnected || !m_connectionName.isEmpty()) {
+        disconnectFromDatabase();
+    }
+
+    m_host = host;
+    m_port = port;
+    m_dbName = dbName;
+    m_user = user;
+    m_password = password;
+    m_connectionName = connectionName;
+
+    m_database = connectionName.isEmpty()
+        ? QSqlDatabase::addDatabase("QMYSQL")
+        : QSqlDatabase::addDatabase("QMYSQL", connectionName);
+    m_database.setHostName(host);
+    m_database.setPort(port);
+    m_database.setDatabaseName(dbName);
+    m_database.setUserName(user);
+    m_database.setPassword(password);
+
+    if (!m_database.open()) {
+        m_lastError = m_database.lastError().text();
+        qWarning() << "数据库连接失败:" << m_lastError;
+        return false;
+    }
+
+    m_isConnected = true;
+    qDebug() << "数据库连接成功";
+
+    // 创建表
+    if (!createTables()) {
+        m_lastError = "创建表失败";
+        disconnectFromDatabase();
+        return false;
+    }
+
+    return true;
+}
+
+bool DatabaseManager::connectLike(const DatabaseManager* source, const QString& connectionName)
+{
+    if (!source || connectionName.isEmpty()) {
+        return false;
+    }
+    return connectToDatabase(source->m_host, source->m_port, source->m_dbName,
+                             source->m_user, source->m_password, connectionName);
+}
+
+void DatabaseManager::disconnectFromDatabase()
+{
+    if (m_isConnected) {
+        m_database.close();
+        m_isConnected = false;
+        qDebug() << "数据库已断开连接";
+    }
+
+    // 命名连接在释放最后一个引用后移除
+    if (!m_connectionName.isEmpty()) {
+        m_database = QSqlDatabase();
+        QSqlDatabase::removeDatabase(m_connectionName);
+        m_connectionName.clear();
+    }
+}
+
+bool DatabaseManager::isConnected() const
+{
+    return m_isConnected && m_database.isOpen();
+}
+
+bool DatabaseManager::createTables()
+{
+    QSqlQuery query(m_database);
+
+    // 创建任务表
+    QString createTaskTable = R"(
+        CREATE TABLE IF NOT EXISTS tasks (
+            task_id INT AUTO_INCREMENT PRIMARY KEY,
+            task_name VARCHAR(255) NOT NULL,
+            sample_rate DOUBLE NOT NULL,
+            duration DOUBLE NOT NULL,
+            channel_count INT DEFAULT 2,
+            create_time DATETIME DEFAULT CURRENT_TIMESTAMP,
+            description TEXT,
+            INDEX idx_task_name (task_name),
+            INDEX idx_create_time (create_time)
+        ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4
+    )";
+
+    if (!query.exec(createTaskTable)) {
+        m_lastError = query.lastError().text();
+        qWarning() << "创建任务表失败:" << m_lastError;
+        return false;
+    }
+
+    // 创建原始数据表
+    QString createRawDataTable = R"(
+        CREATE TABLE IF NOT EXISTS raw_data (
+            data_id BIGINT AUTO_INCREMENT PRIMARY KEY,
+            task_id INT NOT NULL,
+            channel INT NOT NULL,
+            time_value DOUBLE NOT NULL,
+            amplitude DOUBLE NOT NULL,
+            INDEX idx_task_channel (task_id, channel),
+            INDEX idx_time (time_value),
+            INDEX idx_task_channel_time (task_id, channel, time_value, amplitude),
+            FOREIGN KEY (task_id) REFERENCES tasks(task_id) ON DELETE CASCADE
+        ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4
+    )";
+
+    if (!query.exec(createRawDataTable)) {
+        m_lastError = query.lastError().text();
+        qWarning() << "创建原始数据表失败:" << m_lastError;
+        return false;
+    }
+
+    // 旧版本创建的表缺少覆盖索引时不在连接时补建（大表上 ALTER 耗时很长），
+    // 由 migrateRawDataTimeIndex() 作为一次性迁移显式执行
+    if (!hasRawDataTimeIndex()) {
+        qDebug() << "原始数据表缺少时间索引，区间统计将回退为全表扫描";
+    }
+
+    // 创建处理后坐标数据表
+    QString createProcessedTable = R"(
+        CREATE TABLE IF NOT EXISTS processed_coordinates (
+            coord_id BIGINT AUTO_INCREMENT PRIMARY KEY,
+            task_id INT NOT NULL,
+            channel INT NOT NULL,
+            time_value DOUBLE NOT NULL,
+            amplitude DOUBLE NOT NULL,
+            INDEX idx_task_channel (task_id, channel),
+            FOREIGN KEY (task_id) REFERENCES tasks(task_id) ON DELETE CASCADE
+        ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4
+    )";
+
+    if (!query.exec(createProcessedTable)) {
+        m_lastError = query.lastError().text();
+        qWarning() << "创建处理数据表失败:" << m_lastError;
+        return false;
+    }
+
+    // 创建分析结果表
+    QString createAnalysisTable = R"(
+        CREATE TABLE IF NOT EXISTS analysis_results (
+            analysis_id INT AUTO_INCREMENT PRIMARY KEY,
+            task_id INT NOT NULL,
+            channel INT NOT NULL,
+            max_amplitude DOUBLE,
+            min_amplitude DOUBLE,
+            avg_amplitude DOUBLE,
+            rms_value DOUBLE,
+            frequency DOUBLE,
+            analysis_time DATETIME DEFAULT CURRENT_TIMESTAMP,
+            cache_key CHAR(64) NULL,
+            INDEX idx_task (task_id),
+            UNIQUE KEY uk_cache_key (cache_key),
+            FOREIGN KEY (task_id) REFERENCES tasks(task_id) ON DELETE CASCADE
+        ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4
+    )";
+
+    if (!query.exec(createAnalysisTable)) {
+        m_lastError = query.lastError().text();
+        qWarning() << "创建分析结果表失败:" << m_lastError;
+        return false;
+    }
+
+    // 旧版本创建的分析结果表补充缓存键列（NULL 不受唯一约束限制，已有记录不受影响）
+    if (query.exec("SHOW COLUMNS FROM analysis_results LIKE 'cache_key'") && !query.next()) {
+        if (!query.exec("ALTER TABLE analysis_results ADD COLUMN cache_key CHAR(64) NULL, "
+                        "ADD UNIQUE KEY uk_cache_key (cache_key)")) {
+            m_lastError = query.lastError().text();
+            qWarning() << "分析结果表添加缓存键列失败:" << m_lastError;
+            return false;
+        }
+    }
+
+    // 创建通道间相关分析结果表
+    QString createCorrelationTable = R"(
+        CREATE TABLE IF NOT EXISTS correlation_results (
+            correlation_id INT AUTO_INCREMENT PRIMARY KEY,
+            task_id INT NOT NULL,
+            channel_a INT NOT NULL,
+            channel_b INT NOT NULL,
+            peak_correlation DOUBLE,
+            lag_samples DOUBLE,
+            lag_seconds DOUBLE,
+            mean_coherence DOUBLE,
+            peak_coherence DOUBLE,
+            peak_coherence_frequency DOUBLE,
+            analysis_time DATETIME DEFAULT CURRENT_TIMESTAMP,
+            INDEX idx_task_pair (task_id, channel_a, channel_b),
+            FOREIGN KEY (task_id) REFERENCES tasks(task_id) ON DELETE CASCADE
+        ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4
+    )";
+
+    if (!query.exec(createCorrelationTable)) {
+        m_lastError = query.lastError().text();
+        qWarning() << "创建相关分析结果表失败:" << m_lastError;
+        return false;
+    }
+
+    // 创建块级分析索引表（每通道每块一条，功率谱以 float 数组存为 BLOB）
+    QString createBlockTable = R"(
+        CREATE TABLE IF NOT EXISTS analysis_blocks (
+            block_id BIGINT AUTO_INCREMENT PRIMARY KEY,
+            task_id INT NOT NULL,
+            channel INT NOT NULL,
+            block_index INT NOT NULL,
+            start_time DOUBLE NOT NULL,
+            end_time DOUBLE NOT NULL,
+            sample_count BIGINT NOT NULL,
+            min_value DOUBLE,
+            max_value DOUBLE,
+            sum_value DOUBLE,
+            sum_squares DOUBLE,
+            mean_value DOUBLE,
+            m2_value DOUBLE,
+            spectrum_segments INT DEFAULT 0,
+            frequency_resolution DOUBLE DEFAULT 0,
+            spectrum MEDIUMBLOB,
+            UNIQUE KEY uk_task_channel_block (task_id, channel, block_index),
+            INDEX idx_task_channel_time (task_id, channel, start_time),
+            FOREIGN KEY (task_id) REFERENCES tasks(task_id) ON DELETE CASCADE
+        ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4
+    )";
+
+    if (!query.exec(createBlockTable)) {
+        m_lastError = query.lastError().text();
+        qWarning() << "创建块级分析索引表失败:" << m_lastError;
+        return false;
+    }
+
+    // 创建批量分析作业表
+    QString createBatchJobTable = R"(
+        CREATE TABLE IF NOT EXISTS batch_jobs (
+            job_id INT AUTO_INCREMENT PRIMARY KEY,
+            job_name VARCHAR(255) NOT NULL,
+            total_tasks INT NOT NULL,
+            finished TINYINT DEFAULT 0,
+            create_time DATETIME DEFAULT CURRENT_TIMESTAMP,
+            finish_time DATETIME NULL,
+            INDEX idx_finished (finished)
+        ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4
+    )";
+
+    if (!query.exec(createBatchJobTable)) {
+        m_lastError = query.lastError().text();
+        qWarning() << "创建批量分析作业表失败:" << m_lastError;
+        return false;
+    }
+
+    // 创建批量分析作业进度表（每个任务一条，完成后置 done）
+    QString createBatchTaskTable = R"(
+        CREATE TABLE IF NOT EXISTS batch_job_tasks (
+            job_id INT NOT NULL,
+            task_id INT NOT NULL,
+            done TINYINT DEFAULT 0,
+            sample_count BIGINT DEFAULT 0,
+            finish_time DATETIME NULL,
+            PRIMARY KEY (job_id, task_id),
+            FOREIGN KEY (job_id) REFERENCES batch_jobs(job_id) ON DELETE CASCADE
+        ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4
+    )";
+
+    if (!query.exec(createBatchTaskTable)) {
+        m_lastError = query.lastError().text();
+        qWarning() << "创建批量分析进度表失败:" << m_lastError;
+        return false;
+    }
+
+    qDebug() << "数据库表创建成功";
+    return true;
+}
+
+bool DatabaseManager::hasRawDataTimeIndex()
+{
+    // 只查询数据字典，不访问表本身
+    QSqlQuery query(m_database);
+    query.prepare("SELECT COUNT(*) FROM information_schema.statistics "
+                  "WHERE table_schema = DATABASE() AND table_name = 'raw_data' "
+                  "AND index_name = 'idx_task_channel_time'");
+    if (!query.exec() || !query.next()) {
+        qWarning() << "查询原始数据表索引失败:" << query.lastError().text();
+        return false;
+    }
+    return query.value(0).toInt() > 0;
+}
+
+bool DatabaseManager::migrateRawDataTimeIndex()
+{
+    if (!isConnected()) {
+        m_lastError = "数据库未连接";
+        return false;
+    }
+    if (hasRawDataTimeIndex()) {
+        return true;
+    }
+
+    // 在线建索引，迁移期间不阻塞其他连接写入
+    QSqlQuery query(m_database);
+    if (!query.exec("ALTER TABLE raw_data ADD INDEX idx_task_channel_time "
+                    "(task_id, channel, time_value, amplitude), "
+                    "ALGORITHM=INPLACE, LOCK=NONE")) {
+        m_lastError = query.lastError().text();
+        qWarning() << "添加原始数据时间索引失败:" << m_lastError;
+        return false;
+    }
+
+    qDebug() << "原始数据表时间索引已添加";
+    return true;
+}
+
+int DatabaseManager::createTask(const TaskInfo& info)
+{
+    QSqlQuery query(m_database);
+    query.prepare("INSERT INTO tasks (task_name, sample_rate, duration, "
+                  "channel_count, description) VALUES (?, ?, ?, ?, ?)");
+    query.addBindValue(info.taskName);
+    query.addBindValue(info.sampleRate);
+    query.addBindValue(info.duration);
+    query.addBindValue(info.channelCount);
+    query.addBindValue(info.description);
+
+    if (!executeQuery(query)) {
+        return -1;
+    }
+
+    int taskId = query.lastInsertId().toInt();
+    qDebug() << "任务创建成功，ID:" << taskId;
+    return taskId;
+}
+
+bool DatabaseManager::updateTask(const TaskInfo& info)
+{
+    QSqlQuery query(m_database);
+    query.prepare("UPDATE tasks SET task_name=?, sample_rate=?, duration=?, "
+                  "channel_count=?, description=? WHERE task_id=?");
+    query.addBindValue(info.taskName);
+    query.addBindValue(info.sampleRate);
+    query.addBindValue(info.duration);
+    query.addBindValue(info.channelCount);
+    query.addBindValue(info.description);
+    query.addBindValue(info.taskId);
+
+    return executeQuery(query);
+}
+
+bool DatabaseManager::deleteTask(int taskId)
+{
+    QSqlQuery query(m_database);
+    query.prepare("DELETE FROM tasks WHERE task_id=?");
+    query.addBindValue(taskId);
+
+    bool success = executeQuery(query);
+    if (success) {
+        qDebug() << "任务删除成功，ID:" << taskId;
+    }
+    return success;
+}
+
+TaskInfo DatabaseManager::getTask(int taskId)
+{
+    TaskInfo info;
+
+    QSqlQuery query(m_database);
+    query.prepare("SELECT * FROM tasks WHERE task_id=?");
+    query.addBindValue(taskId);
+
+    if (!executeQuery(query)) {
+        return info;
+    }
+
+    if (query.next()) {
+        info.taskId = query.value("task_id").toInt();
+        info.taskName = query.value("task_name").toString();
+        info.sampleRate = query.value("sample_rate").toDouble();
+        info.duration = query.value("duration").toDouble();
+        info.channelCount = query.value("channel_count").toInt();
+        info.createTime = query.value("create_time").toString();
+        info.description = query.value("description").toString();
+    }
+
+    return info;
+}
+
+QVector<TaskInfo> DatabaseManager::getAllTasks()
+{
+    QVector<TaskInfo> tasks;
+
+    QSqlQuery query(m_database);
+    if (!query.exec("SELECT * FROM tasks ORDER BY create_time DESC")) {
+        m_lastError = query.lastError().text();
+        return tasks;
+    }
+
+    while (query.next()) {
+        TaskInfo info;
+        info.taskId = query.value("task_id").toInt();
+        info.taskName = query.value("task_name").toString();
+        info.sampleRate = query.value("sample_rate").toDouble();
+        info.duration = query.value("duration").toDouble();
+        info.channelCount = query.value("channel_count").toInt();
+        info.createTime = query.value("create_time").toString();
+        info.description = query.value("description").toString();
+        tasks.append(info);
+    }
+
+    return tasks;
+}
+
+QVector<TaskInfo> DatabaseManager::searchTasks(const QString& keyword)
+{
+    QVector<TaskInfo> tasks;
+
+    QSqlQuery query(m_database);
+    query.prepare("SELECT * FROM tasks WHERE task_name LIKE ? OR description LIKE ? "
+                  "ORDER BY create_time DESC");
+    QString searchPattern = "%" + keyword + "%";
+    query.addBindValue(searchPattern);
+    query.addBindValue(searchPattern);
+
+    if (!executeQuery(query)) {
+        return tasks;
+    }
+
+    while (query.next()) {
+        TaskInfo info;
+        info.taskId = query.value("task_id").toInt();
+        info.taskName = query.value("task_name").toString();
+        info.sampleRate = query.value("sample_rate").toDouble();
+        info.duration = query.value("duration").toDouble();
+        info.channelCount = query.value("channel_count").toInt();
+        info.createTime = query.value("create_time").toString();
+        info.description = query.value("description").toString();
+        tasks.append(info);
+    }
+
+    return tasks;
+}
+
+QVector<TaskInfo> DatabaseManager::searchTasks(const QString& keyword,
+                                               const QDateTime& from, const QDateTime& to)
+{
+    QVector<TaskInfo> tasks;
+
+    QSqlQuery query(m_database);
+    query.prepare("SELECT * FROM tasks WHERE (task_name LIKE ? OR description LIKE ?) "
+                  "AND create_time >= ? AND create_time < ? ORDER BY create_time DESC");
+    QString searchPattern = "%" + keyword + "%";
+    query.addBindValue(searchPattern);
+    query.addBindValue(searchPattern);
+    query.addBindValue(from);
+    query.addBindValue(to);
+
+    if (!executeQuery(query)) {
+        return tasks;
+    }
+
+    while (query.next()) {
+        TaskInfo info;
+        info.taskId = query.value("task_id").toInt();
+        info.taskName = query.value("task_name").toString();
+        info.sampleRate = query.value("sample_rate").toDouble();
+        info.duration = query.value("duration").toDouble();
+        info.channelCount = query.value("channel_count").toInt();
+        info.createTime = query.value("create_time").toString();
+        info.description = query.value("description").toString();
+        tasks.append(info);
+    }
+
+    return tasks;
+}
+
+bool DatabaseManager::saveRawData(int taskId, int channel, const QVector<DataPoint>& data)
+{
+    if (data.isEmpty()) {
+        return true;
+    }
+
+    if (!beginTransaction()) {
+        return false;
+    }
+
+    if (!insertRawData(taskId, channel, data)) {
+        rollbackTransaction();
+        return false;
+    }
+
+    if (!commitTransaction()) {
+        return false;
+    }
+
+    qDebug() << "原始数据保存成功 - 任务:" << taskId << "通道:" << channel << "点数:" << data.size();
+    return true;
+}
+
+bool DatabaseManager::insertRawData(int taskId, int channel, const QVector<DataPoint>& data)
+{
+    QSqlQuery query(m_database);
+    query.prepare("INSERT INTO raw_data (task_id, channel, time_value, amplitude) "
+                  "VALUES (?, ?, ?, ?)");
+
+    int totalPoints = data.size();
+    int batchSize = 1000;
+
+    for (int i = 0; i < totalPoints; i += batchSize) {
+        int endIndex = qMin(i + batchSize, totalPoints);
+
+        for (int j = i; j < endIndex; ++j) {
+            query.addBindValue(taskId);
+            query.addBindValue(channel);
+            query.addBindValue(data[j].time);
+            query.addBindValue(data[j].amplitude);
+
+            if (!query.exec()) {
+                m_lastError = query.lastError().text();
+                return false;
+            }
+        }
+
+        int percentage = (endIndex * 100) / totalPoints;
+        emit progressUpdated(percentage, QString("保存原始数据: %1/%2").arg(endIndex).arg(totalPoints));
+    }
+    return true;
+}
+
+int DatabaseManager::saveTask(const TaskInfo& info, const QVector<int>& channels,
+                              const QVector<QVector<DataPoint>>& channelData,
+                              const QVector<QVector<BlockSummary>>& summaries)
+{
+    if (channels.size() != channelData.size() || summaries.size() != channelData.size()) {
+        m_lastError = "通道、数据与分析索引数量不匹配";
+        qWarning() << m_lastError;
+        return -1;
+    }
+
+    if (!beginTransaction()) {
+        return -1;
+    }
+
+    // 任务记录也在事务内，失败回滚后不会留下没有数据的任务
+    int taskId = createTask(info);
+    if (taskId < 0) {
+        rollbackTransaction();
+        return -1;
+    }
+
+    for (int i = 0; i < channelData.size(); ++i) {
+        if (channelData[i].isEmpty()) {
+            continue;
+        }
+
+        QVector<BlockSummary> channelSummaries = summaries[i];
+        for (BlockSummary& summary : channelSummaries) {
+            summary.taskId = taskId;
+        }
+
+        if (!insertRawData(taskId, channels[i], channelData[i])
+            || !insertBlockSummaries(channelSummaries)) {
+            qWarning() << "保存通道" << channels[i] << "失败，回滚整个任务:" << m_lastError;
+            rollbackTransaction();
+            return -1;
+        }
+    }
+
+    if (!commitTransaction()) {
+        rollbackTransaction();
+        return -1;
+    }
+
+    qDebug() << "任务保存成功 - 任务:" << taskId << "通道数:" << channelData.size();
+    return taskId;
+}
+
+bool DatabaseManager::saveProcessedCoordinates(int taskId, int channel,
+                                               const QVector<DataPoint>& data)
+{
+    if (data.isEmpty()) {
+        return true;
+    }
+
+    if (!beginTransaction()) {
+        return false;
+    }
+
+    QSqlQuery query(m_database);
+    query.prepare("INSERT INTO processed_coordinates (task_id, channel, time_value, amplitude) "
+                  "VALUES (?, ?, ?, ?)");
+
+    int totalPoints = data.size();
+    int batchSize = 1000;
+
+    for (int i = 0; i < totalPoints; i += batchSize) {
+        int endIndex = qMin(i + batchSize, totalPoints);
+
+        for (int j = i; j < endIndex; ++j) {
+            query.addBindValue(taskId);
+            query.addBindValue(channel);
+            query.addBindValue(data[j].time);
+            query.addBindValue(data[j].amplitude);
+
+            if (!query.exec()) {
+                m_lastError = query.lastError().text();
+                rollbackTransaction();
+                return false;
+            }
+        }
+
+        int percentage = (endIndex * 100) / totalPoints;
+        emit progressUpdated(percentage, QString("保存处理数据: %1/%2").arg(endIndex).arg(totalPoints));
+    }
+
+    if (!commitTransaction()) {
+        return false;
+    }
+
+    qDebug() << "处理数据保存成功 - 任务:" << taskId << "通道:" << channel << "点数:" << data.size();
+    return true;
+}
+
+QVector<DataPoint> DatabaseManager::loadRawData(int taskId, int channel)
+{
+    QVector<DataPoint> data;
+
+    QSqlQuery query(m_database);
+    query.prepare("SELECT time_value, amplitude FROM raw_data "
+                  "WHERE task_id=? AND channel=? ORDER BY time_value ASC");
+    query.addBindValue(taskId);
+    query.addBindValue(channel);
+
+    if (!executeQuery(query)) {
+        return data;
+    }
+
+    while (query.next()) {
+        DataPoint point;
+        point.time = query.value("time_value").toDouble();
+        point.amplitude = query.value("amplitude").toDouble();
+        data.append(point);
+    }
+
+    qDebug() << "原始数据加载成功 - 任务:" << taskId << "通道:" << channel << "点数:" << data.size();
+    return data;
+}
+
+QVector<DataPoint> DatabaseManager::loadProcessedData(int taskId, int channel)
+{
+    QVector<DataPoint> data;
+
+    QSqlQuery query(m_database);
+    query.prepare("SELECT time_value, amplitude FROM processed_coordinates "
+                  "WHERE task_id=? AND channel=? ORDER BY time_value ASC");
+    query.addBindValue(taskId);
+    query.addBindValue(channel);
+
+    if (!executeQuery(query)) {
+        return data;
+    }
+
+    while (query.next()) {
+        DataPoint point;
+        point.time = query.value("time_value").toDouble();
+        point.amplitude = query.value("amplitude").toDouble();
+        data.append(point);
+    }
+
+    qDebug() << "处理数据加载成功 - 任务:" << taskId << "通道:" << channel << "点数:" << data.size();
+    return data;
+}
+
+bool DatabaseManager::saveAnalysisResult(const AnalysisResult& result)
+{
+    QSqlQuery query(m_database);
+    query.prepare("INSERT INTO analysis_results "
+                  "(task_id, channel, max_amplitude, min_amplitude, avg_amplitude, "
+                  "rms_value, frequency, cache_key) VALUES (?, ?, ?, ?, ?, ?, ?, ?) "
+                  "ON DUPLICATE KEY UPDATE "
+                  "max_amplitude=VALUES(max_amplitude), min_amplitude=VALUES(min_amplitude), "
+                  "avg_amplitude=VALUES(avg_amplitude), rms_value=VALUES(rms_value), "
+                  "frequency=VALUES(frequency), analysis_time=CURRENT_TIMESTAMP");
+    query.addBindValue(result.taskId);
+    query.addBindValue(result.channel);
+    query.addBindValue(result.maxAmplitude);
+    query.addBindValue(result.minAmplitude);
+    query.addBindValue(result.avgAmplitude);
+    query.addBindValue(result.rmsValue);
+    query.addBindValue(result.frequency);
+    query.addBindValue(result.cacheKey.isEmpty() ? QVariant(QMetaType::fromType<QString>())
+                                                 : QVariant(result.cacheKey));
+
+    bool success = executeQuery(query);
+    if (success) {
+        qDebug() << "分析结果保存成功 - 任务:" << result.taskId << "通道:" << result.channel;
+    }
+    return success;
+}
+
+QVector<AnalysisResult> DatabaseManager::getAnalysisResults(int taskId)
+{
+    QVector<AnalysisResult> results;
+
+    QSqlQuery query(m_database);
+    query.prepare("SELECT * FROM analysis_results WHERE task_id=? "
+                  "ORDER BY analysis_time DESC");
+    query.addBindValue(taskId);
+
+    if (!executeQuery(query)) {
+        return results;
+    }
+
+    while (query.next()) {
+        results.append(readAnalysisResult(query));
+    }
+
+    return results;
+}
+
+bool DatabaseManager::findAnalysisResult(const QString& cacheKey, AnalysisResult* result)
+{
+    QSqlQuery query(m_database);
+    query.prepare("SELECT * FROM analysis_results WHERE cache_key=?");
+    query.addBindValue(cacheKey);
+
+    if (!executeQuery(query) || !query.next()) {
+        return false;
+    }
+
+    *result = readAnalysisResult(query);
+    return true;
+}
+
+AnalysisResult DatabaseManager::readAnalysisResult(const QSqlQuery& query)
+{
+    AnalysisResult result;
+    result.analysisId = query.value("analysis_id").toInt();
+    result.taskId = query.value("task_id").toInt();
+    result.channel = query.value("channel").toInt();
+    result.maxAmplitude = query.value("max_amplitude").toDouble();
+    result.minAmplitude = query.value("min_amplitude").toDouble();
+    result.avgAmplitude = query.value("avg_amplitude").toDouble();
+    result.rmsValue = query.value("rms_value").toDouble();
+    result.frequency = query.value("frequency").toDouble();
+    result.analysisTime = query.value("analysis_time").toString();
+    result.cacheKey = query.value("cache_key").toString();
+    return result;
+}
+
+bool DatabaseManager::beginTransaction()
+{
+    if (!m_database.transaction()) {
+        m_lastError = m_database.lastError().text();
+        qWarning() << "开始事务失败:" << m_lastError;
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::commitTransaction()
+{
+    if (!m_database.commit()) {
+        m_lastError = m_database.lastError().text();
+        qWarning() << "提交事务失败:" << m_lastError;
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::rollbackTransaction()
+{
+    if (!m_database.rollback()) {
+        m_lastError = m_database.lastError().text();
+        qWarning() << "回滚事务失败:" << m_lastError;
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::executeQuery(QSqlQuery& query)
+{
+    if (!query.exec()) {
+        m_lastError = query.lastError().text();
+        qWarning() << "SQL执行失败:" << m_lastError;
+        qWarning() << "SQL语句:" << query.lastQuery();
+        return false;
+    }
+    return true;
+}
+
+// 在原有 databasemanager.cpp 的基础上添加以下方法
+
+// 在文件末尾添加这些新方法：
+
+bool DatabaseManager::saveMultiChannelData(int taskId,
+                                           const QVector<QVector<DataPoint>>& channelData,
+                                           const QVector<int>& channelIndices)
+{
+    if (channelData.size() != channelIndices.size()) {
+        qWarning() << "通道数据和索引数量不匹配";
+        return false;
+    }
+
+    if (!beginTransaction()) {
+        return false;
+    }
+
+    for (int i = 0; i < channelData.size(); ++i) {
+        int channel = channelIndices[i];
+        const QVector<DataPoint>& data = channelData[i];
+
+        if (data.isEmpty()) continue;
+
+        QSqlQuery query(m_database);
+        query.prepare("INSERT INTO raw_data (task_id, channel, time_value, amplitude) "
+                      "VALUES (?, ?, ?, ?)");
+
+        int totalPoints = data.size();
+        int batchSize = 1000;
+
+        for (int j = 0; j < totalPoints; j += batchSize) {
+            int endIndex = qMin(j + batchSize, totalPoints);
+
+            for (int k = j; k < endIndex; ++k) {
+                query.addBindValue(taskId);
+                query.addBindValue(channel);
+                query.addBindValue(data[k].time);
+                query.addBindValue(data[k].amplitude);
+
+                if (!query.exec()) {
+                    m_lastError = query.lastError().text();
+                    rollbackTransaction();
+                    return false;
+                }
+            }
+
+            int percentage = ((i * totalPoints + endIndex) * 100) /
+                             (channelData.size() * totalPoints);
+            emit progressUpdated(percentage,
+                                 QString("保存通道 %1 数据: %2/%3").arg(channel).arg(endIndex).arg(totalPoints));
+        }
+    }
+
+    if (!commitTransaction()) {
+        return false;
+    }
+
+    qDebug() << "多通道数据保存成功";
+    return true;
+}
+
+QVector<QVector<DataPoint>> DatabaseManager::loadMultiChannelData(int taskId,
+                                                                  const QVector<int>& channels)
+{
+    QVector<QVector<DataPoint>> allData;
+    allData.reserve(channels.size());
+
+    for (int channel : channels) {
+        QVector<DataPoint> data = loadRawData(taskId, channel);
+        allData.append(data);
+    }
+
+    return allData;
+}
+
+QVector<AnalysisResult> DatabaseManager::getChannelAnalysisResults(int taskId, int channel)
+{
+    QVector<AnalysisResult> results;
+
+    QSqlQuery query(m_database);
+    query.prepare("SELECT * FROM analysis_results WHERE task_id=? AND channel=? "
+                  "ORDER BY analysis_time DESC");
+    query.addBindValue(taskId);
+    query.addBindValue(channel);
+
+    if (!executeQuery(query)) {
+        return results;
+    }
+
+    while (query.next()) {
+        results.append(readAnalysisResult(query));
+    }
+
+    return results;
+}
+
+bool DatabaseManager::saveCorrelationResults(const QVector<CorrelationResult>& results)
+{
+    if (results.isEmpty()) {
+        return true;
+    }
+
+    if (!beginTransaction()) {
+        return false;
+    }
+
+    QSqlQuery query(m_database);
+    query.prepare("INSERT INTO correlation_results "
+                  "(task_id, channel_a, channel_b, peak_correlation, lag_samples, lag_seconds, "
+                  "mean_coherence, peak_coherence, peak_coherence_frequency) "
+                  "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)");
+
+    for (const CorrelationResult& result : results) {
+        query.addBindValue(result.taskId);
+        query.addBindValue(result.channelA);
+        query.addBindValue(result.channelB);
+        query.addBindValue(result.peakCorrelation);
+        query.addBindValue(result.lagSamples);
+        query.addBindValue(result.lagSeconds);
+        query.addBindValue(result.meanCoherence);
+        query.addBindValue(result.peakCoherence);
+        query.addBindValue(result.peakCoherenceFrequency);
+
+        if (!executeQuery(query)) {
+            rollbackTransaction();
+            return false;
+        }
+    }
+
+    if (!commitTransaction()) {
+        rollbackTransaction();
+        return false;
+    }
+
+    qDebug() << "相关分析结果保存成功 - 任务:" << results.first().taskId
+             << "通道对数:" << results.size();
+    return true;
+}
+
+QVector<CorrelationResult> DatabaseManager::getCorrelationResults(int taskId)
+{
+    QVector<CorrelationResult> results;
+
+    QSqlQuery query(m_database);
+    query.prepare("SELECT * FROM correlation_results WHERE task_id=? "
+                  "ORDER BY analysis_time DESC, channel_a, channel_b");
+    query.addBindValue(taskId);
+
+    if (!executeQuery(query)) {
+        return results;
+    }
+
+    while (query.next()) {
+        CorrelationResult result;
+        result.correlationId = query.value("correlation_id").toInt();
+        result.taskId = query.value("task_id").toInt();
+        result.channelA = query.value("channel_a").toInt();
+        result.channelB = query.value("channel_b").toInt();
+        result.peakCorrelation = query.value("peak_correlation").toDouble();
+        result.lagSamples = query.value("lag_samples").toDouble();
+        result.lagSeconds = query.value("lag_seconds").toDouble();
+        result.meanCoherence = query.value("mean_coherence").toDouble();
+        result.peakCoherence = query.value("peak_coherence").toDouble();
+        result.peakCoherenceFrequency = query.value("peak_coherence_frequency").toDouble();
+        result.analysisTime = query.value("analysis_time").toString();
+        results.append(result);
+    }
+
+    return results;
+}
+
+QVector<DataPoint> DatabaseManager::loadRawDataRange(int taskId, int channel,
+                                                     double startTime, double endTime)
+{
+    QVector<DataPoint> data;
+
+    QSqlQuery query(m_database);
+    query.prepare("SELECT time_value, amplitude FROM raw_data "
+                  "WHERE task_id=? AND channel=? AND time_value BETWEEN ? AND ? "
+                  "ORDER BY time_value ASC");
+    query.addBindValue(taskId);
+    query.addBindValue(channel);
+    query.addBindValue(startTime);
+    query.addBindValue(endTime);
+
+    if (!executeQuery(query)) {
+        return data;
+    }
+
+    while (query.next()) {
+        DataPoint point;
+        point.time = query.value(0).toDouble();
+        point.amplitude = query.value(1).toDouble();
+        data.append(point);
+    }
+
+    return data;
+}
+
+QVector<int> DatabaseManager::getTaskChannels(int taskId)
+{
+    QVector<int> channels;
+
+    QSqlQuery query(m_database);
+    query.prepare("SELECT DISTINCT channel FROM raw_data WHERE task_id=? ORDER BY channel");
+    query.addBindValue(taskId);
+
+    if (!executeQuery(query)) {
+        return channels;
+    }
+
+    while (query.next()) {
+        channels.append(query.value(0).toInt());
+    }
+
+    return channels;
+}
+
+bool DatabaseManager::saveBlockSummaries(const QVector<BlockSummary>& summaries)
+{
+    if (summaries.isEmpty()) {
+        return true;
+    }
+
+    if (!beginTransaction()) {
+        return false;
+    }
+
+    if (!insertBlockSummaries(summaries)) {
+        rollbackTransaction();
+        return false;
+    }
+
+    if (!commitTransaction()) {
+        rollbackTransaction();
+        return false;
+    }
+
+    qDebug() << "分析索引保存成功 - 任务:" << summaries.first().taskId
+             << "通道:" << summaries.first().channel << "块数:" << summaries.size();
+    return true;
+}
+
+bool DatabaseManager::insertBlockSummaries(const QVector<BlockSummary>& summaries)
+{
+    QSqlQuery query(m_database);
+    query.prepare("INSERT INTO analysis_blocks "
+                  "(task_id, channel, block_index, start_time, end_time, sample_count, "
+                  "min_value, max_value, sum_value, sum_squares, mean_value, m2_value, "
+                  "spectrum_segments, frequency_resolution, spectrum) "
+                  "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?) "
+                  "ON DUPLICATE KEY UPDATE start_time=VALUES(start_time), "
+                  "end_time=VALUES(end_time), sample_count=VALUES(sample_count), "
+                  "min_value=VALUES(min_value), max_value=VALUES(max_value), "
+                  "sum_value=VALUES(sum_value), sum_squares=VALUES(sum_squares), "
+                  "mean_value=VALUES(mean_value), m2_value=VALUES(m2_value), "
+                  "spectrum_segments=VALUES(spectrum_segments), "
+                  "frequency_resolution=VALUES(frequency_resolution), "
+                  "spectrum=VALUES(spectrum)");
+
+    for (const BlockSummary& summary : summaries) {
+        // 功率谱按本机字节序的 float 数组保存
+        QByteArray spectrum(reinterpret_cast<const char*>(summary.spectrum.constData()),
+                            summary.spectrum.size() * static_cast<int>(sizeof(float)));
+
+        query.addBindValue(summary.taskId);
+        query.addBindValue(summary.channel);
+        query.addBindValue(summary.blockIndex);
+        query.addBindValue(summary.startTime);
+        query.addBindValue(summary.endTime);
+        query.addBindValue(summary.stats.count);
+        query.addBindValue(summary.stats.min);
+        query.addBindValue(summary.stats.max);
+        query.addBindValue(summary.stats.sum);
+        query.addBindValue(summary.stats.sumSquares);
+        query.addBindValue(summary.stats.mean);
+        query.addBindValue(summary.stats.m2);
+        query.addBindValue(summary.spectrumSegments);
+        query.addBindValue(summary.frequencyResolution);
+        query.addBindValue(spectrum);
+
+        if (!executeQuery(query)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DatabaseManager::hasBlockSummaries(int taskId, int channel)
+{
+    QSqlQuery query(m_database);
+    query.prepare("SELECT 1 FROM analysis_blocks WHERE task_id=? AND channel=? LIMIT 1");
+    query.addBindValue(taskId);
+    query.addBindValue(channel);
+
+    return executeQuery(query) && query.next();
+}
+
+QVector<BlockSummary> DatabaseManager::loadBlockSummaries(int taskId, int channel)
+{
+    QSqlQuery query(m_database);
+    query.prepare("SELECT * FROM analysis_blocks WHERE task_id=? AND channel=? "
+                  "ORDER BY block_index");
+    query.addBindValue(taskId);
+    query.addBindValue(channel);
+
+    return readBlockSummaries(query);
+}
+
+QVector<BlockSummary> DatabaseManager::loadBlockSummaries(int taskId, int channel,
+                                                          double startTime, double endTime)
+{
+    QSqlQuery query(m_database);
+    query.prepare("SELECT * FROM analysis_blocks WHERE task_id=? AND channel=? "
+                  "AND end_time >= ? AND start_time <= ? ORDER BY block_index");
+    query.addBindValue(taskId);
+    query.addBindValue(channel);
+    query.addBindValue(startTime);
+    query.addBindValue(endTime);
+
+    return readBlockSummaries(query);
+}
+
+QVector<BlockSummary> DatabaseManager::readBlockSummaries(QSqlQuery& query)
+{
+    QVector<BlockSummary> summaries;
+
+    if (!executeQuery(query)) {
+        return summaries;
+    }
+
+    while (query.next()) {
+        BlockSummary summary;
+        summary.taskId = query.value("task_id").toInt();
+        summary.channel = query.value("channel").toInt();
+        summary.blockIndex = query.value("block_index").toInt();
+        summary.startTime = query.value("start_time").toDouble();
+        summary.endTime = query.value("end_time").toDouble();
+        summary.stats.count = query.value("sample_count").toLongLong();
+        summary.stats.min = query.value("min_value").toDouble();
+        summary.stats.max = query.value("max_value").toDouble();
+        summary.stats.sum = query.value("sum_value").toDouble();
+        summary.stats.sumSquares = query.value("sum_squares").toDouble();
+        summary.stats.mean = query.value("mean_value").toDouble();
+        summary.stats.m2 = query.value("m2_value").toDouble();
+        summary.spectrumSegments = query.value("spectrum_segments").toInt();
+        summary.frequencyResolution = query.value("frequency_resolution").toDouble();
+
+        QByteArray spectrum = query.value("spectrum").toByteArray();
+        summary.spectrum.resize(spectrum.size() / static_cast<int>(sizeof(float)));
+        if (!summary.spectrum.isEmpty()) {
+            std::memcpy(summary.spectrum.data(), spectrum.constData(),
+                        summary.spectrum.size() * sizeof(float));
+        }
+        summaries.append(summary);
+    }
+
+    return summaries;
+}
+
+SignalStatistics DatabaseManager::getChannelStatistics(int taskId, int channel)
+{
+    return getRangeStatistics(taskId, channel,
+                              std::numeric_limits<double>::lowest(),
+                              std::numeric_limits<double>::max());
+}
+
+SignalStatistics DatabaseManager::getRangeStatistics(int taskId, int channel,
+                                                     double startTime, double endTime)
+{
+    SignalStatistics stats;
+
+    if (!hasBlockSummaries(taskId, channel)) {
+        aggregateRawData(taskId, channel, startTime, endTime, &stats);
+        return stats;
+    }
+
+    // 只读取统计列，不读取功率谱
+    QSqlQuery query(m_database);
+    query.prepare("SELECT start_time, end_time, sample_count, min_value, max_value, "
+                  "sum_value, sum_squares, mean_value, m2_value FROM analysis_blocks "
+                  "WHERE task_id=? AND channel=? AND end_time >= ? AND start_time <= ? "
+                  "ORDER BY block_index");
+    query.addBindValue(taskId);
+    query.addBindValue(channel);
+    query.addBindValue(startTime);
+    query.addBindValue(endTime);
+
+    if (!executeQuery(query)) {
+        return stats;
+    }
+
+    while (query.next()) {
+        double blockStart = query.value(0).toDouble();
+        double blockEnd = query.value(1).toDouble();
+
+        if (blockStart >= startTime && blockEnd <= endTime) {
+            SignalStatistics block;
+            block.count = query.value(2).toLongLong();
+            block.min = query.value(3).toDouble();
+            block.max = query.value(4).toDouble();
+            block.sum = query.value(5).toDouble();
+            block.sumSquares = query.value(6).toDouble();
+            block.mean = query.value(7).toDouble();
+            block.m2 = query.value(8).toDouble();
+            stats.merge(block);
+            continue;
+        }
+
+        // 与区间边界相交的块只聚合区间内的部分
+        SignalStatistics edge;
+        if (!aggregateRawData(taskId, channel, qMax(startTime, blockStart),
+                              qMin(endTime, blockEnd), &edge)) {
+            return SignalStatistics();
+        }
+        stats.merge(edge);
+    }
+
+    return stats;
+}
+
+QMap<int, SignalStatistics> DatabaseManager::getTaskStatistics(int taskId)
+{
+    QMap<int, SignalStatistics> statistics;
+
+    QVector<int> channels = getTaskChannels(taskId);
+    for (int channel : channels) {
+        statistics.insert(channel, getChannelStatistics(taskId, channel));
+    }
+
+    return statistics;
+}
+
+QVector<BucketStatistics> DatabaseManager::getBucketStatistics(int taskId, int channel,
+                                                               double bucketWidth,
+                                                               double startTime, double endTime)
+{
+    QVector<BucketStatistics> buckets;
+
+    if (bucketWidth <= 0) {
+        return buckets;
+    }
+
+    QSqlQuery query(m_database);
+    query.prepare("SELECT FLOOR(time_value / ?) AS bucket, COUNT(*), MIN(amplitude), "
+                  "MAX(amplitude), SUM(amplitude), SUM(amplitude * amplitude), "
+                  "VAR_POP(amplitude) FROM raw_data "
+                  "WHERE task_id=? AND channel=? AND time_value BETWEEN ? AND ? "
+                  "GROUP BY bucket ORDER BY bucket");
+    query.addBindValue(bucketWidth);
+    query.addBindValue(taskId);
+    query.addBindValue(channel);
+    query.addBindValue(startTime);
+    query.addBindValue(endTime);
+
+    if (!executeQuery(query)) {
+        return buckets;
+    }
+
+    while (query.next()) {
+        BucketStatistics bucket;
+        bucket.bucketStart = query.value(0).toDouble() * bucketWidth;
+        bucket.bucketEnd = bucket.bucketStart + bucketWidth;
+        bucket.stats = readAggregate(query, 1);
+        buckets.append(bucket);
+    }
+
+    return buckets;
+}
+
+bool DatabaseManager::aggregateRawData(int taskId, int channel,
+                                       double startTime, double endTime,
+                                       SignalStatistics* stats)
+{
+    QSqlQuery query(m_database);
+    query.prepare("SELECT COUNT(*), MIN(amplitude), MAX(amplitude), SUM(amplitude), "
+                  "SUM(amplitude * amplitude), VAR_POP(amplitude) FROM raw_data "
+                  "WHERE task_id=? AND channel=? AND time_value BETWEEN ? AND ?");
+    query.addBindValue(taskId);
+    query.addBindValue(channel);
+    query.addBindValue(startTime);
+    query.addBindValue(endTime);
+
+    if (!executeQuery(query) || !query.next()) {
+        return false;
+    }
+
+    *stats = readAggregate(query, 0);
+    return true;
+}
+
+SignalStatistics DatabaseManager::readAggregate(const QSqlQuery& query, int firstColumn)
+{
+    // 列顺序: COUNT, MIN, MAX, SUM, SUM(x*x), VAR_POP
+    SignalStatistics stats;
+    stats.count = query.value(firstColumn).toLongLong();
+    if (stats.count == 0) {
+        return stats;
+    }
+
+    stats.min = query.value(firstColumn + 1).toDouble();
+    stats.max = query.value(firstColumn + 2).toDouble();
+    stats.sum = query.value(firstColumn + 3).toDouble();
+    stats.sumSquares = query.value(firstColumn + 4).toDouble();
+    stats.mean = stats.sum / stats.count;
+    // 服务器的总体方差比 sumSquares - sum²/n 数值上稳定，乘以点数即得 m2
+    stats.m2 = query.value(firstColumn + 5).toDouble() * stats.count;
+    return stats;
+}
+
+bool DatabaseManager::loadRawDataPage(int taskId, int channel, qint64* lastId, int pageSize,
+                                      QVector<DataPoint>* data)
+{
+    data->clear();
+
+    // (task_id, channel) 索引的叶子节点按主键排序，WHERE data_id > ? 直接定位到上一页末尾
+    QSqlQuery query(m_database);
+    query.setForwardOnly(true);
+    query.prepare("SELECT data_id, time_value, amplitude FROM raw_data "
+                  "WHERE task_id=? AND channel=? AND data_id > ? "
+                  "ORDER BY data_id LIMIT ?");
+    query.addBindValue(taskId);
+    query.addBindValue(channel);
+    query.addBindValue(*lastId);
+    query.addBindValue(pageSize);
+
+    if (!executeQuery(query)) {
+        return false;
+    }
+
+    data->reserve(pageSize);
+    while (query.next()) {
+        *lastId = query.value(0).toLongLong();
+        DataPoint point;
+        point.time = query.value(1).toDouble();
+        point.amplitude = query.value(2).toDouble();
+        data->append(point);
+    }
+
+    return true;
+}
+
+bool DatabaseManager::saveAnalysisResults(const QVector<AnalysisResult>& results)
+{
+    if (results.isEmpty()) {
+        return true;
+    }
+
+    if (!beginTransaction()) {
+        return false;
+    }
+
+    if (!insertAnalysisResults(results)) {
+        rollbackTransaction();
+        return false;
+    }
+
+    if (!commitTransaction()) {
+        rollbackTransaction();
+        return false;
+    }
+
+    qDebug() << "分析结果批量保存成功 - 条数:" << results.size();
+    return true;
+}
+
+bool DatabaseManager::insertAnalysisResults(const QVector<AnalysisResult>& results)
+{
+    // 每条语句最多插入的行数（8个参数/行，远低于预处理语句的参数上限）
+    const int rowsPerStatement = 500;
+
+    for (int start = 0; start < results.size(); start += rowsPerStatement) {
+        int end = qMin(start + rowsPerStatement, results.size());
+
+        QString sql = "INSERT INTO analysis_results "
+                      "(task_id, channel, max_amplitude, min_amplitude, avg_amplitude, "
+                      "rms_value, frequency, cache_key) VALUES ";
+        for (int i = start; i < end; ++i) {
+            sql += (i == start) ? "(?, ?, ?, ?, ?, ?, ?, ?)" : ", (?, ?, ?, ?, ?, ?, ?, ?)";
+        }
+        sql += " ON DUPLICATE KEY UPDATE "
+               "max_amplitude=VALUES(max_amplitude), min_amplitude=VALUES(min_amplitude), "
+               "avg_amplitude=VALUES(avg_amplitude), rms_value=VALUES(rms_value), "
+               "frequency=VALUES(frequency), analysis_time=CURRENT_TIMESTAMP";
+
+        QSqlQuery query(m_database);
+        query.prepare(sql);
+        for (int i = start; i < end; ++i) {
+            const AnalysisResult& result = results[i];
+            query.addBindValue(result.taskId);
+            query.addBindValue(result.channel);
+            query.addBindValue(result.maxAmplitude);
+            query.addBindValue(result.minAmplitude);
+            query.addBindValue(result.avgAmplitude);
+            query.addBindValue(result.rmsValue);
+            query.addBindValue(result.frequency);
+            query.addBindValue(result.cacheKey.isEmpty() ? QVariant(QMetaType::fromType<QString>())
+                                                         : QVariant(result.cacheKey));
+        }
+
+        if (!executeQuery(query)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int DatabaseManager::createBatchJob(const QString& jobName, const QVector<int>& taskIds)
+{
+    if (taskIds.isEmpty() || !beginTransaction()) {
+        return -1;
+    }
+
+    QSqlQuery query(m_database);
+    query.prepare("INSERT INTO batch_jobs (job_name, total_tasks) VALUES (?, ?)");
+    query.addBindValue(jobName);
+    query.addBindValue(taskIds.size());
+
+    if (!executeQuery(query)) {
+        rollbackTransaction();
+        return -1;
+    }
+
+    int jobId = query.lastInsertId().toInt();
+
+    QSqlQuery taskQuery(m_database);
+    taskQuery.prepare("INSERT INTO batch_job_tasks (job_id, task_id) VALUES (?, ?)");
+    for (int taskId : taskIds) {
+        taskQuery.addBindValue(jobId);
+        taskQuery.addBindValue(taskId);
+
+        if (!executeQuery(taskQuery)) {
+            rollbackTransaction();
+            return -1;
+        }
+    }
+
+    if (!commitTransaction()) {
+        rollbackTransaction();
+        return -1;
+    }
+
+    qDebug() << "批量分析作业创建成功，ID:" << jobId << "任务数:" << taskIds.size();
+    return jobId;
+}
+
+BatchJobInfo DatabaseManager::getBatchJob(int jobId)
+{
+    QSqlQuery query(m_database);
+    query.prepare("SELECT j.*, (SELECT COUNT(*) FROM batch_job_tasks t "
+                  "WHERE t.job_id = j.job_id AND t.done = 1) AS completed_tasks "
+                  "FROM batch_jobs j WHERE j.job_id=?");
+    query.addBindValue(jobId);
+
+    if (!executeQuery(query) || !query.next()) {
+        return BatchJobInfo();
+    }
+
+    return readBatchJob(query);
+}
+
+QVector<BatchJobInfo> DatabaseManager::getUnfinishedBatchJobs()
+{
+    QVector<BatchJobInfo> jobs;
+
+    QSqlQuery query(m_database);
+    query.prepare("SELECT j.*, (SELECT COUNT(*) FROM batch_job_tasks t "
+                  "WHERE t.job_id = j.job_id AND t.done = 1) AS completed_tasks "
+                  "FROM batch_jobs j WHERE j.finished = 0 ORDER BY j.create_time DESC");
+
+    if (!executeQuery(query)) {
+        return jobs;
+    }
+
+    while (query.next()) {
+        jobs.append(readBatchJob(query));
+    }
+
+    return jobs;
+}
+
+BatchJobInfo DatabaseManager::readBatchJob(const QSqlQuery& query)
+{
+    BatchJobInfo job;
+    job.jobId = query.value("job_id").toInt();
+    job.jobName = query.value("job_name").toString();
+    job.totalTasks = query.value("total_tasks").toInt();
+    job.completedTasks = query.value("completed_tasks").toInt();
+    job.finished = query.value("finished").toInt() != 0;
+    job.createTime = query.value("create_time").toString();
+    return job;
+}
+
+QVector<int> DatabaseManager::getPendingBatchTasks(int jobId)
+{
+    QVector<int> taskIds;
+
+    QSqlQuery query(m_database);
+    query.prepare("SELECT task_id FROM batch_job_tasks WHERE job_id=? AND done=0 "
+                  "ORDER BY task_id");
+    query.addBindValue(jobId);
+
+    if (!executeQuery(query)) {
+        return taskIds;
+    }
+
+    while (query.next()) {
+        taskIds.append(query.value(0).toInt());
+    }
+
+    return taskIds;
+}
+
+bool DatabaseManager::completeBatchTask(int jobId, int taskId,
+                                        const QVector<AnalysisResult>& results,
+                                        qint64 sampleCount)
+{
+    if (!beginTransaction()) {
+        return false;
+    }
+
+    if (!insertAnalysisResults(results)) {
+        rollbackTransaction();
+        return false;
+    }
+
+    QSqlQuery query(m_database);
+    query.prepare("UPDATE batch_job_tasks SET done=1, sample_count=?, finish_time=NOW() "
+                  "WHERE job_id=? AND task_id=?");
+    query.addBindValue(sampleCount);
+    query.addBindValue(jobId);
+    query.addBindValue(taskId);
+
+    if (!executeQuery(query)) {
+        rollbackTransaction();
+        return false;
+    }
+
+    if (!commitTransaction()) {
+        rollbackTransaction();
+        return false;
+    }
+
+    return true;
+}
+
+bool DatabaseManager::finishBatchJob(int jobId)
+{
+    QSqlQuery query(m_database);
+    query.prepare("UPDATE batch_jobs SET finished=1, finish_time=NOW() WHERE job_id=?");
+    query.addBindValue(jobId);
+
+    return executeQuery(query);
+}
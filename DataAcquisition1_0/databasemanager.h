@@ -1,109 +1,249 @@
-#ifndef DATABASEMANAGER_H
-#define DATABASEMANAGER_H
-
-#include <QObject>
-#include <QSqlDatabase>
-#include <QSqlQuery>
-#include <QSqlError>
-#include <QString>
-#include <QVector>
-#include "databuffer.h"
-
-// 任务信息结构
-struct TaskInfo {
-    int taskId;
-    QString taskName;
-    double sampleRate;
-    double duration;
-    int channelCount;      // 支持最多13个通道
-    QString createTime;
-    QString description;
-    QVector<int> enabledChannels;  // 启用的通道列表
-
-    TaskInfo() : taskId(-1), sampleRate(0), duration(0), channelCount(13) {}
-};
-
-// 分析结果结构
-struct AnalysisResult {
-    int analysisId;
-    int taskId;
-    int channel;
-    double maxAmplitude;
-    double minAmplitude;
-    double avgAmplitude;
-    double rmsValue;
-    double frequency;
-    QString analysisTime;
-
-    AnalysisResult() : analysisId(-1), taskId(-1), channel(0),
-        maxAmplitude(0), minAmplitude(0), avgAmplitude(0),
-        rmsValue(0), frequency(0) {}
-};
-
-class DatabaseManager : public QObject
-{
-    Q_OBJECT
-
-public:
-    explicit DatabaseManager(QObject *parent = nullptr);
-    ~DatabaseManager();
-
-    // 连接数据库
-    bool connectToDatabase(const QString& host, int port,
-                           const QString& dbName,
-                           const QString& user,
-                           const QString& password);
-    void disconnectFromDatabase();
-    bool isConnected() const;
-
-    // 任务操作
-    int createTask(const TaskInfo& info);
-    bool updateTask(const TaskInfo& info);
-    bool deleteTask(int taskId);
-    TaskInfo getTask(int taskId);
-    QVector<TaskInfo> getAllTasks();
-    QVector<TaskInfo> searchTasks(const QString& keyword);
-
-    // 数据保存 - 支持多通道
-    bool saveRawData(int taskId, int channel, const QVector<DataPoint>& data);
-    bool saveProcessedCoordinates(int taskId, int channel,
-                                  const QVector<DataPoint>& data);
-
-    // 批量保存多通道数据
-    bool saveMultiChannelData(int taskId, const QVector<QVector<DataPoint>>& channelData,
-                              const QVector<int>& channelIndices);
-
-    // 数据读取
-    QVector<DataPoint> loadRawData(int taskId, int channel);
-    QVector<DataPoint> loadProcessedData(int taskId, int channel);
-
-    // 加载多通道数据
-    QVector<QVector<DataPoint>> loadMultiChannelData(int taskId,
-                                                     const QVector<int>& channels);
-
-    // 分析结果
-    bool saveAnalysisResult(const AnalysisResult& result);
-    QVector<AnalysisResult> getAnalysisResults(int taskId);
-    QVector<AnalysisResult> getChannelAnalysisResults(int taskId, int channel);
-
-    // 批量操作
-    bool beginTransaction();
-    bool commitTransaction();
-    bool rollbackTransaction();
-
-    QString getLastError() const { return m_lastError; }
-
-signals:
-    void progressUpdated(int percentage, const QString& message);
-    void operationCompleted(bool success, const QString& message);
-
-private:
-    bool executeQuery(QSqlQuery& query);
-    bool createTables();
-
-    QSqlDatabase m_database;
-    QString m_lastError;
-    bool m_isConnected;
-};
-
-#endif // DATABASEMANAGER_H
+#ifndef DATABASEMANAGER_H
+#define DATABASEMANAGER_H
+
+#include <QObject>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QString>
+#include <QVector>
+#include <QMap>
+#include <QDateTime>
+#include "databuffer.h"
+#include "signalstatistics.h"
+
+// 任务信息结构
+struct TaskInfo {
+    int taskId;
+    QString taskName;
+    double sampleRate;
+    double duration;
+    int channelCount;      // 支持最多13个通道
+    QString createTime;
+    QString description;
+    QVector<int> enabledChannels;  // 启用的通道列表
+
+    TaskInfo() : taskId(-1), sampleRate(0), duration(0), channelCount(13) {}
+};
+
+// 分析结果结构
+struct AnalysisResult {
+    int analysisId;
+    int taskId;
+    int channel;
+    double maxAmplitude;
+    double minAmplitude;
+    double avgAmplitude;
+    double rmsValue;
+    double frequency;
+    QString analysisTime;
+    QString cacheKey;       // 结果缓存键（SHA-256十六进制），为空时不参与缓存，每次保存新增一行
+
+    AnalysisResult() : analysisId(-1), taskId(-1), channel(0),
+        maxAmplitude(0), minAmplitude(0), avgAmplitude(0),
+        rmsValue(0), frequency(0) {}
+};
+
+// 通道间相关/相干分析结果（每个通道对一条）
+struct CorrelationResult {
+    int correlationId;
+    int taskId;
+    int channelA;
+    int channelB;
+    double peakCorrelation;         // 归一化互相关峰值 [-1, 1]
+    double lagSamples;              // 峰值对应的延迟（样本，抛物线插值），正值表示A滞后于B
+    double lagSeconds;
+    double meanCoherence;           // 平均相干系数（不含直流）
+    double peakCoherence;
+    double peakCoherenceFrequency;  // 相干系数最大的频率（Hz）
+    QString analysisTime;
+
+    CorrelationResult() : correlationId(-1), taskId(-1), channelA(0), channelB(0),
+        peakCorrelation(0), lagSamples(0), lagSeconds(0), meanCoherence(0),
+        peakCoherence(0), peakCoherenceFrequency(0) {}
+};
+
+// 块级分析摘要：保存时按固定块长计算一次，之后整段或任意区间的分析只需合并摘要
+struct BlockSummary {
+    int taskId;
+    int channel;
+    int blockIndex;
+    double startTime;               // 块内第一个样本的时间
+    double endTime;                 // 块内最后一个样本的时间
+    SignalStatistics stats;         // 可合并的统计量
+    QVector<float> spectrum;        // 粗粒度Welch功率谱密度（V²/Hz），块太短时为空
+    int spectrumSegments;           // 参与平均的段数（合并时的权重）
+    double frequencyResolution;
+
+    BlockSummary() : taskId(-1), channel(0), blockIndex(0), startTime(0), endTime(0),
+        spectrumSegments(0), frequencyResolution(0) {}
+};
+
+// 按时间桶聚合的统计量（由数据库服务器计算）
+struct BucketStatistics {
+    double bucketStart;             // 桶起点时间（桶宽的整数倍）
+    double bucketEnd;
+    SignalStatistics stats;
+
+    BucketStatistics() : bucketStart(0), bucketEnd(0) {}
+};
+
+// 批量分析作业（可中断，未完成的任务在数据库中记录，下次继续）
+struct BatchJobInfo {
+    int jobId;
+    QString jobName;
+    int totalTasks;
+    int completedTasks;
+    bool finished;
+    QString createTime;
+
+    BatchJobInfo() : jobId(-1), totalTasks(0), completedTasks(0), finished(false) {}
+};
+
+class DatabaseManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DatabaseManager(QObject *parent = nullptr);
+    ~DatabaseManager();
+
+    // 连接数据库
+    bool connectToDatabase(const QString& host, int port,
+                           const QString& dbName,
+                           const QString& user,
+                           const QString& password,
+                           const QString& connectionName = QString());
+    // 以与 source 相同的参数建立独立的命名连接（QSqlDatabase 连接不能跨线程使用）
+    bool connectLike(const DatabaseManager* source, const QString& connectionName);
+    void disconnectFromDatabase();
+    bool isConnected() const;
+
+    // 任务操作
+    int createTask(const TaskInfo& info);
+    bool updateTask(const TaskInfo& info);
+    bool deleteTask(int taskId);
+    TaskInfo getTask(int taskId);
+    QVector<TaskInfo> getAllTasks();
+    QVector<TaskInfo> searchTasks(const QString& keyword);
+    // 关键字为空时只按创建时间 [from, to) 筛选
+    QVector<TaskInfo> searchTasks(const QString& keyword,
+                                  const QDateTime& from, const QDateTime& to);
+
+    // 在一个事务中创建任务并写入各通道的原始数据和块级分析索引，任一步失败整体回滚，
+    // 不会留下任务记录或部分数据；summaries 与 channelData 一一对应，其中的任务号在写入时
+    // 替换为新建的任务号。成功返回任务号，失败返回-1
+    int saveTask(const TaskInfo& info, const QVector<int>& channels,
+                 const QVector<QVector<DataPoint>>& channelData,
+                 const QVector<QVector<BlockSummary>>& summaries);
+
+    // 数据保存 - 支持多通道
+    bool saveRawData(int taskId, int channel, const QVector<DataPoint>& data);
+    bool saveProcessedCoordinates(int taskId, int channel,
+                                  const QVector<DataPoint>& data);
+
+    // 批量保存多通道数据
+    bool saveMultiChannelData(int taskId, const QVector<QVector<DataPoint>>& channelData,
+                              const QVector<int>& channelIndices);
+
+    // 数据读取
+    QVector<DataPoint> loadRawData(int taskId, int channel);
+    QVector<DataPoint> loadProcessedData(int taskId, int channel);
+    // 读取时间区间 [startTime, endTime] 内的原始数据
+    QVector<DataPoint> loadRawDataRange(int taskId, int channel,
+                                        double startTime, double endTime);
+    // 任务中有数据的通道
+    QVector<int> getTaskChannels(int taskId);
+
+    // 按主键分页读取（keyset分页，不使用OFFSET），lastId 输入上一页最后一行的ID，输出本页最后一行的ID
+    bool loadRawDataPage(int taskId, int channel, qint64* lastId, int pageSize,
+                         QVector<DataPoint>* data);
+
+    // 加载多通道数据
+    QVector<QVector<DataPoint>> loadMultiChannelData(int taskId,
+                                                     const QVector<int>& channels);
+
+    // 分析结果
+    // 带缓存键的结果按键覆盖（INSERT ... ON DUPLICATE KEY UPDATE），不会产生重复行
+    bool saveAnalysisResult(const AnalysisResult& result);
+    bool findAnalysisResult(const QString& cacheKey, AnalysisResult* result);
+    QVector<AnalysisResult> getAnalysisResults(int taskId);
+    QVector<AnalysisResult> getChannelAnalysisResults(int taskId, int channel);
+    // 多行插入，一条语句写入全部结果
+    bool saveAnalysisResults(const QVector<AnalysisResult>& results);
+
+    // 通道间相关分析结果
+    bool saveCorrelationResults(const QVector<CorrelationResult>& results);
+    QVector<CorrelationResult> getCorrelationResults(int taskId);
+
+    // 服务器端统计：聚合在数据库中完成，只返回结果而不传输原始数据
+    // 有块级分析索引时整块直接取索引中的统计量，只对区间两端的不完整块做聚合查询
+    SignalStatistics getChannelStatistics(int taskId, int channel);
+    SignalStatistics getRangeStatistics(int taskId, int channel,
+                                        double startTime, double endTime);
+    QMap<int, SignalStatistics> getTaskStatistics(int taskId);
+    // 按 FLOOR(time / bucketWidth) 分组的统计量，用于概览长时间录制
+    QVector<BucketStatistics> getBucketStatistics(int taskId, int channel, double bucketWidth,
+                                                  double startTime, double endTime);
+
+    // 块级分析索引
+    bool saveBlockSummaries(const QVector<BlockSummary>& summaries);
+    bool hasBlockSummaries(int taskId, int channel);
+    QVector<BlockSummary> loadBlockSummaries(int taskId, int channel);
+    // 与时间区间 [startTime, endTime] 有重叠的块
+    QVector<BlockSummary> loadBlockSummaries(int taskId, int channel,
+                                             double startTime, double endTime);
+
+    // 批量分析作业
+    int createBatchJob(const QString& jobName, const QVector<int>& taskIds);
+    BatchJobInfo getBatchJob(int jobId);
+    QVector<BatchJobInfo> getUnfinishedBatchJobs();
+    QVector<int> getPendingBatchTasks(int jobId);
+    // 在同一事务中写入任务的分析结果并标记完成，中断后不会重复或遗漏
+    bool completeBatchTask(int jobId, int taskId, const QVector<AnalysisResult>& results,
+                           qint64 sampleCount);
+    bool finishBatchJob(int jobId);
+
+    // 旧版本数据库的一次性迁移：补建原始数据表的覆盖索引（大表上耗时较长，应在工作线程中调用）
+    bool hasRawDataTimeIndex();
+    bool migrateRawDataTimeIndex();
+
+    // 批量操作
+    bool beginTransaction();
+    bool commitTransaction();
+    bool rollbackTransaction();
+
+    QString getLastError() const { return m_lastError; }
+
+signals:
+    void progressUpdated(int percentage, const QString& message);
+    void operationCompleted(bool success, const QString& message);
+
+private:
+    bool executeQuery(QSqlQuery& query);
+    bool createTables();
+    QVector<BlockSummary> readBlockSummaries(QSqlQuery& query);
+    bool insertAnalysisResults(const QVector<AnalysisResult>& results);
+    // 以下插入函数不开启事务，由调用者负责提交或回滚
+    bool insertRawData(int taskId, int channel, const QVector<DataPoint>& data);
+    bool insertBlockSummaries(const QVector<BlockSummary>& summaries);
+    BatchJobInfo readBatchJob(const QSqlQuery& query);
+    static AnalysisResult readAnalysisResult(const QSqlQuery& query);
+    bool aggregateRawData(int taskId, int channel, double startTime, double endTime,
+                          SignalStatistics* stats);
+    static SignalStatistics readAggregate(const QSqlQuery& query, int firstColumn);
+
+    QSqlDatabase m_database;
+    QString m_lastError;
+    bool m_isConnected;
+
+    // 连接参数（用于 connectLike）
+    QString m_host;
+    int m_port;
+    QString m_dbName;
+    QString m_user;
+    QString m_password;
+    QString m_connectionName;
+};
+
+#endif // DATABASEMANAGER_H
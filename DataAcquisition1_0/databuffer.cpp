@@ -1,157 +1,335 @@
-#include "databuffer.h"
-#include <QDebug>
-
-DataBuffer::DataBuffer(QObject *parent)
-    : QObject(parent)
-    , m_maxCapacity(100000)  // 默认最大容量10万个数据点
-{
-}
-
-DataBuffer::~DataBuffer()
-{
-}
-
-void DataBuffer::addDataPoint(int channel, const DataPoint& point)
-{
-    if (channel < 0 || channel >= MAX_CHANNELS) {
-        qWarning() << "无效的通道号:" << channel;
-        return;
-    }
-
-    QMutexLocker locker(&m_mutex);
-
-    m_channelData[channel].append(point);
-
-    // 检查是否超过最大容量
-    if (m_channelData[channel].size() > m_maxCapacity) {
-        // 移除最旧的数据点
-        m_channelData[channel].remove(0, m_channelData[channel].size() - m_maxCapacity);
-        emit bufferFull(channel);
-    }
-
-    emit dataAdded(channel);
-}
-
-void DataBuffer::addDataPoints(int channel, const QVector<DataPoint>& points)
-{
-    if (points.isEmpty()) {
-        return;
-    }
-
-    if (channel < 0 || channel >= MAX_CHANNELS) {
-        qWarning() << "无效的通道号:" << channel;
-        return;
-    }
-
-    QMutexLocker locker(&m_mutex);
-
-    m_channelData[channel].append(points);
-
-    // 检查是否超过最大容量
-    if (m_channelData[channel].size() > m_maxCapacity) {
-        // 移除最旧的数据点
-        int removeCount = m_channelData[channel].size() - m_maxCapacity;
-        m_channelData[channel].remove(0, removeCount);
-        emit bufferFull(channel);
-    }
-
-    emit dataAdded(channel);
-}
-
-QVector<DataPoint> DataBuffer::getChannelData(int channel, int maxPoints)
-{
-    if (channel < 0 || channel >= MAX_CHANNELS) {
-        qWarning() << "无效的通道号:" << channel;
-        return QVector<DataPoint>();
-    }
-
-    QMutexLocker locker(&m_mutex);
-
-    QVector<DataPoint> data;
-
-    if (maxPoints < 0 || maxPoints >= m_channelData[channel].size()) {
-        data = m_channelData[channel];
-    } else {
-        // 返回最新的maxPoints个数据点
-        int startIndex = m_channelData[channel].size() - maxPoints;
-        data = m_channelData[channel].mid(startIndex, maxPoints);
-    }
-
-    return data;
-}
-
-QVector<DataPoint> DataBuffer::getAllChannelData(int channel)
-{
-    return getChannelData(channel, -1);
-}
-
-void DataBuffer::clear()
-{
-    QMutexLocker locker(&m_mutex);
-
-    for (int i = 0; i < MAX_CHANNELS; ++i) {
-        m_channelData[i].clear();
-    }
-
-    qDebug() << "数据缓冲区已清空";
-}
-
-void DataBuffer::clearChannel(int channel)
-{
-    if (channel < 0 || channel >= MAX_CHANNELS) {
-        qWarning() << "无效的通道号:" << channel;
-        return;
-    }
-
-    QMutexLocker locker(&m_mutex);
-
-    m_channelData[channel].clear();
-    qDebug() << "通道" << channel << "数据已清空";
-}
-
-int DataBuffer::getDataCount(int channel) const
-{
-    if (channel < 0 || channel >= MAX_CHANNELS) {
-        qWarning() << "无效的通道号:" << channel;
-        return 0;
-    }
-
-    QMutexLocker locker(&m_mutex);
-    return m_channelData[channel].size();
-}
-
-void DataBuffer::setMaxCapacity(int capacity)
-{
-    QMutexLocker locker(&m_mutex);
-
-    if (capacity <= 0) {
-        qWarning() << "无效的缓冲区容量:" << capacity;
-        return;
-    }
-
-    m_maxCapacity = capacity;
-
-    // 如果当前数据量超过新容量，进行裁剪
-    for (int i = 0; i < MAX_CHANNELS; ++i) {
-        if (m_channelData[i].size() > m_maxCapacity) {
-            int removeCount = m_channelData[i].size() - m_maxCapacity;
-            m_channelData[i].remove(0, removeCount);
-        }
-    }
-
-    qDebug() << "缓冲区最大容量设置为:" << m_maxCapacity;
-}
-
-QVector<QVector<DataPoint>> DataBuffer::getAllChannelsData()
-{
-    QMutexLocker locker(&m_mutex);
-
-    QVector<QVector<DataPoint>> allData;
-    allData.reserve(MAX_CHANNELS);
-
-    for (int i = 0; i < MAX_CHANNELS; ++i) {
-        allData.append(m_channelData[i]);
-    }
-
-    return allData;
-}
+#include "databuffer.h"
+#include "sharedstreampublisher.h"
+#include <QDebug>
+
+DataBuffer::DataBuffer(QObject *parent)
+    : QObject(parent)
+    , m_maxCapacity(100000)  // 默认最大容量10万个数据点
+    , m_sharedStream(nullptr)
+{
+    for (int i = 0; i < MAX_CHANNELS; ++i) {
+        m_firstIndex[i] = 0;
+        m_totalDirty[i] = false;
+    }
+}
+
+DataBuffer::~DataBuffer()
+{
+    delete m_sharedStream;
+}
+
+void DataBuffer::addDataPoint(int channel, const DataPoint& point)
+{
+    if (channel < 0 || channel >= MAX_CHANNELS) {
+        qWarning() << "无效的通道号:" << channel;
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    m_channelData[channel].append(point);
+    appendStatistics(channel, &point, 1, m_channelData[channel].size() - 1);
+    if (m_sharedStream) {
+        m_sharedStream->publish(channel, &point, 1);
+    }
+
+    // 检查是否超过最大容量
+    if (m_channelData[channel].size() > m_maxCapacity) {
+        // 移除最旧的数据点
+        removeOldest(channel, m_channelData[channel].size() - m_maxCapacity);
+        emit bufferFull(channel);
+    }
+
+    emit dataAdded(channel);
+}
+
+void DataBuffer::addDataPoints(int channel, const QVector<DataPoint>& points)
+{
+    if (points.isEmpty()) {
+        return;
+    }
+
+    if (channel < 0 || channel >= MAX_CHANNELS) {
+        qWarning() << "无效的通道号:" << channel;
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    int oldSize = m_channelData[channel].size();
+    m_channelData[channel].append(points);
+    appendStatistics(channel, points.constData(), points.size(), oldSize);
+    if (m_sharedStream) {
+        m_sharedStream->publish(channel, points.constData(), points.size());
+    }
+
+    // 检查是否超过最大容量
+    if (m_channelData[channel].size() > m_maxCapacity) {
+        // 移除最旧的数据点
+        int removeCount = m_channelData[channel].size() - m_maxCapacity;
+        removeOldest(channel, removeCount);
+        emit bufferFull(channel);
+    }
+
+    emit dataAdded(channel);
+}
+
+QVector<DataPoint> DataBuffer::getChannelData(int channel, int maxPoints)
+{
+    if (channel < 0 || channel >= MAX_CHANNELS) {
+        qWarning() << "无效的通道号:" << channel;
+        return QVector<DataPoint>();
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    QVector<DataPoint> data;
+
+    if (maxPoints < 0 || maxPoints >= m_channelData[channel].size()) {
+        data = m_channelData[channel];
+    } else {
+        // 返回最新的maxPoints个数据点
+        int startIndex = m_channelData[channel].size() - maxPoints;
+        data = m_channelData[channel].mid(startIndex, maxPoints);
+    }
+
+    return data;
+}
+
+QVector<DataPoint> DataBuffer::getAllChannelData(int channel)
+{
+    return getChannelData(channel, -1);
+}
+
+void DataBuffer::clear()
+{
+    QMutexLocker locker(&m_mutex);
+
+    for (int i = 0; i < MAX_CHANNELS; ++i) {
+        m_channelData[i].clear();
+        resetStatistics(i);
+    }
+    if (m_sharedStream) {
+        m_sharedStream->reset();
+    }
+
+    qDebug() << "数据缓冲区已清空";
+}
+
+void DataBuffer::clearChannel(int channel)
+{
+    if (channel < 0 || channel >= MAX_CHANNELS) {
+        qWarning() << "无效的通道号:" << channel;
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    m_channelData[channel].clear();
+    resetStatistics(channel);
+    qDebug() << "通道" << channel << "数据已清空";
+}
+
+int DataBuffer::getDataCount(int channel) const
+{
+    if (channel < 0 || channel >= MAX_CHANNELS) {
+        qWarning() << "无效的通道号:" << channel;
+        return 0;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    return m_channelData[channel].size();
+}
+
+SignalStatistics DataBuffer::getChannelStatistics(int channel) const
+{
+    if (channel < 0 || channel >= MAX_CHANNELS) {
+        qWarning() << "无效的通道号:" << channel;
+        return SignalStatistics();
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    if (m_totalDirty[channel]) {
+        SignalStatistics total;
+        for (const SignalStatistics& block : m_blockStats[channel]) {
+            total.merge(block);
+        }
+        m_totalStats[channel] = total;
+        m_totalDirty[channel] = false;
+    }
+
+    return m_totalStats[channel];
+}
+
+SignalStatistics DataBuffer::getRecentStatistics(int channel, int maxPoints) const
+{
+    if (channel < 0 || channel >= MAX_CHANNELS) {
+        qWarning() << "无效的通道号:" << channel;
+        return SignalStatistics();
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        const QVector<DataPoint>& data = m_channelData[channel];
+
+        if (maxPoints >= 0 && maxPoints < data.size()) {
+            if (maxPoints == 0) {
+                return SignalStatistics();
+            }
+
+            // 起点所在的块只统计其中属于最近数据的部分，其后的完整块直接合并
+            int start = data.size() - maxPoints;
+            int offset = headOffset(channel);
+            int block = (start + offset) / STATS_BLOCK_SIZE;
+            int blockEnd = qMin((block + 1) * STATS_BLOCK_SIZE - offset, data.size());
+
+            SignalStatistics stats = SignalStatistics::compute(data.constData() + start, blockEnd - start);
+            for (int i = block + 1; i < m_blockStats[channel].size(); ++i) {
+                stats.merge(m_blockStats[channel][i]);
+            }
+            return stats;
+        }
+    }
+
+    return getChannelStatistics(channel);
+}
+
+void DataBuffer::appendStatistics(int channel, const DataPoint* points, int count, int oldSize)
+{
+    QVector<SignalStatistics>& blocks = m_blockStats[channel];
+    int offset = headOffset(channel);
+    int pos = oldSize;
+    int done = 0;
+
+    // 新数据可能跨越多个块，按块边界切分后分别累加
+    while (done < count) {
+        int block = (pos + offset) / STATS_BLOCK_SIZE;
+        int blockEnd = (block + 1) * STATS_BLOCK_SIZE - offset;
+        int length = qMin(count - done, blockEnd - pos);
+
+        if (block >= blocks.size()) {
+            blocks.append(SignalStatistics());
+        }
+
+        SignalStatistics stats = SignalStatistics::compute(points + done, length);
+        blocks[block].merge(stats);
+        if (!m_totalDirty[channel]) {
+            m_totalStats[channel].merge(stats);
+        }
+
+        done += length;
+        pos += length;
+    }
+}
+
+void DataBuffer::removeOldest(int channel, int removeCount)
+{
+    QVector<DataPoint>& data = m_channelData[channel];
+    QVector<SignalStatistics>& blocks = m_blockStats[channel];
+
+    data.remove(0, removeCount);
+
+    // 最小/最大值无法从统计量中扣除：完全移出的块直接丢弃，被截断的首块从剩余样本重算
+    qint64 newFirst = m_firstIndex[channel] + removeCount;
+    int dropBlocks = static_cast<int>(newFirst / STATS_BLOCK_SIZE - m_firstIndex[channel] / STATS_BLOCK_SIZE);
+    blocks.remove(0, qMin(dropBlocks, blocks.size()));
+    m_firstIndex[channel] = newFirst;
+
+    int offset = headOffset(channel);
+    if (offset != 0 && !data.isEmpty() && !blocks.isEmpty()) {
+        int headLength = qMin(STATS_BLOCK_SIZE - offset, data.size());
+        blocks[0] = SignalStatistics::compute(data.constData(), headLength);
+    }
+
+    m_totalDirty[channel] = true;
+}
+
+void DataBuffer::resetStatistics(int channel)
+{
+    m_blockStats[channel].clear();
+    m_firstIndex[channel] = 0;
+    m_totalStats[channel] = SignalStatistics();
+    m_totalDirty[channel] = false;
+}
+
+int DataBuffer::headOffset(int channel) const
+{
+    return static_cast<int>(m_firstIndex[channel] % STATS_BLOCK_SIZE);
+}
+
+void DataBuffer::setMaxCapacity(int capacity)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (capacity <= 0) {
+        qWarning() << "无效的缓冲区容量:" << capacity;
+        return;
+    }
+
+    m_maxCapacity = capacity;
+
+    // 如果当前数据量超过新容量，进行裁剪
+    for (int i = 0; i < MAX_CHANNELS; ++i) {
+        if (m_channelData[i].size() > m_maxCapacity) {
+            int removeCount = m_channelData[i].size() - m_maxCapacity;
+            removeOldest(i, removeCount);
+        }
+    }
+
+    qDebug() << "缓冲区最大容量设置为:" << m_maxCapacity;
+}
+
+QVector<QVector<DataPoint>> DataBuffer::getAllChannelsData()
+{
+    QMutexLocker locker(&m_mutex);
+
+    QVector<QVector<DataPoint>> allData;
+    allData.reserve(MAX_CHANNELS);
+
+    for (int i = 0; i < MAX_CHANNELS; ++i) {
+        allData.append(m_channelData[i]);
+    }
+
+    return allData;
+}
+
+bool DataBuffer::enableSharedStream(const QString& name, int capacity, double sampleRate,
+                                    QString* error)
+{
+    QMutexLocker locker(&m_mutex);
+
+    // 先关闭旧的发布端，同名重建时不会删掉新建的共享内存
+    delete m_sharedStream;
+    m_sharedStream = new SharedStreamPublisher();
+    if (!m_sharedStream->create(name, capacity, sampleRate)) {
+        if (error) {
+            *error = m_sharedStream->lastError();
+        }
+        delete m_sharedStream;
+        m_sharedStream = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void DataBuffer::disableSharedStream()
+{
+    QMutexLocker locker(&m_mutex);
+    delete m_sharedStream;
+    m_sharedStream = nullptr;
+}
+
+bool DataBuffer::isSharedStreamEnabled() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_sharedStream != nullptr;
+}
+
+void DataBuffer::setSharedStreamSampleRate(double sampleRate)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_sharedStream) {
+        m_sharedStream->setSampleRate(sampleRate);
+    }
+}
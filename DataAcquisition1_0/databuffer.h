@@ -1,61 +1,91 @@
-#ifndef DATABUFFER_H
-#define DATABUFFER_H
-
-#include <QObject>
-#include <QVector>
-#include <QMutex>
-#include <QMutexLocker>
-
-#define MAX_CHANNELS 13
-
-// 单个数据点结构
-struct DataPoint {
-    double time;      // 时间值（秒）
-    double amplitude; // 幅值
-
-    DataPoint() : time(0.0), amplitude(0.0) {}
-    DataPoint(double t, double a) : time(t), amplitude(a) {}
-};
-
-// 数据缓冲区类 - 支持13个通道
-class DataBuffer : public QObject
-{
-    Q_OBJECT
-
-public:
-    explicit DataBuffer(QObject *parent = nullptr);
-    ~DataBuffer();
-
-    // 添加数据点
-    void addDataPoint(int channel, const DataPoint& point);
-    void addDataPoints(int channel, const QVector<DataPoint>& points);
-
-    // 获取数据
-    QVector<DataPoint> getChannelData(int channel, int maxPoints = -1);
-    QVector<DataPoint> getAllChannelData(int channel);
-
-    // 清空缓冲区
-    void clear();
-    void clearChannel(int channel);
-
-    // 获取数据点数量
-    int getDataCount(int channel) const;
-
-    // 设置缓冲区最大容量
-    void setMaxCapacity(int capacity);
-    int getMaxCapacity() const { return m_maxCapacity; }
-
-    // 获取所有通道的数据
-    QVector<QVector<DataPoint>> getAllChannelsData();
-
-signals:
-    void dataAdded(int channel);
-    void bufferFull(int channel);
-
-private:
-    QVector<DataPoint> m_channelData[MAX_CHANNELS];
-    mutable QMutex m_mutex;
-    int m_maxCapacity;  // 最大缓冲容量
-};
-
-#endif // DATABUFFER_H
+#ifndef DATABUFFER_H
+#define DATABUFFER_H
+
+#include <QObject>
+#include <QVector>
+#include <QMutex>
+#include <QMutexLocker>
+#include "signalstatistics.h"
+
+class SharedStreamPublisher;
+
+#define MAX_CHANNELS 13
+
+// 单个数据点结构
+struct DataPoint {
+    double time;      // 时间值（秒）
+    double amplitude; // 幅值
+
+    DataPoint() : time(0.0), amplitude(0.0) {}
+    DataPoint(double t, double a) : time(t), amplitude(a) {}
+};
+
+// 数据缓冲区类 - 支持13个通道
+class DataBuffer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DataBuffer(QObject *parent = nullptr);
+    ~DataBuffer();
+
+    // 添加数据点
+    void addDataPoint(int channel, const DataPoint& point);
+    void addDataPoints(int channel, const QVector<DataPoint>& points);
+
+    // 获取数据
+    QVector<DataPoint> getChannelData(int channel, int maxPoints = -1);
+    QVector<DataPoint> getAllChannelData(int channel);
+
+    // 清空缓冲区
+    void clear();
+    void clearChannel(int channel);
+
+    // 获取数据点数量
+    int getDataCount(int channel) const;
+
+    // 获取通道统计量（随写入增量维护，无需遍历样本）
+    SignalStatistics getChannelStatistics(int channel) const;
+    // 获取最新 maxPoints 个数据点的统计量，只需重算一个不完整的块
+    SignalStatistics getRecentStatistics(int channel, int maxPoints) const;
+
+    // 设置缓冲区最大容量
+    void setMaxCapacity(int capacity);
+    int getMaxCapacity() const { return m_maxCapacity; }
+
+    // 获取所有通道的数据
+    QVector<QVector<DataPoint>> getAllChannelsData();
+
+    // 共享内存实时流：开启后新写入的数据同时发布到共享内存，供本机外部程序读取
+    bool enableSharedStream(const QString& name, int capacity, double sampleRate,
+                            QString* error = nullptr);
+    void disableSharedStream();
+    bool isSharedStreamEnabled() const;
+    void setSharedStreamSampleRate(double sampleRate);
+
+signals:
+    void dataAdded(int channel);
+    void bufferFull(int channel);
+
+private:
+    // 以下函数调用时须已持有 m_mutex
+    void appendStatistics(int channel, const DataPoint* points, int count, int oldSize);
+    void removeOldest(int channel, int removeCount);
+    void resetStatistics(int channel);
+    int headOffset(int channel) const;
+
+    QVector<DataPoint> m_channelData[MAX_CHANNELS];
+    mutable QMutex m_mutex;
+    int m_maxCapacity;  // 最大缓冲容量
+
+    // 分块统计：块按绝对样本序号对齐，淘汰旧数据时整块丢弃，只重算不完整的首块
+    static const int STATS_BLOCK_SIZE = 1024;
+    QVector<SignalStatistics> m_blockStats[MAX_CHANNELS];
+    qint64 m_firstIndex[MAX_CHANNELS];                  // 首个数据点的绝对序号
+    mutable SignalStatistics m_totalStats[MAX_CHANNELS];
+    mutable bool m_totalDirty[MAX_CHANNELS];            // 淘汰数据后需由各块重新合并
+
+    SharedStreamPublisher* m_sharedStream;              // 为空时不发布
+};
+
+#endif // DATABUFFER_H
@@ -0,0 +1,579 @@
+#include "fftplan.h"
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QDebug>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define FFTPLAN_USE_SSE2
+#endif
+
+namespace {
+
+typedef std::complex<double> Complex;
+
+const int MAX_CACHED_PLANS = 16;
+
+QMutex s_cacheMutex;
+QHash<int, QSharedPointer<const FftPlan>> s_planCache;
+QHash<int, QSharedPointer<const RealFftPlan>> s_realPlanCache;
+
+#ifdef FFTPLAN_USE_SSE2
+
+// 复数以 [实部, 虚部] 存放于一个128位寄存器中
+inline __m128d load(const Complex* p)
+{
+    return _mm_loadu_pd(reinterpret_cast<const double*>(p));
+}
+
+inline void store(Complex* p, __m128d v)
+{
+    _mm_storeu_pd(reinterpret_cast<double*>(p), v);
+}
+
+// (ar + i*ai) * (br + i*bi)
+inline __m128d complexMul(__m128d a, __m128d b)
+{
+    const __m128d signLow = _mm_set_pd(0.0, -0.0);
+    __m128d br = _mm_unpacklo_pd(b, b);
+    __m128d bi = _mm_unpackhi_pd(b, b);
+    __m128d swapped = _mm_shuffle_pd(a, a, 1);
+    return _mm_add_pd(_mm_mul_pd(a, br),
+                      _mm_xor_pd(_mm_mul_pd(swapped, bi), signLow));
+}
+
+// 乘以 -i：(x + i*y) * (-i) = y - i*x
+inline __m128d mulMinusI(__m128d a)
+{
+    const __m128d signHigh = _mm_set_pd(-0.0, 0.0);
+    return _mm_xor_pd(_mm_shuffle_pd(a, a, 1), signHigh);
+}
+
+void radix2Stage(Complex* x, int n, int span, const Complex* tw)
+{
+    for (int base = 0; base < n; base += 2 * span) {
+        Complex* p0 = x + base;
+        Complex* p1 = p0 + span;
+        for (int j = 0; j < span; ++j) {
+            __m128d a0 = load(p0 + j);
+            __m128d a1 = complexMul(load(p1 + j), load(tw + j));
+            store(p0 + j, _mm_add_pd(a0, a1));
+            store(p1 + j, _mm_sub_pd(a0, a1));
+        }
+    }
+}
+
+void radix4Stage(Complex* x, int n, int span, const Complex* tw)
+{
+    for (int base = 0; base < n; base += 4 * span) {
+        Complex* p0 = x + base;
+        Complex* p1 = p0 + span;
+        Complex* p2 = p1 + span;
+        Complex* p3 = p2 + span;
+        for (int j = 0; j < span; ++j) {
+            const Complex* w = tw + 3 * j;
+            __m128d a0 = load(p0 + j);
+            __m128d a1 = complexMul(load(p1 + j), load(w));
+            __m128d a2 = complexMul(load(p2 + j), load(w + 1));
+            __m128d a3 = complexMul(load(p3 + j), load(w + 2));
+
+            __m128d t0 = _mm_add_pd(a0, a2);
+            __m128d t1 = _mm_sub_pd(a0, a2);
+            __m128d t2 = _mm_add_pd(a1, a3);
+            __m128d t3 = mulMinusI(_mm_sub_pd(a1, a3));
+
+            store(p0 + j, _mm_add_pd(t0, t2));
+            store(p1 + j, _mm_add_pd(t1, t3));
+            store(p2 + j, _mm_sub_pd(t0, t2));
+            store(p3 + j, _mm_sub_pd(t1, t3));
+        }
+    }
+}
+
+#else
+
+void radix2Stage(Complex* x, int n, int span, const Complex* tw)
+{
+    for (int base = 0; base < n; base += 2 * span) {
+        Complex* p0 = x + base;
+        Complex* p1 = p0 + span;
+        for (int j = 0; j < span; ++j) {
+            Complex a0 = p0[j];
+            Complex a1 = p1[j] * tw[j];
+            p0[j] = a0 + a1;
+            p1[j] = a0 - a1;
+        }
+    }
+}
+
+void radix4Stage(Complex* x, int n, int span, const Complex* tw)
+{
+    for (int base = 0; base < n; base += 4 * span) {
+        Complex* p0 = x + base;
+        Complex* p1 = p0 + span;
+        Complex* p2 = p1 + span;
+        Complex* p3 = p2 + span;
+        for (int j = 0; j < span; ++j) {
+            const Complex* w = tw + 3 * j;
+            Complex a0 = p0[j];
+            Complex a1 = p1[j] * w[0];
+            Complex a2 = p2[j] * w[1];
+            Complex a3 = p3[j] * w[2];
+
+            Complex t0 = a0 + a2;
+            Complex t1 = a0 - a2;
+            Complex t2 = a1 + a3;
+            Complex d = a1 - a3;
+            Complex t3(d.imag(), -d.real());
+
+            p0[j] = t0 + t2;
+            p1[j] = t1 + t3;
+            p2[j] = t0 - t2;
+            p3[j] = t1 - t3;
+        }
+    }
+}
+
+#endif
+
+// 基3蝶形：W3 = -1/2 - i*sqrt(3)/2
+void radix3Stage(Complex* x, int n, int span, const Complex* tw)
+{
+    const double sin60 = std::sqrt(3.0) / 2.0;
+    for (int base = 0; base < n; base += 3 * span) {
+        Complex* p0 = x + base;
+        Complex* p1 = p0 + span;
+        Complex* p2 = p1 + span;
+        for (int j = 0; j < span; ++j) {
+            const Complex* w = tw + 2 * j;
+            Complex a0 = p0[j];
+            Complex a1 = p1[j] * w[0];
+            Complex a2 = p2[j] * w[1];
+
+            Complex sum = a1 + a2;
+            Complex mid = a0 - 0.5 * sum;
+            Complex d = a1 - a2;
+            Complex rot(sin60 * d.imag(), -sin60 * d.real());
+
+            p0[j] = a0 + sum;
+            p1[j] = mid + rot;
+            p2[j] = mid - rot;
+        }
+    }
+}
+
+// 奇数基（5、7）蝶形：利用 W^r 与 W^(p-r) 共轭对称，成对合并输入
+// X_q = a0 + sum cos(2*pi*r*q/p)*(a_r + a_(p-r)) - i * sum sin(2*pi*r*q/p)*(a_r - a_(p-r))
+void oddRadixStage(Complex* x, int n, int radix, int span, const Complex* tw)
+{
+    const int MAX_RADIX = 7;
+    const int MAX_HALF = MAX_RADIX / 2;
+    int half = radix / 2;
+
+    double cosTable[MAX_HALF + 1][MAX_HALF + 1];
+    double sinTable[MAX_HALF + 1][MAX_HALF + 1];
+    for (int q = 1; q <= half; ++q) {
+        for (int r = 1; r <= half; ++r) {
+            double angle = 2.0 * M_PI * r * q / radix;
+            cosTable[q][r] = std::cos(angle);
+            sinTable[q][r] = std::sin(angle);
+        }
+    }
+
+    Complex sums[MAX_HALF + 1];
+    Complex diffs[MAX_HALF + 1];
+    for (int base = 0; base < n; base += radix * span) {
+        Complex* p = x + base;
+        for (int j = 0; j < span; ++j) {
+            const Complex* w = tw + (radix - 1) * j;
+            Complex a0 = p[j];
+            Complex total = a0;
+            for (int r = 1; r <= half; ++r) {
+                Complex ar = p[r * span + j] * w[r - 1];
+                Complex br = p[(radix - r) * span + j] * w[radix - r - 1];
+                sums[r] = ar + br;
+                diffs[r] = ar - br;
+                total += sums[r];
+            }
+
+            p[j] = total;
+            for (int q = 1; q <= half; ++q) {
+                Complex t = a0;
+                Complex u(0.0, 0.0);
+                for (int r = 1; r <= half; ++r) {
+                    t += cosTable[q][r] * sums[r];
+                    u += sinTable[q][r] * diffs[r];
+                }
+                // -i*u 与 +i*u
+                Complex rot(u.imag(), -u.real());
+                p[q * span + j] = t + rot;
+                p[(radix - q) * span + j] = t - rot;
+            }
+        }
+    }
+}
+
+} // namespace
+
+QSharedPointer<const FftPlan> FftPlan::plan(int n)
+{
+    if (n < 1) {
+        qWarning() << "无效的FFT长度:" << n;
+        return QSharedPointer<const FftPlan>();
+    }
+
+    {
+        QMutexLocker locker(&s_cacheMutex);
+        QSharedPointer<const FftPlan> cached = s_planCache.value(n);
+        if (cached) {
+            return cached;
+        }
+    }
+
+    // 在锁外创建：Bluestein计划的构造过程会递归获取卷积长度的计划
+    QSharedPointer<const FftPlan> created(new FftPlan(n));
+
+    QMutexLocker locker(&s_cacheMutex);
+
+    QSharedPointer<const FftPlan> cached = s_planCache.value(n);
+    if (cached) {
+        return cached;
+    }
+
+    // 缓存过多时整体清除，正在使用的计划由共享指针保持有效
+    if (s_planCache.size() >= MAX_CACHED_PLANS) {
+        s_planCache.clear();
+    }
+
+    s_planCache.insert(n, created);
+    return created;
+}
+
+void FftPlan::clearCache()
+{
+    QMutexLocker locker(&s_cacheMutex);
+    s_planCache.clear();
+}
+
+FftPlan::FftPlan(int n)
+    : m_size(n)
+{
+    // 分解质因数：优先基4，其余为2、3、5、7，列表顺序为从外到内
+    QVector<int> radices;
+    int remaining = n;
+    while (remaining % 4 == 0) {
+        radices.append(4);
+        remaining /= 4;
+    }
+    const int smallPrimes[] = {2, 3, 5, 7};
+    for (int prime : smallPrimes) {
+        while (remaining % prime == 0) {
+            radices.append(prime);
+            remaining /= prime;
+        }
+    }
+
+    if (remaining == 1) {
+        buildPermutation(radices);
+        buildStages(radices);
+    } else {
+        // 含有大于7的质因子，改用Bluestein算法
+        buildBluestein();
+    }
+}
+
+bool FftPlan::isSmoothSize(int n)
+{
+    if (n < 1) {
+        return false;
+    }
+    const int smallPrimes[] = {2, 3, 5, 7};
+    for (int prime : smallPrimes) {
+        while (n % prime == 0) {
+            n /= prime;
+        }
+    }
+    return n == 1;
+}
+
+int FftPlan::nextSmoothSize(int n)
+{
+    int size = qMax(1, n);
+    while (!isSmoothSize(size)) {
+        ++size;
+    }
+    return size;
+}
+
+void FftPlan::buildBluestein()
+{
+    // X_k = conj(w_k) * sum_j (x_j * conj(w_j)) * w_(k-j)，其中 w_k = exp(i*pi*k^2/n)
+    // 卷积用长度 >= 2n-1 的最小混合基长度计算（比取2的幂次最多省一半）
+    int convolutionSize = nextSmoothSize(2 * m_size - 1);
+    m_bluesteinPlan = FftPlan::plan(convolutionSize);
+
+    // 用 k^2 mod 2n 计算相位，避免k较大时的精度损失
+    m_chirp.resize(m_size);
+    qint64 modulus = 2 * static_cast<qint64>(m_size);
+    for (int k = 0; k < m_size; ++k) {
+        qint64 phase = (static_cast<qint64>(k) * k) % modulus;
+        double angle = -M_PI * static_cast<double>(phase) / m_size;
+        m_chirp[k] = std::complex<double>(std::cos(angle), std::sin(angle));
+    }
+
+    // 卷积核的频谱，预先乘以逆变换的 1/M
+    QVector<Complex> kernel(convolutionSize, Complex(0.0, 0.0));
+    double scale = 1.0 / convolutionSize;
+    kernel[0] = std::conj(m_chirp[0]) * scale;
+    for (int k = 1; k < m_size; ++k) {
+        Complex value = std::conj(m_chirp[k]) * scale;
+        kernel[k] = value;
+        kernel[convolutionSize - k] = value;
+    }
+
+    m_chirpSpectrum.resize(convolutionSize);
+    m_bluesteinPlan->transform(kernel.constData(), m_chirpSpectrum.data());
+}
+
+void FftPlan::bluesteinTransform(const std::complex<double>* in, std::complex<double>* out) const
+{
+    int convolutionSize = m_bluesteinPlan->size();
+
+    QVector<Complex> buffer(convolutionSize, Complex(0.0, 0.0));
+    for (int k = 0; k < m_size; ++k) {
+        buffer[k] = in[k] * m_chirp[k];
+    }
+
+    QVector<Complex> spectrum(convolutionSize);
+    m_bluesteinPlan->transform(buffer.constData(), spectrum.data());
+
+    // 频域相乘后取共轭，用正向变换完成逆变换
+    for (int k = 0; k < convolutionSize; ++k) {
+        spectrum[k] = std::conj(spectrum[k] * m_chirpSpectrum[k]);
+    }
+    m_bluesteinPlan->transform(spectrum.constData(), buffer.data());
+
+    for (int k = 0; k < m_size; ++k) {
+        out[k] = m_chirp[k] * std::conj(buffer[k]);
+    }
+}
+
+void FftPlan::buildPermutation(const QVector<int>& radices)
+{
+    m_permutation.resize(m_size);
+
+    // 按时间抽取：第 level 级的第 r 个子变换取输入 offset + r*stride 开始、步长为 stride*radix 的序列
+    struct Frame {
+        int offset;
+        int stride;
+        int level;
+    };
+
+    QVector<Frame> stack;
+    stack.append(Frame{0, 1, 0});
+    int position = 0;
+
+    while (!stack.isEmpty()) {
+        Frame frame = stack.last();
+        stack.removeLast();
+
+        if (frame.level == radices.size()) {
+            m_permutation[position++] = frame.offset;
+            continue;
+        }
+
+        // 逆序入栈，保证子变换 r=0 最先输出
+        int radix = radices[frame.level];
+        for (int r = radix - 1; r >= 0; --r) {
+            stack.append(Frame{frame.offset + r * frame.stride,
+                               frame.stride * radix, frame.level + 1});
+        }
+    }
+}
+
+void FftPlan::buildStages(const QVector<int>& radices)
+{
+    int span = 1;
+    for (int level = radices.size() - 1; level >= 0; --level) {
+        int radix = radices[level];
+
+        Stage stage;
+        stage.radix = radix;
+        stage.span = span;
+        stage.twiddleOffset = m_twiddles.size();
+
+        // 第 j 个蝶形使用 W^(r*j), r = 1..radix-1，直接由三角函数计算以保证大长度时的精度
+        int length = radix * span;
+        for (int j = 0; j < span; ++j) {
+            for (int r = 1; r < radix; ++r) {
+                double angle = -2.0 * M_PI * static_cast<double>(r) * j / length;
+                m_twiddles.append(std::complex<double>(std::cos(angle), std::sin(angle)));
+            }
+        }
+
+        m_stages.append(stage);
+        span = length;
+    }
+}
+
+void FftPlan::transform(const std::complex<double>* in, std::complex<double>* out) const
+{
+    if (m_bluesteinPlan) {
+        bluesteinTransform(in, out);
+        return;
+    }
+
+    const int* perm = m_permutation.constData();
+    for (int i = 0; i < m_size; ++i) {
+        out[i] = in[perm[i]];
+    }
+
+    const Complex* twiddles = m_twiddles.constData();
+    for (const Stage& stage : m_stages) {
+        const Complex* tw = twiddles + stage.twiddleOffset;
+        switch (stage.radix) {
+        case 4:
+            radix4Stage(out, m_size, stage.span, tw);
+            break;
+        case 2:
+            radix2Stage(out, m_size, stage.span, tw);
+            break;
+        case 3:
+            radix3Stage(out, m_size, stage.span, tw);
+            break;
+        default:
+            oddRadixStage(out, m_size, stage.radix, stage.span, tw);
+            break;
+        }
+    }
+}
+
+void FftPlan::forward(QVector<std::complex<double>>& data) const
+{
+    if (data.size() != m_size) {
+        qWarning() << "FFT数据长度与计划不匹配:" << data.size() << "!=" << m_size;
+        return;
+    }
+
+    QVector<std::complex<double>> input = data;
+    transform(input.constData(), data.data());
+}
+
+QSharedPointer<const RealFftPlan> RealFftPlan::plan(int n)
+{
+    if (n < 1) {
+        qWarning() << "无效的实数FFT长度:" << n;
+        return QSharedPointer<const RealFftPlan>();
+    }
+
+    {
+        QMutexLocker locker(&s_cacheMutex);
+        QSharedPointer<const RealFftPlan> cached = s_realPlanCache.value(n);
+        if (cached) {
+            return cached;
+        }
+    }
+
+    // 复数计划在锁外获取，FftPlan::plan 自身会加锁
+    // 偶数长度使用半长变换，奇数长度只能退回到全长复数变换
+    QSharedPointer<const FftPlan> complexPlan = FftPlan::plan(n % 2 == 0 ? n / 2 : n);
+    if (!complexPlan) {
+        return QSharedPointer<const RealFftPlan>();
+    }
+
+    QMutexLocker locker(&s_cacheMutex);
+
+    QSharedPointer<const RealFftPlan> cached = s_realPlanCache.value(n);
+    if (cached) {
+        return cached;
+    }
+
+    if (s_realPlanCache.size() >= MAX_CACHED_PLANS) {
+        s_realPlanCache.clear();
+    }
+
+    QSharedPointer<const RealFftPlan> created(new RealFftPlan(n, complexPlan));
+    s_realPlanCache.insert(n, created);
+    return created;
+}
+
+void RealFftPlan::clearCache()
+{
+    QMutexLocker locker(&s_cacheMutex);
+    s_realPlanCache.clear();
+}
+
+RealFftPlan::RealFftPlan(int n, const QSharedPointer<const FftPlan>& complexPlan)
+    : m_size(n)
+    , m_complexPlan(complexPlan)
+{
+    if (n % 2 != 0) {
+        return;
+    }
+
+    int half = n / 2;
+    m_twiddles.resize(half + 1);
+    for (int k = 0; k <= half; ++k) {
+        double angle = -2.0 * M_PI * k / n;
+        m_twiddles[k] = std::complex<double>(std::cos(angle), std::sin(angle));
+    }
+}
+
+std::complex<double> RealFftPlan::bin(const std::complex<double>* half, int k) const
+{
+    // Z = FFT(x[2m] + i*x[2m+1])，偶/奇序列的频谱分别为 E 和 O：
+    // E_k = (Z_k + conj(Z_{N/2-k})) / 2,  O_k = -i * (Z_k - conj(Z_{N/2-k})) / 2
+    // X_k = E_k + W_n^k * O_k
+    int halfSize = m_size / 2;
+    Complex zk = half[k % halfSize];
+    Complex zc = std::conj(half[(halfSize - k) % halfSize]);
+
+    Complex even = 0.5 * (zk + zc);
+    Complex diff = zk - zc;
+    Complex odd(0.5 * diff.imag(), -0.5 * diff.real());
+
+    return even + m_twiddles[k] * odd;
+}
+
+QVector<std::complex<double>> RealFftPlan::complexSpectrum(const double* in) const
+{
+    QVector<Complex> spectrum(m_complexPlan->size());
+
+    if (m_size % 2 == 0) {
+        // 实数序列两两打包即为复数序列，无需复制
+        m_complexPlan->transform(reinterpret_cast<const Complex*>(in), spectrum.data());
+    } else {
+        QVector<Complex> widened(m_size);
+        for (int i = 0; i < m_size; ++i) {
+            widened[i] = Complex(in[i], 0.0);
+        }
+        m_complexPlan->transform(widened.constData(), spectrum.data());
+    }
+
+    return spectrum;
+}
+
+void RealFftPlan::transform(const double* in, std::complex<double>* out) const
+{
+    QVector<Complex> spectrum = complexSpectrum(in);
+
+    int bins = spectrumSize();
+    for (int k = 0; k < bins; ++k) {
+        out[k] = (m_size % 2 == 0) ? bin(spectrum.constData(), k) : spectrum[k];
+    }
+}
+
+void RealFftPlan::magnitude(const double* in, double* out, int bins, bool squared) const
+{
+    bins = qMin(bins, spectrumSize());
+
+    QVector<Complex> spectrum = complexSpectrum(in);
+
+    for (int k = 0; k < bins; ++k) {
+        Complex value = (m_size % 2 == 0) ? bin(spectrum.constData(), k) : spectrum[k];
+        double power = std::norm(value);
+        out[k] = squared ? power : std::sqrt(power);
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef FFTPLAN_H
+#define FFTPLAN_H
+
+#include <QVector>
+#include <QSharedPointer>
+#include <complex>
+
+// FFT计划 - 按变换长度缓存置换表和旋转因子表
+// 同一长度的重复变换（实时分析中的常见情况）无需再计算位反转和三角函数
+// 长度只含2、3、5、7因子时使用混合基算法，否则使用Bluestein（chirp-z）算法
+class FftPlan
+{
+public:
+    // 获取指定长度的计划（首次使用时创建并缓存），线程安全，支持任意正整数长度
+    static QSharedPointer<const FftPlan> plan(int n);
+    static void clearCache();
+
+    // 长度是否只含2、3、5、7因子（可直接用混合基计算）
+    static bool isSmoothSize(int n);
+    // 不小于 n 的最小混合基长度（用于卷积/相关的零填充）
+    static int nextSmoothSize(int n);
+
+    int size() const { return m_size; }
+
+    // 正向变换：in 与 out 不能重叠
+    void transform(const std::complex<double>* in, std::complex<double>* out) const;
+
+    // 原地正向变换
+    void forward(QVector<std::complex<double>>& data) const;
+
+private:
+    explicit FftPlan(int n);
+
+    // 一级蝶形运算：radix 个长度为 span 的子变换合并为长度 radix*span 的变换
+    struct Stage {
+        int radix;
+        int span;
+        int twiddleOffset;
+    };
+
+    void buildPermutation(const QVector<int>& radices);
+    void buildStages(const QVector<int>& radices);
+    void buildBluestein();
+    void bluesteinTransform(const std::complex<double>* in, std::complex<double>* out) const;
+
+    int m_size;
+    QVector<int> m_permutation;                 // 输入置换表（数位反转）
+    QVector<std::complex<double>> m_twiddles;   // 各级旋转因子，按级、按蝶形连续存放
+    QVector<Stage> m_stages;                    // 从内到外的执行顺序
+
+    // Bluestein算法（长度含大于7的质因子时）
+    QSharedPointer<const FftPlan> m_bluesteinPlan;   // 卷积用的混合基计划
+    QVector<std::complex<double>> m_chirp;           // exp(-i*pi*k^2/n)
+    QVector<std::complex<double>> m_chirpSpectrum;   // 卷积核频谱（已含1/M缩放）
+};
+
+// 实数输入FFT计划 - 长度为 n 的实序列按 n/2 点复数变换加一次后处理完成
+// 相比把实数补成复数再做 n 点变换，计算量和内存都约减半（奇数长度退回全长复数变换）
+class RealFftPlan
+{
+public:
+    // 获取指定长度的计划，线程安全
+    static QSharedPointer<const RealFftPlan> plan(int n);
+    static void clearCache();
+
+    int size() const { return m_size; }
+    int spectrumSize() const { return m_size / 2 + 1; }
+
+    // 正向变换：输出 n/2+1 个非负频率分量（整数除法）
+    void transform(const double* in, std::complex<double>* out) const;
+
+    // 只计算前 bins 个频点（bins <= n/2+1）的幅值，squared 为 true 时输出功率（幅值平方）
+    void magnitude(const double* in, double* out, int bins, bool squared = false) const;
+
+private:
+    explicit RealFftPlan(int n, const QSharedPointer<const FftPlan>& complexPlan);
+
+    QVector<std::complex<double>> complexSpectrum(const double* in) const;
+    std::complex<double> bin(const std::complex<double>* half, int k) const;
+
+    int m_size;
+    QSharedPointer<const FftPlan> m_complexPlan;  // 偶数长度为 n/2 点，奇数长度为 n 点
+    QVector<std::complex<double>> m_twiddles;     // 后处理旋转因子 W_n^k, k = 0..n/2
+};
+
+#endif // FFTPLAN_H
@@ -0,0 +1,209 @@
+#include "frequencytracker.h"
+#include <QDebug>
+#include <cmath>
+
+namespace {
+
+// 每处理这么多个窗口长度的样本，就用窗口内样本精确重算一次累加和（摊销开销约 1/16 次三角运算每样本）
+const int RECOMPUTE_WINDOWS = 16;
+const int MIN_RECOMPUTE_INTERVAL = 65536;
+
+} // namespace
+
+FrequencyTracker::FrequencyTracker(QObject *parent)
+    : QObject(parent)
+    , m_sampleRate(1000000.0)
+    , m_windowLength(4096)
+{
+}
+
+FrequencyTracker::~FrequencyTracker()
+{
+}
+
+void FrequencyTracker::setSampleRate(double rate)
+{
+    if (rate <= 0.0) {
+        qWarning() << "无效的采样率:" << rate;
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_sampleRate = rate;
+    for (int i = 0; i < MAX_CHANNELS; ++i) {
+        resetChannelLocked(i);
+    }
+}
+
+void FrequencyTracker::setWindowLength(int samples)
+{
+    if (samples < 2) {
+        qWarning() << "无效的跟踪窗口长度:" << samples;
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_windowLength = samples;
+    for (int i = 0; i < MAX_CHANNELS; ++i) {
+        resetChannelLocked(i);
+    }
+}
+
+void FrequencyTracker::setFrequencies(int channel, const QVector<double>& frequencies)
+{
+    if (channel < 0 || channel >= MAX_CHANNELS) {
+        qWarning() << "无效的通道号:" << channel;
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_frequencies[channel] = frequencies;
+    resetChannelLocked(channel);
+}
+
+QVector<double> FrequencyTracker::frequencies(int channel) const
+{
+    if (channel < 0 || channel >= MAX_CHANNELS) {
+        return QVector<double>();
+    }
+
+    QMutexLocker locker(&m_mutex);
+    return m_frequencies[channel];
+}
+
+QVector<ToneMeasurement> FrequencyTracker::measurements(int channel) const
+{
+    if (channel < 0 || channel >= MAX_CHANNELS) {
+        return QVector<ToneMeasurement>();
+    }
+
+    QMutexLocker locker(&m_mutex);
+    return m_channels[channel].snapshot;
+}
+
+void FrequencyTracker::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    for (int i = 0; i < MAX_CHANNELS; ++i) {
+        resetChannelLocked(i);
+    }
+}
+
+void FrequencyTracker::processBlock(int channel, const QVector<DataPoint>& data)
+{
+    if (channel < 0 || channel >= MAX_CHANNELS || data.isEmpty()) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        ChannelState& state = m_channels[channel];
+        if (state.bins.isEmpty()) {
+            return;
+        }
+
+        const int windowLength = m_windowLength;
+        const int binCount = state.bins.size();
+        TrackedBin* bins = state.bins.data();
+        double* history = state.history.data();
+        qint64 recomputeInterval = qMax<qint64>(MIN_RECOMPUTE_INTERVAL,
+                                                static_cast<qint64>(windowLength) * RECOMPUTE_WINDOWS);
+
+        for (const DataPoint& point : data) {
+            double x = point.amplitude;
+            bool full = state.sampleCount >= windowLength;
+            double oldest = full ? history[state.writePos] : 0.0;
+
+            // S += e^{-jω(n-base)}·(x[n] - x[n-N]·e^{jωN})，然后相量前进一个样本
+            for (int b = 0; b < binCount; ++b) {
+                TrackedBin& bin = bins[b];
+                std::complex<double> delta = full ? x - oldest * bin.wrap
+                                                  : std::complex<double>(x, 0.0);
+                bin.sum += bin.phasor * delta;
+                bin.phasor *= bin.step;
+            }
+
+            history[state.writePos] = x;
+            state.writePos = (state.writePos + 1) % windowLength;
+            ++state.sampleCount;
+            ++state.samplesSinceRecompute;
+
+            if (full && state.samplesSinceRecompute >= recomputeInterval) {
+                recomputeLocked(state);
+            }
+        }
+
+        updateSnapshotLocked(state);
+    }
+
+    emit measurementsUpdated(channel);
+}
+
+void FrequencyTracker::resetChannelLocked(int channel)
+{
+    ChannelState& state = m_channels[channel];
+    state.history = QVector<double>(m_windowLength, 0.0);
+    state.writePos = 0;
+    state.sampleCount = 0;
+    state.samplesSinceRecompute = 0;
+    state.bins.clear();
+    state.snapshot.clear();
+
+    for (double frequency : m_frequencies[channel]) {
+        double omega = 2.0 * M_PI * frequency / m_sampleRate;
+
+        TrackedBin bin;
+        bin.frequency = frequency;
+        bin.sum = std::complex<double>(0.0, 0.0);
+        bin.phasor = std::complex<double>(1.0, 0.0);
+        bin.step = std::polar(1.0, -omega);
+        bin.wrap = std::polar(1.0, omega * m_windowLength);
+        state.bins.append(bin);
+
+        ToneMeasurement measurement;
+        measurement.frequency = frequency;
+        state.snapshot.append(measurement);
+    }
+}
+
+void FrequencyTracker::recomputeLocked(ChannelState& state)
+{
+    // 以当前窗口起点为新的相位参考，直接计算累加和，消除递推积累的误差
+    const int windowLength = m_windowLength;
+    for (TrackedBin& bin : state.bins) {
+        double omega = 2.0 * M_PI * bin.frequency / m_sampleRate;
+        std::complex<double> sum(0.0, 0.0);
+        for (int i = 0; i < windowLength; ++i) {
+            double x = state.history[(state.writePos + i) % windowLength];
+            sum += x * std::polar(1.0, -omega * i);
+        }
+        bin.sum = sum;
+        bin.phasor = std::conj(bin.wrap);   // 下一个样本相对新参考点的序号为 N
+    }
+    state.samplesSinceRecompute = 0;
+}
+
+void FrequencyTracker::updateSnapshotLocked(ChannelState& state)
+{
+    qint64 count = qMin<qint64>(state.sampleCount, m_windowLength);
+    if (count == 0) {
+        return;
+    }
+
+    for (int b = 0; b < state.bins.size(); ++b) {
+        const TrackedBin& bin = state.bins[b];
+        ToneMeasurement& measurement = state.snapshot[b];
+
+        // 余弦分量的能量一半落在正频率：幅值 = 2|S|/N（直流除外）
+        double omega = 2.0 * M_PI * bin.frequency / m_sampleRate;
+        bool dc = std::fabs(std::sin(omega / 2.0)) < 1e-12;
+        double gain = dc ? 1.0 / count : 2.0 / count;
+
+        // 相位从窗口参考点换算到最新样本：最新样本的相量为 phasor·e^{jω}
+        std::complex<double> latest = bin.phasor * std::conj(bin.step);
+        measurement.amplitude = std::abs(bin.sum) * gain;
+        measurement.phase = std::arg(bin.sum * std::conj(latest));
+        measurement.valid = state.sampleCount >= m_windowLength;
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef FREQUENCYTRACKER_H
+#define FREQUENCYTRACKER_H
+
+#include <QObject>
+#include <QVector>
+#include <QMutex>
+#include <complex>
+#include "databuffer.h"
+
+// 单个跟踪频率的测量结果
+struct ToneMeasurement {
+    double frequency;   // 跟踪频率（Hz）
+    double amplitude;   // 正弦幅值（峰值）
+    double phase;       // 最新样本处的相位（弧度，余弦参考）
+    bool valid;         // 滑动窗口是否已填满
+
+    ToneMeasurement() : frequency(0.0), amplitude(0.0), phase(0.0), valid(false) {}
+};
+
+// 目标频率跟踪 - 对每个通道的若干指定频率维护滑动DFT
+// 每个样本每个频点只需一次复数乘加和一次相量旋转，与窗口长度无关
+// 频率可以是任意值（不要求落在FFT频点上）；窗口长度取基频周期的整数倍时各次谐波互不泄漏
+// 递推累加的舍入误差由定期按窗口内样本精确重算来限制
+class FrequencyTracker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FrequencyTracker(QObject *parent = nullptr);
+    ~FrequencyTracker();
+
+    void setSampleRate(double rate);
+    void setWindowLength(int samples);
+
+    // 设置某个通道的跟踪频率列表（会重新开始累积）
+    void setFrequencies(int channel, const QVector<double>& frequencies);
+    QVector<double> frequencies(int channel) const;
+
+    // 最近一次处理数据块后的测量快照，线程安全
+    QVector<ToneMeasurement> measurements(int channel) const;
+
+public slots:
+    void processBlock(int channel, const QVector<DataPoint>& data);
+    void reset();
+
+signals:
+    void measurementsUpdated(int channel);
+
+private:
+    struct TrackedBin {
+        double frequency;
+        std::complex<double> sum;       // Σ x[m]·e^{-jω(m-base)}，base 为最近一次重算时的窗口起点
+        std::complex<double> phasor;    // 下一个样本的 e^{-jω(n-base)}
+        std::complex<double> step;      // e^{-jω}
+        std::complex<double> wrap;      // e^{jωN}：移出样本相对移入样本的相位差
+    };
+
+    struct ChannelState {
+        QVector<double> history;        // 最近 N 个样本的环形缓冲
+        int writePos;
+        qint64 sampleCount;
+        qint64 samplesSinceRecompute;
+        QVector<TrackedBin> bins;
+        QVector<ToneMeasurement> snapshot;
+
+        ChannelState() : writePos(0), sampleCount(0), samplesSinceRecompute(0) {}
+    };
+
+    void resetChannelLocked(int channel);
+    void recomputeLocked(ChannelState& state);
+    void updateSnapshotLocked(ChannelState& state);
+
+    mutable QMutex m_mutex;
+    double m_sampleRate;
+    int m_windowLength;
+    QVector<double> m_frequencies[MAX_CHANNELS];
+    ChannelState m_channels[MAX_CHANNELS];
+};
+
+#endif // FREQUENCYTRACKER_H
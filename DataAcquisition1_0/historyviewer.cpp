@@ -1,349 +1,723 @@
-#include "historyviewer.h"
-#include <QMessageBox>
-#include <QDebug>
-#include <QHeaderView>
-#include <QVBoxLayout>
-#include <QHBoxLayout>
-#include <QGroupBox>
-
-HistoryViewer::HistoryViewer(DatabaseManager* dbManager, QWidget *parent)
-    : QDialog(parent)
-    , m_dbManager(dbManager)
-{
-    setWindowTitle("历史数据查看");
-    resize(900, 600);
-
-    // 创建UI控件
-    createWidgets();
-
-    // 设置布局
-    setupLayout();
-
-    // 设置表格
-    setupTableWidget();
-
-    // 连接信号槽
-    connectSignals();
-
-    // 加载任务列表
-    loadTasks();
-}
-
-HistoryViewer::~HistoryViewer()
-{
-}
-
-void HistoryViewer::createWidgets()
-{
-    // 搜索区域控件
-    m_searchLineEdit = new QLineEdit(this);
-    m_searchLineEdit->setPlaceholderText("输入任务名称或描述关键字...");
-
-    m_searchButton = new QPushButton("搜索", this);
-    m_refreshButton = new QPushButton("刷新", this);
-
-    // 表格控件
-    m_taskTableWidget = new QTableWidget(this);
-
-    // 操作按钮
-    m_viewButton = new QPushButton("查看/回放", this);
-    m_deleteButton = new QPushButton("删除", this);
-    m_analyzeButton = new QPushButton("分析结果", this);
-    m_closeButton = new QPushButton("关闭", this);
-
-    // 状态标签
-    m_statusLabel = new QLabel("就绪", this);
-
-    // 初始状态
-    m_viewButton->setEnabled(false);
-    m_deleteButton->setEnabled(false);
-    m_analyzeButton->setEnabled(false);
-}
-
-void HistoryViewer::setupLayout()
-{
-    QVBoxLayout* mainLayout = new QVBoxLayout(this);
-
-    // 搜索区域
-    QGroupBox* searchGroup = new QGroupBox("搜索", this);
-    QHBoxLayout* searchLayout = new QHBoxLayout(searchGroup);
-    searchLayout->addWidget(m_searchLineEdit);
-    searchLayout->addWidget(m_searchButton);
-    searchLayout->addWidget(m_refreshButton);
-
-    mainLayout->addWidget(searchGroup);
-
-    // 表格区域
-    QGroupBox* tableGroup = new QGroupBox("任务列表", this);
-    QVBoxLayout* tableLayout = new QVBoxLayout(tableGroup);
-    tableLayout->addWidget(m_taskTableWidget);
-
-    mainLayout->addWidget(tableGroup);
-
-    // 操作按钮区域
-    QHBoxLayout* buttonLayout = new QHBoxLayout();
-    buttonLayout->addWidget(m_viewButton);
-    buttonLayout->addWidget(m_deleteButton);
-    buttonLayout->addWidget(m_analyzeButton);
-    buttonLayout->addStretch();
-    buttonLayout->addWidget(m_closeButton);
-
-    mainLayout->addLayout(buttonLayout);
-
-    // 状态栏
-    mainLayout->addWidget(m_statusLabel);
-
-    setLayout(mainLayout);
-}
-
-void HistoryViewer::setupTableWidget()
-{
-    // 设置表格列
-    m_taskTableWidget->setColumnCount(7);
-    QStringList headers;
-    headers << "任务ID" << "任务名称" << "采样率(Hz)"
-            << "时长(s)" << "通道数" << "创建时间" << "描述";
-    m_taskTableWidget->setHorizontalHeaderLabels(headers);
-
-    // 设置表格属性
-    m_taskTableWidget->setSelectionBehavior(QAbstractItemView::SelectRows);
-    m_taskTableWidget->setSelectionMode(QAbstractItemView::SingleSelection);
-    m_taskTableWidget->setEditTriggers(QAbstractItemView::NoEditTriggers);
-    m_taskTableWidget->setAlternatingRowColors(true);
-
-    // 设置列宽
-    m_taskTableWidget->setColumnWidth(0, 80);
-    m_taskTableWidget->setColumnWidth(1, 150);
-    m_taskTableWidget->setColumnWidth(2, 100);
-    m_taskTableWidget->setColumnWidth(3, 80);
-    m_taskTableWidget->setColumnWidth(4, 80);
-    m_taskTableWidget->setColumnWidth(5, 150);
-    m_taskTableWidget->horizontalHeader()->setStretchLastSection(true);
-}
-
-void HistoryViewer::connectSignals()
-{
-    connect(m_searchButton, &QPushButton::clicked,
-            this, &HistoryViewer::onSearchClicked);
-    connect(m_refreshButton, &QPushButton::clicked,
-            this, &HistoryViewer::onRefreshClicked);
-    connect(m_viewButton, &QPushButton::clicked,
-            this, &HistoryViewer::onViewClicked);
-    connect(m_deleteButton, &QPushButton::clicked,
-            this, &HistoryViewer::onDeleteClicked);
-    connect(m_analyzeButton, &QPushButton::clicked,
-            this, &HistoryViewer::onAnalyzeClicked);
-    connect(m_closeButton, &QPushButton::clicked,
-            this, &QDialog::reject);
-    connect(m_taskTableWidget, &QTableWidget::itemSelectionChanged,
-            this, &HistoryViewer::onTableSelectionChanged);
-}
-
-void HistoryViewer::loadTasks()
-{
-    if (!m_dbManager || !m_dbManager->isConnected()) {
-        QMessageBox::warning(this, "警告", "数据库未连接");
-        return;
-    }
-
-    m_currentTasks = m_dbManager->getAllTasks();
-    updateTaskTable(m_currentTasks);
-}
-
-void HistoryViewer::updateTaskTable(const QVector<TaskInfo>& tasks)
-{
-    m_taskTableWidget->setRowCount(0);
-
-    for (int i = 0; i < tasks.size(); ++i) {
-        const TaskInfo& task = tasks[i];
-
-        int row = m_taskTableWidget->rowCount();
-        m_taskTableWidget->insertRow(row);
-
-        // 任务ID
-        QTableWidgetItem* idItem = new QTableWidgetItem(QString::number(task.taskId));
-        idItem->setTextAlignment(Qt::AlignCenter);
-        m_taskTableWidget->setItem(row, 0, idItem);
-
-        // 任务名称
-        QTableWidgetItem* nameItem = new QTableWidgetItem(task.taskName);
-        m_taskTableWidget->setItem(row, 1, nameItem);
-
-        // 采样率
-        QTableWidgetItem* rateItem = new QTableWidgetItem(QString::number(task.sampleRate, 'f', 1));
-        rateItem->setTextAlignment(Qt::AlignCenter);
-        m_taskTableWidget->setItem(row, 2, rateItem);
-
-        // 时长
-        QTableWidgetItem* durationItem = new QTableWidgetItem(QString::number(task.duration, 'f', 2));
-        durationItem->setTextAlignment(Qt::AlignCenter);
-        m_taskTableWidget->setItem(row, 3, durationItem);
-
-        // 通道数
-        QTableWidgetItem* channelItem = new QTableWidgetItem(QString::number(task.channelCount));
-        channelItem->setTextAlignment(Qt::AlignCenter);
-        m_taskTableWidget->setItem(row, 4, channelItem);
-
-        // 创建时间
-        QTableWidgetItem* timeItem = new QTableWidgetItem(task.createTime);
-        m_taskTableWidget->setItem(row, 5, timeItem);
-
-        // 描述
-        QTableWidgetItem* descItem = new QTableWidgetItem(task.description);
-        m_taskTableWidget->setItem(row, 6, descItem);
-    }
-
-    // 更新状态
-    m_statusLabel->setText(QString("共 %1 条记录").arg(tasks.size()));
-
-    // 默认禁用操作按钮
-    m_viewButton->setEnabled(false);
-    m_deleteButton->setEnabled(false);
-    m_analyzeButton->setEnabled(false);
-}
-
-void HistoryViewer::onSearchClicked()
-{
-    QString keyword = m_searchLineEdit->text().trimmed();
-
-    if (keyword.isEmpty()) {
-        loadTasks();
-        return;
-    }
-
-    if (!m_dbManager || !m_dbManager->isConnected()) {
-        QMessageBox::warning(this, "警告", "数据库未连接");
-        return;
-    }
-
-    m_currentTasks = m_dbManager->searchTasks(keyword);
-    updateTaskTable(m_currentTasks);
-
-    if (m_currentTasks.isEmpty()) {
-        m_statusLabel->setText("未找到匹配的记录");
-    }
-}
-
-void HistoryViewer::onRefreshClicked()
-{
-    m_searchLineEdit->clear();
-    loadTasks();
-}
-
-void HistoryViewer::onViewClicked()
-{
-    int currentRow = m_taskTableWidget->currentRow();
-    if (currentRow < 0 || currentRow >= m_currentTasks.size()) {
-        return;
-    }
-
-    int taskId = m_currentTasks[currentRow].taskId;
-
-    // 显示任务详情
-    showTaskDetails(taskId);
-
-    // 发出回放请求信号
-    emit replayRequested(taskId);
-
-    // 关闭对话框
-    accept();
-}
-
-void HistoryViewer::onDeleteClicked()
-{
-    int currentRow = m_taskTableWidget->currentRow();
-    if (currentRow < 0 || currentRow >= m_currentTasks.size()) {
-        return;
-    }
-
-    const TaskInfo& task = m_currentTasks[currentRow];
-
-    QMessageBox::StandardButton reply = QMessageBox::question(
-        this, "确认删除",
-        QString("确定要删除任务 '%1' 及其所有数据吗？\n此操作无法撤销！")
-            .arg(task.taskName),
-        QMessageBox::Yes | QMessageBox::No);
-
-    if (reply == QMessageBox::Yes) {
-        if (m_dbManager->deleteTask(task.taskId)) {
-            QMessageBox::information(this, "成功", "任务已删除");
-            loadTasks();
-        } else {
-            QMessageBox::critical(this, "错误",
-                                  QString("删除任务失败: %1").arg(m_dbManager->getLastError()));
-        }
-    }
-}
-
-void HistoryViewer::onAnalyzeClicked()
-{
-    int currentRow = m_taskTableWidget->currentRow();
-    if (currentRow < 0 || currentRow >= m_currentTasks.size()) {
-        return;
-    }
-
-    int taskId = m_currentTasks[currentRow].taskId;
-
-    // 获取分析结果
-    QVector<AnalysisResult> results = m_dbManager->getAnalysisResults(taskId);
-
-    if (results.isEmpty()) {
-        QMessageBox::information(this, "分析结果", "该任务暂无分析结果");
-        return;
-    }
-
-    // 显示分析结果
-    QString message = "=== 分析结果 ===\n\n";
-
-    for (const auto& result : results) {
-        message += QString("通道 %1:\n").arg(result.channel);
-        message += QString("  最大幅值: %1\n").arg(result.maxAmplitude);
-        message += QString("  最小幅值: %1\n").arg(result.minAmplitude);
-        message += QString("  平均幅值: %1\n").arg(result.avgAmplitude);
-        message += QString("  均方根值: %1\n").arg(result.rmsValue);
-        message += QString("  主频率: %1 Hz\n").arg(result.frequency);
-        message += QString("  分析时间: %1\n\n").arg(result.analysisTime);
-    }
-
-    QMessageBox::information(this, "分析结果", message);
-}
-
-void HistoryViewer::onTableSelectionChanged()
-{
-    bool hasSelection = m_taskTableWidget->currentRow() >= 0;
-    m_viewButton->setEnabled(hasSelection);
-    m_deleteButton->setEnabled(hasSelection);
-    m_analyzeButton->setEnabled(hasSelection);
-}
-
-void HistoryViewer::showTaskDetails(int taskId)
-{
-    if (!m_dbManager || !m_dbManager->isConnected()) {
-        return;
-    }
-
-    TaskInfo task = m_dbManager->getTask(taskId);
-
-    if (task.taskId < 0) {
-        QMessageBox::warning(this, "警告", "未找到任务信息");
-        return;
-    }
-
-    QString details = QString(
-                          "任务ID: %1\n"
-                          "任务名称: %2\n"
-                          "采样率: %3 Hz\n"
-                          "时长: %4 秒\n"
-                          "通道数: %5\n"
-                          "创建时间: %6\n"
-                          "描述: %7"
-                          ).arg(task.taskId)
-                          .arg(task.taskName)
-                          .arg(task.sampleRate)
-                          .arg(task.duration)
-                          .arg(task.channelCount)
-                          .arg(task.createTime)
-                          .arg(task.description.isEmpty() ? "无" : task.description);
-
-    qDebug() << "任务详情:" << details;
-}
+#include "historyviewer.h"
+#include "blockindex.h"
+#include "batchanalysisjob.h"
+#include "workstealingpool.h"
+#include <QMessageBox>
+#include <QInputDialog>
+#include <QElapsedTimer>
+#include <QProgressDialog>
+#include <QThread>
+#include <QEventLoop>
+#include <QDebug>
+#include <QHeaderView>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGroupBox>
+#include <limits>
+
+namespace {
+
+// 统计信息中按时间分段概览的段数
+const int STATISTICS_BUCKET_COUNT = 10;
+
+} // namespace
+
+HistoryViewer::HistoryViewer(DatabaseManager* dbManager, QWidget *parent)
+    : QDialog(parent)
+    , m_dbManager(dbManager)
+    , m_statisticsThread(nullptr)
+{
+    setWindowTitle("历史数据查看");
+    resize(900, 600);
+
+    // 创建UI控件
+    createWidgets();
+
+    // 设置布局
+    setupLayout();
+
+    // 设置表格
+    setupTableWidget();
+
+    // 连接信号槽
+    connectSignals();
+
+    // 加载任务列表
+    loadTasks();
+}
+
+HistoryViewer::~HistoryViewer()
+{
+    // 统计线程使用独立连接且会向本对象发信号，关闭前等待其结束
+    if (m_statisticsThread) {
+        m_statisticsThread->wait();
+        delete m_statisticsThread;
+    }
+}
+
+void HistoryViewer::createWidgets()
+{
+    // 搜索区域控件
+    m_searchLineEdit = new QLineEdit(this);
+    m_searchLineEdit->setPlaceholderText("输入任务名称或描述关键字...");
+
+    m_searchButton = new QPushButton("搜索", this);
+    m_refreshButton = new QPushButton("刷新", this);
+
+    m_dateFilterCheckBox = new QCheckBox("按创建日期", this);
+    m_fromDateEdit = new QDateEdit(QDate::currentDate().addMonths(-1), this);
+    m_toDateEdit = new QDateEdit(QDate::currentDate(), this);
+    m_fromDateEdit->setCalendarPopup(true);
+    m_toDateEdit->setCalendarPopup(true);
+    m_fromDateEdit->setEnabled(false);
+    m_toDateEdit->setEnabled(false);
+
+    // 表格控件
+    m_taskTableWidget = new QTableWidget(this);
+
+    // 操作按钮
+    m_viewButton = new QPushButton("查看/回放", this);
+    m_deleteButton = new QPushButton("删除", this);
+    m_analyzeButton = new QPushButton("分析结果", this);
+    m_rangeAnalyzeButton = new QPushButton("区间分析", this);
+    m_statisticsButton = new QPushButton("统计信息", this);
+    m_batchAnalyzeButton = new QPushButton("批量分析", this);
+    m_closeButton = new QPushButton("关闭", this);
+
+    // 状态标签
+    m_statusLabel = new QLabel("就绪", this);
+
+    // 初始状态
+    m_viewButton->setEnabled(false);
+    m_deleteButton->setEnabled(false);
+    m_analyzeButton->setEnabled(false);
+    m_rangeAnalyzeButton->setEnabled(false);
+    m_statisticsButton->setEnabled(false);
+}
+
+void HistoryViewer::setupLayout()
+{
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+
+    // 搜索区域
+    QGroupBox* searchGroup = new QGroupBox("搜索", this);
+    QHBoxLayout* searchLayout = new QHBoxLayout(searchGroup);
+    searchLayout->addWidget(m_searchLineEdit);
+    searchLayout->addWidget(m_dateFilterCheckBox);
+    searchLayout->addWidget(m_fromDateEdit);
+    searchLayout->addWidget(new QLabel("至", this));
+    searchLayout->addWidget(m_toDateEdit);
+    searchLayout->addWidget(m_searchButton);
+    searchLayout->addWidget(m_refreshButton);
+
+    mainLayout->addWidget(searchGroup);
+
+    // 表格区域
+    QGroupBox* tableGroup = new QGroupBox("任务列表", this);
+    QVBoxLayout* tableLayout = new QVBoxLayout(tableGroup);
+    tableLayout->addWidget(m_taskTableWidget);
+
+    mainLayout->addWidget(tableGroup);
+
+    // 操作按钮区域
+    QHBoxLayout* buttonLayout = new QHBoxLayout();
+    buttonLayout->addWidget(m_viewButton);
+    buttonLayout->addWidget(m_deleteButton);
+    buttonLayout->addWidget(m_analyzeButton);
+    buttonLayout->addWidget(m_rangeAnalyzeButton);
+    buttonLayout->addWidget(m_statisticsButton);
+    buttonLayout->addWidget(m_batchAnalyzeButton);
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(m_closeButton);
+
+    mainLayout->addLayout(buttonLayout);
+
+    // 状态栏
+    mainLayout->addWidget(m_statusLabel);
+
+    setLayout(mainLayout);
+}
+
+void HistoryViewer::setupTableWidget()
+{
+    // 设置表格列
+    m_taskTableWidget->setColumnCount(7);
+    QStringList headers;
+    headers << "任务ID" << "任务名称" << "采样率(Hz)"
+            << "时长(s)" << "通道数" << "创建时间" << "描述";
+    m_taskTableWidget->setHorizontalHeaderLabels(headers);
+
+    // 设置表格属性
+    m_taskTableWidget->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_taskTableWidget->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_taskTableWidget->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_taskTableWidget->setAlternatingRowColors(true);
+
+    // 设置列宽
+    m_taskTableWidget->setColumnWidth(0, 80);
+    m_taskTableWidget->setColumnWidth(1, 150);
+    m_taskTableWidget->setColumnWidth(2, 100);
+    m_taskTableWidget->setColumnWidth(3, 80);
+    m_taskTableWidget->setColumnWidth(4, 80);
+    m_taskTableWidget->setColumnWidth(5, 150);
+    m_taskTableWidget->horizontalHeader()->setStretchLastSection(true);
+}
+
+void HistoryViewer::connectSignals()
+{
+    connect(m_searchButton, &QPushButton::clicked,
+            this, &HistoryViewer::onSearchClicked);
+    connect(m_refreshButton, &QPushButton::clicked,
+            this, &HistoryViewer::onRefreshClicked);
+    connect(m_viewButton, &QPushButton::clicked,
+            this, &HistoryViewer::onViewClicked);
+    connect(m_deleteButton, &QPushButton::clicked,
+            this, &HistoryViewer::onDeleteClicked);
+    connect(m_analyzeButton, &QPushButton::clicked,
+            this, &HistoryViewer::onAnalyzeClicked);
+    connect(m_rangeAnalyzeButton, &QPushButton::clicked,
+            this, &HistoryViewer::onRangeAnalyzeClicked);
+    connect(m_statisticsButton, &QPushButton::clicked,
+            this, &HistoryViewer::onStatisticsClicked);
+    connect(m_batchAnalyzeButton, &QPushButton::clicked,
+            this, &HistoryViewer::onBatchAnalyzeClicked);
+    connect(m_dateFilterCheckBox, &QCheckBox::toggled,
+            m_fromDateEdit, &QDateEdit::setEnabled);
+    connect(m_dateFilterCheckBox, &QCheckBox::toggled,
+            m_toDateEdit, &QDateEdit::setEnabled);
+    connect(m_closeButton, &QPushButton::clicked,
+            this, &QDialog::reject);
+    connect(m_taskTableWidget, &QTableWidget::itemSelectionChanged,
+            this, &HistoryViewer::onTableSelectionChanged);
+    connect(this, &HistoryViewer::statisticsReady,
+            this, &HistoryViewer::onStatisticsReady, Qt::QueuedConnection);
+}
+
+void HistoryViewer::loadTasks()
+{
+    if (!m_dbManager || !m_dbManager->isConnected()) {
+        QMessageBox::warning(this, "警告", "数据库未连接");
+        return;
+    }
+
+    m_currentTasks = m_dbManager->getAllTasks();
+    updateTaskTable(m_currentTasks);
+}
+
+void HistoryViewer::updateTaskTable(const QVector<TaskInfo>& tasks)
+{
+    m_taskTableWidget->setRowCount(0);
+
+    for (int i = 0; i < tasks.size(); ++i) {
+        const TaskInfo& task = tasks[i];
+
+        int row = m_taskTableWidget->rowCount();
+        m_taskTableWidget->insertRow(row);
+
+        // 任务ID
+        QTableWidgetItem* idItem = new QTableWidgetItem(QString::number(task.taskId));
+        idItem->setTextAlignment(Qt::AlignCenter);
+        m_taskTableWidget->setItem(row, 0, idItem);
+
+        // 任务名称
+        QTableWidgetItem* nameItem = new QTableWidgetItem(task.taskName);
+        m_taskTableWidget->setItem(row, 1, nameItem);
+
+        // 采样率
+        QTableWidgetItem* rateItem = new QTableWidgetItem(QString::number(task.sampleRate, 'f', 1));
+        rateItem->setTextAlignment(Qt::AlignCenter);
+        m_taskTableWidget->setItem(row, 2, rateItem);
+
+        // 时长
+        QTableWidgetItem* durationItem = new QTableWidgetItem(QString::number(task.duration, 'f', 2));
+        durationItem->setTextAlignment(Qt::AlignCenter);
+        m_taskTableWidget->setItem(row, 3, durationItem);
+
+        // 通道数
+        QTableWidgetItem* channelItem = new QTableWidgetItem(QString::number(task.channelCount));
+        channelItem->setTextAlignment(Qt::AlignCenter);
+        m_taskTableWidget->setItem(row, 4, channelItem);
+
+        // 创建时间
+        QTableWidgetItem* timeItem = new QTableWidgetItem(task.createTime);
+        m_taskTableWidget->setItem(row, 5, timeItem);
+
+        // 描述
+        QTableWidgetItem* descItem = new QTableWidgetItem(task.description);
+        m_taskTableWidget->setItem(row, 6, descItem);
+    }
+
+    // 更新状态
+    m_statusLabel->setText(QString("共 %1 条记录").arg(tasks.size()));
+
+    // 默认禁用操作按钮
+    m_viewButton->setEnabled(false);
+    m_deleteButton->setEnabled(false);
+    m_analyzeButton->setEnabled(false);
+    m_rangeAnalyzeButton->setEnabled(false);
+    m_statisticsButton->setEnabled(false);
+}
+
+void HistoryViewer::onSearchClicked()
+{
+    QString keyword = m_searchLineEdit->text().trimmed();
+    bool filterByDate = m_dateFilterCheckBox->isChecked();
+
+    if (keyword.isEmpty() && !filterByDate) {
+        loadTasks();
+        return;
+    }
+
+    if (!m_dbManager || !m_dbManager->isConnected()) {
+        QMessageBox::warning(this, "警告", "数据库未连接");
+        return;
+    }
+
+    if (filterByDate) {
+        // 结束日期当天也包含在内
+        QDateTime from(m_fromDateEdit->date(), QTime(0, 0));
+        QDateTime to(m_toDateEdit->date().addDays(1), QTime(0, 0));
+        m_currentTasks = m_dbManager->searchTasks(keyword, from, to);
+    } else {
+        m_currentTasks = m_dbManager->searchTasks(keyword);
+    }
+    updateTaskTable(m_currentTasks);
+
+    if (m_currentTasks.isEmpty()) {
+        m_statusLabel->setText("未找到匹配的记录");
+    }
+}
+
+void HistoryViewer::onRefreshClicked()
+{
+    m_searchLineEdit->clear();
+    m_dateFilterCheckBox->setChecked(false);
+    loadTasks();
+}
+
+void HistoryViewer::onViewClicked()
+{
+    int currentRow = m_taskTableWidget->currentRow();
+    if (currentRow < 0 || currentRow >= m_currentTasks.size()) {
+        return;
+    }
+
+    int taskId = m_currentTasks[currentRow].taskId;
+
+    // 显示任务详情
+    showTaskDetails(taskId);
+
+    // 发出回放请求信号
+    emit replayRequested(taskId);
+
+    // 关闭对话框
+    accept();
+}
+
+void HistoryViewer::onDeleteClicked()
+{
+    int currentRow = m_taskTableWidget->currentRow();
+    if (currentRow < 0 || currentRow >= m_currentTasks.size()) {
+        return;
+    }
+
+    const TaskInfo& task = m_currentTasks[currentRow];
+
+    QMessageBox::StandardButton reply = QMessageBox::question(
+        this, "确认删除",
+        QString("确定要删除任务 '%1' 及其所有数据吗？\n此操作无法撤销！")
+            .arg(task.taskName),
+        QMessageBox::Yes | QMessageBox::No);
+
+    if (reply == QMessageBox::Yes) {
+        if (m_dbManager->deleteTask(task.taskId)) {
+            AnalysisResultCache::globalInstance()->invalidateTask(task.taskId);
+            QMessageBox::information(this, "成功", "任务已删除");
+            loadTasks();
+        } else {
+            QMessageBox::critical(this, "错误",
+                                  QString("删除任务失败: %1").arg(m_dbManager->getLastError()));
+        }
+    }
+}
+
+void HistoryViewer::onAnalyzeClicked()
+{
+    int currentRow = m_taskTableWidget->currentRow();
+    if (currentRow < 0 || currentRow >= m_currentTasks.size()) {
+        return;
+    }
+
+    int taskId = m_currentTasks[currentRow].taskId;
+
+    // 获取分析结果
+    QVector<AnalysisResult> results = m_dbManager->getAnalysisResults(taskId);
+
+    // 没有保存过分析结果时由块级索引合并得到，不再重新遍历原始数据
+    if (results.isEmpty()) {
+        results = analyzeFromIndex(m_currentTasks[currentRow], true);
+    }
+
+    if (results.isEmpty()) {
+        QMessageBox::information(this, "分析结果", "该任务暂无分析结果");
+        return;
+    }
+
+    // 显示分析结果
+    QString message = "=== 分析结果 ===\n\n";
+
+    for (const auto& result : results) {
+        message += QString("通道 %1:\n").arg(result.channel);
+        message += QString("  最大幅值: %1\n").arg(result.maxAmplitude);
+        message += QString("  最小幅值: %1\n").arg(result.minAmplitude);
+        message += QString("  平均幅值: %1\n").arg(result.avgAmplitude);
+        message += QString("  均方根值: %1\n").arg(result.rmsValue);
+        message += QString("  主频率: %1 Hz\n").arg(result.frequency);
+        message += QString("  分析时间: %1\n\n").arg(result.analysisTime);
+    }
+
+    QMessageBox::information(this, "分析结果", message);
+}
+
+void HistoryViewer::onRangeAnalyzeClicked()
+{
+    int currentRow = m_taskTableWidget->currentRow();
+    if (currentRow < 0 || currentRow >= m_currentTasks.size()) {
+        return;
+    }
+
+    const TaskInfo& task = m_currentTasks[currentRow];
+
+    bool ok = false;
+    double startTime = QInputDialog::getDouble(this, "区间分析", "起始时间(s):",
+                                               0.0, -1e9, 1e9, 3, &ok);
+    if (!ok) {
+        return;
+    }
+    double endTime = QInputDialog::getDouble(this, "区间分析", "结束时间(s):",
+                                             startTime + task.duration, startTime, 1e9, 3, &ok);
+    if (!ok) {
+        return;
+    }
+
+    QVector<AnalysisResult> results = analyzeFromIndex(task, false, startTime, endTime);
+    if (results.isEmpty()) {
+        QMessageBox::information(this, "区间分析", "该时间区间内没有数据");
+        return;
+    }
+
+    QString message = QString("=== 区间分析 %1 s - %2 s ===\n\n").arg(startTime).arg(endTime);
+
+    for (const auto& result : results) {
+        message += QString("通道 %1:\n").arg(result.channel);
+        message += QString("  最大幅值: %1\n").arg(result.maxAmplitude);
+        message += QString("  最小幅值: %1\n").arg(result.minAmplitude);
+        message += QString("  平均幅值: %1\n").arg(result.avgAmplitude);
+        message += QString("  均方根值: %1\n").arg(result.rmsValue);
+        message += QString("  主频率: %1 Hz\n\n").arg(result.frequency);
+    }
+
+    QMessageBox::information(this, "区间分析", message);
+}
+
+void HistoryViewer::onStatisticsClicked()
+{
+    int currentRow = m_taskTableWidget->currentRow();
+    if (currentRow < 0 || currentRow >= m_currentTasks.size() || m_statisticsThread) {
+        return;
+    }
+
+    const TaskInfo task = m_currentTasks[currentRow];
+
+    // 统计量在数据库端聚合，不加载原始数据；旧任务没有块级索引时仍需扫描整个通道，
+    // 因此放在独立线程和独立数据库连接中进行，结果通过 statisticsReady 信号交回界面线程
+    DatabaseManager* source = m_dbManager;
+    m_statisticsThread = QThread::create([this, source, task]() {
+        QElapsedTimer timer;
+        timer.start();
+
+        QMap<int, SignalStatistics> statistics;
+        QMap<int, QVector<BucketStatistics>> buckets;
+
+        DatabaseManager db;
+        if (db.connectLike(source, QString("statistics_%1").arg(task.taskId))) {
+            statistics = db.getTaskStatistics(task.taskId);
+
+            // 按录制时长等分的时间段概览
+            double bucketWidth = task.duration / STATISTICS_BUCKET_COUNT;
+            if (bucketWidth > 0) {
+                for (auto it = statistics.constBegin(); it != statistics.constEnd(); ++it) {
+                    buckets.insert(it.key(), db.getBucketStatistics(
+                        task.taskId, it.key(), bucketWidth,
+                        std::numeric_limits<double>::lowest(),
+                        std::numeric_limits<double>::max()));
+                }
+            }
+        } else {
+            qWarning() << "统计连接数据库失败:" << db.getLastError();
+        }
+
+        emit statisticsReady(task.taskId, statistics, buckets, timer.elapsed());
+    });
+
+    connect(m_statisticsThread, &QThread::finished, this, [this]() {
+        m_statisticsThread->wait();
+        delete m_statisticsThread;
+        m_statisticsThread = nullptr;
+        onTableSelectionChanged();
+    });
+
+    m_statisticsButton->setEnabled(false);
+    m_statusLabel->setText(QString("正在统计任务 %1...").arg(task.taskId));
+    m_statisticsThread->start();
+}
+
+void HistoryViewer::onStatisticsReady(int taskId, const QMap<int, SignalStatistics>& statistics,
+                                      const QMap<int, QVector<BucketStatistics>>& buckets,
+                                      qint64 elapsedMs)
+{
+    if (statistics.isEmpty()) {
+        m_statusLabel->setText(QString("任务 %1 没有数据").arg(taskId));
+        QMessageBox::information(this, "统计信息", "该任务没有数据");
+        return;
+    }
+
+    QString message = QString("=== 任务 %1 统计信息 ===\n\n").arg(taskId);
+
+    for (auto it = statistics.constBegin(); it != statistics.constEnd(); ++it) {
+        const SignalStatistics& stats = it.value();
+        message += QString("通道 %1:\n").arg(it.key());
+        message += QString("  点数: %1\n").arg(stats.count);
+        message += QString("  最大幅值: %1\n").arg(stats.max);
+        message += QString("  最小幅值: %1\n").arg(stats.min);
+        message += QString("  平均幅值: %1\n").arg(stats.average());
+        message += QString("  均方根值: %1\n").arg(stats.rms());
+        message += QString("  标准差: %1\n").arg(stats.stdDev());
+
+        const QVector<BucketStatistics> channelBuckets = buckets.value(it.key());
+        if (!channelBuckets.isEmpty()) {
+            message += "  分段概览（时间: 平均 / 均方根 / 峰峰值）:\n";
+            for (const BucketStatistics& bucket : channelBuckets) {
+                message += QString("    %1 - %2 s: %3 / %4 / %5\n")
+                               .arg(bucket.bucketStart, 0, 'f', 2)
+                               .arg(bucket.bucketEnd, 0, 'f', 2)
+                               .arg(bucket.stats.average(), 0, 'g', 5)
+                               .arg(bucket.stats.rms(), 0, 'g', 5)
+                               .arg(bucket.stats.peakToPeak(), 0, 'g', 5);
+            }
+        }
+        message += "\n";
+    }
+
+    m_statusLabel->setText(QString("统计 %1 个通道，耗时 %2 ms")
+                               .arg(statistics.size()).arg(elapsedMs));
+    QMessageBox::information(this, "统计信息", message);
+}
+
+void HistoryViewer::onBatchAnalyzeClicked()
+{
+    if (!m_dbManager || !m_dbManager->isConnected()) {
+        QMessageBox::warning(this, "警告", "数据库未连接");
+        return;
+    }
+
+    int jobId = -1;
+
+    // 优先继续上次未完成的作业
+    QVector<BatchJobInfo> unfinished = m_dbManager->getUnfinishedBatchJobs();
+    if (!unfinished.isEmpty()) {
+        const BatchJobInfo& job = unfinished.first();
+        QMessageBox::StandardButton reply = QMessageBox::question(
+            this, "批量分析",
+            QString("存在未完成的批量分析作业 \"%1\"（已完成 %2/%3），是否继续？")
+                .arg(job.jobName).arg(job.completedTasks).arg(job.totalTasks),
+            QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel);
+        if (reply == QMessageBox::Cancel) {
+            return;
+        }
+        if (reply == QMessageBox::Yes) {
+            jobId = job.jobId;
+        }
+    }
+
+    if (jobId < 0) {
+        if (m_currentTasks.isEmpty()) {
+            QMessageBox::information(this, "批量分析", "当前列表中没有任务");
+            return;
+        }
+
+        QMessageBox::StandardButton reply = QMessageBox::question(
+            this, "批量分析",
+            QString("对当前列表中的 %1 个任务进行批量分析？").arg(m_currentTasks.size()),
+            QMessageBox::Yes | QMessageBox::No);
+        if (reply != QMessageBox::Yes) {
+            return;
+        }
+
+        QVector<int> taskIds;
+        for (const TaskInfo& task : m_currentTasks) {
+            taskIds.append(task.taskId);
+        }
+
+        jobId = m_dbManager->createBatchJob(
+            QString("批量分析_%1").arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")),
+            taskIds);
+        if (jobId < 0) {
+            QMessageBox::critical(this, "错误",
+                                  QString("创建批量分析作业失败: %1").arg(m_dbManager->getLastError()));
+            return;
+        }
+    }
+
+    BatchJobInfo job = m_dbManager->getBatchJob(jobId);
+
+    // 作业在独立线程中运行，取消只设置标志，当前数据块处理完后停止
+    QThread* thread = new QThread();
+    BatchAnalysisJob* batchJob = new BatchAnalysisJob(m_dbManager,
+                                                      WorkStealingPool::globalInstance());
+    batchJob->moveToThread(thread);
+
+    QProgressDialog progress("正在批量分析...", "取消", 0, job.totalTasks, this);
+    progress.setWindowTitle("批量分析");
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(0);
+    progress.setAutoClose(false);
+    progress.setAutoReset(false);
+    progress.setValue(job.completedTasks);
+
+    // QProgressDialog 响应取消（按钮、Esc 或关闭窗口）时会先隐藏自身，这里重新显示，
+    // 一直等到作业线程真正结束才关闭对话框，避免在 GUI 线程中阻塞等待
+    connect(&progress, &QProgressDialog::canceled, this, [batchJob, &progress]() {
+        batchJob->cancel();
+        progress.setLabelText("正在取消，等待当前数据块处理完成...");
+        progress.show();
+    });
+    connect(batchJob, &BatchAnalysisJob::progressUpdated, &progress,
+            [&progress](int completedTasks, int totalTasks, qint64 sampleCount,
+                        double samplesPerSecond, const QString& message) {
+                if (progress.wasCanceled()) {
+                    return;
+                }
+                progress.setValue(completedTasks);
+                progress.setLabelText(QString("%1\n已分析 %2/%3 个任务，%4 个样本，%5 样本/秒")
+                                          .arg(message).arg(completedTasks).arg(totalTasks)
+                                          .arg(sampleCount).arg(samplesPerSecond, 0, 'f', 0));
+            });
+
+    // 作业结束（完成、出错或响应取消）后退出线程，线程结束时才关闭对话框
+    QEventLoop loop;
+    connect(batchJob, &BatchAnalysisJob::finished, thread, &QThread::quit);
+    connect(thread, &QThread::finished, &loop, &QEventLoop::quit);
+
+    thread->start();
+    QMetaObject::invokeMethod(batchJob, "run", Qt::QueuedConnection, Q_ARG(int, jobId));
+    progress.show();
+    loop.exec();
+    thread->wait();
+    progress.close();
+
+    QString message = batchJob->resultMessage();
+    bool completed = batchJob->isCompleted();
+    delete batchJob;
+    delete thread;
+
+    m_statusLabel->setText(message);
+    if (completed) {
+        QMessageBox::information(this, "批量分析", message);
+    } else {
+        QMessageBox::warning(this, "批量分析", message);
+    }
+}
+
+QVector<AnalysisResult> HistoryViewer::analyzeFromIndex(const TaskInfo& task, bool wholeRecording,
+                                                        double startTime, double endTime)
+{
+    QVector<AnalysisResult> results;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // 旧任务没有索引时需要分页读取全部原始数据补建，放在独立线程和独立数据库连接中进行
+    DatabaseManager* source = m_dbManager;
+    QThread* thread = QThread::create([&results, source, task, wholeRecording, startTime, endTime]() {
+        DatabaseManager db;
+        if (!db.connectLike(source, QString("index_analysis_%1").arg(task.taskId))) {
+            qWarning() << "索引分析连接数据库失败:" << db.getLastError();
+            return;
+        }
+
+        QVector<int> channels = db.getTaskChannels(task.taskId);
+        for (int channel : channels) {
+            bool ok = false;
+            AnalysisResult result = wholeRecording
+                ? BlockIndex::analyzeRecording(&db, task.taskId, channel, task.sampleRate, &ok)
+                : BlockIndex::analyzeRange(&db, task.taskId, channel,
+                                           task.sampleRate, startTime, endTime, &ok);
+            if (ok) {
+                results.append(result);
+            }
+        }
+    });
+
+    // 等待期间界面保持响应；对话框没有取消按钮，只随线程结束关闭
+    QProgressDialog progress("正在由分析索引计算...", QString(), 0, 0, this);
+    progress.setWindowTitle("分析");
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(500);
+    progress.setAutoClose(false);
+    progress.setAutoReset(false);
+
+    QEventLoop loop;
+    connect(thread, &QThread::finished, &loop, &QEventLoop::quit);
+    thread->start();
+    loop.exec();
+    thread->wait();
+    delete thread;
+    progress.close();
+
+    m_statusLabel->setText(QString("由分析索引计算 %1 个通道，耗时 %2 ms")
+                               .arg(results.size()).arg(timer.elapsed()));
+    return results;
+}
+
+void HistoryViewer::onTableSelectionChanged()
+{
+    bool hasSelection = m_taskTableWidget->currentRow() >= 0;
+    m_viewButton->setEnabled(hasSelection);
+    m_deleteButton->setEnabled(hasSelection);
+    m_analyzeButton->setEnabled(hasSelection);
+    m_rangeAnalyzeButton->setEnabled(hasSelection);
+    m_statisticsButton->setEnabled(hasSelection && !m_statisticsThread);
+}
+
+void HistoryViewer::showTaskDetails(int taskId)
+{
+    if (!m_dbManager || !m_dbManager->isConnected()) {
+        return;
+    }
+
+    TaskInfo task = m_dbManager->getTask(taskId);
+
+    if (task.taskId < 0) {
+        QMessageBox::warning(this, "警告", "未找到任务信息");
+        return;
+    }
+
+    QString details = QString(
+                          "任务ID: %1\n"
+                          "任务名称: %2\n"
+                          "采样率: %3 Hz\n"
+                          "时长: %4 秒\n"
+                          "通道数: %5\n"
+                          "创建时间: %6\n"
+                          "描述: %7"
+                          ).arg(task.taskId)
+                          .arg(task.taskName)
+                          .arg(task.sampleRate)
+                          .arg(task.duration)
+                          .arg(task.channelCount)
+                          .arg(task.createTime)
+                          .arg(task.description.isEmpty() ? "无" : task.description);
+
+    qDebug() << "任务详情:" << details;
+}
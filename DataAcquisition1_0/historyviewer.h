@@ -1,57 +1,78 @@
-#ifndef HISTORYVIEWER_H
-#define HISTORYVIEWER_H
-
-#include <QDialog>
-#include <QTableWidget>
-#include <QPushButton>
-#include <QLineEdit>
-#include <QLabel>
-#include "databasemanager.h"
-#include "waveformwidget.h"
-
-class HistoryViewer : public QDialog
-{
-    Q_OBJECT
-
-public:
-    explicit HistoryViewer(DatabaseManager* dbManager, QWidget *parent = nullptr);
-    ~HistoryViewer();
-
-signals:
-    void taskSelected(int taskId);
-    void replayRequested(int taskId);
-
-private slots:
-    void onSearchClicked();
-    void onRefreshClicked();
-    void onViewClicked();
-    void onDeleteClicked();
-    void onAnalyzeClicked();
-    void onTableSelectionChanged();
-
-private:
-    void createWidgets();
-    void setupLayout();
-    void setupTableWidget();
-    void connectSignals();
-    void loadTasks();
-    void updateTaskTable(const QVector<TaskInfo>& tasks);
-    void showTaskDetails(int taskId);
-
-    // UI控件
-    QLineEdit* m_searchLineEdit;
-    QPushButton* m_searchButton;
-    QPushButton* m_refreshButton;
-    QTableWidget* m_taskTableWidget;
-    QPushButton* m_viewButton;
-    QPushButton* m_deleteButton;
-    QPushButton* m_analyzeButton;
-    QPushButton* m_closeButton;
-    QLabel* m_statusLabel;
-
-    // 数据
-    DatabaseManager* m_dbManager;
-    QVector<TaskInfo> m_currentTasks;
-};
-
-#endif // HISTORYVIEWER_H
+#ifndef HISTORYVIEWER_H
+#define HISTORYVIEWER_H
+
+#include <QDialog>
+#include <QTableWidget>
+#include <QPushButton>
+#include <QLineEdit>
+#include <QLabel>
+#include <QCheckBox>
+#include <QDateEdit>
+#include <QMap>
+#include "databasemanager.h"
+#include "waveformwidget.h"
+
+class HistoryViewer : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit HistoryViewer(DatabaseManager* dbManager, QWidget *parent = nullptr);
+    ~HistoryViewer();
+
+signals:
+    void taskSelected(int taskId);
+    void replayRequested(int taskId);
+    // 统计线程完成后发出（由统计线程发出，排队到界面线程处理）
+    void statisticsReady(int taskId, const QMap<int, SignalStatistics>& statistics,
+                         const QMap<int, QVector<BucketStatistics>>& buckets, qint64 elapsedMs);
+
+private slots:
+    void onSearchClicked();
+    void onRefreshClicked();
+    void onViewClicked();
+    void onDeleteClicked();
+    void onAnalyzeClicked();
+    void onRangeAnalyzeClicked();
+    void onStatisticsClicked();
+    void onBatchAnalyzeClicked();
+    void onTableSelectionChanged();
+    void onStatisticsReady(int taskId, const QMap<int, SignalStatistics>& statistics,
+                           const QMap<int, QVector<BucketStatistics>>& buckets, qint64 elapsedMs);
+
+private:
+    void createWidgets();
+    void setupLayout();
+    void setupTableWidget();
+    void connectSignals();
+    void loadTasks();
+    void updateTaskTable(const QVector<TaskInfo>& tasks);
+    void showTaskDetails(int taskId);
+    // 由块级分析索引计算各通道在 [startTime, endTime] 内的分析结果，wholeRecording 为 true 时分析整段
+    QVector<AnalysisResult> analyzeFromIndex(const TaskInfo& task, bool wholeRecording,
+                                             double startTime = 0.0, double endTime = 0.0);
+
+    // UI控件
+    QLineEdit* m_searchLineEdit;
+    QPushButton* m_searchButton;
+    QPushButton* m_refreshButton;
+    QCheckBox* m_dateFilterCheckBox;
+    QDateEdit* m_fromDateEdit;
+    QDateEdit* m_toDateEdit;
+    QTableWidget* m_taskTableWidget;
+    QPushButton* m_viewButton;
+    QPushButton* m_deleteButton;
+    QPushButton* m_analyzeButton;
+    QPushButton* m_rangeAnalyzeButton;
+    QPushButton* m_statisticsButton;
+    QPushButton* m_batchAnalyzeButton;
+    QPushButton* m_closeButton;
+    QLabel* m_statusLabel;
+
+    // 数据
+    DatabaseManager* m_dbManager;
+    QVector<TaskInfo> m_currentTasks;
+    QThread* m_statisticsThread;    // 正在运行的统计线程，同一时间只有一个
+};
+
+#endif // HISTORYVIEWER_H
@@ -1,155 +1,359 @@
-#include "jsonexporter.h"
-#include <QFile>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
-#include <QDebug>
-#include <QFileInfo>
-#include <QDir>
-
-JsonExporter::JsonExporter(QObject *parent)
-    : QObject(parent)
-{
-}
-
-JsonExporter::~JsonExporter()
-{
-}
-
-bool JsonExporter::exportChannelToJson(const QString& filePath,
-                                       int channel,
-                                       const QVector<DataPoint>& data)
-{
-    if (data.isEmpty()) {
-        m_lastError = "数据为空";
-        return false;
-    }
-
-    emit exportProgress(10, "准备导出单通道数据...");
-
-    QJsonObject root;
-    root[QString::number(channel)] = convertToJsonArray(data);
-
-    emit exportProgress(50, "生成JSON文档...");
-
-    QJsonDocument doc(root);
-    QByteArray jsonData = doc.toJson(QJsonDocument::Indented);
-
-    emit exportProgress(70, "写入文件...");
-
-    // 确保目录存在
-    QFileInfo fileInfo(filePath);
-    QDir dir = fileInfo.absoluteDir();
-    if (!dir.exists()) {
-        dir.mkpath(".");
-    }
-
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        m_lastError = QString("无法打开文件: %1").arg(file.errorString());
-        return false;
-    }
-
-    qint64 written = file.write(jsonData);
-    file.close();
-
-    if (written < 0) {
-        m_lastError = "写入文件失败";
-        return false;
-    }
-
-    emit exportProgress(100, "导出完成");
-    qDebug() << "JSON文件已保存到:" << filePath;
-    return true;
-}
-
-bool JsonExporter::exportMultiChannelToJson(const QString& filePath,
-                                            const QVector<int>& channels,
-                                            const QVector<QVector<DataPoint>>& channelData)
-{
-    if (channels.size() != channelData.size()) {
-        m_lastError = "通道数量与数据数量不匹配";
-        return false;
-    }
-
-    if (channels.isEmpty()) {
-        m_lastError = "没有数据要导出";
-        return false;
-    }
-
-    emit exportProgress(10, "准备导出多通道数据...");
-
-    // 创建JSON对象，格式参照iio_1.py
-    QJsonObject root;
-
-    int totalChannels = channels.size();
-    for (int i = 0; i < totalChannels; ++i) {
-        int channelIndex = channels[i];
-        const QVector<DataPoint>& data = channelData[i];
-
-        if (!data.isEmpty()) {
-            // 使用通道索引作为键（字符串格式）
-            root[QString::number(channelIndex)] = convertToJsonArray(data);
-        }
-
-        int progress = 10 + (i * 60 / totalChannels);
-        emit exportProgress(progress,
-                            QString("处理通道 %1...").arg(channelIndex));
-    }
-
-    emit exportProgress(70, "生成JSON文档...");
-
-    QJsonDocument doc(root);
-    QByteArray jsonData = doc.toJson(QJsonDocument::Indented);
-
-    emit exportProgress(80, "写入文件...");
-
-    // 确保目录存在
-    QFileInfo fileInfo(filePath);
-    QDir dir = fileInfo.absoluteDir();
-    if (!dir.exists()) {
-        dir.mkpath(".");
-    }
-
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        m_lastError = QString("无法打开文件: %1").arg(file.errorString());
-        return false;
-    }
-
-    qint64 written = file.write(jsonData);
-    file.close();
-
-    if (written < 0) {
-        m_lastError = "写入文件失败";
-        return false;
-    }
-
-    emit exportProgress(100, "导出完成");
-
-    qDebug() << "多通道JSON文件已保存到:" << filePath;
-    qDebug() << "文件大小:" << jsonData.size() << "字节";
-    qDebug() << "包含通道数:" << channels.size();
-
-    emit exportCompleted(true, QString("成功导出 %1 个通道的数据").arg(channels.size()));
-    return true;
-}
-
-bool JsonExporter::exportTaskToJson(const QString& filePath,
-                                    const TaskInfo& taskInfo,
-                                    const QVector<QVector<DataPoint>>& channelData)
-{
-    return exportMultiChannelToJson(filePath, taskInfo.enabledChannels, channelData);
-}
-
-QJsonArray JsonExporter::convertToJsonArray(const QVector<DataPoint>& data)
-{
-    QJsonArray array;
-
-    // 只保存幅值数据，与iio_1.py的格式保持一致
-    for (const auto& point : data) {
-        array.append(point.amplitude);
-    }
-
-    return array;
-}
+#include "jsonexporter.h"
+#include <QSaveFile>
+#include <QDebug>
+#include <QFileInfo>
+#include <QDir>
+#include <QElapsedTimer>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// 写缓冲区大小：缓冲满时一次写入文件
+const int WRITE_BUFFER_SIZE = 1 << 20;
+// 单个数值的最大输出长度（含分隔符和缩进）
+const int MAX_VALUE_LENGTH = 64;
+// 从数据库导出时每页读取的样本数
+const int EXPORT_PAGE_SIZE = 65536;
+
+// 最短往返格式：解析回来与原值完全相同的最短十进制表示
+// NaN/Inf 不是合法的JSON数值，与 QJsonDocument 一样写为 null
+inline int formatDouble(char* out, double value)
+{
+    if (!std::isfinite(value)) {
+        std::memcpy(out, "null", 4);
+        return 4;
+    }
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    std::to_chars_result result = std::to_chars(out, out + 32, value);
+    return static_cast<int>(result.ptr - out);
+#else
+    // 编译器不支持浮点 to_chars 时退回17位有效数字（同样可以无损往返）
+    return qsnprintf(out, 32, "%.17g", value);
+#endif
+}
+
+} // namespace
+
+// 流式JSON写入器 - 只支持导出需要的 {"键": [数值, ...], ...} 结构
+// 输出与 QJsonDocument::toJson 的缩进/紧凑格式一致
+class JsonStreamWriter
+{
+public:
+    JsonStreamWriter(QIODevice* device, bool compact)
+        : m_device(device)
+        , m_compact(compact)
+        , m_buffer(WRITE_BUFFER_SIZE)
+        , m_used(0)
+        , m_firstMember(true)
+        , m_firstValue(true)
+        , m_error(false)
+        , m_bytesWritten(0)
+    {
+    }
+
+    void beginDocument()
+    {
+        append("{", 1);
+    }
+
+    void beginArray(const QString& key)
+    {
+        QByteArray name = key.toUtf8();
+        ensure(name.size() + 16);
+        if (!m_firstMember) {
+            append(",", 1);
+        }
+        if (!m_compact) {
+            append("\n    ", 5);
+        }
+        append("\"", 1);
+        append(name.constData(), name.size());
+        append(m_compact ? "\":[" : "\": [", m_compact ? 3 : 4);
+        m_firstMember = false;
+        m_firstValue = true;
+    }
+
+    // 写入一段幅值
+    void writeValues(const DataPoint* data, int count)
+    {
+        for (int i = 0; i < count; ++i) {
+            if (m_used + MAX_VALUE_LENGTH > WRITE_BUFFER_SIZE && !flush()) {
+                return;
+            }
+
+            char* out = m_buffer.data() + m_used;
+            if (!m_firstValue) {
+                *out++ = ',';
+            }
+            if (!m_compact) {
+                std::memcpy(out, "\n        ", 9);
+                out += 9;
+            }
+            out += formatDouble(out, data[i].amplitude);
+
+            m_used = static_cast<int>(out - m_buffer.data());
+            m_firstValue = false;
+        }
+    }
+
+    void endArray()
+    {
+        if (m_compact) {
+            append("]", 1);
+        } else {
+            append("\n    ]", 6);
+        }
+    }
+
+    bool endDocument()
+    {
+        if (m_compact) {
+            append("}", 1);
+        } else {
+            append("\n}\n", 3);
+        }
+        return flush();
+    }
+
+    bool hasError() const { return m_error; }
+    qint64 bytesWritten() const { return m_bytesWritten + m_used; }
+
+private:
+    void ensure(int bytes)
+    {
+        if (m_used + bytes > WRITE_BUFFER_SIZE) {
+            flush();
+        }
+    }
+
+    void append(const char* text, int length)
+    {
+        ensure(length);
+        if (length > WRITE_BUFFER_SIZE - m_used) {
+            // 超长的键直接写入
+            if (m_device->write(text, length) != length) {
+                m_error = true;
+            }
+            m_bytesWritten += length;
+            return;
+        }
+        std::memcpy(m_buffer.data() + m_used, text, length);
+        m_used += length;
+    }
+
+    bool flush()
+    {
+        if (m_error) {
+            return false;
+        }
+        if (m_used > 0) {
+            if (m_device->write(m_buffer.data(), m_used) != m_used) {
+                m_error = true;
+                return false;
+            }
+            m_bytesWritten += m_used;
+            m_used = 0;
+        }
+        return true;
+    }
+
+    QIODevice* m_device;
+    bool m_compact;
+    std::vector<char> m_buffer;
+    int m_used;
+    bool m_firstMember;
+    bool m_firstValue;
+    bool m_error;
+    qint64 m_bytesWritten;
+};
+
+JsonExporter::JsonExporter(QObject *parent)
+    : QObject(parent)
+    , m_format(Indented)
+{
+}
+
+JsonExporter::~JsonExporter()
+{
+}
+
+bool JsonExporter::exportChannelToJson(const QString& filePath,
+                                       int channel,
+                                       const QVector<DataPoint>& data)
+{
+    if (data.isEmpty()) {
+        m_lastError = "数据为空";
+        return false;
+    }
+
+    emit exportProgress(10, "准备导出单通道数据...");
+
+    QVector<int> channels;
+    channels.append(channel);
+
+    bool success = writeJson(filePath, channels, [&data](int, JsonStreamWriter& writer) {
+        writer.writeValues(data.constData(), data.size());
+        return !writer.hasError();
+    });
+
+    if (success) {
+        qDebug() << "JSON文件已保存到:" << filePath;
+    }
+    return success;
+}
+
+bool JsonExporter::exportMultiChannelToJson(const QString& filePath,
+                                            const QVector<int>& channels,
+                                            const QVector<QVector<DataPoint>>& channelData)
+{
+    if (channels.size() != channelData.size()) {
+        m_lastError = "通道数量与数据数量不匹配";
+        return false;
+    }
+
+    if (channels.isEmpty()) {
+        m_lastError = "没有数据要导出";
+        return false;
+    }
+
+    emit exportProgress(10, "准备导出多通道数据...");
+
+    // 空通道不写入，与原来的格式保持一致
+    QVector<int> exportedChannels;
+    QVector<int> dataIndices;
+    for (int i = 0; i < channels.size(); ++i) {
+        if (!channelData[i].isEmpty()) {
+            exportedChannels.append(channels[i]);
+            dataIndices.append(i);
+        }
+    }
+
+    bool success = writeJson(filePath, exportedChannels,
+                             [&](int index, JsonStreamWriter& writer) {
+        const QVector<DataPoint>& data = channelData[dataIndices[index]];
+        writer.writeValues(data.constData(), data.size());
+        return !writer.hasError();
+    });
+
+    if (!success) {
+        emit exportCompleted(false, m_lastError);
+        return false;
+    }
+
+    qDebug() << "多通道JSON文件已保存到:" << filePath;
+    qDebug() << "包含通道数:" << channels.size();
+
+    emit exportCompleted(true, QString("成功导出 %1 个通道的数据").arg(channels.size()));
+    return true;
+}
+
+bool JsonExporter::exportTaskToJson(const QString& filePath,
+                                    const TaskInfo& taskInfo,
+                                    const QVector<QVector<DataPoint>>& channelData)
+{
+    return exportMultiChannelToJson(filePath, taskInfo.enabledChannels, channelData);
+}
+
+bool JsonExporter::exportStoredTaskToJson(const QString& filePath,
+                                          DatabaseManager* dbManager, int taskId)
+{
+    if (!dbManager || !dbManager->isConnected()) {
+        m_lastError = "数据库未连接";
+        return false;
+    }
+
+    QVector<int> channels = dbManager->getTaskChannels(taskId);
+    if (channels.isEmpty()) {
+        m_lastError = "没有数据要导出";
+        return false;
+    }
+
+    emit exportProgress(10, QString("准备导出任务 %1...").arg(taskId));
+
+    // 每次只保留一页数据
+    bool success = writeJson(filePath, channels, [&](int index, JsonStreamWriter& writer) {
+        QVector<DataPoint> page;
+        qint64 lastId = 0;
+        while (true) {
+            if (!dbManager->loadRawDataPage(taskId, channels[index], &lastId,
+                                            EXPORT_PAGE_SIZE, &page)) {
+                m_lastError = dbManager->getLastError();
+                return false;
+            }
+            if (page.isEmpty()) {
+                break;
+            }
+            writer.writeValues(page.constData(), page.size());
+            if (writer.hasError()) {
+                return false;
+            }
+        }
+        return true;
+    });
+
+    if (!success) {
+        emit exportCompleted(false, m_lastError);
+        return false;
+    }
+
+    emit exportCompleted(true, QString("成功导出任务 %1 的 %2 个通道").arg(taskId).arg(channels.size()));
+    return true;
+}
+
+bool JsonExporter::writeJson(const QString& filePath, const QVector<int>& channels,
+                             const ChannelWriter& writeChannel)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // 确保目录存在
+    QFileInfo fileInfo(filePath);
+    QDir dir = fileInfo.absoluteDir();
+    if (!dir.exists()) {
+        dir.mkpath(".");
+    }
+
+    // 先写临时文件，全部成功后再替换目标文件，失败时不会留下半个文件
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        m_lastError = QString("无法打开文件: %1").arg(file.errorString());
+        return false;
+    }
+
+    JsonStreamWriter writer(&file, m_format == Compact);
+    writer.beginDocument();
+
+    int totalChannels = channels.size();
+    for (int i = 0; i < totalChannels; ++i) {
+        // 使用通道索引作为键（字符串格式）
+        writer.beginArray(QString::number(channels[i]));
+        if (!writeChannel(i, writer) || writer.hasError()) {
+            if (writer.hasError()) {
+                m_lastError = QString("写入文件失败: %1").arg(file.errorString());
+            }
+            file.cancelWriting();
+            return false;
+        }
+        writer.endArray();
+
+        emit exportProgress(10 + ((i + 1) * 85 / totalChannels),
+                            QString("已写入通道 %1").arg(channels[i]));
+    }
+
+    if (!writer.endDocument() || !file.commit()) {
+        m_lastError = QString("写入文件失败: %1").arg(file.errorString());
+        return false;
+    }
+
+    emit exportProgress(100, "导出完成");
+
+    qint64 elapsed = timer.elapsed();
+    qDebug() << "文件大小:" << writer.bytesWritten() << "字节"
+             << "耗时" << elapsed << "ms"
+             << "速度" << (elapsed > 0 ? writer.bytesWritten() / 1024.0 / 1024.0 / (elapsed / 1000.0) : 0.0)
+             << "MB/s";
+    return true;
+}
@@ -1,49 +1,66 @@
-#ifndef JSONEXPORTER_H
-#define JSONEXPORTER_H
-
-#include <QObject>
-#include <QString>
-#include <QVector>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
-#include "databuffer.h"
-#include "databasemanager.h"
-
-class JsonExporter : public QObject
-{
-    Q_OBJECT
-
-public:
-    explicit JsonExporter(QObject *parent = nullptr);
-    ~JsonExporter();
-
-    // 导出单通道数据到JSON
-    bool exportChannelToJson(const QString& filePath,
-                             int channel,
-                             const QVector<DataPoint>& data);
-
-    // 导出多通道数据到JSON（参照iio_1.py格式）
-    bool exportMultiChannelToJson(const QString& filePath,
-                                  const QVector<int>& channels,
-                                  const QVector<QVector<DataPoint>>& channelData);
-
-    // 从任务信息导出
-    bool exportTaskToJson(const QString& filePath,
-                          const TaskInfo& taskInfo,
-                          const QVector<QVector<DataPoint>>& channelData);
-
-    QString getLastError() const { return m_lastError; }
-
-signals:
-    void exportProgress(int percentage, const QString& message);
-    void exportCompleted(bool success, const QString& message);
-
-private:
-    QString m_lastError;
-
-    // 将DataPoint数组转换为JSON数组（只保存幅值）
-    QJsonArray convertToJsonArray(const QVector<DataPoint>& data);
-};
-
-#endif // JSONEXPORTER_H
+#ifndef JSONEXPORTER_H
+#define JSONEXPORTER_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <functional>
+#include "databuffer.h"
+#include "databasemanager.h"
+
+class JsonStreamWriter;
+
+// JSON导出 - 格式参照iio_1.py：以通道号（字符串）为键、幅值数组为值的对象
+// 直接流式写入带缓冲的文件，不构建 QJsonDocument，内存占用与数据量无关
+class JsonExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Format {
+        Indented,   // 与 QJsonDocument::Indented 相同的缩进格式
+        Compact     // 无空白，文件更小、写入更快
+    };
+
+    explicit JsonExporter(QObject *parent = nullptr);
+    ~JsonExporter();
+
+    void setFormat(Format format) { m_format = format; }
+    Format format() const { return m_format; }
+
+    // 导出单通道数据到JSON
+    bool exportChannelToJson(const QString& filePath,
+                             int channel,
+                             const QVector<DataPoint>& data);
+
+    // 导出多通道数据到JSON（参照iio_1.py格式）
+    bool exportMultiChannelToJson(const QString& filePath,
+                                  const QVector<int>& channels,
+                                  const QVector<QVector<DataPoint>>& channelData);
+
+    // 从任务信息导出
+    bool exportTaskToJson(const QString& filePath,
+                          const TaskInfo& taskInfo,
+                          const QVector<QVector<DataPoint>>& channelData);
+
+    // 直接从数据库分页读取并导出已保存的任务，不把整个任务加载到内存
+    bool exportStoredTaskToJson(const QString& filePath,
+                                DatabaseManager* dbManager, int taskId);
+
+    QString getLastError() const { return m_lastError; }
+
+signals:
+    void exportProgress(int percentage, const QString& message);
+    void exportCompleted(bool success, const QString& message);
+
+private:
+    // 写出 {"通道": [幅值, ...], ...}，writeChannel(i, writer) 写入第 i 个通道的全部幅值
+    typedef std::function<bool(int index, JsonStreamWriter& writer)> ChannelWriter;
+    bool writeJson(const QString& filePath, const QVector<int>& channels,
+                   const ChannelWriter& writeChannel);
+
+    QString m_lastError;
+    Format m_format;
+};
+
+#endif // JSONEXPORTER_H
@@ -1,656 +1,1046 @@
-#include "mainwindow.h"
-#include <QMessageBox>
-#include <QDateTime>
-#include <QDebug>
-#include <QProgressDialog>
-#include <QStatusBar>
-
-// ==================== Worker Implementations ====================
-
-void DatabaseWorker::saveTaskData(const TaskInfo& taskInfo,
-                                  const QVector<QVector<DataPoint>>& channelData)
-{
-    emit progressUpdated(10, "正在创建任务记录...");
-
-    int taskId = m_dbManager->createTask(taskInfo);
-    if (taskId < 0) {
-        emit saveCompleted(false, "创建任务失败");
-        return;
-    }
-
-    emit progressUpdated(20, "正在保存通道数据...");
-
-    // 保存各个通道的数据
-    int totalChannels = channelData.size();
-    for (int i = 0; i < totalChannels; ++i) {
-        if (!channelData[i].isEmpty()) {
-            int channel = taskInfo.enabledChannels.value(i, i);
-
-            emit progressUpdated(20 + (i * 60 / totalChannels),
-                                 QString("正在保存通道 %1 数据...").arg(channel));
-
-            if (!m_dbManager->saveRawData(taskId, channel, channelData[i])) {
-                emit saveCompleted(false, QString("保存通道 %1 数据失败").arg(channel));
-                return;
-            }
-        }
-    }
-
-    emit progressUpdated(100, "数据保存完成");
-    emit saveCompleted(true, "数据已成功保存到数据库");
-}
-
-void DatabaseWorker::saveAnalysisResults(const QVector<AnalysisResult>& results)
-{
-    for (const auto& result : results) {
-        if (!m_dbManager->saveAnalysisResult(result)) {
-            emit saveCompleted(false, "保存分析结果失败");
-            return;
-        }
-    }
-    emit saveCompleted(true, "分析结果已保存");
-}
-
-void AnalysisWorker::analyzeData(const QVector<QVector<DataPoint>>& channelData,
-                                 int taskId, double sampleRate)
-{
-    QVector<AnalysisResult> results;
-
-    int totalChannels = channelData.size();
-    for (int i = 0; i < totalChannels; ++i) {
-        if (!channelData[i].isEmpty()) {
-            emit progressUpdated((i * 100) / totalChannels,
-                                 QString("正在分析通道 %1...").arg(i));
-
-            AnalysisResult result = m_analyzer->performFullAnalysis(
-                channelData[i], taskId, i, sampleRate);
-            results.append(result);
-        }
-    }
-
-    emit progressUpdated(100, "分析完成");
-    emit analysisCompleted(results);
-}
-
-
-// ==================== MainWindow Implementation ====================
-
-MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent)
-    , ui(new MainWindowUI())
-    , m_dataBuffer(new DataBuffer(this))
-    , m_iioReceiver(new IioReceiver(m_dataBuffer, this))
-    , m_waveformWidget(new WaveformWidget(this))
-    , m_dbManager(new DatabaseManager(this))
-    , m_dataProcessor(new DataProcessor(this))
-    , m_dataAnalyzer(new DataAnalyzer(this))
-    , m_statusUpdateTimer(new QTimer(this))
-    , m_isAcquiring(false)
-    , m_isDatabaseConnected(false)
-    , m_currentTaskId(-1)
-    , m_startTime(0.0)
-{
-    setupUi();
-    connectSignals();
-
-    setWindowTitle("数据采集与分析系统 - IIO版本");
-    resize(1400, 900);
-
-    // 初始化多线程
-    m_databaseThread = new QThread(this);
-    m_databaseWorker = new DatabaseWorker(m_dbManager);
-    m_databaseWorker->moveToThread(m_databaseThread);
-    connect(m_databaseThread, &QThread::finished, m_databaseWorker, &QObject::deleteLater);
-    connect(m_databaseWorker, &DatabaseWorker::saveCompleted,
-            this, &MainWindow::onSaveCompleted);
-    connect(m_databaseWorker, &DatabaseWorker::progressUpdated,
-            [this](int p, const QString& m) {
-                statusBar()->showMessage(QString("%1 (%2%)").arg(m).arg(p));
-            });
-    m_databaseThread->start();
-
-    m_analysisThread = new QThread(this);
-    m_analysisWorker = new AnalysisWorker(m_dataAnalyzer);
-    m_analysisWorker->moveToThread(m_analysisThread);
-    connect(m_analysisThread, &QThread::finished, m_analysisWorker, &QObject::deleteLater);
-    connect(m_analysisWorker, &AnalysisWorker::analysisCompleted,
-            this, &MainWindow::onAnalysisCompleted);
-    connect(m_analysisWorker, &AnalysisWorker::progressUpdated,
-            [this](int p, const QString& m) {
-                statusBar()->showMessage(QString("%1 (%2%)").arg(m).arg(p));
-            });
-    m_analysisThread->start();
-
-    // 启动状态更新定时器
-    m_statusUpdateTimer->start(1000);
-
-    // 初始化通道启用状态
-    m_enabledChannels.resize(MAX_CHANNELS);
-    m_enabledChannels.fill(false);
-    m_enabledChannels.setBit(0, true);
-    m_enabledChannels.setBit(1, true);
-
-    // 设置默认任务名称
-    ui->taskNameEdit->setText(QString("Task_%1").arg(
-        QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")));
-}
-
-MainWindow::~MainWindow()
-{
-    if (m_isAcquiring) {
-        onStopAcquisitionClicked();
-    }
-    m_databaseThread->quit();
-    m_databaseThread->wait();
-
-    m_analysisThread->quit();
-    m_analysisThread->wait();
-
-    delete ui;
-}
-
-void MainWindow::setupUi()
-{
-    // 创建UI
-    ui->setupUi(this);
-    // 设置菜单栏
-    setMenuBar(ui->menuBar);
-
-    // 设置中央部件
-    setCentralWidget(ui->centralWidget);
-
-    // 设置波形显示控件
-    m_waveformWidget->setDataBuffer(m_dataBuffer);
-    ui->waveformLayout->addWidget(m_waveformWidget);
-
-    // 创建状态栏
-    statusBar()->showMessage("就绪");
-}
-
-void MainWindow::connectSignals()
-{
-    // ========== 菜单栏信号 ==========
-    // 设备连接菜单
-    connect(ui->connectDeviceAction, &QAction::triggered,
-            this, &MainWindow::onShowDeviceDialog);
-    connect(ui->disconnectDeviceAction, &QAction::triggered,
-            this, &MainWindow::onDisconnectClicked);
-
-    // 数据库菜单
-    connect(ui->connectDbAction, &QAction::triggered,
-            this, &MainWindow::onShowDatabaseDialog);
-    connect(ui->viewHistoryAction, &QAction::triggered,
-            this, &MainWindow::onViewHistoryClicked);
-
-    // 任务配置菜单
-    connect(ui->taskInfoAction, &QAction::triggered,
-            this, &MainWindow::onShowTaskDialog);
-
-    // 通道管理菜单
-    connect(ui->channelSelectAction, &QAction::triggered,
-            this, &MainWindow::onShowChannelDialog);
-
-    // 帮助菜单
-    connect(ui->aboutAction, &QAction::triggered,
-            this, &MainWindow::onShowAbout);
-
-    // ========== 设备连接对话框信号 ==========
-    connect(ui->connectButton, &QPushButton::clicked,
-            this, &MainWindow::onConnectClicked);
-    connect(ui->disconnectButton, &QPushButton::clicked,
-            this, &MainWindow::onDisconnectClicked);
-
-    // IIO连接信号
-    connect(m_iioReceiver, &IioReceiver::connected,
-            this, &MainWindow::onIioConnected);
-    connect(m_iioReceiver, &IioReceiver::disconnected,
-            this, &MainWindow::onIioDisconnected);
-    connect(m_iioReceiver, &IioReceiver::errorOccurred,
-            this, &MainWindow::onIioError);
-    connect(m_iioReceiver, &IioReceiver::statusChanged,
-            this, &MainWindow::onIioStatusChanged);
-
-    // ========== 数据库对话框信号 ==========
-    connect(ui->connectDbButton, &QPushButton::clicked,
-            this, &MainWindow::onConnectDatabaseClicked);
-    connect(ui->viewHistoryButton, &QPushButton::clicked,
-            this, &MainWindow::onViewHistoryClicked);
-
-    // ========== 采集控制信号 ==========
-    connect(ui->startAcquisitionButton, &QPushButton::clicked,
-            this, &MainWindow::onStartAcquisitionClicked);
-    connect(ui->stopAcquisitionButton, &QPushButton::clicked,
-            this, &MainWindow::onStopAcquisitionClicked);
-    connect(ui->saveDataButton, &QPushButton::clicked,
-            this, &MainWindow::onSaveDataClicked);
-    connect(ui->clearDataButton, &QPushButton::clicked,
-            this, &MainWindow::onClearDataClicked);
-    connect(ui->analyzeButton, &QPushButton::clicked,
-            this, &MainWindow::onAnalyzeDataClicked);
-
-    // ========== 通道选择信号 ==========
-    for (int i = 0; i < 13; ++i) {
-        connect(ui->channelCheckBoxes[i], &QCheckBox::stateChanged,
-                [this, i](int state) { onChannelVisibilityChanged(i, state); });
-    }
-
-    // ========== 状态更新信号 ==========
-    connect(m_statusUpdateTimer, &QTimer::timeout,
-            this, &MainWindow::updateStatusBar);
-}
-
-// ========== 菜单槽函数 ==========
-void MainWindow::onShowDeviceDialog()
-{
-    ui->deviceDialog->exec();
-}
-void MainWindow::onShowDatabaseDialog()
-{
-    ui->databaseDialog->exec();
-}
-void MainWindow::onShowTaskDialog()
-{
-    if (ui->taskDialog->exec() == QDialog::Accepted) {
-        statusBar()->showMessage("任务信息已更新", 2000);
-    }
-}
-void MainWindow::onShowChannelDialog()
-{
-    if (ui->channelDialog->exec() == QDialog::Accepted) {
-        // 更新通道启用状态
-        int enabledCount = 0;
-        for (int i = 0; i < 13; ++i) {
-            bool enabled = ui->channelCheckBoxes[i]->isChecked();
-            m_enabledChannels.setBit(i, enabled);
-            m_waveformWidget->setChannelVisible(i, enabled);
-            if (enabled) enabledCount++;
-        }
-        // 更新显示
-        ui->channelCountValue->setText(QString::number(enabledCount));
-
-        // 如果正在连接,更新接收器的通道配置
-        if (m_iioReceiver->isConnected()) {
-            m_iioReceiver->setEnabledChannels(getSelectedChannels());
-        }
-
-        statusBar()->showMessage(QString("已启用 %1 个通道").arg(enabledCount), 2000);
-    }
-}
-
-void MainWindow::onShowAbout()
-{
-    QMessageBox::about(this, "关于系统",
-                       "<h2>数据采集与分析系统</h2>"
-                       "<p>版本: 1.0.0</p>"
-                       "<p>基于Qt和libiio库开发的多通道数据采集系统</p>"
-                       "<h3>主要功能:</h3>"
-                       "<ul>"
-                       "<li>支持最多13个通道的并行数据采集</li>"
-                       "<li>实时波形显示</li>"
-                       "<li>FFT频域分析</li>"
-                       "<li>MySQL数据库存储</li>"
-                       "<li>历史数据回放</li>"
-                       "</ul>"
-                       "<h3>连接配置:</h3>"
-                       "<ul>"
-                       "<li>支持通过IP地址连接IIO设备</li>"
-                       "<li>可配置采样率和缓冲区大小</li>"
-                       "<li>支持动态启用/禁用通道</li>"
-                       "</ul>"
-                       "<p>Copyright © 2024 DataAcquisition</p>");
-}
-
-// ========== IIO设备连接槽函数 ==========
-void MainWindow::onConnectClicked()
-{
-    QString ipAddress = ui->deviceIpEdit->text().trimmed();
-    if (ipAddress.isEmpty()) {
-        QMessageBox::warning(this, "警告", "请输入设备IP地址");
-        return;
-    }
-
-    // 更新启用的通道
-    QVector<int> enabledChannels = getSelectedChannels();
-    if (enabledChannels.isEmpty()) {
-        QMessageBox::warning(this, "警告", "请至少选择一个通道");
-        return;
-    }
-
-    // 配置IIO接收器
-    m_iioReceiver->setEnabledChannels(enabledChannels);
-    m_iioReceiver->setSampleRate(ui->sampleRateSpinBox->value());
-    m_iioReceiver->setBufferSize(ui->bufferSizeSpinBox->value());
-
-    // 连接设备
-    if (m_iioReceiver->connectToDevice(ipAddress)) {
-        ui->connectButton->setEnabled(false);
-        ui->disconnectButton->setEnabled(true);
-        ui->connectDeviceAction->setEnabled(false);
-        ui->disconnectDeviceAction->setEnabled(true);
-        ui->deviceGroupBox->setEnabled(false);
-        statusBar()->showMessage("正在连接IIO设备...");
-    } else {
-        QMessageBox::warning(this, "连接失败", "无法连接到IIO设备");
-    }
-}
-void MainWindow::onDisconnectClicked()
-{
-    if (m_isAcquiring) {
-        onStopAcquisitionClicked();
-    }
-    m_iioReceiver->disconnectFromDevice();
-
-    ui->connectButton->setEnabled(true);
-    ui->disconnectButton->setEnabled(false);
-    ui->connectDeviceAction->setEnabled(true);
-    ui->disconnectDeviceAction->setEnabled(false);
-    ui->deviceGroupBox->setEnabled(true);
-    ui->startAcquisitionButton->setEnabled(false);
-
-    statusBar()->showMessage("已断开连接");
-}
-void MainWindow::onIioConnected()
-{
-    statusBar()->showMessage("IIO设备已连接");
-    ui->connectionStatusValue->setText("已连接");
-    ui->connectionStatusValue->setStyleSheet("QLabel { color: green; font-weight: bold; }");
-    ui->startAcquisitionButton->setEnabled(true);
-    // 关闭对话框
-    ui->deviceDialog->close();
-
-    QMessageBox::information(this, "连接成功",
-                             QString("IIO设备连接已建立\n设备IP: %1\n采样率: %2 Hz\n缓冲区: %3 samples")
-                                 .arg(ui->deviceIpEdit->text())
-                                 .arg(ui->sampleRateSpinBox->value())
-                                 .arg(ui->bufferSizeSpinBox->value()));
-}
-void MainWindow::onIioDisconnected()
-{
-    statusBar()->showMessage("IIO连接已断开");
-    ui->connectionStatusValue->setText("未连接");
-    ui->connectionStatusValue->setStyleSheet("QLabel { color: red; font-weight: bold; }");
-    ui->startAcquisitionButton->setEnabled(false);
-    if (m_isAcquiring) {
-        onStopAcquisitionClicked();
-    }
-}
-void MainWindow::onIioError(const QString& error)
-{
-    QMessageBox::critical(this, "IIO错误", error);
-    statusBar()->showMessage("错误: " + error);
-}
-void MainWindow::onIioStatusChanged(const QString& status)
-{
-    statusBar()->showMessage(status);
-}
-// ========== 数据采集槽函数 ==========
-void MainWindow::onStartAcquisitionClicked()
-{
-    if (!validateTaskInfo()) {
-        return;
-    }
-    // 清空缓冲区
-    m_dataBuffer->clear();
-
-    // 记录开始时间
-    m_startTime = QDateTime::currentMSecsSinceEpoch() / 1000.0;
-
-    // 启动显示
-    m_waveformWidget->startDisplay();
-
-    m_isAcquiring = true;
-    ui->startAcquisitionButton->setEnabled(false);
-    ui->stopAcquisitionButton->setEnabled(true);
-    ui->saveDataButton->setEnabled(false);
-    ui->analyzeButton->setEnabled(false);
-    ui->taskInfoAction->setEnabled(false);
-    ui->channelSelectAction->setEnabled(false);
-    ui->connectDeviceAction->setEnabled(false);
-
-    statusBar()->showMessage("正在采集数据...");
-}
-void MainWindow::onStopAcquisitionClicked()
-{
-    m_waveformWidget->stopDisplay();
-    m_isAcquiring = false;
-    ui->startAcquisitionButton->setEnabled(true);
-    ui->stopAcquisitionButton->setEnabled(false);
-    ui->saveDataButton->setEnabled(true);
-    ui->analyzeButton->setEnabled(true);
-    ui->taskInfoAction->setEnabled(true);
-    ui->channelSelectAction->setEnabled(true);
-    ui->connectDeviceAction->setEnabled(true);
-
-    statusBar()->showMessage("采集已停止");
-}
-void MainWindow::onSaveDataClicked()
-{
-    if (!m_isDatabaseConnected) {
-        QMessageBox::warning(this, "警告", "请先连接数据库");
-        return;
-    }
-    if (!validateTaskInfo()) {
-        return;
-    }
-
-    // 准备任务信息
-    TaskInfo taskInfo;
-    taskInfo.taskName = ui->taskNameEdit->text();
-    taskInfo.sampleRate = ui->sampleRateSpinBox->value();
-    taskInfo.description = ui->taskDescEdit->toPlainText();
-    taskInfo.channelCount = 13;
-    taskInfo.enabledChannels = getSelectedChannels();
-
-    // 计算时长
-    QVector<int> channels = getSelectedChannels();
-    if (!channels.isEmpty()) {
-        QVector<DataPoint> data = m_dataBuffer->getAllChannelData(channels[0]);
-        if (!data.isEmpty()) {
-            taskInfo.duration = data.last().time - data.first().time;
-        }
-    }
-
-    // 获取所有通道数据
-    QVector<QVector<DataPoint>> channelData;
-    for (int ch : channels) {
-        channelData.append(m_dataBuffer->getAllChannelData(ch));
-    }
-
-    // 在工作线程中保存
-    QMetaObject::invokeMethod(m_databaseWorker, "saveTaskData",
-                              Qt::QueuedConnection,
-                              Q_ARG(TaskInfo, taskInfo),
-                              Q_ARG(QVector<QVector<DataPoint>>, channelData));
-
-    statusBar()->showMessage("正在保存数据...");
-}
-void MainWindow::onClearDataClicked()
-{
-    QMessageBox::StandardButton reply = QMessageBox::question(
-        this, "确认", "确定要清空当前数据吗?",
-        QMessageBox::Yes | QMessageBox::No);
-    if (reply == QMessageBox::Yes) {
-        m_dataBuffer->clear();
-        m_waveformWidget->clearDisplay();
-        ui->dataPointsValue->setText("0");
-        statusBar()->showMessage("数据已清空");
-    }
-}
-// ========== 数据库槽函数 ==========
-void MainWindow::onConnectDatabaseClicked()
-{
-    QString host = ui->dbHostEdit->text();
-    int port = ui->dbPortSpinBox->value();
-    QString dbName = ui->dbNameEdit->text();
-    QString user = ui->dbUserEdit->text();
-    QString password = ui->dbPasswordEdit->text();
-    if (m_dbManager->connectToDatabase(host, port, dbName, user, password)) {
-        m_isDatabaseConnected = true;
-        ui->connectDbButton->setEnabled(false);
-        ui->dbConfigGroupBox->setEnabled(false);
-        ui->viewHistoryButton->setEnabled(true);
-        ui->viewHistoryAction->setEnabled(true);
-
-        ui->dbStatusValue->setText("已连接");
-        ui->dbStatusValue->setStyleSheet("QLabel { color: green; font-weight: bold; }");
-
-        statusBar()->showMessage("数据库已连接");
-
-        // 关闭对话框
-        ui->databaseDialog->close();
-
-        QMessageBox::information(this, "成功", "数据库连接成功");
-    } else {
-        QMessageBox::critical(this, "错误",
-                              QString("数据库连接失败: %1").arg(m_dbManager->getLastError()));
-    }
-}
-void MainWindow::onViewHistoryClicked()
-{
-    if (!m_isDatabaseConnected) {
-        QMessageBox::warning(this, "警告", "请先连接数据库");
-        return;
-    }
-    HistoryViewer* viewer = new HistoryViewer(m_dbManager, this);
-    connect(viewer, &HistoryViewer::replayRequested,
-            this, &MainWindow::onReplayTask);
-    viewer->exec();
-    delete viewer;
-}
-void MainWindow::onReplayTask(int taskId)
-{
-    statusBar()->showMessage("正在加载历史数据...");
-    // 停止当前采集
-    if (m_isAcquiring) {
-        onStopAcquisitionClicked();
-    }
-
-    // 获取任务信息
-    TaskInfo task = m_dbManager->getTask(taskId);
-
-    // 加载多通道数据
-    m_waveformWidget->clearDisplayData();
-
-    for (int ch : task.enabledChannels) {
-        QVector<DataPoint> data = m_dbManager->loadRawData(taskId, ch);
-        if (!data.isEmpty()) {
-            m_waveformWidget->setDisplayData(ch, data);
-        }
-    }
-
-    m_currentTaskId = taskId;
-    statusBar()->showMessage("历史数据回放中");
-}
-// ========== 数据分析槽函数 ==========
-void MainWindow::onAnalyzeDataClicked()
-{
-    QVector<int> channels = getSelectedChannels();
-    QVector<QVector<DataPoint>> channelData;
-    for (int ch : channels) {
-        channelData.append(m_dataBuffer->getAllChannelData(ch));
-    }
-
-    if (channelData.isEmpty()) {
-        QMessageBox::warning(this, "警告", "没有可分析的数据");
-        return;
-    }
-
-    double sampleRate = ui->sampleRateSpinBox->value();
-
-    // 在工作线程中分析
-    QMetaObject::invokeMethod(m_analysisWorker, "analyzeData",
-                              Qt::QueuedConnection,
-                              Q_ARG(QVector<QVector<DataPoint>>, channelData),
-                              Q_ARG(int, m_currentTaskId),
-                              Q_ARG(double, sampleRate));
-
-    statusBar()->showMessage("正在分析数据...");
-}
-void MainWindow::onAnalysisCompleted(const QVector<AnalysisResult>& results)
-{
-    QString message = "=== 分析结果 ===\n\n";
-    for (const auto& result : results) {
-        message += QString("通道 %1:\n").arg(result.channel);
-        message += QString("  最大幅值: %1\n").arg(result.maxAmplitude);
-        message += QString("  最小幅值: %1\n").arg(result.minAmplitude);
-        message += QString("  平均幅值: %1\n").arg(result.avgAmplitude);
-        message += QString("  均方根值: %1\n").arg(result.rmsValue);
-        message += QString("  主频率: %1 Hz\n\n").arg(result.frequency);
-    }
-
-    QMessageBox::information(this, "分析结果", message);
-
-    // 如果已连接数据库,保存分析结果
-    if (m_isDatabaseConnected) {
-        QMetaObject::invokeMethod(m_databaseWorker, "saveAnalysisResults",
-                                  Qt::QueuedConnection,
-                                  Q_ARG(QVector<AnalysisResult>, results));
-    }
-
-    statusBar()->showMessage("分析完成");
-}
-void MainWindow::onSaveCompleted(bool success, const QString& message)
-{
-    if (success) {
-        QMessageBox::information(this, "成功", message);
-    } else {
-        QMessageBox::critical(this, "错误", message);
-    }
-    statusBar()->showMessage(message);
-}
-// ========== 通道管理 ==========
-void MainWindow::onChannelVisibilityChanged(int channel, int state)
-{
-    bool visible = (state == Qt::Checked);
-    m_enabledChannels.setBit(channel, visible);
-    m_waveformWidget->setChannelVisible(channel, visible);
-    // 更新启用通道数
-    int enabledCount = 0;
-    for (int i = 0; i < MAX_CHANNELS; ++i) {
-        if (m_enabledChannels.testBit(i)) enabledCount++;
-    }
-    ui->channelCountValue->setText(QString::number(enabledCount));
-
-    // 如果正在连接,更新接收器的通道配置
-    if (m_iioReceiver->isConnected()) {
-        m_iioReceiver->setEnabledChannels(getSelectedChannels());
-    }
-}
-void MainWindow::updateStatusBar()
-{
-    // 更新数据点数
-    QString countText;
-    QVector<int> channels = getSelectedChannels();
-    int totalPoints = 0;
-    for (int ch : channels) {
-        int count = m_dataBuffer->getDataCount(ch);
-        totalPoints += count;
-    }
-
-    ui->dataPointsValue->setText(QString::number(totalPoints));
-}
-// ========== 辅助函数 ==========
-bool MainWindow::validateTaskInfo()
-{
-    if (ui->taskNameEdit->text().trimmed().isEmpty()) {
-        QMessageBox::warning(this, "警告", "请输入任务名称");
-        return false;
-    }
-    if (getSelectedChannels().isEmpty()) {
-        QMessageBox::warning(this, "警告", "请至少选择一个通道");
-        return false;
-    }
-
-    return true;
-}
-
-QVector<int> MainWindow::getSelectedChannels()
-{
-    QVector<int> channels;
-    for (int i = 0; i < 13; ++i) {
-        if (ui->channelCheckBoxes[i]->isChecked()) {
-            channels.append(i);
-        }
-    }
-    return channels;
-}
+#include "mainwindow.h"
+#include <QMessageBox>
+#include <QDateTime>
+#include <QDebug>
+#include <QProgressDialog>
+#include <QStatusBar>
+#include <QElapsedTimer>
+#include <QInputDialog>
+#include <QRegularExpression>
+#include <QFileDialog>
+#include <QSignalBlocker>
+#include <atomic>
+#include <algorithm>
+
+namespace {
+
+// 打开录制文件时一次载入显示的时长（秒），大文件不整体载入
+const double RECORDING_REPLAY_WINDOW = 10.0;
+
+} // namespace
+
+// ==================== Worker Implementations ====================
+
+void DatabaseWorker::saveTaskData(const TaskInfo& taskInfo,
+                                  const QVector<QVector<DataPoint>>& channelData,
+                                  const QVector<QVector<BlockSummary>>& summaries)
+{
+    emit progressUpdated(10, "正在保存任务数据...");
+
+    QVector<int> channels;
+    for (int i = 0; i < channelData.size(); ++i) {
+        channels.append(taskInfo.enabledChannels.value(i, i));
+    }
+
+    // 任务记录、各通道原始数据和块级分析索引在一个事务中写入，任一通道失败整体回滚
+    int taskId = m_dbManager->saveTask(taskInfo, channels, channelData, summaries);
+    if (taskId < 0) {
+        emit saveCompleted(false, QString("保存任务失败，已回滚: %1")
+                                      .arg(m_dbManager->getLastError()));
+        return;
+    }
+    // 任务号可能被复用（例如删除后服务器重启），丢弃内存中同号任务的旧结果
+    AnalysisResultCache::globalInstance()->invalidateTask(taskId);
+
+    emit progressUpdated(100, "数据保存完成");
+    emit saveCompleted(true, "数据已成功保存到数据库");
+}
+
+void DatabaseWorker::saveAnalysisResults(const QVector<AnalysisResult>& results)
+{
+    if (!m_dbManager->saveAnalysisResults(results)) {
+        emit saveCompleted(false, "保存分析结果失败");
+        return;
+    }
+    emit saveCompleted(true, "分析结果已保存");
+}
+
+void DatabaseWorker::saveCorrelationResults(const QVector<CorrelationResult>& results)
+{
+    // 与通道分析结果一同保存，成功时不再单独提示
+    if (!m_dbManager->saveCorrelationResults(results)) {
+        emit saveCompleted(false, "保存通道间相关分析结果失败");
+        return;
+    }
+    emit progressUpdated(100, QString("已保存 %1 个通道对的相关分析结果").arg(results.size()));
+}
+
+void DatabaseWorker::migrateRawDataIndex()
+{
+    emit progressUpdated(0, "正在为原始数据表添加时间索引...");
+    if (!m_dbManager->migrateRawDataTimeIndex()) {
+        emit saveCompleted(false, QString("添加原始数据时间索引失败: %1")
+                                      .arg(m_dbManager->getLastError()));
+        return;
+    }
+    emit saveCompleted(true, "原始数据表时间索引已添加");
+}
+
+void AnalysisWorker::analyzeData(const QVector<QVector<DataPoint>>& channelData,
+                                 int taskId, double sampleRate)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QVector<int> channels;
+    for (int i = 0; i < channelData.size(); ++i) {
+        if (!channelData[i].isEmpty()) {
+            channels.append(i);
+        }
+    }
+
+    emit progressUpdated(0, QString("正在并行分析 %1 个通道...").arg(channels.size()));
+
+    // 每个通道一个任务，任务之间不共享分析器状态；结果按通道顺序存放
+    QVector<AnalysisResult> results(channels.size());
+    std::atomic<int> finished(0);
+    int totalChannels = channels.size();
+
+    WorkStealingPool::TaskGroup group(m_pool);
+    for (int k = 0; k < totalChannels; ++k) {
+        group.run([&, k]() {
+            int channel = channels[k];
+            results[k] = DataAnalyzer::analyzeChannel(channelData[channel], taskId,
+                                                      channel, sampleRate, m_pool);
+            results[k].cacheKey = DataAnalyzer::liveCacheKey(taskId, channel, sampleRate,
+                                                             channelData[channel]).digest();
+
+            int done = finished.fetch_add(1) + 1;
+            emit progressUpdated((done * 100) / totalChannels,
+                                 QString("通道 %1 分析完成 (%2/%3)")
+                                     .arg(channel).arg(done).arg(totalChannels));
+        });
+    }
+    group.wait();
+
+    // 通道间相关与相干：每个通道只做一次FFT，所有通道对复用
+    QVector<CorrelationResult> correlations;
+    if (totalChannels >= 2) {
+        emit progressUpdated(95, QString("正在计算 %1 个通道对的相关性与相干性...")
+                                     .arg(totalChannels * (totalChannels - 1) / 2));
+        correlations = CrossChannelAnalyzer::analyze(channelData, channels, taskId, sampleRate,
+                                                     CrossChannelSettings(), m_pool);
+    }
+
+    qDebug() << "并行分析完成: 通道数" << totalChannels
+             << "线程数" << m_pool->threadCount()
+             << "耗时" << timer.elapsed() << "ms";
+
+    emit progressUpdated(100, "分析完成");
+    emit correlationCompleted(correlations);
+    emit analysisCompleted(results);
+}
+
+
+void AnalysisWorker::prepareTaskData(const TaskInfo& taskInfo,
+                                     const QVector<QVector<DataPoint>>& channelData)
+{
+    emit progressUpdated(0, "正在生成分析索引...");
+
+    // 保存时生成块级分析索引，之后的整段/区间分析只需合并摘要；各块在线程池中并行计算
+    QVector<QVector<BlockSummary>> summaries(channelData.size());
+    for (int i = 0; i < channelData.size(); ++i) {
+        if (!channelData[i].isEmpty()) {
+            int channel = taskInfo.enabledChannels.value(i, i);
+            summaries[i] = BlockIndex::build(channelData[i], -1, channel,
+                                             taskInfo.sampleRate, m_pool);
+        }
+    }
+
+    emit taskDataPrepared(taskInfo, channelData, summaries);
+}
+
+// ==================== MainWindow Implementation ====================
+
+MainWindow::MainWindow(QWidget *parent)
+    : QMainWindow(parent)
+    , ui(new MainWindowUI())
+    , m_dataBuffer(new DataBuffer(this))
+    , m_iioReceiver(new IioReceiver(m_dataBuffer, this))
+    , m_waveformWidget(new WaveformWidget(this))
+    , m_spectrogramWidget(new SpectrogramWidget(this))
+    , m_dbManager(new DatabaseManager(this))
+    , m_dataProcessor(new DataProcessor(this))
+    , m_dataAnalyzer(new DataAnalyzer(this))
+    , m_statusUpdateTimer(new QTimer(this))
+    , m_isAcquiring(false)
+    , m_isDatabaseConnected(false)
+    , m_currentTaskId(-1)
+    , m_startTime(0.0)
+{
+    setupUi();
+    connectSignals();
+
+    setWindowTitle("数据采集与分析系统 - IIO版本");
+    resize(1400, 900);
+
+    // 初始化多线程
+    m_databaseThread = new QThread(this);
+    m_databaseWorker = new DatabaseWorker(m_dbManager);
+    m_databaseWorker->moveToThread(m_databaseThread);
+    connect(m_databaseThread, &QThread::finished, m_databaseWorker, &QObject::deleteLater);
+    connect(m_databaseWorker, &DatabaseWorker::saveCompleted,
+            this, &MainWindow::onSaveCompleted);
+    connect(m_databaseWorker, &DatabaseWorker::progressUpdated, this,
+            [this](int p, const QString& m) {
+                statusBar()->showMessage(QString("%1 (%2%)").arg(m).arg(p));
+            });
+    m_databaseThread->start();
+
+    m_analysisThread = new QThread(this);
+    m_analysisWorker = new AnalysisWorker(WorkStealingPool::globalInstance());
+    m_analysisWorker->moveToThread(m_analysisThread);
+    connect(m_analysisThread, &QThread::finished, m_analysisWorker, &QObject::deleteLater);
+    connect(m_analysisWorker, &AnalysisWorker::correlationCompleted,
+            this, &MainWindow::onCorrelationCompleted);
+    connect(m_analysisWorker, &AnalysisWorker::analysisCompleted,
+            this, &MainWindow::onAnalysisCompleted);
+    // 分析索引在分析线程中计算好后直接交给数据库线程保存
+    connect(m_analysisWorker, &AnalysisWorker::taskDataPrepared,
+            m_databaseWorker, &DatabaseWorker::saveTaskData);
+    connect(m_analysisWorker, &AnalysisWorker::progressUpdated, this,
+            [this](int p, const QString& m) {
+                statusBar()->showMessage(QString("%1 (%2%)").arg(m).arg(p));
+            });
+    m_analysisThread->start();
+
+    // 流式STFT和频率跟踪在独立线程中处理新到的数据块，界面定时读取结果
+    m_streamThread = new QThread(this);
+    m_stftEngine = new StftEngine();
+    m_stftEngine->moveToThread(m_streamThread);
+    connect(m_streamThread, &QThread::finished, m_stftEngine, &QObject::deleteLater);
+    connect(m_iioReceiver, &IioReceiver::blockReceived,
+            m_stftEngine, &StftEngine::processBlock);
+    m_spectrogramWidget->setEngine(m_stftEngine);
+
+    m_frequencyTracker = new FrequencyTracker();
+    m_frequencyTracker->moveToThread(m_streamThread);
+    connect(m_streamThread, &QThread::finished, m_frequencyTracker, &QObject::deleteLater);
+    connect(m_iioReceiver, &IioReceiver::blockReceived,
+            m_frequencyTracker, &FrequencyTracker::processBlock);
+    m_streamThread->start();
+
+    // 启动状态更新定时器
+    m_statusUpdateTimer->start(1000);
+
+    // 初始化通道启用状态
+    m_enabledChannels.resize(MAX_CHANNELS);
+    m_enabledChannels.fill(false);
+    m_enabledChannels.setBit(0, true);
+    m_enabledChannels.setBit(1, true);
+
+    // 设置默认任务名称
+    ui->taskNameEdit->setText(QString("Task_%1").arg(
+        QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")));
+}
+
+MainWindow::~MainWindow()
+{
+    if (m_isAcquiring) {
+        onStopAcquisitionClicked();
+    }
+    m_databaseThread->quit();
+    m_databaseThread->wait();
+
+    m_analysisThread->quit();
+    m_analysisThread->wait();
+
+    m_streamThread->quit();
+    m_streamThread->wait();
+
+    delete ui;
+}
+
+void MainWindow::setupUi()
+{
+    // 创建UI
+    ui->setupUi(this);
+    // 设置菜单栏
+    setMenuBar(ui->menuBar);
+
+    // 设置中央部件
+    setCentralWidget(ui->centralWidget);
+
+    // 设置波形显示控件
+    m_waveformWidget->setDataBuffer(m_dataBuffer);
+    ui->waveformLayout->addWidget(m_waveformWidget, 3);
+
+    // 时频图显示在波形下方
+    ui->waveformLayout->addWidget(m_spectrogramWidget, 2);
+
+    // 创建状态栏
+    statusBar()->showMessage("就绪");
+}
+
+void MainWindow::connectSignals()
+{
+    // ========== 菜单栏信号 ==========
+    // 文件菜单
+    connect(ui->exportRecordingAction, &QAction::triggered,
+            this, &MainWindow::onExportRecordingClicked);
+    connect(ui->openRecordingAction, &QAction::triggered,
+            this, &MainWindow::onOpenRecordingClicked);
+
+    // 设备连接菜单
+    connect(ui->connectDeviceAction, &QAction::triggered,
+            this, &MainWindow::onShowDeviceDialog);
+    connect(ui->disconnectDeviceAction, &QAction::triggered,
+            this, &MainWindow::onDisconnectClicked);
+    connect(ui->sharedStreamAction, &QAction::toggled,
+            this, &MainWindow::onSharedStreamToggled);
+
+    // 数据库菜单
+    connect(ui->connectDbAction, &QAction::triggered,
+            this, &MainWindow::onShowDatabaseDialog);
+    connect(ui->viewHistoryAction, &QAction::triggered,
+            this, &MainWindow::onViewHistoryClicked);
+
+    // 任务配置菜单
+    connect(ui->taskInfoAction, &QAction::triggered,
+            this, &MainWindow::onShowTaskDialog);
+
+    // 通道管理菜单
+    connect(ui->channelSelectAction, &QAction::triggered,
+            this, &MainWindow::onShowChannelDialog);
+    connect(ui->trackFrequencyAction, &QAction::triggered,
+            this, &MainWindow::onShowTrackerDialog);
+
+    // 帮助菜单
+    connect(ui->aboutAction, &QAction::triggered,
+            this, &MainWindow::onShowAbout);
+
+    // ========== 设备连接对话框信号 ==========
+    connect(ui->connectButton, &QPushButton::clicked,
+            this, &MainWindow::onConnectClicked);
+    connect(ui->disconnectButton, &QPushButton::clicked,
+            this, &MainWindow::onDisconnectClicked);
+
+    // IIO连接信号
+    connect(m_iioReceiver, &IioReceiver::connected,
+            this, &MainWindow::onIioConnected);
+    connect(m_iioReceiver, &IioReceiver::disconnected,
+            this, &MainWindow::onIioDisconnected);
+    connect(m_iioReceiver, &IioReceiver::errorOccurred,
+            this, &MainWindow::onIioError);
+    connect(m_iioReceiver, &IioReceiver::statusChanged,
+            this, &MainWindow::onIioStatusChanged);
+
+    // ========== 数据库对话框信号 ==========
+    connect(ui->connectDbButton, &QPushButton::clicked,
+            this, &MainWindow::onConnectDatabaseClicked);
+    connect(ui->viewHistoryButton, &QPushButton::clicked,
+            this, &MainWindow::onViewHistoryClicked);
+
+    // ========== 采集控制信号 ==========
+    connect(ui->startAcquisitionButton, &QPushButton::clicked,
+            this, &MainWindow::onStartAcquisitionClicked);
+    connect(ui->stopAcquisitionButton, &QPushButton::clicked,
+            this, &MainWindow::onStopAcquisitionClicked);
+    connect(ui->saveDataButton, &QPushButton::clicked,
+            this, &MainWindow::onSaveDataClicked);
+    connect(ui->clearDataButton, &QPushButton::clicked,
+            this, &MainWindow::onClearDataClicked);
+    connect(ui->analyzeButton, &QPushButton::clicked,
+            this, &MainWindow::onAnalyzeDataClicked);
+
+    // ========== 通道选择信号 ==========
+    for (int i = 0; i < 13; ++i) {
+        connect(ui->channelCheckBoxes[i], &QCheckBox::stateChanged,
+                [this, i](int state) { onChannelVisibilityChanged(i, state); });
+    }
+
+    // ========== 状态更新信号 ==========
+    connect(m_statusUpdateTimer, &QTimer::timeout,
+            this, &MainWindow::updateStatusBar);
+}
+
+// ========== 菜单槽函数 ==========
+void MainWindow::onShowDeviceDialog()
+{
+    ui->deviceDialog->exec();
+}
+void MainWindow::onShowDatabaseDialog()
+{
+    ui->databaseDialog->exec();
+}
+void MainWindow::onShowTaskDialog()
+{
+    if (ui->taskDialog->exec() == QDialog::Accepted) {
+        statusBar()->showMessage("任务信息已更新", 2000);
+    }
+}
+void MainWindow::onShowChannelDialog()
+{
+    if (ui->channelDialog->exec() == QDialog::Accepted) {
+        // 更新通道启用状态
+        int enabledCount = 0;
+        for (int i = 0; i < 13; ++i) {
+            bool enabled = ui->channelCheckBoxes[i]->isChecked();
+            m_enabledChannels.setBit(i, enabled);
+            m_waveformWidget->setChannelVisible(i, enabled);
+            if (enabled) enabledCount++;
+        }
+        // 更新显示
+        ui->channelCountValue->setText(QString::number(enabledCount));
+
+        // 如果正在连接,更新接收器的通道配置
+        if (m_iioReceiver->isConnected()) {
+            m_iioReceiver->setEnabledChannels(getSelectedChannels());
+        }
+
+        statusBar()->showMessage(QString("已启用 %1 个通道").arg(enabledCount), 2000);
+    }
+}
+
+void MainWindow::onShowTrackerDialog()
+{
+    QStringList current;
+    for (double frequency : m_frequencyTracker->frequencies(m_spectrogramWidget->channel())) {
+        current << QString::number(frequency);
+    }
+
+    bool ok = false;
+    QString text = QInputDialog::getText(this, "跟踪频率设置",
+                                         "跟踪频率（Hz，用逗号分隔，应用到所有选中通道）:",
+                                         QLineEdit::Normal, current.join(", "), &ok);
+    if (!ok) {
+        return;
+    }
+
+    QVector<double> frequencies;
+    const QStringList items = text.split(QRegularExpression("[,，\\s]+"), Qt::SkipEmptyParts);
+    for (const QString& item : items) {
+        bool valid = false;
+        double frequency = item.toDouble(&valid);
+        if (!valid || frequency < 0.0) {
+            QMessageBox::warning(this, "警告", QString("无效的频率: %1").arg(item));
+            return;
+        }
+        frequencies.append(frequency);
+    }
+
+    for (int channel : getSelectedChannels()) {
+        m_frequencyTracker->setFrequencies(channel, frequencies);
+    }
+    updateTrackerDisplay();
+}
+
+void MainWindow::onShowAbout()
+{
+    QMessageBox::about(this, "关于系统",
+                       "<h2>数据采集与分析系统</h2>"
+                       "<p>版本: 1.0.0</p>"
+                       "<p>基于Qt和libiio库开发的多通道数据采集系统</p>"
+                       "<h3>主要功能:</h3>"
+                       "<ul>"
+                       "<li>支持最多13个通道的并行数据采集</li>"
+                       "<li>实时波形显示</li>"
+                       "<li>FFT频域分析</li>"
+                       "<li>MySQL数据库存储</li>"
+                       "<li>历史数据回放</li>"
+                       "</ul>"
+                       "<h3>连接配置:</h3>"
+                       "<ul>"
+                       "<li>支持通过IP地址连接IIO设备</li>"
+                       "<li>可配置采样率和缓冲区大小</li>"
+                       "<li>支持动态启用/禁用通道</li>"
+                       "</ul>"
+                       "<p>Copyright © 2024 DataAcquisition</p>");
+}
+
+// ========== IIO设备连接槽函数 ==========
+void MainWindow::onConnectClicked()
+{
+    QString ipAddress = ui->deviceIpEdit->text().trimmed();
+    if (ipAddress.isEmpty()) {
+        QMessageBox::warning(this, "警告", "请输入设备IP地址");
+        return;
+    }
+
+    // 更新启用的通道
+    QVector<int> enabledChannels = getSelectedChannels();
+    if (enabledChannels.isEmpty()) {
+        QMessageBox::warning(this, "警告", "请至少选择一个通道");
+        return;
+    }
+
+    // 配置IIO接收器
+    m_iioReceiver->setEnabledChannels(enabledChannels);
+    m_iioReceiver->setSampleRate(ui->sampleRateSpinBox->value());
+    m_iioReceiver->setBufferSize(ui->bufferSizeSpinBox->value());
+
+    // 连接设备
+    if (m_iioReceiver->connectToDevice(ipAddress)) {
+        ui->connectButton->setEnabled(false);
+        ui->disconnectButton->setEnabled(true);
+        ui->connectDeviceAction->setEnabled(false);
+        ui->disconnectDeviceAction->setEnabled(true);
+        ui->deviceGroupBox->setEnabled(false);
+        statusBar()->showMessage("正在连接IIO设备...");
+    } else {
+        QMessageBox::warning(this, "连接失败", "无法连接到IIO设备");
+    }
+}
+void MainWindow::onDisconnectClicked()
+{
+    if (m_isAcquiring) {
+        onStopAcquisitionClicked();
+    }
+    m_iioReceiver->disconnectFromDevice();
+
+    ui->connectButton->setEnabled(true);
+    ui->disconnectButton->setEnabled(false);
+    ui->connectDeviceAction->setEnabled(true);
+    ui->disconnectDeviceAction->setEnabled(false);
+    ui->deviceGroupBox->setEnabled(true);
+    ui->startAcquisitionButton->setEnabled(false);
+
+    statusBar()->showMessage("已断开连接");
+}
+void MainWindow::onIioConnected()
+{
+    statusBar()->showMessage("IIO设备已连接");
+    ui->connectionStatusValue->setText("已连接");
+    ui->connectionStatusValue->setStyleSheet("QLabel { color: green; font-weight: bold; }");
+    ui->startAcquisitionButton->setEnabled(true);
+    // 关闭对话框
+    ui->deviceDialog->close();
+
+    QMessageBox::information(this, "连接成功",
+                             QString("IIO设备连接已建立\n设备IP: %1\n采样率: %2 Hz\n缓冲区: %3 samples")
+                                 .arg(ui->deviceIpEdit->text())
+                                 .arg(ui->sampleRateSpinBox->value())
+                                 .arg(ui->bufferSizeSpinBox->value()));
+}
+void MainWindow::onIioDisconnected()
+{
+    statusBar()->showMessage("IIO连接已断开");
+    ui->connectionStatusValue->setText("未连接");
+    ui->connectionStatusValue->setStyleSheet("QLabel { color: red; font-weight: bold; }");
+    ui->startAcquisitionButton->setEnabled(false);
+    if (m_isAcquiring) {
+        onStopAcquisitionClicked();
+    }
+}
+void MainWindow::onIioError(const QString& error)
+{
+    QMessageBox::critical(this, "IIO错误", error);
+    statusBar()->showMessage("错误: " + error);
+}
+void MainWindow::onIioStatusChanged(const QString& status)
+{
+    statusBar()->showMessage(status);
+}
+void MainWindow::onSharedStreamToggled(bool enabled)
+{
+    if (!enabled) {
+        m_dataBuffer->disableSharedStream();
+        statusBar()->showMessage("共享内存实时流已关闭", 3000);
+        return;
+    }
+
+    QString error;
+    if (!m_dataBuffer->enableSharedStream(SharedStream::DEFAULT_NAME, SharedStream::DEFAULT_CAPACITY,
+                                          ui->sampleRateSpinBox->value(), &error)) {
+        QMessageBox::warning(this, "警告", QString("开启共享内存实时流失败: %1").arg(error));
+        QSignalBlocker blocker(ui->sharedStreamAction);
+        ui->sharedStreamAction->setChecked(false);
+        return;
+    }
+    statusBar()->showMessage(QString("共享内存实时流已开启: %1").arg(SharedStream::DEFAULT_NAME), 5000);
+}
+// ========== 数据采集槽函数 ==========
+void MainWindow::onStartAcquisitionClicked()
+{
+    if (!validateTaskInfo()) {
+        return;
+    }
+    // 清空缓冲区
+    m_dataBuffer->clear();
+
+    // 记录开始时间
+    m_startTime = QDateTime::currentMSecsSinceEpoch() / 1000.0;
+
+    // 启动显示
+    m_waveformWidget->startDisplay();
+    m_stftEngine->setSampleRate(ui->sampleRateSpinBox->value());
+    m_frequencyTracker->setSampleRate(ui->sampleRateSpinBox->value());
+    m_dataBuffer->setSharedStreamSampleRate(ui->sampleRateSpinBox->value());
+    m_frequencyTracker->setWindowLength(qMax(64, static_cast<int>(ui->sampleRateSpinBox->value() * 0.1)));
+    updateSpectrogramChannel();
+    m_spectrogramWidget->startDisplay();
+
+    m_isAcquiring = true;
+    ui->startAcquisitionButton->setEnabled(false);
+    ui->stopAcquisitionButton->setEnabled(true);
+    ui->saveDataButton->setEnabled(false);
+    ui->analyzeButton->setEnabled(false);
+    ui->taskInfoAction->setEnabled(false);
+    ui->channelSelectAction->setEnabled(false);
+    ui->connectDeviceAction->setEnabled(false);
+
+    statusBar()->showMessage("正在采集数据...");
+}
+void MainWindow::onStopAcquisitionClicked()
+{
+    m_waveformWidget->stopDisplay();
+    m_spectrogramWidget->stopDisplay();
+    m_isAcquiring = false;
+    ui->startAcquisitionButton->setEnabled(true);
+    ui->stopAcquisitionButton->setEnabled(false);
+    ui->saveDataButton->setEnabled(true);
+    ui->analyzeButton->setEnabled(true);
+    ui->taskInfoAction->setEnabled(true);
+    ui->channelSelectAction->setEnabled(true);
+    ui->connectDeviceAction->setEnabled(true);
+
+    statusBar()->showMessage("采集已停止");
+}
+void MainWindow::onSaveDataClicked()
+{
+    if (!m_isDatabaseConnected) {
+        QMessageBox::warning(this, "警告", "请先连接数据库");
+        return;
+    }
+    if (!validateTaskInfo()) {
+        return;
+    }
+
+    // 准备任务信息
+    TaskInfo taskInfo;
+    taskInfo.taskName = ui->taskNameEdit->text();
+    taskInfo.sampleRate = ui->sampleRateSpinBox->value();
+    taskInfo.description = ui->taskDescEdit->toPlainText();
+    taskInfo.channelCount = 13;
+    taskInfo.enabledChannels = getSelectedChannels();
+
+    // 计算时长
+    QVector<int> channels = getSelectedChannels();
+    if (!channels.isEmpty()) {
+        QVector<DataPoint> data = m_dataBuffer->getAllChannelData(channels[0]);
+        if (!data.isEmpty()) {
+            taskInfo.duration = data.last().time - data.first().time;
+        }
+    }
+
+    // 获取所有通道数据
+    QVector<QVector<DataPoint>> channelData;
+    for (int ch : channels) {
+        channelData.append(m_dataBuffer->getAllChannelData(ch));
+    }
+
+    // 分析线程先生成分析索引，再由数据库线程保存
+    QMetaObject::invokeMethod(m_analysisWorker, "prepareTaskData",
+                              Qt::QueuedConnection,
+                              Q_ARG(TaskInfo, taskInfo),
+                              Q_ARG(QVector<QVector<DataPoint>>, channelData));
+
+    statusBar()->showMessage("正在保存数据...");
+}
+void MainWindow::onClearDataClicked()
+{
+    QMessageBox::StandardButton reply = QMessageBox::question(
+        this, "确认", "确定要清空当前数据吗?",
+        QMessageBox::Yes | QMessageBox::No);
+    if (reply == QMessageBox::Yes) {
+        m_dataBuffer->clear();
+        m_waveformWidget->clearDisplay();
+        m_stftEngine->reset();
+        m_frequencyTracker->reset();
+        m_spectrogramWidget->clearDisplay();
+        ui->dataPointsValue->setText("0");
+        statusBar()->showMessage("数据已清空");
+    }
+}
+// ========== 数据库槽函数 ==========
+void MainWindow::onConnectDatabaseClicked()
+{
+    QString host = ui->dbHostEdit->text();
+    int port = ui->dbPortSpinBox->value();
+    QString dbName = ui->dbNameEdit->text();
+    QString user = ui->dbUserEdit->text();
+    QString password = ui->dbPasswordEdit->text();
+    if (m_dbManager->connectToDatabase(host, port, dbName, user, password)) {
+        m_isDatabaseConnected = true;
+        ui->connectDbButton->setEnabled(false);
+        ui->dbConfigGroupBox->setEnabled(false);
+        ui->viewHistoryButton->setEnabled(true);
+        ui->viewHistoryAction->setEnabled(true);
+
+        ui->dbStatusValue->setText("已连接");
+        ui->dbStatusValue->setStyleSheet("QLabel { color: green; font-weight: bold; }");
+
+        statusBar()->showMessage("数据库已连接");
+
+        // 关闭对话框
+        ui->databaseDialog->close();
+
+        QMessageBox::information(this, "成功", "数据库连接成功");
+
+        // 旧版本数据库缺少覆盖索引：询问后在数据库线程中一次性补建，不阻塞界面
+        if (!m_dbManager->hasRawDataTimeIndex()
+            && QMessageBox::question(this, "数据库迁移",
+                                     "原始数据表缺少时间索引，区间统计会较慢。\n"
+                                     "是否现在补建？数据量大时可能耗时较长。")
+                   == QMessageBox::Yes) {
+            QMetaObject::invokeMethod(m_databaseWorker, "migrateRawDataIndex",
+                                      Qt::QueuedConnection);
+        }
+    } else {
+        QMessageBox::critical(this, "错误",
+                              QString("数据库连接失败: %1").arg(m_dbManager->getLastError()));
+    }
+}
+void MainWindow::onViewHistoryClicked()
+{
+    if (!m_isDatabaseConnected) {
+        QMessageBox::warning(this, "警告", "请先连接数据库");
+        return;
+    }
+    HistoryViewer* viewer = new HistoryViewer(m_dbManager, this);
+    connect(viewer, &HistoryViewer::replayRequested,
+            this, &MainWindow::onReplayTask);
+    viewer->exec();
+    delete viewer;
+}
+void MainWindow::onReplayTask(int taskId)
+{
+    statusBar()->showMessage("正在加载历史数据...");
+    // 停止当前采集
+    if (m_isAcquiring) {
+        onStopAcquisitionClicked();
+    }
+
+    // 获取任务信息
+    TaskInfo task = m_dbManager->getTask(taskId);
+
+    // 加载多通道数据
+    m_waveformWidget->clearDisplayData();
+
+    for (int ch : task.enabledChannels) {
+        QVector<DataPoint> data = m_dbManager->loadRawData(taskId, ch);
+        if (!data.isEmpty()) {
+            m_waveformWidget->setDisplayData(ch, data);
+        }
+    }
+
+    m_currentTaskId = taskId;
+    statusBar()->showMessage("历史数据回放中");
+}
+// ========== 录制文件槽函数 ==========
+void MainWindow::onExportRecordingClicked()
+{
+    QVector<int> channels = getSelectedChannels();
+    QVector<QVector<DataPoint>> channelData;
+    QVector<int> exportedChannels;
+    double startTime = 0.0;
+    for (int ch : channels) {
+        QVector<DataPoint> data = m_dataBuffer->getAllChannelData(ch);
+        if (!data.isEmpty()) {
+            if (exportedChannels.isEmpty() || data.first().time < startTime) {
+                startTime = data.first().time;
+            }
+            exportedChannels.append(ch);
+            channelData.append(data);
+        }
+    }
+    if (exportedChannels.isEmpty()) {
+        QMessageBox::warning(this, "警告", "没有可导出的数据");
+        return;
+    }
+
+    QString taskName = ui->taskNameEdit->text().trimmed();
+    QString filePath = QFileDialog::getSaveFileName(
+        this, "导出录制文件",
+        QString("%1.darec").arg(taskName.isEmpty() ? QString("recording") : taskName),
+        "录制文件 (*.darec)");
+    if (filePath.isEmpty()) {
+        return;
+    }
+
+    RecordingSettings settings;
+    settings.sampleRate = ui->sampleRateSpinBox->value();
+    settings.startTime = startTime;
+    settings.taskName = taskName;
+    settings.channels = exportedChannels;
+
+    // 已知ADC缩放系数的通道直接存码值（int16/int24），否则存float32幅值
+    int integerChannels = 0;
+    for (int i = 0; i < exportedChannels.size(); ++i) {
+        double scale = m_iioReceiver->getChannelScale(exportedChannels[i]);
+        RecordingFormat::SampleType type = RecordingWriter::integerSampleType(channelData[i], scale);
+        settings.scales.append(type == RecordingFormat::Float32 ? 1.0 : scale);
+        settings.sampleTypes.append(type);
+        if (type != RecordingFormat::Float32) {
+            ++integerChannels;
+        }
+    }
+
+    statusBar()->showMessage("正在导出录制文件...");
+    QElapsedTimer timer;
+    timer.start();
+
+    QString error;
+    if (!RecordingWriter::writeRecording(filePath, settings, channelData, &error)) {
+        QMessageBox::critical(this, "错误", QString("导出录制文件失败: %1").arg(error));
+        statusBar()->showMessage("导出录制文件失败", 3000);
+        return;
+    }
+
+    statusBar()->showMessage(QString("已导出 %1 个通道到录制文件（%2 个按ADC码值存储），耗时 %3 ms")
+                                 .arg(exportedChannels.size()).arg(integerChannels)
+                                 .arg(timer.elapsed()), 5000);
+}
+
+void MainWindow::onOpenRecordingClicked()
+{
+    QString filePath = QFileDialog::getOpenFileName(this, "打开录制文件", QString(),
+                                                    "录制文件 (*.darec)");
+    if (filePath.isEmpty()) {
+        return;
+    }
+
+    RecordingReader reader;
+    if (!reader.open(filePath)) {
+        QMessageBox::critical(this, "错误", QString("打开录制文件失败: %1").arg(reader.lastError()));
+        return;
+    }
+    if (reader.wasRecovered()) {
+        QMessageBox::warning(this, "提示", "录制文件未正常结束，已从数据块中恢复可读取的部分");
+    }
+
+    QVector<int> channels = reader.channels();
+    double firstTime = 0.0;
+    double lastTime = 0.0;
+    bool hasData = false;
+    for (int ch : channels) {
+        if (reader.sampleCount(ch) == 0) {
+            continue;
+        }
+        if (!hasData || reader.startTime(ch) < firstTime) {
+            firstTime = reader.startTime(ch);
+        }
+        if (!hasData || reader.endTime(ch) > lastTime) {
+            lastTime = reader.endTime(ch);
+        }
+        hasData = true;
+    }
+    if (!hasData) {
+        QMessageBox::warning(this, "警告", "录制文件中没有数据");
+        return;
+    }
+
+    // 超过一个显示窗口时选择起始时间，只读取该时间段
+    double windowStart = firstTime;
+    if (lastTime - firstTime > RECORDING_REPLAY_WINDOW) {
+        bool ok = false;
+        windowStart = QInputDialog::getDouble(
+            this, "打开录制文件",
+            QString("录制时长 %1 秒，起始时间（秒）:").arg(lastTime - firstTime, 0, 'f', 1),
+            firstTime, firstTime, lastTime, 3, &ok);
+        if (!ok) {
+            return;
+        }
+    }
+
+    if (m_isAcquiring) {
+        onStopAcquisitionClicked();
+    }
+    m_waveformWidget->clearDisplayData();
+
+    for (int ch : channels) {
+        QVector<DataPoint> data = reader.readRange(ch, windowStart,
+                                                   windowStart + RECORDING_REPLAY_WINDOW);
+        if (!data.isEmpty()) {
+            m_waveformWidget->setDisplayData(ch, data);
+        }
+    }
+
+    statusBar()->showMessage(QString("录制文件回放中: %1 (%2 - %3 秒)")
+                                 .arg(reader.taskName())
+                                 .arg(windowStart, 0, 'f', 3)
+                                 .arg(windowStart + RECORDING_REPLAY_WINDOW, 0, 'f', 3));
+}
+// ========== 数据分析槽函数 ==========
+void MainWindow::onAnalyzeDataClicked()
+{
+    QVector<int> channels = getSelectedChannels();
+    QVector<QVector<DataPoint>> channelData;
+    for (int ch : channels) {
+        channelData.append(m_dataBuffer->getAllChannelData(ch));
+    }
+
+    if (channelData.isEmpty()) {
+        QMessageBox::warning(this, "警告", "没有可分析的数据");
+        return;
+    }
+
+    double sampleRate = ui->sampleRateSpinBox->value();
+
+    // 在工作线程中分析
+    QMetaObject::invokeMethod(m_analysisWorker, "analyzeData",
+                              Qt::QueuedConnection,
+                              Q_ARG(QVector<QVector<DataPoint>>, channelData),
+                              Q_ARG(int, m_currentTaskId),
+                              Q_ARG(double, sampleRate));
+
+    statusBar()->showMessage("正在分析数据...");
+}
+void MainWindow::onAnalysisCompleted(const QVector<AnalysisResult>& results)
+{
+    QString message = "=== 分析结果 ===\n\n";
+    for (const auto& result : results) {
+        message += QString("通道 %1:\n").arg(result.channel);
+        message += QString("  最大幅值: %1\n").arg(result.maxAmplitude);
+        message += QString("  最小幅值: %1\n").arg(result.minAmplitude);
+        message += QString("  平均幅值: %1\n").arg(result.avgAmplitude);
+        message += QString("  均方根值: %1\n").arg(result.rmsValue);
+        message += QString("  主频率: %1 Hz\n\n").arg(result.frequency);
+    }
+
+    if (!m_lastCorrelations.isEmpty()) {
+        // 通道对较多时只列出相干性最强的几对
+        const int maxListed = 10;
+        QVector<CorrelationResult> sorted = m_lastCorrelations;
+        std::sort(sorted.begin(), sorted.end(),
+                  [](const CorrelationResult& a, const CorrelationResult& b) {
+                      return a.meanCoherence > b.meanCoherence;
+                  });
+        if (sorted.size() > maxListed) {
+            sorted.resize(maxListed);
+        }
+
+        message += QString("=== 通道间相关（共 %1 对，按平均相干排序）===\n\n")
+                       .arg(m_lastCorrelations.size());
+        for (const auto& correlation : sorted) {
+            message += QString("通道 %1-%2: 相关 %3, 延迟 %4 ms, 平均相干 %5\n")
+                           .arg(correlation.channelA)
+                           .arg(correlation.channelB)
+                           .arg(correlation.peakCorrelation, 0, 'f', 3)
+                           .arg(correlation.lagSeconds * 1000.0, 0, 'g', 4)
+                           .arg(correlation.meanCoherence, 0, 'f', 3);
+        }
+    }
+
+    QMessageBox::information(this, "分析结果", message);
+
+    // 如果已连接数据库,保存分析结果
+    if (m_isDatabaseConnected) {
+        QMetaObject::invokeMethod(m_databaseWorker, "saveAnalysisResults",
+                                  Qt::QueuedConnection,
+                                  Q_ARG(QVector<AnalysisResult>, results));
+        if (!m_lastCorrelations.isEmpty()) {
+            QMetaObject::invokeMethod(m_databaseWorker, "saveCorrelationResults",
+                                      Qt::QueuedConnection,
+                                      Q_ARG(QVector<CorrelationResult>, m_lastCorrelations));
+        }
+    }
+
+    statusBar()->showMessage("分析完成");
+}
+void MainWindow::onCorrelationCompleted(const QVector<CorrelationResult>& results)
+{
+    // 在 analysisCompleted 之前到达，与通道结果一起显示和保存
+    m_lastCorrelations = results;
+}
+void MainWindow::onSaveCompleted(bool success, const QString& message)
+{
+    if (success) {
+        QMessageBox::information(this, "成功", message);
+    } else {
+        QMessageBox::critical(this, "错误", message);
+    }
+    statusBar()->showMessage(message);
+}
+// ========== 通道管理 ==========
+void MainWindow::onChannelVisibilityChanged(int channel, int state)
+{
+    bool visible = (state == Qt::Checked);
+    m_enabledChannels.setBit(channel, visible);
+    m_waveformWidget->setChannelVisible(channel, visible);
+    updateSpectrogramChannel();
+    // 更新启用通道数
+    int enabledCount = 0;
+    for (int i = 0; i < MAX_CHANNELS; ++i) {
+        if (m_enabledChannels.testBit(i)) enabledCount++;
+    }
+    ui->channelCountValue->setText(QString::number(enabledCount));
+
+    // 如果正在连接,更新接收器的通道配置
+    if (m_iioReceiver->isConnected()) {
+        m_iioReceiver->setEnabledChannels(getSelectedChannels());
+    }
+}
+void MainWindow::updateStatusBar()
+{
+    // 更新数据点数
+    QString countText;
+    QVector<int> channels = getSelectedChannels();
+    int totalPoints = 0;
+    for (int ch : channels) {
+        int count = m_dataBuffer->getDataCount(ch);
+        totalPoints += count;
+    }
+
+    ui->dataPointsValue->setText(QString::number(totalPoints));
+
+    updateTrackerDisplay();
+}
+
+void MainWindow::updateTrackerDisplay()
+{
+    // 显示时频图当前通道的跟踪结果：频率 幅值∠相位
+    int channel = m_spectrogramWidget->channel();
+    QVector<ToneMeasurement> tones = m_frequencyTracker->measurements(channel);
+    if (tones.isEmpty()) {
+        ui->trackerValue->setText("未设置");
+        return;
+    }
+
+    QStringList parts;
+    for (const ToneMeasurement& tone : tones) {
+        if (!tone.valid) {
+            parts << QString("%1Hz 累积中").arg(tone.frequency);
+            continue;
+        }
+        parts << QString("%1Hz %2∠%3°")
+                     .arg(tone.frequency)
+                     .arg(tone.amplitude, 0, 'g', 4)
+                     .arg(tone.phase * 180.0 / M_PI, 0, 'f', 1);
+    }
+    ui->trackerValue->setText(QString("通道%1: ").arg(channel) + parts.join("  "));
+}
+// ========== 辅助函数 ==========
+bool MainWindow::validateTaskInfo()
+{
+    if (ui->taskNameEdit->text().trimmed().isEmpty()) {
+        QMessageBox::warning(this, "警告", "请输入任务名称");
+        return false;
+    }
+    if (getSelectedChannels().isEmpty()) {
+        QMessageBox::warning(this, "警告", "请至少选择一个通道");
+        return false;
+    }
+
+    return true;
+}
+
+void MainWindow::updateSpectrogramChannel()
+{
+    // 时频图显示的通道被取消时，切换到第一个选中的通道
+    QVector<int> channels = getSelectedChannels();
+    if (!channels.isEmpty() && !channels.contains(m_spectrogramWidget->channel())) {
+        m_spectrogramWidget->setChannel(channels.first());
+    }
+}
+
+QVector<int> MainWindow::getSelectedChannels()
+{
+    QVector<int> channels;
+    for (int i = 0; i < 13; ++i) {
+        if (ui->channelCheckBoxes[i]->isChecked()) {
+            channels.append(i);
+        }
+    }
+    return channels;
+}
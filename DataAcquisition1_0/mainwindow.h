@@ -1,149 +1,182 @@
-#ifndef MAINWINDOW_H
-#define MAINWINDOW_H
-
-#include <QMainWindow>
-#include <QTimer>
-#include <QLabel>
-#include <QThread>
-#include <QVector>
-#include <QBitArray>
-#include "databuffer.h"
-#include "iioreceiver.h"
-#include "waveformwidget.h"
-#include "databasemanager.h"
-#include "dataprocessor.h"
-#include "dataanalyzer.h"
-#include "historyviewer.h"
-#include "mainwindow_ui.h"
-
-// 数据库工作线程
-class DatabaseWorker : public QObject
-{
-    Q_OBJECT
-public:
-    explicit DatabaseWorker(DatabaseManager* dbManager, QObject *parent = nullptr)
-        : QObject(parent), m_dbManager(dbManager) {}
-
-public slots:
-    void saveTaskData(const TaskInfo& taskInfo,
-                      const QVector<QVector<DataPoint>>& channelData);
-    void saveAnalysisResults(const QVector<AnalysisResult>& results);
-
-signals:
-    void saveCompleted(bool success, const QString& message);
-    void progressUpdated(int percentage, const QString& message);
-
-private:
-    DatabaseManager* m_dbManager;
-};
-
-// 分析工作线程
-class AnalysisWorker : public QObject
-{
-    Q_OBJECT
-public:
-    explicit AnalysisWorker(DataAnalyzer* analyzer, QObject *parent = nullptr)
-        : QObject(parent), m_analyzer(analyzer) {}
-
-public slots:
-    void analyzeData(const QVector<QVector<DataPoint>>& channelData,
-                     int taskId, double sampleRate);
-
-signals:
-    void analysisCompleted(const QVector<AnalysisResult>& results);
-    void progressUpdated(int percentage, const QString& message);
-
-private:
-    DataAnalyzer* m_analyzer;
-};
-
-class MainWindow : public QMainWindow
-{
-    Q_OBJECT
-
-public:
-    MainWindow(QWidget *parent = nullptr);
-    ~MainWindow();
-
-private slots:
-    // IIO设备连接
-    void onShowDeviceDialog();
-    void onConnectClicked();
-    void onDisconnectClicked();
-    void onIioConnected();
-    void onIioDisconnected();
-    void onIioError(const QString& error);
-    void onIioStatusChanged(const QString& status);
-
-    // 数据采集
-    void onStartAcquisitionClicked();
-    void onStopAcquisitionClicked();
-    void onSaveDataClicked();
-    void onClearDataClicked();
-
-    // 数据库连接
-    void onShowDatabaseDialog();
-    void onConnectDatabaseClicked();
-
-    // 通道显示
-    void onShowChannelDialog();
-    void onChannelVisibilityChanged(int channel, int state);
-    void updateStatusBar();
-
-    // 历史数据
-    void onViewHistoryClicked();
-    void onReplayTask(int taskId);
-
-    // 数据分析
-    void onAnalyzeDataClicked();
-    void onAnalysisCompleted(const QVector<AnalysisResult>& results);
-
-    // 数据保存完成
-    void onSaveCompleted(bool success, const QString& message);
-
-    // 菜单槽函数
-    void onShowTaskDialog();
-    void onShowAbout();
-
-private:
-    void setupUi();
-    void connectSignals();
-    void updateConnectionStatus();
-    bool validateTaskInfo();
-    QVector<int> getSelectedChannels();
-
-    MainWindowUI *ui;
-
-    // 核心组件
-    DataBuffer* m_dataBuffer;
-    IioReceiver* m_iioReceiver;
-    WaveformWidget* m_waveformWidget;
-    DatabaseManager* m_dbManager;
-    DataProcessor* m_dataProcessor;
-    DataAnalyzer* m_dataAnalyzer;
-
-    // 多线程
-    QThread* m_databaseThread;
-    DatabaseWorker* m_databaseWorker;
-    QThread* m_analysisThread;
-    AnalysisWorker* m_analysisWorker;
-
-    // 状态标签
-    QLabel* m_statusLabel;
-    QLabel* m_connectionLabel;
-    QLabel* m_dataCountLabel;
-
-    // 定时器
-    QTimer* m_statusUpdateTimer;
-
-    // 状态标志
-    bool m_isAcquiring;
-    bool m_isDatabaseConnected;
-    int m_currentTaskId;
-
-    // 采集参数
-    double m_startTime;
-    QBitArray m_enabledChannels;
-};
-
-#endif // MAINWINDOW_H
+#ifndef MAINWINDOW_H
+#define MAINWINDOW_H
+
+#include <QMainWindow>
+#include <QTimer>
+#include <QLabel>
+#include <QThread>
+#include <QVector>
+#include <QBitArray>
+#include "databuffer.h"
+#include "iioreceiver.h"
+#include "waveformwidget.h"
+#include "stftengine.h"
+#include "spectrogramwidget.h"
+#include "frequencytracker.h"
+#include "databasemanager.h"
+#include "dataprocessor.h"
+#include "dataanalyzer.h"
+#include "workstealingpool.h"
+#include "crosschannelanalyzer.h"
+#include "blockindex.h"
+#include "recordingfile.h"
+#include "sharedstreamlayout.h"
+#include "historyviewer.h"
+#include "mainwindow_ui.h"
+
+// 数据库工作线程
+class DatabaseWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DatabaseWorker(DatabaseManager* dbManager, QObject *parent = nullptr)
+        : QObject(parent), m_dbManager(dbManager) {}
+
+public slots:
+    // 任务、原始数据与分析索引在同一事务中保存；summaries 由分析线程预先计算
+    void saveTaskData(const TaskInfo& taskInfo,
+                      const QVector<QVector<DataPoint>>& channelData,
+                      const QVector<QVector<BlockSummary>>& summaries);
+    void saveAnalysisResults(const QVector<AnalysisResult>& results);
+    void saveCorrelationResults(const QVector<CorrelationResult>& results);
+    void migrateRawDataIndex();
+
+signals:
+    void saveCompleted(bool success, const QString& message);
+    void progressUpdated(int percentage, const QString& message);
+
+private:
+    DatabaseManager* m_dbManager;
+};
+
+// 分析工作线程
+class AnalysisWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit AnalysisWorker(WorkStealingPool* pool, QObject *parent = nullptr)
+        : QObject(parent), m_pool(pool) {}
+
+public slots:
+    void analyzeData(const QVector<QVector<DataPoint>>& channelData,
+                     int taskId, double sampleRate);
+    // 保存前计算各通道的块级分析索引（任务号待数据库线程创建任务后填入），完成后发出 taskDataPrepared
+    void prepareTaskData(const TaskInfo& taskInfo,
+                         const QVector<QVector<DataPoint>>& channelData);
+
+signals:
+    void taskDataPrepared(const TaskInfo& taskInfo,
+                          const QVector<QVector<DataPoint>>& channelData,
+                          const QVector<QVector<BlockSummary>>& summaries);
+    void analysisCompleted(const QVector<AnalysisResult>& results);
+    void correlationCompleted(const QVector<CorrelationResult>& results);
+    void progressUpdated(int percentage, const QString& message);
+
+private:
+    WorkStealingPool* m_pool;   // 各通道（及长数据的分块）在线程池中并行分析
+};
+
+class MainWindow : public QMainWindow
+{
+    Q_OBJECT
+
+public:
+    MainWindow(QWidget *parent = nullptr);
+    ~MainWindow();
+
+private slots:
+    // IIO设备连接
+    void onShowDeviceDialog();
+    void onConnectClicked();
+    void onDisconnectClicked();
+    void onIioConnected();
+    void onIioDisconnected();
+    void onIioError(const QString& error);
+    void onIioStatusChanged(const QString& status);
+    void onSharedStreamToggled(bool enabled);
+
+    // 数据采集
+    void onStartAcquisitionClicked();
+    void onStopAcquisitionClicked();
+    void onSaveDataClicked();
+    void onClearDataClicked();
+
+    // 数据库连接
+    void onShowDatabaseDialog();
+    void onConnectDatabaseClicked();
+
+    // 通道显示
+    void onShowChannelDialog();
+    void onChannelVisibilityChanged(int channel, int state);
+    void updateStatusBar();
+
+    // 历史数据
+    void onViewHistoryClicked();
+    void onReplayTask(int taskId);
+
+    // 录制文件
+    void onExportRecordingClicked();
+    void onOpenRecordingClicked();
+
+    // 数据分析
+    void onAnalyzeDataClicked();
+    void onAnalysisCompleted(const QVector<AnalysisResult>& results);
+    void onCorrelationCompleted(const QVector<CorrelationResult>& results);
+
+    // 数据保存完成
+    void onSaveCompleted(bool success, const QString& message);
+
+    // 菜单槽函数
+    void onShowTaskDialog();
+    void onShowAbout();
+    void onShowTrackerDialog();
+
+private:
+    void setupUi();
+    void connectSignals();
+    void updateConnectionStatus();
+    bool validateTaskInfo();
+    QVector<int> getSelectedChannels();
+    void updateSpectrogramChannel();
+    void updateTrackerDisplay();
+
+    MainWindowUI *ui;
+
+    // 核心组件
+    DataBuffer* m_dataBuffer;
+    IioReceiver* m_iioReceiver;
+    WaveformWidget* m_waveformWidget;
+    SpectrogramWidget* m_spectrogramWidget;
+    DatabaseManager* m_dbManager;
+    DataProcessor* m_dataProcessor;
+    DataAnalyzer* m_dataAnalyzer;
+
+    // 多线程
+    QThread* m_databaseThread;
+    DatabaseWorker* m_databaseWorker;
+    QThread* m_analysisThread;
+    AnalysisWorker* m_analysisWorker;
+    QThread* m_streamThread;        // 流式处理线程（STFT、频率跟踪）
+    StftEngine* m_stftEngine;
+    FrequencyTracker* m_frequencyTracker;
+
+    // 状态标签
+    QLabel* m_statusLabel;
+    QLabel* m_connectionLabel;
+    QLabel* m_dataCountLabel;
+
+    // 定时器
+    QTimer* m_statusUpdateTimer;
+
+    // 状态标志
+    bool m_isAcquiring;
+    bool m_isDatabaseConnected;
+    int m_currentTaskId;
+    QVector<CorrelationResult> m_lastCorrelations;  // 最近一次分析的通道间结果
+
+    // 采集参数
+    double m_startTime;
+    QBitArray m_enabledChannels;
+};
+
+#endif // MAINWINDOW_H
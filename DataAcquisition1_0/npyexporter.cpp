@@ -0,0 +1,635 @@
+#include "npyexporter.h"
+#include <QSaveFile>
+#include <QDateTime>
+#include <QDebug>
+#include <QFileInfo>
+#include <QDir>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace {
+
+// 写缓冲区大小
+const int WRITE_BUFFER_SIZE = 1 << 20;
+// 从数据库导出时每页读取的样本数
+const int EXPORT_PAGE_SIZE = 65536;
+// NPY头的固定总长度（含魔数、版本和长度字段），64字节对齐，
+// 足够容纳两个20位数字的形状
+const int NPY_HEADER_SIZE = 128;
+// 不使用ZIP64时偏移和大小的上限
+const qint64 ZIP_LIMIT = 0xFFFFFFFFLL;
+
+const quint32 ZIP_LOCAL_HEADER_SIGNATURE = 0x04034b50;
+const quint32 ZIP_CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+const quint32 ZIP_END_SIGNATURE = 0x06054b50;
+const int ZIP_LOCAL_HEADER_SIZE = 30;
+
+// CRC-32（ZIP使用的IEEE多项式）
+class Crc32
+{
+public:
+    Crc32() : m_value(0xFFFFFFFFu) {}
+
+    void update(const char* data, qint64 size)
+    {
+        static const std::vector<quint32> table = makeTable();
+        const uchar* bytes = reinterpret_cast<const uchar*>(data);
+        quint32 crc = m_value;
+        for (qint64 i = 0; i < size; ++i) {
+            crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+        }
+        m_value = crc;
+    }
+
+    quint32 value() const { return m_value ^ 0xFFFFFFFFu; }
+
+private:
+    static std::vector<quint32> makeTable()
+    {
+        std::vector<quint32> table(256);
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+            table[i] = c;
+        }
+        return table;
+    }
+
+    quint32 m_value;
+};
+
+void appendLittleEndian16(QByteArray* out, quint16 value)
+{
+    out->append(static_cast<char>(value & 0xFF));
+    out->append(static_cast<char>((value >> 8) & 0xFF));
+}
+
+void appendLittleEndian32(QByteArray* out, quint32 value)
+{
+    for (int i = 0; i < 4; ++i) {
+        out->append(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+// DOS格式的当前日期时间（ZIP文件头使用）
+void currentDosDateTime(quint16* dosDate, quint16* dosTime)
+{
+    QDateTime now = QDateTime::currentDateTime();
+    QDate date = now.date();
+    QTime time = now.time();
+    *dosDate = static_cast<quint16>(((std::max(date.year(), 1980) - 1980) << 9)
+                                    | (date.month() << 5) | date.day());
+    *dosTime = static_cast<quint16>((time.hour() << 11) | (time.minute() << 5)
+                                    | (time.second() / 2));
+}
+
+} // namespace
+
+// 单个数组的写入器：转换为目标类型后按块写入，同时累计CRC（.npz需要）
+// 写满声明的样本数后忽略多余的数据
+class NpyArrayWriter
+{
+public:
+    NpyArrayWriter(QIODevice* device, NpyExporter::DataType type, double integerScale)
+        : m_device(device)
+        , m_type(type)
+        , m_inverseScale(integerScale != 0.0 ? 1.0 / integerScale : 1.0)
+        , m_buffer(WRITE_BUFFER_SIZE)
+        , m_used(0)
+        , m_remaining(0)
+        , m_bytesWritten(0)
+        , m_error(false)
+    {
+    }
+
+    // 开始一个数组（或矩阵的一行），最多接受 count 个样本
+    void begin(qint64 count) { m_remaining = count; }
+    qint64 remaining() const { return m_remaining; }
+
+    void resetChecksum()
+    {
+        m_crc = Crc32();
+        m_bytesWritten = 0;
+    }
+
+    void writeRaw(const char* data, qint64 size)
+    {
+        if (m_used + size > WRITE_BUFFER_SIZE && !flush()) {
+            return;
+        }
+        if (size > WRITE_BUFFER_SIZE) {
+            writeDevice(data, size);
+            return;
+        }
+        std::memcpy(m_buffer.data() + m_used, data, size);
+        m_used += static_cast<int>(size);
+    }
+
+    void writeValues(const DataPoint* data, int count)
+    {
+        qint64 n = std::min<qint64>(count, m_remaining);
+        switch (m_type) {
+        case NpyExporter::Float32:
+            convert<float>(data, n, [](double value) { return static_cast<float>(value); });
+            break;
+        case NpyExporter::Float64:
+            convert<double>(data, n, [](double value) { return value; });
+            break;
+        case NpyExporter::Int32: {
+            double inverseScale = m_inverseScale;
+            convert<qint32>(data, n, [inverseScale](double value) {
+                double scaled = std::round(value * inverseScale);
+                if (std::isnan(scaled)) {
+                    return qint32(0);
+                }
+                scaled = std::min(std::max(scaled, double(std::numeric_limits<qint32>::min())),
+                                  double(std::numeric_limits<qint32>::max()));
+                return static_cast<qint32>(scaled);
+            });
+            break;
+        }
+        }
+        m_remaining -= n;
+    }
+
+    bool flush()
+    {
+        if (m_error) {
+            return false;
+        }
+        if (m_used > 0) {
+            writeDevice(m_buffer.data(), m_used);
+            m_used = 0;
+        }
+        return !m_error;
+    }
+
+    bool hasError() const { return m_error; }
+    quint32 checksum() const { return m_crc.value(); }
+    qint64 bytesWritten() const { return m_bytesWritten + m_used; }
+
+private:
+    template <typename T, typename Convert>
+    void convert(const DataPoint* data, qint64 count, Convert toValue)
+    {
+        const int perBuffer = WRITE_BUFFER_SIZE / static_cast<int>(sizeof(T));
+        qint64 done = 0;
+        while (done < count && !m_error) {
+            int space = (WRITE_BUFFER_SIZE - m_used) / static_cast<int>(sizeof(T));
+            if (space == 0) {
+                flush();
+                space = perBuffer;
+            }
+            int n = static_cast<int>(std::min<qint64>(space, count - done));
+            char* out = m_buffer.data() + m_used;
+            for (int i = 0; i < n; ++i) {
+                T value = toValue(data[done + i].amplitude);
+                std::memcpy(out + i * sizeof(T), &value, sizeof(T));
+            }
+            m_used += n * static_cast<int>(sizeof(T));
+            done += n;
+        }
+    }
+
+    void writeDevice(const char* data, qint64 size)
+    {
+        if (m_device->write(data, size) != size) {
+            m_error = true;
+            return;
+        }
+        m_crc.update(data, size);
+        m_bytesWritten += size;
+    }
+
+    QIODevice* m_device;
+    NpyExporter::DataType m_type;
+    double m_inverseScale;
+    std::vector<char> m_buffer;
+    int m_used;
+    qint64 m_remaining;
+    qint64 m_bytesWritten;
+    Crc32 m_crc;
+    bool m_error;
+};
+
+namespace {
+
+// NPY 1.0头：魔数、版本、头长度和Python字典文本，用空格补齐到固定长度并以换行结尾
+QByteArray npyHeader(NpyExporter::DataType type, int rows, qint64 columns)
+{
+    const char order = Q_BYTE_ORDER == Q_LITTLE_ENDIAN ? '<' : '>';
+    QString descr;
+    switch (type) {
+    case NpyExporter::Float32: descr = QString("%1f4").arg(order); break;
+    case NpyExporter::Float64: descr = QString("%1f8").arg(order); break;
+    case NpyExporter::Int32:   descr = QString("%1i4").arg(order); break;
+    }
+
+    QString shape = rows < 0
+        ? QString("(%1,)").arg(columns)
+        : QString("(%1, %2)").arg(rows).arg(columns);
+    QByteArray dict = QString("{'descr': '%1', 'fortran_order': False, 'shape': %2, }")
+                          .arg(descr).arg(shape).toUtf8();
+
+    QByteArray header("\x93NUMPY\x01\x00", 8);
+    appendLittleEndian16(&header, NPY_HEADER_SIZE - 10);
+    header.append(dict);
+    while (header.size() < NPY_HEADER_SIZE - 1) {
+        header.append(' ');
+    }
+    header.append('\n');
+    return header;
+}
+
+} // namespace
+
+NpyExporter::NpyExporter(QObject *parent)
+    : QObject(parent)
+    , m_dataType(Float64)
+    , m_integerScale(1.0)
+{
+}
+
+NpyExporter::~NpyExporter()
+{
+}
+
+int NpyExporter::itemSize() const
+{
+    return m_dataType == Float64 ? 8 : 4;
+}
+
+bool NpyExporter::exportChannelToNpy(const QString& filePath, const QVector<DataPoint>& data)
+{
+    if (data.isEmpty()) {
+        m_lastError = "数据为空";
+        return false;
+    }
+
+    return writeNpy(filePath, -1, data.size(), [&data](int, NpyArrayWriter& writer) {
+        writer.writeValues(data.constData(), data.size());
+        return !writer.hasError();
+    });
+}
+
+bool NpyExporter::exportMatrixToNpy(const QString& filePath,
+                                    const QVector<int>& channels,
+                                    const QVector<QVector<DataPoint>>& channelData)
+{
+    if (channels.size() != channelData.size()) {
+        m_lastError = "通道数量与数据数量不匹配";
+        return false;
+    }
+    if (channels.isEmpty()) {
+        m_lastError = "没有数据要导出";
+        return false;
+    }
+
+    qint64 columns = std::numeric_limits<qint64>::max();
+    for (const QVector<DataPoint>& data : channelData) {
+        columns = std::min<qint64>(columns, data.size());
+    }
+    for (const QVector<DataPoint>& data : channelData) {
+        if (data.size() != columns) {
+            qWarning() << "通道长度不同，矩阵截取到最短通道的" << columns << "个样本";
+            break;
+        }
+    }
+
+    bool success = writeNpy(filePath, channels.size(), columns,
+                            [&channelData](int index, NpyArrayWriter& writer) {
+        const QVector<DataPoint>& data = channelData[index];
+        writer.writeValues(data.constData(), data.size());
+        return !writer.hasError();
+    });
+
+    emit exportCompleted(success, success
+        ? QString("成功导出 %1 个通道的矩阵").arg(channels.size())
+        : m_lastError);
+    return success;
+}
+
+bool NpyExporter::exportMultiChannelToNpz(const QString& filePath,
+                                          const QVector<int>& channels,
+                                          const QVector<QVector<DataPoint>>& channelData)
+{
+    if (channels.size() != channelData.size()) {
+        m_lastError = "通道数量与数据数量不匹配";
+        return false;
+    }
+
+    QVector<int> exportedChannels;
+    QVector<qint64> lengths;
+    QVector<int> dataIndices;
+    for (int i = 0; i < channels.size(); ++i) {
+        if (!channelData[i].isEmpty()) {
+            exportedChannels.append(channels[i]);
+            lengths.append(channelData[i].size());
+            dataIndices.append(i);
+        }
+    }
+    if (exportedChannels.isEmpty()) {
+        m_lastError = "没有数据要导出";
+        return false;
+    }
+
+    bool success = writeNpz(filePath, exportedChannels, lengths,
+                            [&](int index, NpyArrayWriter& writer) {
+        const QVector<DataPoint>& data = channelData[dataIndices[index]];
+        writer.writeValues(data.constData(), data.size());
+        return !writer.hasError();
+    });
+
+    emit exportCompleted(success, success
+        ? QString("成功导出 %1 个通道的数据").arg(exportedChannels.size())
+        : m_lastError);
+    return success;
+}
+
+bool NpyExporter::exportStoredTaskToNpy(const QString& filePath,
+                                        DatabaseManager* dbManager, int taskId)
+{
+    if (!dbManager || !dbManager->isConnected()) {
+        m_lastError = "数据库未连接";
+        return false;
+    }
+
+    QVector<int> channels = dbManager->getTaskChannels(taskId);
+    if (channels.isEmpty()) {
+        m_lastError = "没有数据要导出";
+        return false;
+    }
+
+    // 矩阵头需要预先知道列数：各通道样本数取最小值（有分析索引时不扫描原始数据）
+    qint64 columns = std::numeric_limits<qint64>::max();
+    for (int channel : channels) {
+        columns = std::min(columns, dbManager->getChannelStatistics(taskId, channel).count);
+    }
+
+    bool success = writeNpy(filePath, channels.size(), columns,
+                            [&](int index, NpyArrayWriter& writer) {
+        return writeStoredChannel(dbManager, taskId, channels[index], writer);
+    });
+
+    emit exportCompleted(success, success
+        ? QString("成功导出任务 %1 的 %2 个通道").arg(taskId).arg(channels.size())
+        : m_lastError);
+    return success;
+}
+
+bool NpyExporter::exportStoredTaskToNpz(const QString& filePath,
+                                        DatabaseManager* dbManager, int taskId)
+{
+    if (!dbManager || !dbManager->isConnected()) {
+        m_lastError = "数据库未连接";
+        return false;
+    }
+
+    QVector<int> exportedChannels;
+    QVector<qint64> lengths;
+    for (int channel : dbManager->getTaskChannels(taskId)) {
+        qint64 count = dbManager->getChannelStatistics(taskId, channel).count;
+        if (count > 0) {
+            exportedChannels.append(channel);
+            lengths.append(count);
+        }
+    }
+    if (exportedChannels.isEmpty()) {
+        m_lastError = "没有数据要导出";
+        return false;
+    }
+
+    bool success = writeNpz(filePath, exportedChannels, lengths,
+                            [&](int index, NpyArrayWriter& writer) {
+        return writeStoredChannel(dbManager, taskId, exportedChannels[index], writer);
+    });
+
+    emit exportCompleted(success, success
+        ? QString("成功导出任务 %1 的 %2 个通道").arg(taskId).arg(exportedChannels.size())
+        : m_lastError);
+    return success;
+}
+
+bool NpyExporter::writeStoredChannel(DatabaseManager* dbManager, int taskId, int channel,
+                                     NpyArrayWriter& writer)
+{
+    QVector<DataPoint> page;
+    qint64 lastId = 0;
+    while (writer.remaining() > 0) {
+        if (!dbManager->loadRawDataPage(taskId, channel, &lastId, EXPORT_PAGE_SIZE, &page)) {
+            m_lastError = dbManager->getLastError();
+            return false;
+        }
+        if (page.isEmpty()) {
+            break;
+        }
+        writer.writeValues(page.constData(), page.size());
+        if (writer.hasError()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool NpyExporter::writeNpy(const QString& filePath, int rows, qint64 columns,
+                           const ChannelWriter& writeChannel)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QFileInfo fileInfo(filePath);
+    QDir dir = fileInfo.absoluteDir();
+    if (!dir.exists()) {
+        dir.mkpath(".");
+    }
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        m_lastError = QString("无法打开文件: %1").arg(file.errorString());
+        return false;
+    }
+
+    NpyArrayWriter writer(&file, m_dataType, m_integerScale);
+    QByteArray header = npyHeader(m_dataType, rows, columns);
+    writer.writeRaw(header.constData(), header.size());
+
+    int totalRows = rows < 0 ? 1 : rows;
+    for (int i = 0; i < totalRows; ++i) {
+        writer.begin(columns);
+        if (!writeChannel(i, writer) || writer.hasError()) {
+            if (writer.hasError()) {
+                m_lastError = QString("写入文件失败: %1").arg(file.errorString());
+            }
+            file.cancelWriting();
+            return false;
+        }
+        if (writer.remaining() > 0) {
+            // 数据比头中声明的少，文件将无法被 numpy 读取
+            m_lastError = QString("第 %1 行数据不足，缺少 %2 个样本").arg(i).arg(writer.remaining());
+            file.cancelWriting();
+            return false;
+        }
+        emit exportProgress(10 + ((i + 1) * 85 / totalRows),
+                            QString("已写入第 %1/%2 行").arg(i + 1).arg(totalRows));
+    }
+
+    if (!writer.flush() || !file.commit()) {
+        m_lastError = QString("写入文件失败: %1").arg(file.errorString());
+        return false;
+    }
+
+    emit exportProgress(100, "导出完成");
+    qDebug() << "NPY文件已保存到:" << filePath << "大小" << writer.bytesWritten()
+             << "字节，耗时" << timer.elapsed() << "ms";
+    return true;
+}
+
+bool NpyExporter::writeNpz(const QString& filePath, const QVector<int>& channels,
+                           const QVector<qint64>& lengths, const ChannelWriter& writeChannel)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // 不使用ZIP64：所有偏移和大小都必须小于4GB，写入前检查
+    qint64 estimated = 22;
+    for (int i = 0; i < channels.size(); ++i) {
+        qint64 nameLength = QString("%1.npy").arg(channels[i]).toUtf8().size();
+        estimated += ZIP_LOCAL_HEADER_SIZE + 46 + 2 * nameLength
+            + NPY_HEADER_SIZE + lengths[i] * itemSize();
+    }
+    if (estimated > ZIP_LIMIT) {
+        m_lastError = QString("数据约 %1 MB，超过 .npz 的4GB上限，请导出为 .npy")
+                          .arg(estimated / (1024 * 1024));
+        return false;
+    }
+
+    QFileInfo fileInfo(filePath);
+    QDir dir = fileInfo.absoluteDir();
+    if (!dir.exists()) {
+        dir.mkpath(".");
+    }
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        m_lastError = QString("无法打开文件: %1").arg(file.errorString());
+        return false;
+    }
+
+    quint16 dosDate = 0;
+    quint16 dosTime = 0;
+    currentDosDateTime(&dosDate, &dosTime);
+
+    NpyArrayWriter writer(&file, m_dataType, m_integerScale);
+    QByteArray centralDirectory;
+    qint64 offset = 0;
+
+    for (int i = 0; i < channels.size(); ++i) {
+        QByteArray name = QString("%1.npy").arg(channels[i]).toUtf8();
+        qint64 entrySize = NPY_HEADER_SIZE + lengths[i] * itemSize();
+
+        // 本地文件头：CRC在数据写完后回填，不压缩时大小已知
+        QByteArray local;
+        appendLittleEndian32(&local, ZIP_LOCAL_HEADER_SIGNATURE);
+        appendLittleEndian16(&local, 20);          // 所需版本
+        appendLittleEndian16(&local, 0);           // 标志
+        appendLittleEndian16(&local, 0);           // 存储，不压缩
+        appendLittleEndian16(&local, dosTime);
+        appendLittleEndian16(&local, dosDate);
+        appendLittleEndian32(&local, 0);           // CRC，稍后回填
+        appendLittleEndian32(&local, static_cast<quint32>(entrySize));
+        appendLittleEndian32(&local, static_cast<quint32>(entrySize));
+        appendLittleEndian16(&local, static_cast<quint16>(name.size()));
+        appendLittleEndian16(&local, 0);           // 扩展字段长度
+        local.append(name);
+
+        // 先把文件头写出，CRC只覆盖条目内容
+        writer.writeRaw(local.constData(), local.size());
+        if (!writer.flush()) {
+            m_lastError = QString("写入文件失败: %1").arg(file.errorString());
+            file.cancelWriting();
+            return false;
+        }
+        writer.resetChecksum();
+
+        QByteArray header = npyHeader(m_dataType, -1, lengths[i]);
+        writer.writeRaw(header.constData(), header.size());
+        writer.begin(lengths[i]);
+
+        if (!writeChannel(i, writer) || !writer.flush()) {
+            if (writer.hasError()) {
+                m_lastError = QString("写入文件失败: %1").arg(file.errorString());
+            }
+            file.cancelWriting();
+            return false;
+        }
+        if (writer.remaining() > 0) {
+            m_lastError = QString("通道 %1 数据不足，缺少 %2 个样本")
+                              .arg(channels[i]).arg(writer.remaining());
+            file.cancelWriting();
+            return false;
+        }
+
+        quint32 crc = writer.checksum();
+        QByteArray crcBytes;
+        appendLittleEndian32(&crcBytes, crc);
+        qint64 endOfEntry = file.pos();
+        if (!file.seek(offset + 14) || file.write(crcBytes) != crcBytes.size()
+            || !file.seek(endOfEntry)) {
+            m_lastError = QString("写入文件失败: %1").arg(file.errorString());
+            file.cancelWriting();
+            return false;
+        }
+
+        appendLittleEndian32(&centralDirectory, ZIP_CENTRAL_HEADER_SIGNATURE);
+        appendLittleEndian16(&centralDirectory, 20);   // 创建版本
+        appendLittleEndian16(&centralDirectory, 20);   // 所需版本
+        appendLittleEndian16(&centralDirectory, 0);
+        appendLittleEndian16(&centralDirectory, 0);
+        appendLittleEndian16(&centralDirectory, dosTime);
+        appendLittleEndian16(&centralDirectory, dosDate);
+        appendLittleEndian32(&centralDirectory, crc);
+        appendLittleEndian32(&centralDirectory, static_cast<quint32>(entrySize));
+        appendLittleEndian32(&centralDirectory, static_cast<quint32>(entrySize));
+        appendLittleEndian16(&centralDirectory, static_cast<quint16>(name.size()));
+        appendLittleEndian16(&centralDirectory, 0);    // 扩展字段长度
+        appendLittleEndian16(&centralDirectory, 0);    // 注释长度
+        appendLittleEndian16(&centralDirectory, 0);    // 磁盘号
+        appendLittleEndian16(&centralDirectory, 0);    // 内部属性
+        appendLittleEndian32(&centralDirectory, 0);    // 外部属性
+        appendLittleEndian32(&centralDirectory, static_cast<quint32>(offset));
+        centralDirectory.append(name);
+
+        offset = endOfEntry;
+
+        emit exportProgress(10 + ((i + 1) * 85 / channels.size()),
+                            QString("已写入通道 %1").arg(channels[i]));
+    }
+
+    QByteArray end;
+    appendLittleEndian32(&end, ZIP_END_SIGNATURE);
+    appendLittleEndian16(&end, 0);
+    appendLittleEndian16(&end, 0);
+    appendLittleEndian16(&end, static_cast<quint16>(channels.size()));
+    appendLittleEndian16(&end, static_cast<quint16>(channels.size()));
+    appendLittleEndian32(&end, static_cast<quint32>(centralDirectory.size()));
+    appendLittleEndian32(&end, static_cast<quint32>(offset));
+    appendLittleEndian16(&end, 0);
+
+    if (file.write(centralDirectory) != centralDirectory.size()
+        || file.write(end) != end.size() || !file.commit()) {
+        m_lastError = QString("写入文件失败: %1").arg(file.errorString());
+        return false;
+    }
+
+    emit exportProgress(100, "导出完成");
+    qDebug() << "NPZ文件已保存到:" << filePath << "通道数" << channels.size()
+             << "大小" << offset + centralDirectory.size() + end.size()
+             << "字节，耗时" << timer.elapsed() << "ms";
+    return true;
+}
@@ -0,0 +1,82 @@
+#ifndef NPYEXPORTER_H
+#define NPYEXPORTER_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <functional>
+#include "databuffer.h"
+#include "databasemanager.h"
+
+class NpyArrayWriter;
+
+// NumPy导出 - 写出 .npy（NPY 1.0格式）或不压缩的 .npz，Python端可直接 np.load
+//  - .npy：单通道一维数组，或多通道矩阵 (通道数, 样本数)
+//  - .npz：每个通道一个一维数组，键为通道号（字符串），与JSON导出的键一致
+// 数据按块转换后直接写入文件，内存占用与数据量无关。
+// .npz 不使用ZIP64，单个文件超过4GB时报错，此时应导出为 .npy
+class NpyExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum DataType {
+        Float32,    // '<f4'
+        Float64,    // '<f8'
+        Int32       // '<i4'，存储值 = round(幅值 / integerScale)
+    };
+
+    explicit NpyExporter(QObject *parent = nullptr);
+    ~NpyExporter();
+
+    void setDataType(DataType type) { m_dataType = type; }
+    DataType dataType() const { return m_dataType; }
+
+    // Int32 时幅值的量化步长，通常为ADC的scale，这样存储值就是原始码值
+    void setIntegerScale(double scale) { m_integerScale = scale; }
+    double integerScale() const { return m_integerScale; }
+
+    // 单通道一维数组
+    bool exportChannelToNpy(const QString& filePath, const QVector<DataPoint>& data);
+
+    // 多通道矩阵 (通道数, 样本数)，通道长度不同时截取到最短的通道
+    bool exportMatrixToNpy(const QString& filePath,
+                           const QVector<int>& channels,
+                           const QVector<QVector<DataPoint>>& channelData);
+
+    // 每个通道一个数组的 .npz，空通道不写入
+    bool exportMultiChannelToNpz(const QString& filePath,
+                                 const QVector<int>& channels,
+                                 const QVector<QVector<DataPoint>>& channelData);
+
+    // 直接从数据库分页读取已保存的任务
+    bool exportStoredTaskToNpy(const QString& filePath,
+                               DatabaseManager* dbManager, int taskId);
+    bool exportStoredTaskToNpz(const QString& filePath,
+                               DatabaseManager* dbManager, int taskId);
+
+    QString getLastError() const { return m_lastError; }
+
+signals:
+    void exportProgress(int percentage, const QString& message);
+    void exportCompleted(bool success, const QString& message);
+
+private:
+    // writeChannel(i, writer) 写入第 i 个数组（或矩阵第 i 行）的样本，超出长度的部分被忽略
+    typedef std::function<bool(int index, NpyArrayWriter& writer)> ChannelWriter;
+
+    bool writeNpy(const QString& filePath, int rows, qint64 columns,
+                  const ChannelWriter& writeChannel);
+    bool writeNpz(const QString& filePath, const QVector<int>& channels,
+                  const QVector<qint64>& lengths, const ChannelWriter& writeChannel);
+    bool writeStoredChannel(DatabaseManager* dbManager, int taskId, int channel,
+                            NpyArrayWriter& writer);
+
+    int itemSize() const;
+
+    QString m_lastError;
+    DataType m_dataType;
+    double m_integerScale;
+};
+
+#endif // NPYEXPORTER_H
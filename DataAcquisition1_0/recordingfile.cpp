@@ -0,0 +1,801 @@
+#include "recordingfile.h"
+#include <QDateTime>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// 数据块的样本区补齐到8字节，保证下一个块头对齐
+inline qint64 paddedDataSize(quint32 sampleCount, quint32 sampleType)
+{
+    return (static_cast<qint64>(sampleCount) * RecordingFormat::bytesPerSample(sampleType) + 7)
+        & ~qint64(7);
+}
+
+// 整数存储类型的码值范围
+inline void integerRange(quint32 sampleType, double* lo, double* hi)
+{
+    if (sampleType == RecordingFormat::Int16) {
+        *lo = -32768.0;
+        *hi = 32767.0;
+    } else {
+        *lo = -8388608.0;
+        *hi = 8388607.0;
+    }
+}
+
+// 块内第 i 个存储值（未乘 scale）
+inline double storedValue(const uchar* data, quint32 sampleType, qint64 i)
+{
+    switch (sampleType) {
+    case RecordingFormat::Int16: {
+        qint16 value;
+        std::memcpy(&value, data + 2 * i, sizeof(value));
+        return value;
+    }
+    case RecordingFormat::Int24: {
+        const uchar* p = data + 3 * i;
+        quint32 raw = p[0] | (p[1] << 8) | (static_cast<quint32>(p[2]) << 16);
+        return static_cast<qint32>(raw << 8) >> 8; // 符号扩展
+    }
+    default: {
+        float value;
+        std::memcpy(&value, data + 4 * i, sizeof(value));
+        return value;
+    }
+    }
+}
+
+inline qint64 chunkEnd(const RecordingIndexEntry& entry)
+{
+    return entry.firstSample + entry.sampleCount;
+}
+
+} // namespace
+
+// ==================== RecordingWriter ====================
+
+RecordingWriter::RecordingWriter()
+{
+}
+
+RecordingWriter::~RecordingWriter()
+{
+    close();
+}
+
+bool RecordingWriter::open(const QString& filePath, const RecordingSettings& settings)
+{
+    close();
+
+    if (settings.sampleRate <= 0 || settings.chunkSamples <= 0 || settings.channels.isEmpty()) {
+        m_lastError = "录制参数无效";
+        return false;
+    }
+    if (!settings.scales.isEmpty() && settings.scales.size() != settings.channels.size()) {
+        m_lastError = "通道数量与缩放系数数量不匹配";
+        return false;
+    }
+    if (!settings.sampleTypes.isEmpty() && settings.sampleTypes.size() != settings.channels.size()) {
+        m_lastError = "通道数量与存储类型数量不匹配";
+        return false;
+    }
+    for (int type : settings.sampleTypes) {
+        if (type < RecordingFormat::Float32 || type > RecordingFormat::Int24) {
+            m_lastError = QString("不支持的存储类型: %1").arg(type);
+            return false;
+        }
+    }
+
+    m_settings = settings;
+    if (m_settings.scales.isEmpty()) {
+        m_settings.scales.fill(1.0, m_settings.channels.size());
+    }
+    if (m_settings.sampleTypes.isEmpty()) {
+        m_settings.sampleTypes.fill(RecordingFormat::Float32, m_settings.channels.size());
+    }
+    for (int i = 0; i < m_settings.scales.size(); ++i) {
+        double& scale = m_settings.scales[i];
+        if (scale == 0.0 || !std::isfinite(scale)) {
+            // 没有有效的缩放系数时码值没有意义，退回float32
+            scale = 1.0;
+            m_settings.sampleTypes[i] = RecordingFormat::Float32;
+        }
+    }
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_lastError = QString("无法打开文件: %1").arg(m_file.errorString());
+        return false;
+    }
+
+    int channelCount = m_settings.channels.size();
+
+    RecordingFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, RecordingFormat::FILE_MAGIC, sizeof(header.magic));
+    header.version = RecordingFormat::VERSION;
+    header.headerSize = sizeof(RecordingFileHeader) + channelCount * sizeof(RecordingChannelInfo);
+    header.sampleRate = m_settings.sampleRate;
+    header.startTime = m_settings.startTime;
+    header.channelCount = channelCount;
+    header.chunkSamples = m_settings.chunkSamples;
+    header.createdMsecs = QDateTime::currentMSecsSinceEpoch();
+    QByteArray name = m_settings.taskName.toUtf8().left(sizeof(header.taskName) - 1);
+    std::memcpy(header.taskName, name.constData(), name.size());
+
+    QVector<RecordingChannelInfo> channelTable(channelCount);
+    for (int i = 0; i < channelCount; ++i) {
+        std::memset(&channelTable[i], 0, sizeof(RecordingChannelInfo));
+        channelTable[i].channel = m_settings.channels[i];
+        channelTable[i].sampleType = m_settings.sampleTypes[i];
+        channelTable[i].scale = m_settings.scales[i];
+    }
+
+    m_pending = QVector<QVector<float>>(channelCount);
+    for (QVector<float>& pending : m_pending) {
+        pending.reserve(m_settings.chunkSamples);
+    }
+    m_pendingStart.fill(0.0, channelCount);
+    m_written.fill(0, channelCount);
+    m_index.clear();
+
+    if (!writeBytes(&header, sizeof(header))
+        || !writeBytes(channelTable.constData(), channelCount * sizeof(RecordingChannelInfo))) {
+        m_file.close();
+        return false;
+    }
+    return true;
+}
+
+bool RecordingWriter::append(int channel, const QVector<DataPoint>& data)
+{
+    return append(channel, data.constData(), data.size());
+}
+
+bool RecordingWriter::append(int channel, const DataPoint* data, int count)
+{
+    if (!m_file.isOpen()) {
+        m_lastError = "录制文件未打开";
+        return false;
+    }
+
+    int index = m_settings.channels.indexOf(channel);
+    if (index < 0) {
+        m_lastError = QString("通道 %1 不在录制通道表中").arg(channel);
+        return false;
+    }
+
+    QVector<float>& pending = m_pending[index];
+    double fs = m_settings.sampleRate;
+    double inverseScale = 1.0 / m_settings.scales[index];
+    double tolerance = 0.5 / fs;
+    int sampleType = m_settings.sampleTypes[index];
+    double lo = 0.0;
+    double hi = 0.0;
+    integerRange(sampleType, &lo, &hi);
+
+    for (int i = 0; i < count; ++i) {
+        if (pending.isEmpty()) {
+            m_pendingStart[index] = data[i].time;
+        } else {
+            double expected = m_pendingStart[index] + pending.size() / fs;
+            if (std::fabs(data[i].time - expected) > tolerance) {
+                if (!writeChunk(index)) {
+                    return false;
+                }
+                m_pendingStart[index] = data[i].time;
+            }
+        }
+
+        double stored = data[i].amplitude * inverseScale;
+        if (sampleType != RecordingFormat::Float32) {
+            // 码值取整并限幅；float 可以精确表示24位以内的整数
+            stored = std::isfinite(stored) ? std::min(std::max(std::round(stored), lo), hi) : 0.0;
+        }
+        pending.append(static_cast<float>(stored));
+
+        if (pending.size() >= m_settings.chunkSamples && !writeChunk(index)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RecordingWriter::writeChunk(int index)
+{
+    QVector<float>& pending = m_pending[index];
+    if (pending.isEmpty()) {
+        return true;
+    }
+
+    // 块头统计使用读回的幅值，与读取端一致
+    double scale = m_settings.scales[index];
+    double minValue = pending[0] * scale;
+    double maxValue = minValue;
+    double sum = 0.0;
+    for (float stored : pending) {
+        double value = stored * scale;
+        minValue = std::min(minValue, value);
+        maxValue = std::max(maxValue, value);
+        sum += value;
+    }
+
+    RecordingChunkHeader chunk;
+    std::memset(&chunk, 0, sizeof(chunk));
+    chunk.magic = RecordingFormat::CHUNK_MAGIC;
+    chunk.channelIndex = index;
+    chunk.sampleCount = pending.size();
+    chunk.firstSample = m_written[index];
+    chunk.startTime = m_pendingStart[index];
+    chunk.minValue = minValue;
+    chunk.maxValue = maxValue;
+    chunk.sum = sum;
+
+    RecordingIndexEntry entry;
+    entry.offset = m_file.pos();
+    entry.channelIndex = index;
+    entry.sampleCount = chunk.sampleCount;
+    entry.firstSample = chunk.firstSample;
+    entry.startTime = chunk.startTime;
+    entry.minValue = minValue;
+    entry.maxValue = maxValue;
+    entry.sum = sum;
+
+    int sampleType = m_settings.sampleTypes[index];
+    qint64 dataSize = static_cast<qint64>(pending.size()) * RecordingFormat::bytesPerSample(sampleType);
+    const void* encoded = pending.constData();
+    if (sampleType == RecordingFormat::Int16) {
+        m_encoded.resize(static_cast<int>(dataSize));
+        qint16* out = reinterpret_cast<qint16*>(m_encoded.data());
+        for (int i = 0; i < pending.size(); ++i) {
+            out[i] = static_cast<qint16>(pending[i]);
+        }
+        encoded = m_encoded.constData();
+    } else if (sampleType == RecordingFormat::Int24) {
+        m_encoded.resize(static_cast<int>(dataSize));
+        uchar* out = reinterpret_cast<uchar*>(m_encoded.data());
+        for (int i = 0; i < pending.size(); ++i) {
+            quint32 raw = static_cast<quint32>(static_cast<qint32>(pending[i]));
+            out[3 * i] = static_cast<uchar>(raw);
+            out[3 * i + 1] = static_cast<uchar>(raw >> 8);
+            out[3 * i + 2] = static_cast<uchar>(raw >> 16);
+        }
+        encoded = m_encoded.constData();
+    }
+
+    static const char padding[8] = {0};
+    if (!writeBytes(&chunk, sizeof(chunk))
+        || !writeBytes(encoded, dataSize)
+        || !writeBytes(padding, paddedDataSize(chunk.sampleCount, sampleType) - dataSize)) {
+        return false;
+    }
+
+    m_index.append(entry);
+    m_written[index] += pending.size();
+    pending.resize(0);
+    return true;
+}
+
+bool RecordingWriter::close()
+{
+    if (!m_file.isOpen()) {
+        return true;
+    }
+
+    bool success = true;
+    for (int i = 0; i < m_pending.size() && success; ++i) {
+        success = writeChunk(i);
+    }
+
+    if (success) {
+        RecordingIndexHeader indexHeader;
+        indexHeader.magic = RecordingFormat::INDEX_MAGIC;
+        indexHeader.entryCount = m_index.size();
+
+        RecordingFileFooter footer;
+        std::memset(&footer, 0, sizeof(footer));
+        std::memcpy(footer.magic, RecordingFormat::FOOTER_MAGIC, sizeof(footer.magic));
+        footer.indexOffset = m_file.pos();
+        footer.entryCount = m_index.size();
+
+        success = writeBytes(&indexHeader, sizeof(indexHeader))
+            && writeBytes(m_index.constData(), m_index.size() * sizeof(RecordingIndexEntry))
+            && writeBytes(&footer, sizeof(footer));
+    }
+
+    if (success) {
+        qint64 totalSamples = 0;
+        for (qint64 written : m_written) {
+            totalSamples += written;
+        }
+        qDebug() << "录制文件已保存:" << m_file.fileName()
+                 << "样本数" << totalSamples << "数据块" << m_index.size();
+    }
+
+    m_file.close();
+    m_pending.clear();
+    m_encoded.clear();
+    m_index.clear();
+    return success;
+}
+
+bool RecordingWriter::writeBytes(const void* data, qint64 size)
+{
+    if (size <= 0) {
+        return true;
+    }
+    if (m_file.write(static_cast<const char*>(data), size) != size) {
+        m_lastError = QString("写入文件失败: %1").arg(m_file.errorString());
+        return false;
+    }
+    return true;
+}
+
+RecordingFormat::SampleType RecordingWriter::integerSampleType(const QVector<DataPoint>& data,
+                                                               double scale)
+{
+    if (data.isEmpty() || scale == 0.0 || !std::isfinite(scale)) {
+        return RecordingFormat::Float32;
+    }
+
+    // 幅值由ADC码值乘 scale 得到时，除回去与整数的偏差只有舍入误差
+    const double tolerance = 1e-3;
+    double inverseScale = 1.0 / scale;
+    double lo = 0.0;
+    double hi = 0.0;
+    for (const DataPoint& point : data) {
+        double code = point.amplitude * inverseScale;
+        double rounded = std::round(code);
+        if (!(std::fabs(code - rounded) <= tolerance)) {
+            return RecordingFormat::Float32;
+        }
+        lo = std::min(lo, rounded);
+        hi = std::max(hi, rounded);
+    }
+
+    double int16Lo = 0.0;
+    double int16Hi = 0.0;
+    integerRange(RecordingFormat::Int16, &int16Lo, &int16Hi);
+    if (lo >= int16Lo && hi <= int16Hi) {
+        return RecordingFormat::Int16;
+    }
+
+    double int24Lo = 0.0;
+    double int24Hi = 0.0;
+    integerRange(RecordingFormat::Int24, &int24Lo, &int24Hi);
+    if (lo >= int24Lo && hi <= int24Hi) {
+        return RecordingFormat::Int24;
+    }
+    return RecordingFormat::Float32;
+}
+
+bool RecordingWriter::writeRecording(const QString& filePath, const RecordingSettings& settings,
+                                     const QVector<QVector<DataPoint>>& channelData,
+                                     QString* error)
+{
+    RecordingWriter writer;
+    bool success = writer.open(filePath, settings);
+    for (int i = 0; success && i < channelData.size() && i < settings.channels.size(); ++i) {
+        success = writer.append(settings.channels[i], channelData[i]);
+    }
+    if (!writer.close()) {
+        success = false;
+    }
+    if (!success && error) {
+        *error = writer.lastError();
+    }
+    return success;
+}
+
+// ==================== RecordingReader ====================
+
+RecordingReader::RecordingReader()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_header(nullptr)
+    , m_channels(nullptr)
+    , m_recovered(false)
+{
+}
+
+RecordingReader::~RecordingReader()
+{
+    close();
+}
+
+bool RecordingReader::open(const QString& filePath)
+{
+    close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_lastError = QString("无法打开文件: %1").arg(m_file.errorString());
+        return false;
+    }
+
+    m_size = m_file.size();
+    if (m_size < static_cast<qint64>(sizeof(RecordingFileHeader))) {
+        m_lastError = "文件太小，不是录制文件";
+        close();
+        return false;
+    }
+
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        m_lastError = QString("无法映射文件: %1").arg(m_file.errorString());
+        close();
+        return false;
+    }
+
+    m_header = reinterpret_cast<const RecordingFileHeader*>(m_data);
+    quint32 channelCount = m_header->channelCount;
+    if (std::memcmp(m_header->magic, RecordingFormat::FILE_MAGIC, sizeof(m_header->magic)) != 0
+        || m_header->version < 1 || m_header->version > RecordingFormat::VERSION
+        || channelCount == 0 || channelCount > 1024
+        || m_header->headerSize != sizeof(RecordingFileHeader) + channelCount * sizeof(RecordingChannelInfo)
+        || m_header->headerSize > m_size
+        || !(m_header->sampleRate > 0)) {
+        m_lastError = "文件头无效或版本不支持";
+        close();
+        return false;
+    }
+
+    m_channels = reinterpret_cast<const RecordingChannelInfo*>(m_data + sizeof(RecordingFileHeader));
+    for (quint32 i = 0; i < channelCount; ++i) {
+        // 版本1的该字段为保留的0，即float32
+        if (m_channels[i].sampleType > RecordingFormat::Int24) {
+            m_lastError = QString("通道表中有不支持的存储类型: %1").arg(m_channels[i].sampleType);
+            close();
+            return false;
+        }
+    }
+    m_chunks = QVector<QVector<RecordingIndexEntry>>(channelCount);
+
+    if (!loadIndex()) {
+        // 录制未正常结束：没有索引，逐块扫描
+        qWarning() << "录制文件缺少有效索引，扫描数据块恢复:" << filePath;
+        for (QVector<RecordingIndexEntry>& list : m_chunks) {
+            list.clear();
+        }
+        scanChunks();
+        m_recovered = true;
+    }
+
+    for (QVector<RecordingIndexEntry>& list : m_chunks) {
+        std::sort(list.begin(), list.end(),
+                  [](const RecordingIndexEntry& a, const RecordingIndexEntry& b) {
+            return a.firstSample < b.firstSample;
+        });
+    }
+    return true;
+}
+
+void RecordingReader::close()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar*>(m_data));
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_header = nullptr;
+    m_channels = nullptr;
+    m_chunks.clear();
+    m_recovered = false;
+}
+
+bool RecordingReader::loadIndex()
+{
+    qint64 footerOffset = m_size - static_cast<qint64>(sizeof(RecordingFileFooter));
+    if (footerOffset < m_header->headerSize) {
+        return false;
+    }
+
+    const RecordingFileFooter* footer =
+        reinterpret_cast<const RecordingFileFooter*>(m_data + footerOffset);
+    if (std::memcmp(footer->magic, RecordingFormat::FOOTER_MAGIC, sizeof(footer->magic)) != 0) {
+        return false;
+    }
+
+    qint64 indexOffset = footer->indexOffset;
+    qint64 indexSize = sizeof(RecordingIndexHeader)
+        + static_cast<qint64>(footer->entryCount) * sizeof(RecordingIndexEntry);
+    if (indexOffset < m_header->headerSize || (indexOffset & 7) != 0
+        || indexOffset + indexSize != footerOffset) {
+        return false;
+    }
+
+    const RecordingIndexHeader* indexHeader =
+        reinterpret_cast<const RecordingIndexHeader*>(m_data + indexOffset);
+    if (indexHeader->magic != RecordingFormat::INDEX_MAGIC
+        || indexHeader->entryCount != footer->entryCount) {
+        return false;
+    }
+
+    // 只检查索引项的范围，不访问块头，打开大文件时不必读入数据页
+    const RecordingIndexEntry* entries = reinterpret_cast<const RecordingIndexEntry*>(
+        m_data + indexOffset + sizeof(RecordingIndexHeader));
+    for (quint32 i = 0; i < footer->entryCount; ++i) {
+        const RecordingIndexEntry& entry = entries[i];
+        if (entry.channelIndex < 0 || entry.channelIndex >= m_chunks.size()
+            || entry.sampleCount == 0 || (entry.offset & 7) != 0
+            || entry.offset < m_header->headerSize
+            || entry.offset + static_cast<qint64>(sizeof(RecordingChunkHeader))
+                   + chunkDataSize(entry.channelIndex, entry.sampleCount) > indexOffset) {
+            return false;
+        }
+        m_chunks[entry.channelIndex].append(entry);
+    }
+    return true;
+}
+
+bool RecordingReader::scanChunks()
+{
+    qint64 offset = m_header->headerSize;
+    const RecordingChunkHeader* chunk = nullptr;
+    int count = 0;
+
+    while (validChunk(offset, &chunk)) {
+        RecordingIndexEntry entry;
+        entry.offset = offset;
+        entry.channelIndex = chunk->channelIndex;
+        entry.sampleCount = chunk->sampleCount;
+        entry.firstSample = chunk->firstSample;
+        entry.startTime = chunk->startTime;
+        entry.minValue = chunk->minValue;
+        entry.maxValue = chunk->maxValue;
+        entry.sum = chunk->sum;
+        m_chunks[entry.channelIndex].append(entry);
+
+        offset += sizeof(RecordingChunkHeader)
+            + chunkDataSize(chunk->channelIndex, chunk->sampleCount);
+        ++count;
+    }
+
+    qDebug() << "恢复数据块:" << count << "有效数据截止于偏移" << offset;
+    return count > 0;
+}
+
+bool RecordingReader::validChunk(qint64 offset, const RecordingChunkHeader** chunk) const
+{
+    if (offset + static_cast<qint64>(sizeof(RecordingChunkHeader)) > m_size) {
+        return false;
+    }
+
+    const RecordingChunkHeader* header =
+        reinterpret_cast<const RecordingChunkHeader*>(m_data + offset);
+    if (header->magic != RecordingFormat::CHUNK_MAGIC
+        || header->channelIndex < 0 || header->channelIndex >= m_chunks.size()
+        || header->sampleCount == 0
+        || offset + static_cast<qint64>(sizeof(RecordingChunkHeader))
+               + chunkDataSize(header->channelIndex, header->sampleCount) > m_size) {
+        return false;
+    }
+
+    *chunk = header;
+    return true;
+}
+
+qint64 RecordingReader::chunkDataSize(int index, quint32 sampleCount) const
+{
+    return paddedDataSize(sampleCount, m_channels[index].sampleType);
+}
+
+QString RecordingReader::taskName() const
+{
+    if (!m_header) {
+        return QString();
+    }
+    return QString::fromUtf8(m_header->taskName,
+                             qstrnlen(m_header->taskName, sizeof(m_header->taskName)));
+}
+
+QVector<int> RecordingReader::channels() const
+{
+    QVector<int> result;
+    for (int i = 0; i < m_chunks.size(); ++i) {
+        result.append(m_channels[i].channel);
+    }
+    return result;
+}
+
+int RecordingReader::channelIndex(int channel) const
+{
+    for (int i = 0; i < m_chunks.size(); ++i) {
+        if (m_channels[i].channel == channel) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+qint64 RecordingReader::sampleCount(int channel) const
+{
+    int index = channelIndex(channel);
+    if (index < 0 || m_chunks[index].isEmpty()) {
+        return 0;
+    }
+    return chunkEnd(m_chunks[index].last());
+}
+
+double RecordingReader::startTime(int channel) const
+{
+    int index = channelIndex(channel);
+    if (index < 0 || m_chunks[index].isEmpty()) {
+        return 0.0;
+    }
+    return m_chunks[index].first().startTime;
+}
+
+double RecordingReader::endTime(int channel) const
+{
+    int index = channelIndex(channel);
+    if (index < 0 || m_chunks[index].isEmpty()) {
+        return 0.0;
+    }
+    const RecordingIndexEntry& last = m_chunks[index].last();
+    return last.startTime + (last.sampleCount - 1) / m_header->sampleRate;
+}
+
+QVector<RecordingIndexEntry> RecordingReader::chunks(int channel) const
+{
+    int index = channelIndex(channel);
+    return index < 0 ? QVector<RecordingIndexEntry>() : m_chunks[index];
+}
+
+RecordingFormat::SampleType RecordingReader::sampleType(int channel) const
+{
+    int index = channelIndex(channel);
+    if (index < 0) {
+        return RecordingFormat::Float32;
+    }
+    return static_cast<RecordingFormat::SampleType>(m_channels[index].sampleType);
+}
+
+const uchar* RecordingReader::chunkData(const RecordingIndexEntry& entry) const
+{
+    if (!m_data) {
+        return nullptr;
+    }
+    return m_data + entry.offset + sizeof(RecordingChunkHeader);
+}
+
+int RecordingReader::chunkContaining(int index, qint64 sample) const
+{
+    const QVector<RecordingIndexEntry>& list = m_chunks[index];
+    auto it = std::upper_bound(list.begin(), list.end(), sample,
+                               [](qint64 value, const RecordingIndexEntry& entry) {
+        return value < entry.firstSample;
+    });
+    return static_cast<int>(it - list.begin()) - 1;
+}
+
+qint64 RecordingReader::findSample(int channel, double time) const
+{
+    int index = channelIndex(channel);
+    if (index < 0 || m_chunks[index].isEmpty()) {
+        return 0;
+    }
+
+    const QVector<RecordingIndexEntry>& list = m_chunks[index];
+    auto it = std::upper_bound(list.begin(), list.end(), time,
+                               [](double value, const RecordingIndexEntry& entry) {
+        return value < entry.startTime;
+    });
+    if (it == list.begin()) {
+        return list.first().firstSample;
+    }
+
+    const RecordingIndexEntry& entry = *(it - 1);
+    // 块内时间均匀，直接换算样本位置（容差避免浮点误差把恰好相等的时间算到下一个样本）
+    qint64 offset = static_cast<qint64>(
+        std::ceil((time - entry.startTime) * m_header->sampleRate - 1e-6));
+    if (offset < entry.sampleCount) {
+        return entry.firstSample + std::max<qint64>(offset, 0);
+    }
+    return it != list.end() ? it->firstSample : chunkEnd(entry);
+}
+
+QVector<DataPoint> RecordingReader::readSamples(int channel, qint64 first, qint64 count) const
+{
+    QVector<DataPoint> result;
+    int index = channelIndex(channel);
+    if (index < 0 || m_chunks[index].isEmpty()) {
+        return result;
+    }
+
+    const QVector<RecordingIndexEntry>& list = m_chunks[index];
+    first = std::max<qint64>(first, 0);
+    qint64 last = std::min(first + std::max<qint64>(count, 0), chunkEnd(list.last()));
+    if (last <= first) {
+        return result;
+    }
+    result.reserve(static_cast<int>(last - first));
+
+    double scale = m_channels[index].scale;
+    quint32 type = m_channels[index].sampleType;
+    double fs = m_header->sampleRate;
+
+    for (int k = std::max(chunkContaining(index, first), 0); k < list.size(); ++k) {
+        const RecordingIndexEntry& entry = list[k];
+        if (entry.firstSample >= last) {
+            break;
+        }
+
+        const uchar* samples = chunkData(entry);
+        qint64 begin = std::max(first, entry.firstSample) - entry.firstSample;
+        qint64 end = std::min(last, chunkEnd(entry)) - entry.firstSample;
+        for (qint64 i = begin; i < end; ++i) {
+            result.append(DataPoint(entry.startTime + i / fs,
+                                    storedValue(samples, type, i) * scale));
+        }
+    }
+    return result;
+}
+
+QVector<DataPoint> RecordingReader::readRange(int channel, double startTime, double endTime) const
+{
+    qint64 first = findSample(channel, startTime);
+    qint64 last = findSample(channel, endTime);
+    return readSamples(channel, first, last - first);
+}
+
+bool RecordingReader::summarize(int channel, qint64 first, qint64 count,
+                                double* minValue, double* maxValue, double* mean) const
+{
+    int index = channelIndex(channel);
+    if (index < 0 || m_chunks[index].isEmpty() || count <= 0) {
+        return false;
+    }
+
+    const QVector<RecordingIndexEntry>& list = m_chunks[index];
+    first = std::max<qint64>(first, 0);
+    qint64 last = std::min(first + count, chunkEnd(list.last()));
+    if (last <= first) {
+        return false;
+    }
+
+    double scale = m_channels[index].scale;
+    quint32 type = m_channels[index].sampleType;
+    double lo = INFINITY;
+    double hi = -INFINITY;
+    double sum = 0.0;
+    qint64 n = 0;
+
+    for (int k = std::max(chunkContaining(index, first), 0); k < list.size(); ++k) {
+        const RecordingIndexEntry& entry = list[k];
+        if (entry.firstSample >= last) {
+            break;
+        }
+
+        qint64 begin = std::max(first, entry.firstSample) - entry.firstSample;
+        qint64 end = std::min(last, chunkEnd(entry)) - entry.firstSample;
+        if (begin == 0 && end == entry.sampleCount) {
+            lo = std::min(lo, entry.minValue);
+            hi = std::max(hi, entry.maxValue);
+            sum += entry.sum;
+        } else {
+            const uchar* samples = chunkData(entry);
+            for (qint64 i = begin; i < end; ++i) {
+                double value = storedValue(samples, type, i) * scale;
+                lo = std::min(lo, value);
+                hi = std::max(hi, value);
+                sum += value;
+            }
+        }
+        n += end - begin;
+    }
+
+    if (n == 0) {
+        return false;
+    }
+    if (minValue) *minValue = lo;
+    if (maxValue) *maxValue = hi;
+    if (mean) *mean = sum / n;
+    return true;
+}
@@ -0,0 +1,221 @@
+#ifndef RECORDINGFILE_H
+#define RECORDINGFILE_H
+
+#include <QString>
+#include <QVector>
+#include <QFile>
+#include "databuffer.h"
+
+// 二进制录制文件格式（.darec，小端，所有结构按8字节对齐，可直接映射读取）
+//
+//   文件头 RecordingFileHeader
+//   通道表 RecordingChannelInfo × channelCount
+//   数据块 RecordingChunkHeader + 存储值 × sampleCount（补齐到8字节），按写入顺序追加
+//   ...
+//   索引   RecordingIndexHeader + RecordingIndexEntry × entryCount
+//   文件尾 RecordingFileFooter
+//
+// 每个数据块只包含一个通道的连续样本，第 i 个样本的时间为 startTime + i / sampleRate，
+// 幅值为 存储值 × scale。存储值的类型由通道表的 sampleType 决定：float32，或已知ADC
+// 缩放系数时直接存ADC码值（int16 / 小端3字节int24），文件大小为float32的1/2或3/4。
+// 块头带有块内最小/最大值与和，概览和区间统计不必读取样本。
+// 程序异常退出时文件没有索引和文件尾，读取时从文件头顺序扫描块头恢复。
+namespace RecordingFormat {
+const char FILE_MAGIC[8] = {'D', 'A', 'Q', 'R', 'E', 'C', '0', '1'};
+const char FOOTER_MAGIC[8] = {'D', 'A', 'Q', 'I', 'D', 'X', '0', '1'};
+const quint32 CHUNK_MAGIC = 0x4B4E4843;    // "CHNK"
+const quint32 INDEX_MAGIC = 0x58444E49;    // "INDX"
+const quint32 VERSION = 2;                 // 版本1没有 sampleType，样本全部为float32
+const int DEFAULT_CHUNK_SAMPLES = 65536;
+
+enum SampleType {
+    Float32 = 0,
+    Int16 = 1,
+    Int24 = 2
+};
+
+inline int bytesPerSample(quint32 sampleType)
+{
+    return sampleType == Int16 ? 2 : (sampleType == Int24 ? 3 : 4);
+}
+}
+
+struct RecordingFileHeader {
+    char magic[8];
+    quint32 version;
+    quint32 headerSize;         // 文件头加通道表的字节数，即第一个数据块的偏移
+    double sampleRate;
+    double startTime;           // 录制开始时间（秒，与 DataPoint::time 同一时间轴）
+    quint32 channelCount;
+    quint32 chunkSamples;       // 每块最多样本数
+    qint64 createdMsecs;        // 创建时间（UTC毫秒）
+    char taskName[64];          // UTF-8，以0结尾
+    quint8 reserved[16];
+};
+
+struct RecordingChannelInfo {
+    qint32 channel;             // 硬件通道号
+    quint32 sampleType;         // RecordingFormat::SampleType
+    double scale;               // 幅值 = 存储值 × scale
+    quint64 reserved[2];
+};
+
+struct RecordingChunkHeader {
+    quint32 magic;
+    qint32 channelIndex;        // 通道表中的序号
+    quint32 sampleCount;
+    quint32 reserved;
+    qint64 firstSample;         // 块内第一个样本在该通道中的序号
+    double startTime;
+    double minValue;            // 以下为幅值（已乘 scale）
+    double maxValue;
+    double sum;
+    quint64 reserved2;
+};
+
+struct RecordingIndexHeader {
+    quint32 magic;
+    quint32 entryCount;
+};
+
+struct RecordingIndexEntry {
+    qint64 offset;              // 块头在文件中的偏移
+    qint32 channelIndex;
+    quint32 sampleCount;
+    qint64 firstSample;
+    double startTime;
+    double minValue;
+    double maxValue;
+    double sum;
+};
+
+struct RecordingFileFooter {
+    char magic[8];
+    qint64 indexOffset;
+    quint32 entryCount;
+    quint32 reserved;
+    quint64 reserved2;
+};
+
+static_assert(sizeof(RecordingFileHeader) == 128, "录制文件头大小必须固定");
+static_assert(sizeof(RecordingChannelInfo) == 32, "通道表项大小必须固定");
+static_assert(sizeof(RecordingChunkHeader) == 64, "数据块头大小必须固定");
+static_assert(sizeof(RecordingIndexEntry) == 56, "索引项大小必须固定");
+static_assert(sizeof(RecordingFileFooter) == 32, "文件尾大小必须固定");
+
+// 录制参数
+struct RecordingSettings {
+    double sampleRate;
+    double startTime;
+    int chunkSamples;
+    QString taskName;
+    QVector<int> channels;      // 硬件通道号
+    QVector<double> scales;     // 与 channels 对应；为空时全部为1
+    QVector<int> sampleTypes;   // 与 channels 对应；为空时全部为float32
+
+    RecordingSettings() : sampleRate(1000.0), startTime(0.0),
+        chunkSamples(RecordingFormat::DEFAULT_CHUNK_SAMPLES) {}
+};
+
+// 录制文件写入 - 只追加写入，每个通道攒满一块写一次
+// 时间不连续（相邻样本间隔偏离 1/sampleRate 超过半个采样周期）时提前结束当前块，
+// 保证块内时间可由起始时间和采样率还原
+class RecordingWriter
+{
+public:
+    RecordingWriter();
+    ~RecordingWriter();
+
+    bool open(const QString& filePath, const RecordingSettings& settings);
+    bool append(int channel, const DataPoint* data, int count);
+    bool append(int channel, const QVector<DataPoint>& data);
+    // 写出未满的块、索引和文件尾
+    bool close();
+
+    bool isOpen() const { return m_file.isOpen(); }
+    QString lastError() const { return m_lastError; }
+
+    // 能按 scale 无损存为整数码值的最小整数类型（幅值都是 scale 的整数倍且不超出范围），
+    // 否则为 Float32
+    static RecordingFormat::SampleType integerSampleType(const QVector<DataPoint>& data,
+                                                         double scale);
+
+    // 一次写出整段多通道数据
+    static bool writeRecording(const QString& filePath, const RecordingSettings& settings,
+                               const QVector<QVector<DataPoint>>& channelData,
+                               QString* error = nullptr);
+
+private:
+    bool writeChunk(int index);
+    bool writeBytes(const void* data, qint64 size);
+
+    QFile m_file;
+    RecordingSettings m_settings;
+    QVector<QVector<float>> m_pending;      // 每个通道未写出的存储值（整数类型时为码值，float可精确表示24位整数）
+    QByteArray m_encoded;                   // 按存储类型编码后的块数据
+    QVector<double> m_pendingStart;         // 未写出部分第一个样本的时间
+    QVector<qint64> m_written;              // 每个通道已写出的样本数
+    QVector<RecordingIndexEntry> m_index;
+    QString m_lastError;
+};
+
+// 录制文件读取 - 整个文件映射到内存，只解析文件头和索引，样本直接从映射区读取
+class RecordingReader
+{
+public:
+    RecordingReader();
+    ~RecordingReader();
+
+    bool open(const QString& filePath);
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+    QString lastError() const { return m_lastError; }
+    // 文件没有有效的索引，块表由扫描数据块得到
+    bool wasRecovered() const { return m_recovered; }
+
+    const RecordingFileHeader* header() const { return m_header; }
+    double sampleRate() const { return m_header ? m_header->sampleRate : 0.0; }
+    QString taskName() const;
+    QVector<int> channels() const;
+
+    qint64 sampleCount(int channel) const;
+    double startTime(int channel) const;
+    double endTime(int channel) const;      // 最后一个样本的时间
+
+    // 通道的块表（按样本序号排序），块内样本由 chunkData() 直接访问，
+    // 按 sampleType() 解释：float32、int16 或小端3字节int24
+    QVector<RecordingIndexEntry> chunks(int channel) const;
+    RecordingFormat::SampleType sampleType(int channel) const;
+    const uchar* chunkData(const RecordingIndexEntry& entry) const;
+
+    // 第一个时间不早于 time 的样本序号，全部早于 time 时返回样本数
+    qint64 findSample(int channel, double time) const;
+
+    QVector<DataPoint> readSamples(int channel, qint64 first, qint64 count) const;
+    // 读取时间在 [startTime, endTime) 内的样本
+    QVector<DataPoint> readRange(int channel, double startTime, double endTime) const;
+
+    // 区间最小/最大/平均值：完整的块直接用块头统计，只扫描两端不完整的块
+    bool summarize(int channel, qint64 first, qint64 count,
+                   double* minValue, double* maxValue, double* mean) const;
+
+private:
+    int channelIndex(int channel) const;
+    int chunkContaining(int index, qint64 sample) const;
+    bool loadIndex();
+    bool scanChunks();
+    bool validChunk(qint64 offset, const RecordingChunkHeader** chunk) const;
+    qint64 chunkDataSize(int index, quint32 sampleCount) const;
+
+    QFile m_file;
+    const uchar* m_data;
+    qint64 m_size;
+    const RecordingFileHeader* m_header;
+    const RecordingChannelInfo* m_channels;
+    QVector<QVector<RecordingIndexEntry>> m_chunks;     // 按通道序号
+    bool m_recovered;
+    QString m_lastError;
+};
+
+#endif // RECORDINGFILE_H
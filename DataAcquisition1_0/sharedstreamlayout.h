@@ -0,0 +1,90 @@
+#ifndef SHAREDSTREAMLAYOUT_H
+#define SHAREDSTREAMLAYOUT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// 共享内存实时流的内存布局 - 采集程序（发布端）与外部读取程序共用，不依赖Qt
+//
+// 共享内存名：POSIX 为 "/<name>"（Linux 下即 /dev/shm/<name>），Windows 为 "Local\<name>"
+// 所有字段为本机字节序，偏移均为64字节对齐：
+//
+//   0                      SegmentHeader
+//   headerSize             ChannelHeader × channelCount（下标即硬件通道号）
+//   dataOffset + i*stride  通道 i 的环形缓冲区：double 幅值 × capacity
+//
+// 写入协议（单写者，发布端在 DataBuffer 的锁内写入）：
+//   1. sequence 加1（变为奇数）
+//   2. 把新样本写入环形缓冲区 ring[(writeIndex + k) & (capacity - 1)]
+//   3. 更新 lastTime，writeIndex 增加写入的样本数
+//   4. sequence 加1（变回偶数）
+//
+// 读取协议（任意多个读者，不加锁）：
+//   1. 读一次一致快照：sequence 为偶数且读前读后相同时，writeIndex/lastTime 有效
+//   2. 复制需要的样本，序号 k 满足 writeIndex - capacity <= k < writeIndex
+//   3. 再取一次快照 writeIndex'，序号小于 writeIndex' - capacity 的样本在复制期间
+//      可能已被覆盖，丢弃
+//   序号 k 的样本时间为 lastTime - (writeIndex - 1 - k) / sampleRate
+//
+// 发布端清空缓冲区时 generation 加1，writeIndex 不回退；
+// heartbeat 为发布端最近一次写入的时间（UTC毫秒），用于判断发布端是否仍在运行
+namespace SharedStream {
+
+const char MAGIC[8] = {'D', 'A', 'Q', 'S', 'H', 'M', '0', '1'};
+const uint32_t VERSION = 1;
+const uint32_t CHANNEL_COUNT = 13;
+const uint32_t DEFAULT_CAPACITY = 1u << 18;     // 每通道样本数，必须是2的幂
+const size_t ALIGNMENT = 64;
+const char DEFAULT_NAME[] = "daq_stream";
+
+struct SegmentHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;                // 第一个 ChannelHeader 的偏移
+    uint32_t channelCount;
+    uint32_t capacity;
+    uint64_t dataOffset;                // 通道0环形缓冲区的偏移
+    uint64_t channelStride;             // 相邻通道环形缓冲区之间的字节数
+    double sampleRate;
+    std::atomic<uint64_t> generation;
+    std::atomic<uint64_t> heartbeat;
+};
+
+struct ChannelHeader {
+    std::atomic<uint64_t> sequence;     // 写入中为奇数
+    std::atomic<uint64_t> writeIndex;   // 已写入的样本总数，单调递增
+    double lastTime;                    // 序号 writeIndex-1 的样本时间（秒）
+    uint32_t enabled;                   // 该通道是否有数据写入
+    uint32_t reserved0;
+    uint64_t reserved[4];
+};
+
+static_assert(sizeof(SegmentHeader) == 64, "SegmentHeader 必须为64字节");
+static_assert(sizeof(ChannelHeader) == 64, "ChannelHeader 必须为64字节");
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "共享内存中的原子变量必须是无锁的");
+
+inline size_t alignUp(size_t value)
+{
+    return (value + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+inline size_t channelStride(uint32_t capacity)
+{
+    return alignUp(static_cast<size_t>(capacity) * sizeof(double));
+}
+
+inline size_t dataOffset(uint32_t channelCount)
+{
+    return alignUp(sizeof(SegmentHeader) + channelCount * sizeof(ChannelHeader));
+}
+
+inline size_t segmentSize(uint32_t channelCount, uint32_t capacity)
+{
+    return dataOffset(channelCount) + channelCount * channelStride(capacity);
+}
+
+} // namespace SharedStream
+
+#endif // SHAREDSTREAMLAYOUT_H
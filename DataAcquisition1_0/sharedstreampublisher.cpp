@@ -0,0 +1,204 @@
+#include "sharedstreampublisher.h"
+#include <QDateTime>
+#include <QDebug>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace {
+
+const quint32 MIN_CAPACITY = 1024;
+const quint32 MAX_CAPACITY = 1u << 26;
+
+quint32 roundUpToPowerOfTwo(int value)
+{
+    quint32 capacity = MIN_CAPACITY;
+    while (capacity < static_cast<quint32>(value) && capacity < MAX_CAPACITY) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+} // namespace
+
+SharedStreamPublisher::SharedStreamPublisher()
+    : m_base(nullptr)
+    , m_size(0)
+    , m_header(nullptr)
+#ifdef Q_OS_WIN
+    , m_mapping(nullptr)
+#else
+    , m_fd(-1)
+#endif
+{
+}
+
+SharedStreamPublisher::~SharedStreamPublisher()
+{
+    close();
+}
+
+bool SharedStreamPublisher::create(const QString& name, int capacity, double sampleRate)
+{
+    close();
+
+    if (name.isEmpty()) {
+        m_lastError = "共享内存名称为空";
+        return false;
+    }
+
+    quint32 ringCapacity = roundUpToPowerOfTwo(capacity);
+    m_size = SharedStream::segmentSize(SharedStream::CHANNEL_COUNT, ringCapacity);
+
+#ifdef Q_OS_WIN
+    QString mappingName = QString("Local\\%1").arg(name);
+    m_mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                   static_cast<DWORD>(static_cast<quint64>(m_size) >> 32),
+                                   static_cast<DWORD>(m_size & 0xFFFFFFFFu),
+                                   reinterpret_cast<const wchar_t*>(mappingName.utf16()));
+    if (!m_mapping) {
+        m_lastError = QString("创建共享内存失败，错误码 %1").arg(GetLastError());
+        return false;
+    }
+    if (GetLastError() == ERROR_ALREADY_EXISTS) {
+        // 另一个实例正在发布同名的流，或读取程序仍打开着上一次的流，不能与它共用
+        m_lastError = QString("共享内存 %1 已存在，请关闭正在读取的程序后重试").arg(name);
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+        return false;
+    }
+    m_base = static_cast<uchar*>(MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, m_size));
+    if (!m_base) {
+        m_lastError = QString("映射共享内存失败，错误码 %1").arg(GetLastError());
+        close();
+        return false;
+    }
+    // 新建的映射内容为零
+#else
+    m_shmName = QString("/%1").arg(name).toUtf8();
+    // 上次异常退出时遗留的段直接删除重建，仍在映射旧段的读者通过 heartbeat 发现发布端已停止
+    shm_unlink(m_shmName.constData());
+    m_fd = shm_open(m_shmName.constData(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (m_fd < 0) {
+        m_lastError = QString("创建共享内存失败: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+    if (ftruncate(m_fd, static_cast<off_t>(m_size)) != 0) {
+        m_lastError = QString("设置共享内存大小失败: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+        close();
+        return false;
+    }
+    void* address = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (address == MAP_FAILED) {
+        m_lastError = QString("映射共享内存失败: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+        close();
+        return false;
+    }
+    m_base = static_cast<uchar*>(address);
+    // ftruncate 扩展的部分内容为零
+#endif
+
+    m_header = reinterpret_cast<SharedStream::SegmentHeader*>(m_base);
+    m_header->version = SharedStream::VERSION;
+    m_header->headerSize = sizeof(SharedStream::SegmentHeader);
+    m_header->channelCount = SharedStream::CHANNEL_COUNT;
+    m_header->capacity = ringCapacity;
+    m_header->dataOffset = SharedStream::dataOffset(SharedStream::CHANNEL_COUNT);
+    m_header->channelStride = SharedStream::channelStride(ringCapacity);
+    m_header->sampleRate = sampleRate;
+    m_header->generation.store(0, std::memory_order_relaxed);
+    m_header->heartbeat.store(QDateTime::currentMSecsSinceEpoch(), std::memory_order_relaxed);
+
+    // 魔数最后写入：读者看到魔数时其余字段已经有效
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(m_header->magic, SharedStream::MAGIC, sizeof(m_header->magic));
+
+    m_name = name;
+    qDebug() << "共享内存实时流已创建:" << name << "每通道" << ringCapacity << "个样本，共"
+             << m_size / 1024 << "KB";
+    return true;
+}
+
+void SharedStreamPublisher::close()
+{
+#ifdef Q_OS_WIN
+    if (m_base) {
+        UnmapViewOfFile(m_base);
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+#else
+    if (m_base) {
+        munmap(m_base, m_size);
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+        shm_unlink(m_shmName.constData());
+    }
+#endif
+    m_base = nullptr;
+    m_header = nullptr;
+    m_size = 0;
+}
+
+int SharedStreamPublisher::capacity() const
+{
+    return m_header ? static_cast<int>(m_header->capacity) : 0;
+}
+
+void SharedStreamPublisher::setSampleRate(double sampleRate)
+{
+    if (m_header) {
+        m_header->sampleRate = sampleRate;
+    }
+}
+
+void SharedStreamPublisher::publish(int channel, const DataPoint* points, int count)
+{
+    if (!m_header || count <= 0 || channel < 0
+        || channel >= static_cast<int>(m_header->channelCount)) {
+        return;
+    }
+
+    SharedStream::ChannelHeader* state = reinterpret_cast<SharedStream::ChannelHeader*>(
+        m_base + m_header->headerSize) + channel;
+    double* ring = reinterpret_cast<double*>(
+        m_base + m_header->dataOffset + channel * m_header->channelStride);
+    const quint64 capacity = m_header->capacity;
+    const quint64 mask = capacity - 1;
+
+    quint64 sequence = state->sequence.load(std::memory_order_relaxed);
+    state->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    quint64 writeIndex = state->writeIndex.load(std::memory_order_relaxed);
+    // 一次写入超过容量时，较早的样本会被同一批数据覆盖，直接跳过
+    int first = count > static_cast<int>(capacity) ? count - static_cast<int>(capacity) : 0;
+    for (int i = first; i < count; ++i) {
+        ring[(writeIndex + i) & mask] = points[i].amplitude;
+    }
+    state->lastTime = points[count - 1].time;
+    state->enabled = 1;
+    state->writeIndex.store(writeIndex + count, std::memory_order_relaxed);
+
+    state->sequence.store(sequence + 2, std::memory_order_release);
+    m_header->heartbeat.store(QDateTime::currentMSecsSinceEpoch(), std::memory_order_relaxed);
+}
+
+void SharedStreamPublisher::reset()
+{
+    if (m_header) {
+        m_header->generation.fetch_add(1, std::memory_order_release);
+    }
+}
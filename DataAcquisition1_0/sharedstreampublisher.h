@@ -0,0 +1,46 @@
+#ifndef SHAREDSTREAMPUBLISHER_H
+#define SHAREDSTREAMPUBLISHER_H
+
+#include <QString>
+#include "databuffer.h"
+#include "sharedstreamlayout.h"
+
+// 共享内存实时流发布端 - 把各通道新采集的幅值写入共享内存中的环形缓冲区，
+// 本机的外部程序映射同一段共享内存即可读取实时数据（布局见 sharedstreamlayout.h）
+// 只允许一个线程写入；DataBuffer 在自身的锁内调用 publish()
+class SharedStreamPublisher
+{
+public:
+    SharedStreamPublisher();
+    ~SharedStreamPublisher();
+
+    // 创建（或重建）共享内存段；capacity 向上取整为2的幂
+    bool create(const QString& name, int capacity, double sampleRate);
+    void close();
+
+    bool isOpen() const { return m_base != nullptr; }
+    QString name() const { return m_name; }
+    QString lastError() const { return m_lastError; }
+    int capacity() const;
+
+    void setSampleRate(double sampleRate);
+    void publish(int channel, const DataPoint* points, int count);
+    // 缓冲区被清空：增加 generation，读者据此重新同步
+    void reset();
+
+private:
+    uchar* m_base;
+    size_t m_size;
+    SharedStream::SegmentHeader* m_header;
+    QString m_name;
+    QString m_lastError;
+
+#ifdef Q_OS_WIN
+    void* m_mapping;        // HANDLE
+#else
+    int m_fd;
+    QByteArray m_shmName;
+#endif
+};
+
+#endif // SHAREDSTREAMPUBLISHER_H
@@ -0,0 +1,173 @@
+#include "signalstatistics.h"
+#include "databuffer.h"
+#include <cmath>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SIGNALSTATISTICS_USE_SSE2
+#endif
+
+namespace {
+
+// 分块大小：块内以首个样本为偏移累加，块间用Chan公式合并，保证方差的数值稳定性
+const int BLOCK_SIZE = 1024;
+
+SignalStatistics computeBlock(const DataPoint* data, int size)
+{
+    double shift = data[0].amplitude;
+    double minVal = shift;
+    double maxVal = shift;
+    double shiftedSum = 0.0;        // sum(x - shift)
+    double shiftedSquares = 0.0;    // sum((x - shift)^2)
+    double squares = 0.0;           // sum(x^2)
+
+    int i = 0;
+
+#ifdef SIGNALSTATISTICS_USE_SSE2
+    // 每次处理4个样本，两组独立累加器以隐藏加法延迟
+    const __m128d vShift = _mm_set1_pd(shift);
+    __m128d vMin = vShift;
+    __m128d vMax = vShift;
+    __m128d vSum0 = _mm_setzero_pd();
+    __m128d vSum1 = _mm_setzero_pd();
+    __m128d vShiftedSq0 = _mm_setzero_pd();
+    __m128d vShiftedSq1 = _mm_setzero_pd();
+    __m128d vSq0 = _mm_setzero_pd();
+    __m128d vSq1 = _mm_setzero_pd();
+
+    for (; i + 3 < size; i += 4) {
+        __m128d x0 = _mm_loadh_pd(_mm_load_sd(&data[i].amplitude), &data[i + 1].amplitude);
+        __m128d x1 = _mm_loadh_pd(_mm_load_sd(&data[i + 2].amplitude), &data[i + 3].amplitude);
+
+        vMin = _mm_min_pd(vMin, _mm_min_pd(x0, x1));
+        vMax = _mm_max_pd(vMax, _mm_max_pd(x0, x1));
+
+        __m128d d0 = _mm_sub_pd(x0, vShift);
+        __m128d d1 = _mm_sub_pd(x1, vShift);
+        vSum0 = _mm_add_pd(vSum0, d0);
+        vSum1 = _mm_add_pd(vSum1, d1);
+        vShiftedSq0 = _mm_add_pd(vShiftedSq0, _mm_mul_pd(d0, d0));
+        vShiftedSq1 = _mm_add_pd(vShiftedSq1, _mm_mul_pd(d1, d1));
+        vSq0 = _mm_add_pd(vSq0, _mm_mul_pd(x0, x0));
+        vSq1 = _mm_add_pd(vSq1, _mm_mul_pd(x1, x1));
+    }
+
+    double lanes[2];
+    _mm_storeu_pd(lanes, vMin);
+    minVal = std::min(lanes[0], lanes[1]);
+    _mm_storeu_pd(lanes, vMax);
+    maxVal = std::max(lanes[0], lanes[1]);
+    _mm_storeu_pd(lanes, _mm_add_pd(vSum0, vSum1));
+    shiftedSum = lanes[0] + lanes[1];
+    _mm_storeu_pd(lanes, _mm_add_pd(vShiftedSq0, vShiftedSq1));
+    shiftedSquares = lanes[0] + lanes[1];
+    _mm_storeu_pd(lanes, _mm_add_pd(vSq0, vSq1));
+    squares = lanes[0] + lanes[1];
+#endif
+
+    for (; i < size; ++i) {
+        double x = data[i].amplitude;
+        double d = x - shift;
+        minVal = std::min(minVal, x);
+        maxVal = std::max(maxVal, x);
+        shiftedSum += d;
+        shiftedSquares += d * d;
+        squares += x * x;
+    }
+
+    SignalStatistics stats;
+    stats.count = size;
+    stats.min = minVal;
+    stats.max = maxVal;
+    stats.sum = size * shift + shiftedSum;
+    stats.sumSquares = squares;
+    stats.mean = shift + shiftedSum / size;
+    stats.m2 = std::max(0.0, shiftedSquares - shiftedSum * shiftedSum / size);
+    return stats;
+}
+
+} // namespace
+
+void SignalStatistics::add(double value)
+{
+    if (count == 0) {
+        count = 1;
+        min = max = value;
+        sum = value;
+        sumSquares = value * value;
+        mean = value;
+        m2 = 0.0;
+        return;
+    }
+
+    ++count;
+    min = std::min(min, value);
+    max = std::max(max, value);
+    sum += value;
+    sumSquares += value * value;
+
+    double delta = value - mean;
+    mean += delta / count;
+    m2 += delta * (value - mean);
+}
+
+void SignalStatistics::merge(const SignalStatistics& other)
+{
+    if (other.count == 0) {
+        return;
+    }
+
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+
+    double total = static_cast<double>(count + other.count);
+    double delta = other.mean - mean;
+
+    mean += delta * other.count / total;
+    m2 += other.m2 + delta * delta * (static_cast<double>(count) * other.count / total);
+
+    count += other.count;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+    sum += other.sum;
+    sumSquares += other.sumSquares;
+}
+
+double SignalStatistics::rms() const
+{
+    if (count == 0) {
+        return 0.0;
+    }
+    return std::sqrt(sumSquares / count);
+}
+
+double SignalStatistics::variance() const
+{
+    if (count < 2) {
+        return 0.0;
+    }
+    return m2 / (count - 1);
+}
+
+double SignalStatistics::stdDev() const
+{
+    return std::sqrt(variance());
+}
+
+SignalStatistics SignalStatistics::compute(const DataPoint* data, int size)
+{
+    SignalStatistics stats;
+    for (int start = 0; start < size; start += BLOCK_SIZE) {
+        int blockSize = std::min(BLOCK_SIZE, size - start);
+        stats.merge(computeBlock(data + start, blockSize));
+    }
+    return stats;
+}
+
+SignalStatistics SignalStatistics::compute(const QVector<DataPoint>& data)
+{
+    return compute(data.constData(), data.size());
+}
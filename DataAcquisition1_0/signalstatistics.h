@@ -0,0 +1,43 @@
+#ifndef SIGNALSTATISTICS_H
+#define SIGNALSTATISTICS_H
+
+#include <QVector>
+#include <QtGlobal>
+
+struct DataPoint;
+
+// 可合并的统计量 - 一次遍历得到最大/最小值、和、平方和及Welford方差
+// 分块计算的结果可以用 merge() 合并，与整体一次计算的结果一致
+struct SignalStatistics {
+    qint64 count;
+    double min;
+    double max;
+    double sum;
+    double sumSquares;
+    double mean;
+    double m2;          // 与均值之差的平方和（Welford）
+
+    SignalStatistics()
+        : count(0), min(0.0), max(0.0), sum(0.0),
+          sumSquares(0.0), mean(0.0), m2(0.0) {}
+
+    bool isEmpty() const { return count == 0; }
+
+    // 加入单个样本
+    void add(double value);
+
+    // 合并另一段数据的统计量（Chan并行公式）
+    void merge(const SignalStatistics& other);
+
+    double average() const { return mean; }
+    double rms() const;
+    double variance() const;        // 样本方差（n-1）
+    double stdDev() const;
+    double peakToPeak() const { return max - min; }
+
+    // 单次遍历计算一段数据的全部统计量
+    static SignalStatistics compute(const DataPoint* data, int size);
+    static SignalStatistics compute(const QVector<DataPoint>& data);
+};
+
+#endif // SIGNALSTATISTICS_H
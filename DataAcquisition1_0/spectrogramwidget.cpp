@@ -0,0 +1,231 @@
+#include "spectrogramwidget.h"
+#include <QPainter>
+#include <QDebug>
+#include <cstring>
+#include <cmath>
+
+namespace {
+
+const int COLOR_MAP_SIZE = 256;
+const double AUTO_LEVEL_RANGE = 100.0;   // 自动模式下显示的动态范围（dB）
+
+} // namespace
+
+SpectrogramWidget::SpectrogramWidget(QWidget *parent)
+    : QWidget(parent)
+    , m_engine(nullptr)
+    , m_updateTimer(new QTimer(this))
+    , m_channel(0)
+    , m_nextFrame(0)
+    , m_minDb(-140.0)
+    , m_maxDb(-40.0)
+    , m_autoLevel(true)
+    , m_leftMargin(60)
+    , m_rightMargin(20)
+    , m_topMargin(20)
+    , m_bottomMargin(30)
+{
+    setMinimumSize(400, 200);
+    setAutoFillBackground(true);
+
+    QPalette pal = palette();
+    pal.setColor(QPalette::Window, Qt::black);
+    setPalette(pal);
+
+    buildColorMap();
+
+    connect(m_updateTimer, &QTimer::timeout, this, &SpectrogramWidget::updateDisplay);
+    m_updateTimer->setInterval(50);  // 20Hz刷新率
+}
+
+SpectrogramWidget::~SpectrogramWidget()
+{
+}
+
+void SpectrogramWidget::setEngine(StftEngine* engine)
+{
+    m_engine = engine;
+    clearDisplay();
+}
+
+void SpectrogramWidget::setChannel(int channel)
+{
+    if (channel < 0 || channel >= MAX_CHANNELS || channel == m_channel) {
+        return;
+    }
+
+    m_channel = channel;
+    clearDisplay();
+}
+
+void SpectrogramWidget::setUpdateInterval(int ms)
+{
+    m_updateTimer->setInterval(ms);
+}
+
+void SpectrogramWidget::setLevelRange(double minDb, double maxDb)
+{
+    if (maxDb <= minDb) {
+        qWarning() << "无效的时频图显示范围:" << minDb << maxDb;
+        return;
+    }
+
+    m_minDb = minDb;
+    m_maxDb = maxDb;
+    m_autoLevel = false;
+    update();
+}
+
+void SpectrogramWidget::setAutoLevel(bool enable)
+{
+    m_autoLevel = enable;
+}
+
+void SpectrogramWidget::startDisplay()
+{
+    clearDisplay();
+    m_updateTimer->start();
+}
+
+void SpectrogramWidget::stopDisplay()
+{
+    m_updateTimer->stop();
+}
+
+void SpectrogramWidget::clearDisplay()
+{
+    m_image = QImage();
+    m_nextFrame = m_engine ? m_engine->frameCount(m_channel) : 0;
+    update();
+}
+
+void SpectrogramWidget::updateDisplay()
+{
+    if (!m_engine) {
+        return;
+    }
+
+    // 只取上次读取之后的新帧
+    QVector<QVector<float>> frames = m_engine->framesSince(m_channel, m_nextFrame, &m_nextFrame);
+    if (frames.isEmpty()) {
+        return;
+    }
+
+    int bins = frames.first().size();
+    int rows = m_engine->historyLength();
+    if (m_image.isNull() || m_image.width() != bins || m_image.height() != rows) {
+        resetImage(bins, rows);
+    }
+
+    appendRows(frames);
+    update();
+}
+
+void SpectrogramWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+
+    QRect plotRect(m_leftMargin, m_topMargin,
+                   width() - m_leftMargin - m_rightMargin,
+                   height() - m_topMargin - m_bottomMargin);
+    if (plotRect.width() <= 0 || plotRect.height() <= 0) {
+        return;
+    }
+
+    if (!m_image.isNull()) {
+        painter.drawImage(plotRect, m_image);
+    }
+
+    painter.setPen(QColor(50, 50, 50));
+    painter.drawRect(plotRect);
+
+    // 频率轴标注
+    painter.setPen(Qt::white);
+    double nyquist = m_engine ? m_engine->sampleRate() / 2.0 : 0.0;
+    for (int i = 0; i <= 4; ++i) {
+        int x = plotRect.left() + plotRect.width() * i / 4;
+        double freq = nyquist * i / 4.0;
+        QString text = freq >= 1000.0 ? QString::number(freq / 1000.0, 'f', 1) + "kHz"
+                                      : QString::number(freq, 'f', 0) + "Hz";
+        painter.drawText(x - 20, height() - 10, text);
+    }
+
+    painter.drawText(5, m_topMargin + 12, "最新");
+    painter.drawText(5, plotRect.bottom(), "较早");
+    painter.drawText(plotRect.right() - 220, m_topMargin - 5,
+                     QString("通道%1 时频图  %2 ~ %3 dB")
+                         .arg(m_channel)
+                         .arg(m_minDb, 0, 'f', 0)
+                         .arg(m_maxDb, 0, 'f', 0));
+}
+
+void SpectrogramWidget::resetImage(int bins, int rows)
+{
+    m_image = QImage(bins, rows, QImage::Format_RGB32);
+    m_image.fill(m_colorMap.first());
+}
+
+void SpectrogramWidget::appendRows(const QVector<QVector<float>>& frames)
+{
+    int rows = m_image.height();
+    int bins = m_image.width();
+    int newRows = qMin(frames.size(), rows);
+
+    if (m_autoLevel) {
+        float peak = frames.last().first();
+        for (float value : frames.last()) {
+            peak = qMax(peak, value);
+        }
+        m_maxDb = std::ceil(peak / 10.0) * 10.0;
+        m_minDb = m_maxDb - AUTO_LEVEL_RANGE;
+    }
+
+    // 已有内容整体下移 newRows 行（最新帧在顶部）
+    int bytesPerLine = m_image.bytesPerLine();
+    if (newRows < rows) {
+        uchar* bits = m_image.bits();
+        std::memmove(bits + newRows * bytesPerLine, bits,
+                     static_cast<size_t>(rows - newRows) * bytesPerLine);
+    }
+
+    double scale = (COLOR_MAP_SIZE - 1) / (m_maxDb - m_minDb);
+    for (int r = 0; r < newRows; ++r) {
+        const QVector<float>& frame = frames[frames.size() - 1 - r];
+        QRgb* line = reinterpret_cast<QRgb*>(m_image.scanLine(r));
+        int count = qMin(bins, frame.size());
+        for (int k = 0; k < count; ++k) {
+            int index = static_cast<int>((frame[k] - m_minDb) * scale);
+            line[k] = m_colorMap[qBound(0, index, COLOR_MAP_SIZE - 1)];
+        }
+    }
+}
+
+void SpectrogramWidget::buildColorMap()
+{
+    // 黑 → 蓝 → 青 → 黄 → 红 → 白
+    static const struct { double pos; int r, g, b; } stops[] = {
+        {0.00,   0,   0,   0},
+        {0.20,   0,   0, 180},
+        {0.45,   0, 200, 255},
+        {0.65, 255, 255,   0},
+        {0.85, 255,  40,   0},
+        {1.00, 255, 255, 255}
+    };
+    const int stopCount = sizeof(stops) / sizeof(stops[0]);
+
+    m_colorMap.resize(COLOR_MAP_SIZE);
+    for (int i = 0; i < COLOR_MAP_SIZE; ++i) {
+        double t = static_cast<double>(i) / (COLOR_MAP_SIZE - 1);
+        int s = 1;
+        while (s < stopCount - 1 && t > stops[s].pos) {
+            ++s;
+        }
+        double f = (t - stops[s - 1].pos) / (stops[s].pos - stops[s - 1].pos);
+        int r = static_cast<int>(stops[s - 1].r + f * (stops[s].r - stops[s - 1].r));
+        int g = static_cast<int>(stops[s - 1].g + f * (stops[s].g - stops[s - 1].g));
+        int b = static_cast<int>(stops[s - 1].b + f * (stops[s].b - stops[s - 1].b));
+        m_colorMap[i] = qRgb(r, g, b);
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef SPECTROGRAMWIDGET_H
+#define SPECTROGRAMWIDGET_H
+
+#include <QWidget>
+#include <QImage>
+#include <QTimer>
+#include <QVector>
+#include "stftengine.h"
+
+// 时频图（瀑布图）控件 - 定时从 StftEngine 增量读取新帧，最新一帧显示在顶部
+// 横轴为频率（0 ~ 采样率/2），纵轴为时间，颜色表示功率谱密度（dB）
+class SpectrogramWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit SpectrogramWidget(QWidget *parent = nullptr);
+    ~SpectrogramWidget();
+
+    void setEngine(StftEngine* engine);
+    void setChannel(int channel);
+    int channel() const { return m_channel; }
+
+    void setUpdateInterval(int ms);
+
+    // 颜色映射的dB范围，自动模式下跟随最近帧的最大值
+    void setLevelRange(double minDb, double maxDb);
+    void setAutoLevel(bool enable);
+
+public slots:
+    void startDisplay();
+    void stopDisplay();
+    void clearDisplay();
+    void updateDisplay();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    void resetImage(int bins, int rows);
+    void appendRows(const QVector<QVector<float>>& frames);
+    void buildColorMap();
+
+    StftEngine* m_engine;
+    QTimer* m_updateTimer;
+    int m_channel;
+    qint64 m_nextFrame;     // 下一次读取的帧序号
+
+    QImage m_image;         // 每行一帧，第0行为最新
+    QVector<QRgb> m_colorMap;
+    double m_minDb;
+    double m_maxDb;
+    bool m_autoLevel;
+
+    int m_leftMargin;
+    int m_rightMargin;
+    int m_topMargin;
+    int m_bottomMargin;
+};
+
+#endif // SPECTROGRAMWIDGET_H
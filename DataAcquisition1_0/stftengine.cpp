@@ -0,0 +1,258 @@
+#include "stftengine.h"
+#include "fftplan.h"
+#include <QDebug>
+#include <cmath>
+
+namespace {
+
+// 功率下限，避免对0取对数
+const double MIN_POWER = 1e-20;
+
+} // namespace
+
+StftEngine::StftEngine(QObject *parent)
+    : QObject(parent)
+    , m_fftSize(1024)
+    , m_hopSize(256)
+    , m_windowType(WindowFunction::Hann)
+    , m_sampleRate(1000000.0)
+    , m_historyLength(512)
+    , m_scale(1.0)
+{
+    QMutexLocker locker(&m_mutex);
+    QMutexLocker ringLocker(&m_ringMutex);
+    resetLocked();
+}
+
+StftEngine::~StftEngine()
+{
+}
+
+void StftEngine::setFftSize(int size)
+{
+    if (size < 16) {
+        qWarning() << "无效的STFT长度:" << size;
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    QMutexLocker ringLocker(&m_ringMutex);
+    m_fftSize = size;
+    m_hopSize = qMin(m_hopSize, m_fftSize);
+    resetLocked();
+}
+
+void StftEngine::setHopSize(int hop)
+{
+    if (hop < 1) {
+        qWarning() << "无效的STFT跳步:" << hop;
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    QMutexLocker ringLocker(&m_ringMutex);
+    m_hopSize = qMin(hop, m_fftSize);
+    resetLocked();
+}
+
+void StftEngine::setWindow(WindowFunction::Type window)
+{
+    QMutexLocker locker(&m_mutex);
+    QMutexLocker ringLocker(&m_ringMutex);
+    m_windowType = window;
+    resetLocked();
+}
+
+void StftEngine::setSampleRate(double rate)
+{
+    if (rate <= 0.0) {
+        qWarning() << "无效的采样率:" << rate;
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    QMutexLocker ringLocker(&m_ringMutex);
+    m_sampleRate = rate;
+    resetLocked();
+}
+
+void StftEngine::setHistoryLength(int frames)
+{
+    if (frames < 1) {
+        qWarning() << "无效的时频图历史长度:" << frames;
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    QMutexLocker ringLocker(&m_ringMutex);
+    m_historyLength = frames;
+    resetLocked();
+}
+
+int StftEngine::fftSize() const
+{
+    QMutexLocker locker(&m_ringMutex);
+    return m_fftSize;
+}
+
+int StftEngine::hopSize() const
+{
+    QMutexLocker locker(&m_ringMutex);
+    return m_hopSize;
+}
+
+int StftEngine::binCount() const
+{
+    QMutexLocker locker(&m_ringMutex);
+    return m_fftSize / 2 + 1;
+}
+
+double StftEngine::sampleRate() const
+{
+    QMutexLocker locker(&m_ringMutex);
+    return m_sampleRate;
+}
+
+int StftEngine::historyLength() const
+{
+    QMutexLocker locker(&m_ringMutex);
+    return m_historyLength;
+}
+
+qint64 StftEngine::frameCount(int channel) const
+{
+    if (channel < 0 || channel >= MAX_CHANNELS) {
+        return 0;
+    }
+
+    QMutexLocker locker(&m_ringMutex);
+    return m_channels[channel].frameCount;
+}
+
+QVector<QVector<float>> StftEngine::framesSince(int channel, qint64 firstFrame,
+                                                qint64* nextFrame) const
+{
+    QVector<QVector<float>> frames;
+
+    if (channel < 0 || channel >= MAX_CHANNELS) {
+        if (nextFrame) {
+            *nextFrame = 0;
+        }
+        return frames;
+    }
+
+    QMutexLocker locker(&m_ringMutex);
+
+    const ChannelState& state = m_channels[channel];
+    int bins = m_fftSize / 2 + 1;
+
+    // 已被覆盖的帧无法再读取，从仍保留的最早一帧开始
+    qint64 oldest = qMax<qint64>(0, state.frameCount - m_historyLength);
+    qint64 first = qBound(oldest, firstFrame, state.frameCount);
+
+    frames.reserve(static_cast<int>(state.frameCount - first));
+    for (qint64 frame = first; frame < state.frameCount; ++frame) {
+        int row = static_cast<int>(frame % m_historyLength);
+        frames.append(QVector<float>(state.ring.constData() + row * bins,
+                                     state.ring.constData() + (row + 1) * bins));
+    }
+
+    if (nextFrame) {
+        *nextFrame = state.frameCount;
+    }
+    return frames;
+}
+
+void StftEngine::processBlock(int channel, const QVector<DataPoint>& data)
+{
+    if (channel < 0 || channel >= MAX_CHANNELS || data.isEmpty()) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    ChannelState& state = m_channels[channel];
+    int oldSize = state.pending.size();
+    state.pending.resize(oldSize + data.size());
+    for (int i = 0; i < data.size(); ++i) {
+        state.pending[oldSize + i] = data[i].amplitude;
+    }
+
+    int available = state.pending.size() - m_fftSize;
+    if (available < 0 || !m_plan) {
+        return;
+    }
+
+    // 一次到达的数据可能超过历史长度，只计算最终会保留在环形缓冲中的帧
+    int frames = 1 + available / m_hopSize;
+    int readPos = 0;
+    if (frames > m_historyLength) {
+        readPos = (frames - m_historyLength) * m_hopSize;
+        frames = m_historyLength;
+    }
+
+    int bins = m_fftSize / 2 + 1;
+    QVector<float> row(bins);
+
+    for (int f = 0; f < frames; ++f) {
+        computeFrame(state.pending.constData() + readPos, row.data());
+        readPos += m_hopSize;
+
+        QMutexLocker ringLocker(&m_ringMutex);
+        int slot = static_cast<int>(state.frameCount % m_historyLength);
+        std::copy(row.constBegin(), row.constEnd(), state.ring.begin() + slot * bins);
+        ++state.frameCount;
+    }
+
+    // 只保留下一帧需要的样本（不超过一帧长度）
+    state.pending.remove(0, readPos);
+}
+
+void StftEngine::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    QMutexLocker ringLocker(&m_ringMutex);
+    resetLocked();
+}
+
+void StftEngine::resetLocked()
+{
+    m_window = WindowFunction::coefficients(m_windowType, m_fftSize);
+
+    double windowPower = 0.0;
+    for (double w : m_window) {
+        windowPower += w * w;
+    }
+    m_scale = 1.0 / (m_sampleRate * windowPower);
+
+    m_plan = RealFftPlan::plan(m_fftSize);
+    m_frameBuffer.resize(m_fftSize);
+    m_powerBuffer.resize(m_fftSize / 2 + 1);
+
+    int bins = m_fftSize / 2 + 1;
+    for (int i = 0; i < MAX_CHANNELS; ++i) {
+        m_channels[i].pending.clear();
+        m_channels[i].ring = QVector<float>(m_historyLength * bins, 10.0f * std::log10(MIN_POWER));
+        m_channels[i].frameCount = 0;
+    }
+}
+
+void StftEngine::computeFrame(const double* samples, float* out)
+{
+    for (int i = 0; i < m_fftSize; ++i) {
+        m_frameBuffer[i] = samples[i] * m_window[i];
+    }
+
+    int bins = m_powerBuffer.size();
+    m_plan->magnitude(m_frameBuffer.constData(), m_powerBuffer.data(), bins, true);
+
+    // 单边功率谱密度（直流和奈奎斯特频点不加倍），以dB输出
+    int lastDoubled = (m_fftSize % 2 == 0) ? bins - 2 : bins - 1;
+    for (int k = 0; k < bins; ++k) {
+        double power = m_powerBuffer[k] * m_scale;
+        if (k >= 1 && k <= lastDoubled) {
+            power *= 2.0;
+        }
+        out[k] = static_cast<float>(10.0 * std::log10(qMax(power, MIN_POWER)));
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef STFTENGINE_H
+#define STFTENGINE_H
+
+#include <QObject>
+#include <QVector>
+#include <QMutex>
+#include <QSharedPointer>
+#include "databuffer.h"
+#include "windowfunction.h"
+
+// 流式短时傅里叶变换 - 接收采集数据块，按固定跳步输出加窗频谱帧
+// 每个通道只保留不足一帧的剩余样本，处理量只与新到数据量有关，不重算整个缓冲区
+// 频谱帧（单边功率谱密度，dB）保存在每通道的环形缓冲中，供时频图控件按序号增量读取
+class RealFftPlan;
+
+class StftEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StftEngine(QObject *parent = nullptr);
+    ~StftEngine();
+
+    // 参数设置（会清空已有的帧）
+    void setFftSize(int size);
+    void setHopSize(int hop);
+    void setWindow(WindowFunction::Type window);
+    void setSampleRate(double rate);
+    void setHistoryLength(int frames);
+
+    int fftSize() const;
+    int hopSize() const;
+    int binCount() const;
+    double sampleRate() const;
+    int historyLength() const;
+
+    // 已产生的帧总数（下一帧的序号）
+    qint64 frameCount(int channel) const;
+
+    // 读取序号不小于 firstFrame 且仍在环形缓冲中的帧（按时间顺序），nextFrame 返回下一次读取的起点
+    QVector<QVector<float>> framesSince(int channel, qint64 firstFrame, qint64* nextFrame) const;
+
+public slots:
+    void processBlock(int channel, const QVector<DataPoint>& data);
+    void reset();
+
+private:
+    struct ChannelState {
+        QVector<double> pending;    // 尚未组成完整帧的样本
+        QVector<float> ring;        // historyLength 行 × binCount 列
+        qint64 frameCount;
+
+        ChannelState() : frameCount(0) {}
+    };
+
+    void resetLocked();     // 调用时须同时持有 m_mutex 和 m_ringMutex
+    void computeFrame(const double* samples, float* out);
+
+    // m_mutex 保护参数和处理状态；m_ringMutex 只在写入/读取帧时短暂持有，避免读取方等待FFT
+    mutable QMutex m_mutex;
+    mutable QMutex m_ringMutex;
+
+    int m_fftSize;
+    int m_hopSize;
+    WindowFunction::Type m_windowType;
+    double m_sampleRate;
+    int m_historyLength;
+
+    QSharedPointer<const RealFftPlan> m_plan;
+    QVector<double> m_window;
+    double m_scale;             // 1/(fs*Σw²)
+    QVector<double> m_frameBuffer;
+    QVector<double> m_powerBuffer;
+
+    ChannelState m_channels[MAX_CHANNELS];
+};
+
+#endif // STFTENGINE_H
@@ -0,0 +1,83 @@
+// FFT计划基准程序
+// 对典型长度分别计时：2的幂次、混合基长度、含大质因子的长度（Bluestein）
+// 以及幅值谱路径对非混合基长度零填充到混合基长度后的耗时
+//
+// 用法: fftbench [每个长度的重复次数]
+#include "fftplan.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// 返回单次幅值谱计算的平均毫秒数，plan 在计时前创建，不计入计划构造时间
+double timeMagnitude(int fftSize, int sampleCount, int repeats, double* checksum)
+{
+    QSharedPointer<const RealFftPlan> plan = RealFftPlan::plan(fftSize);
+    if (!plan) {
+        return -1.0;
+    }
+
+    std::vector<double> samples(fftSize, 0.0);
+    for (int i = 0; i < sampleCount; ++i) {
+        samples[i] = std::sin(2.0 * M_PI * 0.01234 * i) + 0.1 * std::cos(0.37 * i);
+    }
+    std::vector<double> spectrum(plan->spectrumSize());
+
+    // 预热一次，排除首次访问内存的开销
+    plan->magnitude(samples.data(), spectrum.data(), static_cast<int>(spectrum.size()));
+
+    Clock::time_point start = Clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        plan->magnitude(samples.data(), spectrum.data(), static_cast<int>(spectrum.size()));
+        *checksum += spectrum[spectrum.size() / 3];
+    }
+    double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return elapsed / repeats;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int repeats = argc > 1 ? std::atoi(argv[1]) : 20;
+    if (repeats < 1) {
+        repeats = 1;
+    }
+
+    struct Case {
+        const char* label;
+        int samples;
+        bool padToSmooth;
+    };
+
+    const Case cases[] = {
+        {"2的幂次",              131072, false},
+        {"混合基(2^11*7^2)",     100352, false},
+        {"大质因子(Bluestein)",  100001, false},
+        {"大质因子(零填充)",     100001, true},
+        {"偶数含大质因子",       100002, false},
+        {"偶数含大质因子(零填充)", 100002, true},
+    };
+
+    double checksum = 0.0;
+    std::printf("%-28s %10s %10s %12s\n", "长度类型", "点数", "FFT长度", "平均耗时(ms)");
+    for (const Case& c : cases) {
+        // 与 DataAnalyzer::realSpectrum 相同的填充规则：偶数混合基长度
+        int fftSize = c.samples;
+        if (c.padToSmooth && !FftPlan::isSmoothSize(fftSize)) {
+            fftSize = 2 * FftPlan::nextSmoothSize((c.samples + 1) / 2);
+        }
+
+        double ms = timeMagnitude(fftSize, c.samples, repeats, &checksum);
+        std::printf("%-28s %10d %10d %12.3f\n", c.label, c.samples, fftSize, ms);
+    }
+
+    // 输出校验和，防止编译器优化掉计算
+    std::printf("校验和: %g\n", checksum);
+    return 0;
+}
@@ -0,0 +1,17 @@
+QT -= gui
+QT += core
+
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+TARGET = fftbench
+TEMPLATE = app
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    fftbench.cpp \
+    ../fftplan.cpp
+
+HEADERS += \
+    ../fftplan.h
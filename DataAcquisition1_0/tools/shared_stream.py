@@ -0,0 +1,111 @@
+# -*- coding: utf-8 -*-
+"""共享内存实时流的Python读取端，布局与协议见 ../sharedstreamlayout.h
+
+    from shared_stream import SharedStream
+    stream = SharedStream("daq_stream")
+    next_index = stream.write_index(0)
+    while True:
+        data, next_index, dropped = stream.read(0, next_index)
+"""
+import mmap
+import os
+import struct
+import sys
+import time
+
+import numpy as np
+
+MAGIC = b"DAQSHM01"
+VERSION = 1
+SEGMENT_HEADER = struct.Struct("<8sIIIIQQdQQ")
+CHANNEL_HEADER = struct.Struct("<QQdII")
+CHANNEL_HEADER_SIZE = 64
+# 发布端写入中途退出时 sequence 会一直是奇数，超过该时间仍读不到一致结果即报错
+SNAPSHOT_TIMEOUT = 0.1
+
+
+class SharedStream:
+    def __init__(self, name="daq_stream"):
+        if sys.platform == "win32":
+            # Windows 下 tagname 对应的映射必须已存在，大小取头部声明的大小
+            probe = mmap.mmap(-1, SEGMENT_HEADER.size, tagname="Local\\" + name, access=mmap.ACCESS_READ)
+            size = self._segment_size(probe)
+            probe.close()
+            self._map = mmap.mmap(-1, size, tagname="Local\\" + name, access=mmap.ACCESS_READ)
+        else:
+            fd = os.open("/dev/shm/" + name, os.O_RDONLY)
+            try:
+                self._map = mmap.mmap(fd, 0, prot=mmap.PROT_READ)
+            finally:
+                os.close(fd)
+
+        (magic, version, self.header_size, self.channel_count, self.capacity,
+         self.data_offset, self.channel_stride, _, _, _) = SEGMENT_HEADER.unpack_from(self._map, 0)
+        if magic != MAGIC or version != VERSION:
+            raise ValueError("共享内存格式无效或版本不支持")
+
+        # 每个通道的环形缓冲区直接映射为 numpy 数组，不复制
+        self.rings = [np.frombuffer(self._map, dtype=np.float64, count=self.capacity,
+                                    offset=self.data_offset + ch * self.channel_stride)
+                      for ch in range(self.channel_count)]
+
+    @staticmethod
+    def _segment_size(buffer):
+        fields = SEGMENT_HEADER.unpack_from(buffer, 0)
+        channel_count, capacity, data_offset, stride = fields[3], fields[4], fields[5], fields[6]
+        return data_offset + channel_count * stride
+
+    @property
+    def sample_rate(self):
+        return SEGMENT_HEADER.unpack_from(self._map, 0)[7]
+
+    @property
+    def generation(self):
+        return SEGMENT_HEADER.unpack_from(self._map, 0)[8]
+
+    def snapshot(self, channel):
+        """返回 (write_index, last_time, enabled)，顺序锁保证三者来自同一次写入
+
+        超时仍读不到一致结果（发布端可能已退出）时抛出 TimeoutError
+        """
+        offset = self.header_size + channel * CHANNEL_HEADER_SIZE
+        deadline = time.monotonic() + SNAPSHOT_TIMEOUT
+        while True:
+            before, write_index, last_time, enabled, _ = CHANNEL_HEADER.unpack_from(self._map, offset)
+            if not before & 1:
+                after = struct.unpack_from("<Q", self._map, offset)[0]
+                if before == after:
+                    return write_index, last_time, bool(enabled)
+            if time.monotonic() >= deadline:
+                raise TimeoutError("通道 %d 的写入长时间未完成，发布端可能已退出" % channel)
+
+    def write_index(self, channel):
+        return self.snapshot(channel)[0]
+
+    def read(self, channel, next_index, max_count=None):
+        """读取 next_index 之后的新样本，返回 (样本数组, 新的 next_index, 丢失的样本数)"""
+        write_index, _, _ = self.snapshot(channel)
+        start = min(next_index, write_index)
+        oldest = max(write_index - self.capacity, 0)
+        dropped = max(oldest - start, 0)
+        start = max(start, oldest)
+        count = write_index - start
+        if max_count is not None:
+            count = min(count, max_count)
+
+        positions = (np.arange(start, start + count, dtype=np.uint64) & np.uint64(self.capacity - 1))
+        data = self.rings[channel][positions]
+
+        # 复制期间被覆盖的样本作废
+        valid = max(self.write_index(channel) - self.capacity, 0)
+        if start < valid:
+            stale = min(count, valid - start)
+            data = data[stale:]
+            start += stale
+            dropped += stale
+            count -= stale
+        return data, start + count, dropped
+
+    def close(self):
+        self.rings = []
+        self._map.close()
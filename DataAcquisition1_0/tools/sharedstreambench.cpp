@@ -0,0 +1,108 @@
+// 共享内存实时流基准读取程序
+// 持续读取所有有数据的通道，每秒输出读取速率、丢失样本数和落后发布端的样本数
+//
+// 用法: sharedstreambench [共享内存名] [运行秒数]
+#include "sharedstreamreader.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+    std::string name = argc > 1 ? argv[1] : SharedStream::DEFAULT_NAME;
+    double seconds = argc > 2 ? std::atof(argv[2]) : 10.0;
+
+    SharedStreamReader reader;
+    if (!reader.open(name)) {
+        std::fprintf(stderr, "打开共享内存 %s 失败: %s\n", name.c_str(), reader.lastError().c_str());
+        return 1;
+    }
+
+    int channels = static_cast<int>(reader.channelCount());
+    std::printf("共享内存 %s: %d 个通道，每通道 %u 个样本，采样率 %.1f Hz\n",
+                name.c_str(), channels, reader.capacity(), reader.sampleRate());
+
+    // 从当前位置开始读，不回放已有数据
+    std::vector<uint64_t> next(channels);
+    for (int ch = 0; ch < channels; ++ch) {
+        next[ch] = reader.writeIndex(ch);
+    }
+
+    std::vector<double> buffer(reader.capacity());
+    uint64_t totalSamples = 0;
+    uint64_t totalDropped = 0;
+    uint64_t intervalSamples = 0;
+    uint64_t intervalDropped = 0;
+    uint64_t polls = 0;
+    double checksum = 0.0;
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+    Clock::time_point lastReport = start;
+
+    while (true) {
+        Clock::time_point now = Clock::now();
+        double elapsed = std::chrono::duration<double>(now - start).count();
+        if (elapsed >= seconds) {
+            break;
+        }
+
+        size_t received = 0;
+        for (int ch = 0; ch < channels; ++ch) {
+            if (!reader.channelEnabled(ch)) {
+                continue;
+            }
+            uint64_t dropped = 0;
+            size_t n = reader.read(ch, &next[ch], buffer.data(), buffer.size(), &dropped);
+            // 访问读到的数据，避免只测到指针操作
+            for (size_t i = 0; i < n; ++i) {
+                checksum += buffer[i];
+            }
+            received += n;
+            intervalSamples += n;
+            intervalDropped += dropped;
+        }
+        ++polls;
+
+        double sinceReport = std::chrono::duration<double>(now - lastReport).count();
+        if (sinceReport >= 1.0) {
+            uint64_t lag = 0;
+            for (int ch = 0; ch < channels; ++ch) {
+                lag += reader.writeIndex(ch) - next[ch];
+            }
+            long long heartbeatAge = static_cast<long long>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count()
+                - static_cast<long long>(reader.heartbeat()));
+
+            std::printf("%7.1f 样本/秒  丢失 %llu  落后 %llu  轮询 %llu 次  发布端 %lld ms 前写入\n",
+                        intervalSamples / sinceReport,
+                        static_cast<unsigned long long>(intervalDropped),
+                        static_cast<unsigned long long>(lag),
+                        static_cast<unsigned long long>(polls), heartbeatAge);
+            std::fflush(stdout);
+
+            totalSamples += intervalSamples;
+            totalDropped += intervalDropped;
+            intervalSamples = 0;
+            intervalDropped = 0;
+            polls = 0;
+            lastReport = now;
+        }
+
+        if (received == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
+    }
+
+    totalSamples += intervalSamples;
+    totalDropped += intervalDropped;
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    std::printf("共读取 %llu 个样本（%.1f 样本/秒），丢失 %llu 个，校验和 %g\n",
+                static_cast<unsigned long long>(totalSamples), totalSamples / elapsed,
+                static_cast<unsigned long long>(totalDropped), checksum);
+    return 0;
+}
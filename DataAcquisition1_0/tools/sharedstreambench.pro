@@ -0,0 +1,17 @@
+QT -= core gui
+
+CONFIG += console c++17
+CONFIG -= app_bundle qt
+
+TARGET = sharedstreambench
+TEMPLATE = app
+
+unix:!macx: LIBS += -lrt
+
+SOURCES += \
+    sharedstreambench.cpp \
+    sharedstreamreader.cpp
+
+HEADERS += \
+    ../sharedstreamlayout.h \
+    sharedstreamreader.h
@@ -0,0 +1,255 @@
+#include "sharedstreamreader.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace {
+
+// 发布端的一次写入只有几十纳秒；sequence 长时间保持奇数说明发布端在写入中途崩溃或被挂起
+const int SNAPSHOT_SPIN_COUNT = 1024;
+const std::chrono::milliseconds SNAPSHOT_TIMEOUT(100);
+
+} // namespace
+
+SharedStreamReader::SharedStreamReader()
+    : m_base(nullptr)
+    , m_size(0)
+    , m_header(nullptr)
+#ifdef _WIN32
+    , m_mapping(nullptr)
+#endif
+{
+}
+
+SharedStreamReader::~SharedStreamReader()
+{
+    close();
+}
+
+bool SharedStreamReader::open(const std::string& name)
+{
+    close();
+
+#ifdef _WIN32
+    std::string mappingName = "Local\\" + name;
+    m_mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, mappingName.c_str());
+    if (!m_mapping) {
+        m_lastError = "共享内存不存在（采集程序未开启实时流？）";
+        return false;
+    }
+    m_base = static_cast<const unsigned char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_base) {
+        m_lastError = "映射共享内存失败";
+        close();
+        return false;
+    }
+    MEMORY_BASIC_INFORMATION info;
+    VirtualQuery(m_base, &info, sizeof(info));
+    m_size = info.RegionSize;
+#else
+    std::string shmName = "/" + name;
+    int fd = shm_open(shmName.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        m_lastError = "共享内存不存在（采集程序未开启实时流？）: " + std::string(strerror(errno));
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(SharedStream::SegmentHeader))) {
+        m_lastError = "共享内存大小无效";
+        ::close(fd);
+        return false;
+    }
+    m_size = static_cast<size_t>(info.st_size);
+    void* address = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        m_lastError = "映射共享内存失败: " + std::string(strerror(errno));
+        m_size = 0;
+        return false;
+    }
+    m_base = static_cast<const unsigned char*>(address);
+#endif
+
+    m_header = reinterpret_cast<const SharedStream::SegmentHeader*>(m_base);
+    bool valid = std::memcmp(m_header->magic, SharedStream::MAGIC, sizeof(m_header->magic)) == 0;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (!valid || m_header->version != SharedStream::VERSION
+        || m_header->capacity == 0 || (m_header->capacity & (m_header->capacity - 1)) != 0
+        || SharedStream::segmentSize(m_header->channelCount, m_header->capacity) > m_size) {
+        m_lastError = "共享内存格式无效或版本不支持";
+        close();
+        return false;
+    }
+    return true;
+}
+
+void SharedStreamReader::close()
+{
+#ifdef _WIN32
+    if (m_base) {
+        UnmapViewOfFile(m_base);
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+#else
+    if (m_base) {
+        munmap(const_cast<unsigned char*>(m_base), m_size);
+    }
+#endif
+    m_base = nullptr;
+    m_header = nullptr;
+    m_size = 0;
+}
+
+uint32_t SharedStreamReader::channelCount() const
+{
+    return m_header ? m_header->channelCount : 0;
+}
+
+uint32_t SharedStreamReader::capacity() const
+{
+    return m_header ? m_header->capacity : 0;
+}
+
+double SharedStreamReader::sampleRate() const
+{
+    return m_header ? m_header->sampleRate : 0.0;
+}
+
+uint64_t SharedStreamReader::generation() const
+{
+    return m_header ? m_header->generation.load(std::memory_order_acquire) : 0;
+}
+
+uint64_t SharedStreamReader::heartbeat() const
+{
+    return m_header ? m_header->heartbeat.load(std::memory_order_relaxed) : 0;
+}
+
+const SharedStream::ChannelHeader* SharedStreamReader::channelHeader(int channel) const
+{
+    if (!m_header || channel < 0 || channel >= static_cast<int>(m_header->channelCount)) {
+        return nullptr;
+    }
+    return reinterpret_cast<const SharedStream::ChannelHeader*>(
+        m_base + m_header->headerSize) + channel;
+}
+
+bool SharedStreamReader::channelEnabled(int channel) const
+{
+    const SharedStream::ChannelHeader* state = channelHeader(channel);
+    return state && state->enabled != 0;
+}
+
+const double* SharedStreamReader::ring(int channel) const
+{
+    if (!channelHeader(channel)) {
+        return nullptr;
+    }
+    return reinterpret_cast<const double*>(
+        m_base + m_header->dataOffset + channel * m_header->channelStride);
+}
+
+bool SharedStreamReader::snapshot(int channel, Snapshot* result) const
+{
+    const SharedStream::ChannelHeader* state = channelHeader(channel);
+    if (!state) {
+        return false;
+    }
+
+    // 顺序锁：sequence 为偶数且前后一致时读到的是完整的一次写入结果
+    // 先自旋，之后让出CPU重试，超时仍读不到一致结果时返回失败
+    std::chrono::steady_clock::time_point deadline;
+    for (int attempt = 0; ; ++attempt) {
+        uint64_t before = state->sequence.load(std::memory_order_acquire);
+        if (!(before & 1)) {
+            uint64_t writeIndex = state->writeIndex.load(std::memory_order_relaxed);
+            double lastTime = state->lastTime;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t after = state->sequence.load(std::memory_order_relaxed);
+            if (before == after) {
+                result->writeIndex = writeIndex;
+                result->lastTime = lastTime;
+                return true;
+            }
+        }
+
+        if (attempt < SNAPSHOT_SPIN_COUNT) {
+            continue;
+        }
+        if (attempt == SNAPSHOT_SPIN_COUNT) {
+            deadline = std::chrono::steady_clock::now() + SNAPSHOT_TIMEOUT;
+        } else if (std::chrono::steady_clock::now() >= deadline) {
+            m_lastError = "通道 " + std::to_string(channel) + " 的写入长时间未完成，发布端可能已退出";
+            return false;
+        }
+        std::this_thread::yield();
+    }
+}
+
+uint64_t SharedStreamReader::writeIndex(int channel) const
+{
+    Snapshot current;
+    return snapshot(channel, &current) ? current.writeIndex : 0;
+}
+
+size_t SharedStreamReader::read(int channel, uint64_t* nextIndex, double* out, size_t maxCount,
+                                uint64_t* dropped) const
+{
+    Snapshot before;
+    if (!snapshot(channel, &before) || maxCount == 0) {
+        return 0;
+    }
+
+    const uint64_t capacity = m_header->capacity;
+    const uint64_t mask = capacity - 1;
+    const double* samples = ring(channel);
+
+    // 发布端重建后序号可能比读者记录的小，从头开始
+    uint64_t start = std::min(*nextIndex, before.writeIndex);
+    uint64_t oldest = before.writeIndex > capacity ? before.writeIndex - capacity : 0;
+    uint64_t lost = 0;
+    if (start < oldest) {
+        lost += oldest - start;
+        start = oldest;
+    }
+
+    size_t count = static_cast<size_t>(std::min<uint64_t>(maxCount, before.writeIndex - start));
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = samples[(start + i) & mask];
+    }
+
+    // 复制期间被覆盖的样本作废
+    Snapshot after;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (!snapshot(channel, &after)) {
+        return 0;
+    }
+    uint64_t valid = after.writeIndex > capacity ? after.writeIndex - capacity : 0;
+    if (start < valid) {
+        size_t stale = static_cast<size_t>(std::min<uint64_t>(count, valid - start));
+        std::memmove(out, out + stale, (count - stale) * sizeof(double));
+        count -= stale;
+        start += stale;
+        lost += stale;
+    }
+
+    if (dropped) {
+        *dropped += lost;
+    }
+    *nextIndex = start + count;
+    return count;
+}
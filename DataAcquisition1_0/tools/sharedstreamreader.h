@@ -0,0 +1,71 @@
+#ifndef SHAREDSTREAMREADER_H
+#define SHAREDSTREAMREADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "../sharedstreamlayout.h"
+
+// 共享内存实时流读取库 - 供外部C++程序使用，不依赖Qt
+// 只读映射发布端创建的共享内存，不加锁、不复制整段缓冲区
+//
+// 典型用法：
+//   SharedStreamReader reader;
+//   reader.open("daq_stream");
+//   uint64_t next = reader.writeIndex(ch);          // 从最新位置开始
+//   while (...) {
+//       size_t n = reader.read(ch, &next, buffer, bufferSize, &dropped);
+//       ...
+//   }
+class SharedStreamReader
+{
+public:
+    struct Snapshot {
+        uint64_t writeIndex;    // 已写入的样本总数
+        double lastTime;        // 序号 writeIndex-1 的样本时间
+    };
+
+    SharedStreamReader();
+    ~SharedStreamReader();
+
+    bool open(const std::string& name = SharedStream::DEFAULT_NAME);
+    void close();
+
+    bool isOpen() const { return m_base != nullptr; }
+    const std::string& lastError() const { return m_lastError; }
+
+    uint32_t channelCount() const;
+    uint32_t capacity() const;
+    double sampleRate() const;
+    uint64_t generation() const;
+    uint64_t heartbeat() const;     // 发布端最近一次写入的时间（UTC毫秒）
+    bool channelEnabled(int channel) const;
+
+    // 一致的 writeIndex/lastTime 快照；发布端在写入中途退出导致超时读不到时返回 false，
+    // 原因见 lastError()
+    bool snapshot(int channel, Snapshot* result) const;
+    uint64_t writeIndex(int channel) const;
+
+    // 从 *nextIndex 开始读取最多 maxCount 个样本，返回读取的个数并推进 *nextIndex
+    // 已被覆盖（读得太慢）的样本被跳过，个数累加到 *dropped
+    size_t read(int channel, uint64_t* nextIndex, double* out, size_t maxCount,
+                uint64_t* dropped = nullptr) const;
+
+    // 零拷贝访问：环形缓冲区起始地址，序号 k 位于 ring[k & (capacity - 1)]，
+    // 使用前后需用 snapshot() 判断数据是否仍然有效
+    const double* ring(int channel) const;
+
+private:
+    const SharedStream::ChannelHeader* channelHeader(int channel) const;
+
+    const unsigned char* m_base;
+    size_t m_size;
+    const SharedStream::SegmentHeader* m_header;
+    mutable std::string m_lastError;
+
+#ifdef _WIN32
+    void* m_mapping;
+#endif
+};
+
+#endif // SHAREDSTREAMREADER_H
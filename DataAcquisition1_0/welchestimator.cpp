@@ -0,0 +1,172 @@
+#include "welchestimator.h"
+#include "fftplan.h"
+#include "workstealingpool.h"
+#include <QDebug>
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+// 每个并行任务至少处理的段数，避免任务过小
+const int MIN_SEGMENTS_PER_TASK = 4;
+
+} // namespace
+
+PsdResult WelchEstimator::estimate(const QVector<DataPoint>& data, double sampleRate,
+                                   const WelchSettings& settings, WorkStealingPool* pool)
+{
+    QVector<double> samples(data.size());
+    for (int i = 0; i < data.size(); ++i) {
+        samples[i] = data[i].amplitude;
+    }
+    return estimate(samples.constData(), samples.size(), sampleRate, settings, pool);
+}
+
+PsdResult WelchEstimator::estimate(const double* samples, int count, double sampleRate,
+                                   const WelchSettings& settings, WorkStealingPool* pool)
+{
+    PsdResult result;
+
+    if (count < 2 || sampleRate <= 0.0) {
+        qWarning() << "Welch谱估计参数无效: 点数" << count << "采样率" << sampleRate;
+        return result;
+    }
+
+    int segmentLength = qMin(qMax(2, settings.segmentLength), count);
+    double overlap = qBound(0.0, settings.overlap, 0.99);
+    int step = qMax(1, segmentLength - static_cast<int>(std::round(overlap * segmentLength)));
+    int segmentCount = 1 + (count - segmentLength) / step;
+
+    QSharedPointer<const RealFftPlan> plan = RealFftPlan::plan(segmentLength);
+    if (!plan) {
+        return result;
+    }
+
+    QVector<double> window = WindowFunction::coefficients(settings.window, segmentLength);
+    double windowSum = 0.0;
+    double windowPower = 0.0;
+    for (double w : window) {
+        windowSum += w;
+        windowPower += w * w;
+    }
+
+    // 密度缩放 1/(fs*Σw²)，使白噪声的谱密度与窗和段长无关
+    double scale = 1.0 / (sampleRate * windowPower);
+    int bins = plan->spectrumSize();
+    bool median = settings.averaging == WelchSettings::MedianAveraging;
+
+    // 单段周期图（双边谱的非负频率部分）
+    auto periodogram = [&](int segment, QVector<double>& buffer,
+                           QVector<std::complex<double>>& spectrum, double* out) {
+        const double* x = samples + static_cast<qint64>(segment) * step;
+
+        double mean = 0.0;
+        if (settings.removeMean) {
+            for (int i = 0; i < segmentLength; ++i) {
+                mean += x[i];
+            }
+            mean /= segmentLength;
+        }
+
+        for (int i = 0; i < segmentLength; ++i) {
+            buffer[i] = (x[i] - mean) * window[i];
+        }
+
+        plan->transform(buffer.constData(), spectrum.data());
+        for (int k = 0; k < bins; ++k) {
+            out[k] = std::norm(spectrum[k]) * scale;
+        }
+    };
+
+    // 平均模式下每个任务累加自己负责的段，中位数模式保留每段结果
+    int taskCount = 1;
+    if (pool && segmentCount >= 2 * MIN_SEGMENTS_PER_TASK) {
+        taskCount = qMin(pool->threadCount() * 4, segmentCount / MIN_SEGMENTS_PER_TASK);
+        taskCount = qMax(1, taskCount);
+    }
+    int segmentsPerTask = (segmentCount + taskCount - 1) / taskCount;
+    taskCount = (segmentCount + segmentsPerTask - 1) / segmentsPerTask;
+
+    QVector<double> partial(median ? segmentCount * bins : taskCount * bins, 0.0);
+
+    auto runSegments = [&](int taskBegin, int taskEnd) {
+        QVector<double> buffer(segmentLength);
+        QVector<std::complex<double>> spectrum(bins);
+        QVector<double> power(bins);
+
+        for (int task = taskBegin; task < taskEnd; ++task) {
+            int first = task * segmentsPerTask;
+            int last = qMin(segmentCount, first + segmentsPerTask);
+            for (int segment = first; segment < last; ++segment) {
+                if (median) {
+                    periodogram(segment, buffer, spectrum, partial.data() + segment * bins);
+                } else {
+                    periodogram(segment, buffer, spectrum, power.data());
+                    double* sum = partial.data() + task * bins;
+                    for (int k = 0; k < bins; ++k) {
+                        sum[k] += power[k];
+                    }
+                }
+            }
+        }
+    };
+
+    if (pool && taskCount > 1) {
+        pool->parallelFor(0, taskCount, 1, runSegments);
+    } else {
+        runSegments(0, taskCount);
+    }
+
+    result.density.resize(bins);
+
+    if (median) {
+        // 每个频点取各段的中位数，再除以偏差因子得到与平均一致的期望
+        double bias = medianBias(segmentCount);
+        QVector<double> column(segmentCount);
+        for (int k = 0; k < bins; ++k) {
+            for (int s = 0; s < segmentCount; ++s) {
+                column[s] = partial[s * bins + k];
+            }
+            int mid = segmentCount / 2;
+            std::nth_element(column.begin(), column.begin() + mid, column.end());
+            double value = column[mid];
+            if (segmentCount % 2 == 0) {
+                value = 0.5 * (value + *std::max_element(column.begin(), column.begin() + mid));
+            }
+            result.density[k] = value / bias;
+        }
+    } else {
+        // 按任务顺序累加，结果与线程调度无关
+        for (int task = 0; task < taskCount; ++task) {
+            const double* sum = partial.constData() + task * bins;
+            for (int k = 0; k < bins; ++k) {
+                result.density[k] += sum[k];
+            }
+        }
+        for (int k = 0; k < bins; ++k) {
+            result.density[k] /= segmentCount;
+        }
+    }
+
+    // 单边谱：除直流和奈奎斯特频点外，负频率的能量折叠到正频率
+    int lastDoubled = (segmentLength % 2 == 0) ? bins - 2 : bins - 1;
+    for (int k = 1; k <= lastDoubled; ++k) {
+        result.density[k] *= 2.0;
+    }
+
+    result.frequencyResolution = sampleRate / segmentLength;
+    result.noiseBandwidth = sampleRate * windowPower / (windowSum * windowSum);
+    result.segmentLength = segmentLength;
+    result.segmentCount = segmentCount;
+    return result;
+}
+
+double WelchEstimator::medianBias(int segmentCount)
+{
+    // 指数分布（2自由度卡方）样本中位数相对均值的偏差，与 scipy.signal.welch 一致
+    double bias = 1.0;
+    for (int k = 1; k <= (segmentCount - 1) / 2; ++k) {
+        bias += 1.0 / (2 * k + 1) - 1.0 / (2 * k);
+    }
+    return bias;
+}
@@ -0,0 +1,60 @@
+#ifndef WELCHESTIMATOR_H
+#define WELCHESTIMATOR_H
+
+#include <QVector>
+#include "databuffer.h"
+#include "windowfunction.h"
+
+class WorkStealingPool;
+
+// Welch功率谱密度估计参数
+struct WelchSettings {
+    enum Averaging {
+        MeanAveraging,      // 各段周期图取平均
+        MedianAveraging     // 取中位数（已做偏差校正），对突发干扰更稳健
+    };
+
+    int segmentLength;              // 每段点数（数据不足时取数据长度）
+    double overlap;                 // 段间重叠比例 [0, 1)
+    WindowFunction::Type window;
+    Averaging averaging;
+    bool removeMean;                // 每段去除直流分量
+
+    WelchSettings()
+        : segmentLength(1024), overlap(0.5), window(WindowFunction::Hann),
+          averaging(MeanAveraging), removeMean(true) {}
+};
+
+// Welch功率谱密度估计结果（单边谱）
+struct PsdResult {
+    QVector<double> density;        // 功率谱密度，单位 V²/Hz
+    double frequencyResolution;     // 频点间隔（Hz）= 采样率 / 段长
+    double noiseBandwidth;          // 窗的等效噪声带宽（Hz）
+    int segmentLength;
+    int segmentCount;               // 参与平均的段数
+
+    PsdResult() : frequencyResolution(0.0), noiseBandwidth(0.0),
+                  segmentLength(0), segmentCount(0) {}
+
+    bool isEmpty() const { return density.isEmpty(); }
+    double frequency(int bin) const { return bin * frequencyResolution; }
+};
+
+// Welch功率谱密度估计 - 分段、加窗、实数FFT后对各段周期图取平均
+// 与整段数据做一次FFT相比，方差随段数下降，每段的变换也小得多
+// 无内部状态，可在多个线程中同时调用；提供线程池时各段并行计算
+class WelchEstimator
+{
+public:
+    static PsdResult estimate(const double* samples, int count, double sampleRate,
+                              const WelchSettings& settings = WelchSettings(),
+                              WorkStealingPool* pool = nullptr);
+    static PsdResult estimate(const QVector<DataPoint>& data, double sampleRate,
+                              const WelchSettings& settings = WelchSettings(),
+                              WorkStealingPool* pool = nullptr);
+
+private:
+    static double medianBias(int segmentCount);
+};
+
+#endif // WELCHESTIMATOR_H
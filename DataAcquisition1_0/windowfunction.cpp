@@ -0,0 +1,105 @@
+#include "windowfunction.h"
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QDebug>
+#include <cmath>
+
+namespace {
+
+const int MAX_CACHED_WINDOWS = 16;
+
+QMutex s_cacheMutex;
+QHash<qint64, QVector<double>> s_windowCache;
+
+qint64 cacheKey(WindowFunction::Type type, int length)
+{
+    return (static_cast<qint64>(type) << 32) | static_cast<quint32>(length);
+}
+
+// 余弦和窗：w[n] = a0 - a1*cos(x) + a2*cos(2x) - a3*cos(3x) + ...，x = 2*pi*n/N
+QVector<double> cosineSum(const double* terms, int termCount, int length)
+{
+    QVector<double> window(length);
+    for (int n = 0; n < length; ++n) {
+        double x = 2.0 * M_PI * n / length;
+        double value = 0.0;
+        double sign = 1.0;
+        for (int k = 0; k < termCount; ++k) {
+            value += sign * terms[k] * std::cos(k * x);
+            sign = -sign;
+        }
+        window[n] = value;
+    }
+    return window;
+}
+
+} // namespace
+
+QVector<double> WindowFunction::coefficients(Type type, int length)
+{
+    if (length < 1) {
+        qWarning() << "无效的窗长度:" << length;
+        return QVector<double>();
+    }
+
+    qint64 key = cacheKey(type, length);
+
+    {
+        QMutexLocker locker(&s_cacheMutex);
+        QVector<double> cached = s_windowCache.value(key);
+        if (!cached.isEmpty()) {
+            return cached;
+        }
+    }
+
+    QVector<double> window = generate(type, length);
+
+    QMutexLocker locker(&s_cacheMutex);
+    if (s_windowCache.size() >= MAX_CACHED_WINDOWS) {
+        s_windowCache.clear();
+    }
+    s_windowCache.insert(key, window);
+    return window;
+}
+
+void WindowFunction::clearCache()
+{
+    QMutexLocker locker(&s_cacheMutex);
+    s_windowCache.clear();
+}
+
+QString WindowFunction::name(Type type)
+{
+    switch (type) {
+    case Rectangular:
+        return "矩形窗";
+    case Hann:
+        return "汉宁窗";
+    case BlackmanHarris:
+        return "Blackman-Harris窗";
+    case FlatTop:
+        return "平顶窗";
+    }
+    return "未知窗";
+}
+
+QVector<double> WindowFunction::generate(Type type, int length)
+{
+    static const double hann[] = {0.5, 0.5};
+    static const double blackmanHarris[] = {0.35875, 0.48829, 0.14128, 0.01168};
+    static const double flatTop[] = {0.21557895, 0.41663158, 0.277263158,
+                                     0.083578947, 0.006947368};
+
+    switch (type) {
+    case Hann:
+        return cosineSum(hann, 2, length);
+    case BlackmanHarris:
+        return cosineSum(blackmanHarris, 4, length);
+    case FlatTop:
+        return cosineSum(flatTop, 5, length);
+    case Rectangular:
+    default:
+        return QVector<double>(length, 1.0);
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef WINDOWFUNCTION_H
+#define WINDOWFUNCTION_H
+
+#include <QVector>
+#include <QString>
+
+// 频谱分析窗函数 - 生成周期型（DFT-even）窗系数，按类型和长度缓存
+class WindowFunction
+{
+public:
+    enum Type {
+        Rectangular,
+        Hann,
+        BlackmanHarris,     // 4项Blackman-Harris，旁瓣约 -92 dB
+        FlatTop             // 平顶窗，幅值测量误差小，适合读取正弦幅值
+    };
+
+    // 获取窗系数（线程安全，返回隐式共享的缓存数据）
+    static QVector<double> coefficients(Type type, int length);
+    static void clearCache();
+
+    static QString name(Type type);
+
+private:
+    static QVector<double> generate(Type type, int length);
+};
+
+#endif // WINDOWFUNCTION_H
@@ -0,0 +1,213 @@
+#include "workstealingpool.h"
+#include <QDebug>
+
+namespace {
+
+// 当前线程所属的线程池及其队列序号（非工作线程为 nullptr / -1）
+thread_local WorkStealingPool* t_workerPool = nullptr;
+thread_local int t_workerIndex = -1;
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(int threadCount)
+    : m_queuedCount(0)
+    , m_nextQueue(0)
+    , m_stopping(false)
+{
+    if (threadCount <= 0) {
+        threadCount = 1;
+    }
+
+    for (int i = 0; i < threadCount; ++i) {
+        m_queues.append(new WorkerQueue);
+    }
+
+    for (int i = 0; i < threadCount; ++i) {
+        QThread* thread = QThread::create([this, i]() { workerLoop(i); });
+        m_threads.append(thread);
+        thread->start();
+    }
+
+    qDebug() << "工作窃取线程池已启动，线程数:" << threadCount;
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        QMutexLocker locker(&m_sleepMutex);
+        m_stopping = true;
+        m_wakeup.wakeAll();
+    }
+
+    for (QThread* thread : m_threads) {
+        thread->wait();
+        delete thread;
+    }
+
+    qDeleteAll(m_queues);
+}
+
+WorkStealingPool* WorkStealingPool::globalInstance()
+{
+    static WorkStealingPool pool;
+    return &pool;
+}
+
+void WorkStealingPool::submit(const Task& task)
+{
+    // 工作线程内提交的任务放入自己的队列，外部提交的任务轮流分配
+    int index = currentWorkerIndex();
+    if (index < 0) {
+        index = static_cast<int>(m_nextQueue.fetch_add(1) % m_queues.size());
+    }
+
+    {
+        QMutexLocker locker(&m_queues[index]->mutex);
+        m_queues[index]->tasks.push_back(task);
+    }
+    m_queuedCount.fetch_add(1);
+
+    QMutexLocker locker(&m_sleepMutex);
+    m_wakeup.wakeOne();
+}
+
+bool WorkStealingPool::runPendingTask()
+{
+    Task task;
+    if (!takeTask(currentWorkerIndex(), task)) {
+        return false;
+    }
+
+    task();
+    return true;
+}
+
+bool WorkStealingPool::takeTask(int self, Task& task)
+{
+    if (m_queuedCount.load() == 0) {
+        return false;
+    }
+
+    // 先取自己队列尾部（最近提交，数据仍在缓存中）
+    if (self >= 0) {
+        WorkerQueue* queue = m_queues[self];
+        QMutexLocker locker(&queue->mutex);
+        if (!queue->tasks.empty()) {
+            task = std::move(queue->tasks.back());
+            queue->tasks.pop_back();
+            m_queuedCount.fetch_sub(1);
+            return true;
+        }
+    }
+
+    // 再从其他队列头部窃取（最早提交，通常是粒度最大的任务）
+    int count = m_queues.size();
+    int start = self >= 0 ? self + 1 : 0;
+    for (int i = 0; i < count; ++i) {
+        int victim = (start + i) % count;
+        if (victim == self) {
+            continue;
+        }
+
+        WorkerQueue* queue = m_queues[victim];
+        QMutexLocker locker(&queue->mutex);
+        if (!queue->tasks.empty()) {
+            task = std::move(queue->tasks.front());
+            queue->tasks.pop_front();
+            m_queuedCount.fetch_sub(1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void WorkStealingPool::workerLoop(int index)
+{
+    t_workerPool = this;
+    t_workerIndex = index;
+
+    while (true) {
+        Task task;
+        if (takeTask(index, task)) {
+            task();
+            continue;
+        }
+
+        QMutexLocker locker(&m_sleepMutex);
+        if (m_stopping) {
+            break;
+        }
+        if (m_queuedCount.load() == 0) {
+            m_wakeup.wait(&m_sleepMutex);
+        }
+    }
+
+    t_workerPool = nullptr;
+    t_workerIndex = -1;
+}
+
+int WorkStealingPool::currentWorkerIndex() const
+{
+    return t_workerPool == this ? t_workerIndex : -1;
+}
+
+// ==================== TaskGroup ====================
+
+WorkStealingPool::TaskGroup::TaskGroup(WorkStealingPool* pool)
+    : m_pool(pool)
+    , m_pending(0)
+{
+}
+
+WorkStealingPool::TaskGroup::~TaskGroup()
+{
+    wait();
+}
+
+void WorkStealingPool::TaskGroup::run(const Task& task)
+{
+    m_pending.fetch_add(1);
+    m_pool->submit([this, task]() {
+        task();
+        taskFinished();
+    });
+}
+
+void WorkStealingPool::TaskGroup::wait()
+{
+    if (m_pool->currentWorkerIndex() < 0) {
+        // 非工作线程（如GUI或分析线程）不执行池中的任务，以免占用它去跑其他任务组的长任务；
+        // 直接阻塞到本组最后一个任务完成时被唤醒
+        QMutexLocker locker(&m_mutex);
+        while (m_pending.load() > 0) {
+            m_done.wait(&m_mutex);
+        }
+        return;
+    }
+
+    while (m_pending.load() > 0) {
+        // 工作线程在嵌套等待中帮忙执行任务（包括其他任务组的任务），
+        // 否则所有工作线程都在等待时池中剩余的任务无人执行
+        if (m_pool->runPendingTask()) {
+            continue;
+        }
+
+        QMutexLocker locker(&m_mutex);
+        if (m_pending.load() > 0) {
+            // 本组剩余任务都在其他线程上执行；超时后重新检查是否出现可帮忙的任务
+            m_done.wait(&m_mutex, 1);
+        }
+    }
+
+    // 确保最后完成的任务已经释放锁，之后任务组可以安全销毁
+    QMutexLocker locker(&m_mutex);
+}
+
+void WorkStealingPool::TaskGroup::taskFinished()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_pending.fetch_sub(1) == 1) {
+        m_done.wakeAll();
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <QVector>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThread>
+#include <atomic>
+#include <deque>
+#include <functional>
+
+// 工作窃取线程池 - 每个工作线程拥有自己的任务队列
+// 线程优先从自己队列尾部取最新提交的任务，空闲时从其他线程队列头部窃取较早的任务
+// 任务内提交的子任务进入当前线程的队列；工作线程等待任务组时会帮忙执行任务，嵌套并行不会死锁，
+// 非工作线程等待时只阻塞到本组任务完成
+class WorkStealingPool
+{
+public:
+    typedef std::function<void()> Task;
+
+    explicit WorkStealingPool(int threadCount = QThread::idealThreadCount());
+    ~WorkStealingPool();
+
+    // 全局共享实例（线程数等于CPU核心数）
+    static WorkStealingPool* globalInstance();
+
+    int threadCount() const { return m_threads.size(); }
+
+    // 任务组 - 提交一批任务并等待全部完成
+    class TaskGroup
+    {
+    public:
+        explicit TaskGroup(WorkStealingPool* pool);
+        ~TaskGroup();   // 析构时等待尚未完成的任务
+
+        void run(const Task& task);
+        void wait();
+
+    private:
+        void taskFinished();
+
+        WorkStealingPool* m_pool;
+        std::atomic<int> m_pending;
+        QMutex m_mutex;
+        QWaitCondition m_done;
+    };
+
+    // 把 [begin, end) 按 grainSize 切分后并行执行 fn(chunkBegin, chunkEnd)，返回时全部完成
+    template <typename Fn>
+    void parallelFor(int begin, int end, int grainSize, Fn fn);
+
+private:
+    struct WorkerQueue {
+        QMutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void submit(const Task& task);
+    bool runPendingTask();
+    bool takeTask(int self, Task& task);
+    void workerLoop(int index);
+    int currentWorkerIndex() const;
+
+    QVector<QThread*> m_threads;
+    QVector<WorkerQueue*> m_queues;
+    std::atomic<int> m_queuedCount;      // 所有队列中等待执行的任务数
+    std::atomic<unsigned> m_nextQueue;   // 外部线程提交任务时轮流选择队列
+    std::atomic<bool> m_stopping;
+    QMutex m_sleepMutex;
+    QWaitCondition m_wakeup;
+};
+
+template <typename Fn>
+void WorkStealingPool::parallelFor(int begin, int end, int grainSize, Fn fn)
+{
+    if (end <= begin) {
+        return;
+    }
+
+    grainSize = qMax(1, grainSize);
+
+    TaskGroup group(this);
+    for (int start = begin; start < end; start += qMin(grainSize, end - start)) {
+        int stop = start + qMin(grainSize, end - start);
+        group.run([&fn, start, stop]() { fn(start, stop); });
+    }
+    group.wait();
+}
+
+#endif // WORKSTEALINGPOOL_H
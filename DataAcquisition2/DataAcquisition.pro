@@ -14,6 +14,9 @@ LIBS += -L$$PWD/libiio/Windows-MinGW-W64
 # 链接 libiio 库
 LIBS += -llibiio
 
+# 监听socket在 listen() 之前设置接收缓冲区，直接调用Winsock
+win32: LIBS += -lws2_32
+
 TARGET = DataAcquisitionSystem
 TEMPLATE = app
 
@@ -30,7 +33,11 @@ SOURCES += \
     databasemanager.cpp \
     dataprocessor.cpp \
     historyviewer.cpp \
-    dataanalyzer.cpp
+    dataanalyzer.cpp \
+    tcppublisher.cpp \
+    tcppacketparser.cpp \
+    tcpmultireceiver.cpp \
+    udpreceiver.cpp
 
 HEADERS += \
     iioreceiver.h \
@@ -42,7 +49,11 @@ HEADERS += \
     databasemanager.h \
     dataprocessor.h \
     historyviewer.h \
-    dataanalyzer.h
+    dataanalyzer.h \
+    tcppublisher.h \
+    tcppacketparser.h \
+    tcpmultireceiver.h \
+    udpreceiver.h
 
 FORMS += \
     mainwindow.ui \
@@ -13,16 +13,18 @@ DataAnalyzer::~DataAnalyzer()
 {
 }
 
+// 统计量只计入真实样本，跳过间断标记（DataPoint::isGapMarker）
 double DataAnalyzer::calculateMax(const QVector<DataPoint>& data)
 {
-    if (data.isEmpty()) {
-        return 0.0;
-    }
-
-    double maxVal = data[0].amplitude;
+    double maxVal = 0.0;
+    bool found = false;
     for (const auto& point : data) {
-        if (point.amplitude > maxVal) {
+        if (point.isGapMarker()) {
+            continue;
+        }
+        if (!found || point.amplitude > maxVal) {
             maxVal = point.amplitude;
+            found = true;
         }
     }
 
@@ -31,14 +33,15 @@ double DataAnalyzer::calculateMax(const QVector<DataPoint>& data)
 
 double DataAnalyzer::calculateMin(const QVector<DataPoint>& data)
 {
-    if (data.isEmpty()) {
-        return 0.0;
-    }
-
-    double minVal = data[0].amplitude;
+    double minVal = 0.0;
+    bool found = false;
     for (const auto& point : data) {
-        if (point.amplitude < minVal) {
+        if (point.isGapMarker()) {
+            continue;
+        }
+        if (!found || point.amplitude < minVal) {
             minVal = point.amplitude;
+            found = true;
         }
     }
 
@@ -47,47 +50,50 @@ double DataAnalyzer::calculateMin(const QVector<DataPoint>& data)
 
 double DataAnalyzer::calculateMean(const QVector<DataPoint>& data)
 {
-    if (data.isEmpty()) {
-        return 0.0;
-    }
-
     double sum = 0.0;
+    int count = 0;
     for (const auto& point : data) {
-        sum += point.amplitude;
+        if (!point.isGapMarker()) {
+            sum += point.amplitude;
+            ++count;
+        }
     }
 
-    return sum / data.size();
+    return count > 0 ? sum / count : 0.0;
 }
 
 double DataAnalyzer::calculateRMS(const QVector<DataPoint>& data)
 {
-    if (data.isEmpty()) {
-        return 0.0;
-    }
-
     double sumSquares = 0.0;
+    int count = 0;
     for (const auto& point : data) {
-        sumSquares += point.amplitude * point.amplitude;
+        if (!point.isGapMarker()) {
+            sumSquares += point.amplitude * point.amplitude;
+            ++count;
+        }
     }
 
-    return std::sqrt(sumSquares / data.size());
+    return count > 0 ? std::sqrt(sumSquares / count) : 0.0;
 }
 
 double DataAnalyzer::calculateStdDev(const QVector<DataPoint>& data)
 {
-    if (data.size() < 2) {
-        return 0.0;
-    }
-
     double mean = calculateMean(data);
     double sumSquaredDiff = 0.0;
+    int count = 0;
 
     for (const auto& point : data) {
-        double diff = point.amplitude - mean;
-        sumSquaredDiff += diff * diff;
+        if (!point.isGapMarker()) {
+            double diff = point.amplitude - mean;
+            sumSquaredDiff += diff * diff;
+            ++count;
+        }
     }
 
-    return std::sqrt(sumSquaredDiff / (data.size() - 1));
+    if (count < 2) {
+        return 0.0;
+    }
+    return std::sqrt(sumSquaredDiff / (count - 1));
 }
 
 int DataAnalyzer::nextPowerOf2(int n)
@@ -151,8 +157,10 @@ void DataAnalyzer::fft(QVector<std::complex<double>>& data)
     }
 }
 
-QVector<double> DataAnalyzer::calculateFFT(const QVector<DataPoint>& data)
+QVector<double> DataAnalyzer::calculateFFT(const QVector<DataPoint>& input)
 {
+    // 间断标记不是样本，去掉后按剩余样本计算
+    const QVector<DataPoint> data = DataBuffer::removeGapMarkers(input);
     if (data.isEmpty()) {
         return QVector<double>();
     }
@@ -214,9 +222,11 @@ QVector<double> DataAnalyzer::calculatePowerSpectrum(const QVector<DataPoint>& d
     return powerSpectrum;
 }
 
-double DataAnalyzer::calculateDominantFrequency(const QVector<DataPoint>& data,
+double DataAnalyzer::calculateDominantFrequency(const QVector<DataPoint>& input,
                                                  double sampleRate)
 {
+    // FFT长度由真实样本数决定，间断标记不计入
+    const QVector<DataPoint> data = DataBuffer::removeGapMarkers(input);
     if (data.size() < 2) {
         return 0.0;
     }
@@ -258,10 +268,13 @@ double DataAnalyzer::calculateDominantFrequency(const QVector<DataPoint>& data,
     return dominantFreq;
 }
 
-AnalysisResult DataAnalyzer::performFullAnalysis(const QVector<DataPoint>& data,
+AnalysisResult DataAnalyzer::performFullAnalysis(const QVector<DataPoint>& input,
                                                   int taskId, int channel,
                                                   double sampleRate)
 {
+    // 先去掉间断标记，后面各项分析都只处理真实样本
+    const QVector<DataPoint> data = DataBuffer::removeGapMarkers(input);
+
     AnalysisResult result;
     result.taskId = taskId;
     result.channel = channel;
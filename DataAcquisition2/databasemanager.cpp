@@ -304,6 +304,10 @@ bool DatabaseManager::saveRawData(int taskId, int channel, const QVector<DataPoi
         int endIndex = qMin(i + batchSize, totalPoints);
 
         for (int j = i; j < endIndex; ++j) {
+            // 间断标记（NaN）不是样本，MySQL 也不接受 NaN，不写入
+            if (data[j].isGapMarker()) {
+                continue;
+            }
             query.addBindValue(taskId);
             query.addBindValue(channel);
             query.addBindValue(data[j].time);
@@ -350,6 +354,10 @@ bool DatabaseManager::saveProcessedCoordinates(int taskId, int channel,
         int endIndex = qMin(i + batchSize, totalPoints);
 
         for (int j = i; j < endIndex; ++j) {
+            // 间断标记（NaN）不是样本，MySQL 也不接受 NaN，不写入
+            if (data[j].isGapMarker()) {
+                continue;
+            }
             query.addBindValue(taskId);
             query.addBindValue(channel);
             query.addBindValue(data[j].time);
@@ -550,6 +558,9 @@ bool DatabaseManager::saveMultiChannelData(int taskId,
             int endIndex = qMin(j + batchSize, totalPoints);
 
             for (int k = j; k < endIndex; ++k) {
+                if (data[k].isGapMarker()) {
+                    continue;
+                }
                 query.addBindValue(taskId);
                 query.addBindValue(channel);
                 query.addBindValue(data[k].time);
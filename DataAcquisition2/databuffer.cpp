@@ -85,6 +85,26 @@ QVector<DataPoint> DataBuffer::getAllChannelData(int channel)
     return getChannelData(channel, -1);
 }
 
+QVector<DataPoint> DataBuffer::removeGapMarkers(const QVector<DataPoint>& data)
+{
+    int first = 0;
+    while (first < data.size() && !data[first].isGapMarker()) {
+        ++first;
+    }
+    if (first == data.size()) {
+        return data;
+    }
+
+    QVector<DataPoint> samples;
+    samples.reserve(data.size() - 1);
+    for (int i = 0; i < data.size(); ++i) {
+        if (!data[i].isGapMarker()) {
+            samples.append(data[i]);
+        }
+    }
+    return samples;
+}
+
 void DataBuffer::clear()
 {
     QMutexLocker locker(&m_mutex);
@@ -5,6 +5,7 @@
 #include <QVector>
 #include <QMutex>
 #include <QMutexLocker>
+#include <QtNumeric>
 
 #define MAX_CHANNELS 13
 
@@ -15,6 +16,10 @@ struct DataPoint {
 
     DataPoint() : time(0.0), amplitude(0.0) {}
     DataPoint(double t, double a) : time(t), amplitude(a) {}
+
+    // 数据间断标记（如UDP丢包）：幅值为 NaN，统计和绘图时应跳过
+    static DataPoint gapMarker(double t) { return DataPoint(t, qQNaN()); }
+    bool isGapMarker() const { return qIsNaN(amplitude); }
 };
 
 // 数据缓冲区类 - 支持13个通道
@@ -48,6 +53,9 @@ public:
     // 获取所有通道的数据
     QVector<QVector<DataPoint>> getAllChannelsData();
 
+    // 去掉间断标记，只留下真实样本（没有标记时直接返回共享的原数据，不复制）
+    static QVector<DataPoint> removeGapMarkers(const QVector<DataPoint>& data);
+
 signals:
     void dataAdded(int channel);
     void bufferFull(int channel);
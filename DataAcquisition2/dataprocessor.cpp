@@ -19,7 +19,11 @@ QVector<DataPoint> DataProcessor::applyLowPassFilter(const QVector<DataPoint>& d
     QVector<DataPoint> filtered = data;
     double alpha = calculateAlpha(cutoffFreq, sampleRate);
     
+    // 间断标记原样保留，标记之后的第一个样本重新开始滤波，NaN 不会传到后面
     for (int i = 1; i < filtered.size(); ++i) {
+        if (data[i].isGapMarker() || data[i-1].isGapMarker()) {
+            continue;
+        }
         filtered[i].amplitude = alpha * data[i].amplitude + 
                                (1 - alpha) * filtered[i-1].amplitude;
     }
@@ -37,6 +41,10 @@ QVector<DataPoint> DataProcessor::applyHighPassFilter(const QVector<DataPoint>&
     
     filtered[0].amplitude = data[0].amplitude;
     for (int i = 1; i < filtered.size(); ++i) {
+        // 间断标记原样保留，标记之后的第一个样本与首样本一样作为初值
+        if (data[i].isGapMarker() || data[i-1].isGapMarker()) {
+            continue;
+        }
         filtered[i].amplitude = alpha * (filtered[i-1].amplitude + 
                                         data[i].amplitude - data[i-1].amplitude);
     }
@@ -48,9 +56,12 @@ QVector<DataPoint> DataProcessor::downsample(const QVector<DataPoint>& data, int
 {
     if (data.isEmpty() || factor <= 1) return data;
     
+    // 间断标记全部保留，抽取后仍能看出数据在哪里断开
     QVector<DataPoint> downsampled;
-    for (int i = 0; i < data.size(); i += factor) {
-        downsampled.append(data[i]);
+    for (int i = 0; i < data.size(); ++i) {
+        if (i % factor == 0 || data[i].isGapMarker()) {
+            downsampled.append(data[i]);
+        }
     }
     
     return downsampled;
@@ -65,14 +76,20 @@ QVector<DataPoint> DataProcessor::movingAverageSmooth(const QVector<DataPoint>&
     int halfWindow = windowSize / 2;
     
     for (int i = 0; i < data.size(); ++i) {
+        if (data[i].isGapMarker()) {
+            continue;
+        }
         int start = qMax(0, i - halfWindow);
         int end = qMin(data.size() - 1, i + halfWindow);
         
+        // 窗口内的间断标记不计入平均
         double sum = 0.0;
         int count = 0;
         for (int j = start; j <= end; ++j) {
-            sum += data[j].amplitude;
-            count++;
+            if (!data[j].isGapMarker()) {
+                sum += data[j].amplitude;
+                count++;
+            }
         }
         
         smoothed[i].amplitude = sum / count;
@@ -85,12 +102,16 @@ QVector<DataPoint> DataProcessor::normalizeData(const QVector<DataPoint>& data)
 {
     if (data.isEmpty()) return data;
     
-    double minAmp = data[0].amplitude;
-    double maxAmp = data[0].amplitude;
+    double minAmp = 0.0;
+    double maxAmp = 0.0;
+    bool found = false;
     
+    // 范围只由真实样本决定；间断标记归一化后仍是 NaN
     for (const auto& point : data) {
-        minAmp = qMin(minAmp, point.amplitude);
-        maxAmp = qMax(maxAmp, point.amplitude);
+        if (point.isGapMarker()) continue;
+        minAmp = found ? qMin(minAmp, point.amplitude) : point.amplitude;
+        maxAmp = found ? qMax(maxAmp, point.amplitude) : point.amplitude;
+        found = true;
     }
     
     double range = maxAmp - minAmp;
@@ -5,6 +5,12 @@
 用法：
     python test_5khz.py          # 单通道
     python test_5khz.py --dual   # 双通道
+    python test_5khz.py --frame --channels 0,1,2,3 --encoding int16
+                                 # 多通道帧（FRAM）：所有通道打包在一个包中
+    python test_5khz.py --frame --encoding int24 --compress
+                                 # 差分压缩帧（接收端声明支持 delta 时生效）
+    python test_5khz.py --udp --frame
+                                 # 通过UDP发送（每个数据报带序号），可加 --loss 模拟丢包
 """
 
 import socket
@@ -12,27 +18,105 @@ import struct
 import numpy as np
 import time
 import argparse
-from threading import Thread, Event
+import random
+from threading import Thread, Event, Lock
 
 class DataSender:
     MAGIC = 0x44415441  # "DATA"
+    FRAME_MAGIC = 0x4652414D  # "FRAM"
+    FRAME_VERSION = 1
+    FRAME_HEADER = "<IHHIIBBHddd"
+    # 编码名 -> (编码号, numpy 类型)
+    ENCODINGS = {"float64": (0, "<f8"), "float32": (1, "<f4"),
+                 "int16": (2, "<i2"), "int24": (3, None)}
+    LAYOUTS = {"interleaved": 0, "planar": 1}
+    FLAG_DELTA_PACKED = 0x0001
+    DELTA_BLOCK_SIZE = 128
+    UDP_MAGIC = 0x55445053  # "UDPS"
 
-    def __init__(self, host, port):
+    def __init__(self, host, port, udp=False, loss=0.0):
         self.host = host
         self.port = port
         self.sock = None
         self.stop_evt = Event()
+        self.caps = set()
+        self.udp = udp
+        self.loss = loss        # UDP 模式下模拟的丢包率
+        self.seq = 0
+        self.seq_lock = Lock()
 
     def connect(self):
         try:
+            if self.udp:
+                # UDP 没有握手和能力声明，帧格式和压缩由命令行参数决定
+                self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+                self.sock.connect((self.host, self.port))
+                self.caps = {"FRAM/1", "delta"}
+                print(f"[+] UDP 发送到 {self.host}:{self.port}")
+                return True
             self.sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
             self.sock.connect((self.host, self.port))
             print(f"[+] 已连接 {self.host}:{self.port}")
+            self.read_caps()
             return True
         except Exception as e:
             print(f"[!] 连接失败: {e}")
             return False
 
+    def read_caps(self, timeout=0.5):
+        """读取接收端连接后发送的能力声明，例如 "CAPS FRAM/1 float64,... delta"
+        旧版接收端不发送，超时后 caps 为空"""
+        line = b""
+        self.sock.settimeout(timeout)
+        try:
+            while not line.endswith(b"\n") and len(line) < 256:
+                chunk = self.sock.recv(1)
+                if not chunk:
+                    break
+                line += chunk
+        except socket.timeout:
+            pass
+        finally:
+            self.sock.settimeout(None)
+        words = line.decode(errors="ignore").split()
+        if words and words[0] == "CAPS":
+            for w in words[1:]:
+                self.caps.update(w.split(","))
+            print(f"[+] 接收端能力: {' '.join(words[1:])}")
+        else:
+            print("[*] 接收端未声明能力（旧版本），只能发送 DATA 包")
+
+    @classmethod
+    def pack_delta(cls, values):
+        """差分 + zigzag + 位打包：int32 首样本，之后每 DELTA_BLOCK_SIZE 个差分一组，
+        每组 1 字节位宽 w + 低位在前的 w 位数据"""
+        v = np.asarray(values, dtype=np.int64)
+        if len(v) == 0:
+            return b""
+        out = [struct.pack("<i", int(v[0]))]
+        d = np.diff(v).astype(np.int32).astype(np.int64)
+        zz = ((d << 1) ^ (d >> 63)) & 0xFFFFFFFF
+        for i in range(0, len(zz), cls.DELTA_BLOCK_SIZE):
+            block = zz[i:i + cls.DELTA_BLOCK_SIZE]
+            w = int(block.max()).bit_length()
+            out.append(bytes([w]))
+            if w:
+                bits = (block[:, None] >> np.arange(w)) & 1
+                out.append(np.packbits(bits.astype(np.uint8).ravel(), bitorder="little").tobytes())
+        return b"".join(out)
+
+    def send_bytes(self, packet):
+        """TCP 直接发送；UDP 每个包单独一个数据报，前面加 UDPS 魔数和序号"""
+        if not self.udp:
+            self.sock.sendall(packet)
+            return
+        with self.seq_lock:
+            seq = self.seq
+            self.seq = (self.seq + 1) & 0xFFFFFFFF
+        if self.loss > 0 and random.random() < self.loss:
+            return
+        self.sock.send(struct.pack("<II", self.UDP_MAGIC, seq) + packet)
+
     def disconnect(self):
         if self.sock:
             self.sock.close()
@@ -45,12 +129,77 @@ class DataSender:
             n = len(data)
             hdr = struct.pack("<IIIdd", self.MAGIC, ch, n, fs, t0)
             body = struct.pack(f"<{n}d", *data)
-            self.sock.sendall(hdr + body)
+            self.send_bytes(hdr + body)
             return True
         except Exception as e:
             print(f"[!] 发送失败: {e}")
             return False
 
+    def send_frame(self, channels, fs, signals, t0, encoding="float64", layout="interleaved",
+                   compress=False):
+        """signals: 每个通道一行，行顺序与 channels 从小到大一致"""
+        if not self.sock:
+            return False
+        try:
+            code, dtype = self.ENCODINGS[encoding]
+            mask = 0
+            for ch in channels:
+                mask |= 1 << ch
+            data = np.asarray(signals, dtype=np.float64)
+            n = data.shape[1]
+
+            # 整数编码按本包峰值缩放到满量程，接收端幅值 = 原始值 × scale
+            scale = 1.0
+            peak = max(float(np.max(np.abs(data))) if data.size else 0.0, 1e-12)
+            if encoding == "int16":
+                scale = peak / 32767.0
+            elif encoding == "int24":
+                scale = peak / 8388607.0
+            if code >= 2:
+                data = np.round(data / scale).astype(np.int32)
+
+            flags = 0
+            if compress and code >= 2:
+                # 压缩负载按通道分段，包头后附加 quint32 负载长度
+                body = b"".join(self.pack_delta(row) for row in data)
+                flags = self.FLAG_DELTA_PACKED
+                layout = "planar"
+            else:
+                if self.LAYOUTS[layout] == 0:
+                    data = data.T          # [t0c0 t0c1 ... t1c0 ...]
+                flat = np.ascontiguousarray(data).ravel()
+                if encoding == "int24":
+                    body = flat.astype("<i4").view(np.uint8).reshape(-1, 4)[:, :3].tobytes()
+                else:
+                    body = flat.astype(dtype).tobytes()
+
+            header_size = struct.calcsize(self.FRAME_HEADER) + (4 if flags else 0)
+            hdr = struct.pack(self.FRAME_HEADER, self.FRAME_MAGIC, self.FRAME_VERSION,
+                              header_size, mask, n,
+                              code, self.LAYOUTS[layout], flags, fs, t0, scale)
+            if flags:
+                hdr += struct.pack("<I", len(body))
+            self.send_bytes(hdr + body)
+            return True
+        except Exception as e:
+            print(f"[!] 发送失败: {e}")
+            return False
+
+    @staticmethod
+    def make_signal(t, f_sig, amp, wave):
+        if wave == "sine":
+            return amp * np.sin(2 * np.pi * f_sig * t)
+        elif wave == "square":
+            return amp * np.sign(np.sin(2 * np.pi * f_sig * t))
+        elif wave == "triangle":
+            return amp * (2 / np.pi) * np.arcsin(np.sin(2 * np.pi * f_sig * t))
+        elif wave == "noise":
+            return amp * np.random.randn(len(t))
+        elif wave == "composite":
+            return amp * (np.sin(2 * np.pi * f_sig * t) +
+                          0.5 * np.sin(2 * np.pi * f_sig * 2 * t + np.pi / 4) +
+                          0.3 * np.sin(2 * np.pi * f_sig * 3 * t + np.pi / 3))
+
     def stream(self, ch, fs, f_sig, amp=1.0, wave="sine"):
         pkt_dur = 0.1          # 每包 0.1 s
         pkt_size = int(fs * pkt_dur)
@@ -60,24 +209,39 @@ class DataSender:
                 if self.stop_evt.is_set():
                     break
                 t = np.linspace(i * pkt_dur, (i + 1) * pkt_dur, pkt_size, endpoint=False)
-                if wave == "sine":
-                    sig = amp * np.sin(2 * np.pi * f_sig * t)
-                elif wave == "square":
-                    sig = amp * np.sign(np.sin(2 * np.pi * f_sig * t))
-                elif wave == "triangle":
-                    sig = amp * (2 / np.pi) * np.arcsin(np.sin(2 * np.pi * f_sig * t))
-                elif wave == "noise":
-                    sig = amp * np.random.randn(len(t))
-                elif wave == "composite":
-                    sig = amp * (np.sin(2 * np.pi * f_sig * t) +
-                                 0.5 * np.sin(2 * np.pi * f_sig * 2 * t + np.pi / 4) +
-                                 0.3 * np.sin(2 * np.pi * f_sig * 3 * t + np.pi / 3))
+                sig = self.make_signal(t, f_sig, amp, wave)
                 self.send_packet(ch, fs, sig, i * pkt_dur)
                 time.sleep(pkt_dur)          # 精确 10 包/秒
         except KeyboardInterrupt:
             pass
         print(f"[-] 通道 {ch} 停止发送")
 
+    def stream_frames(self, channels, fs, f_sig, amp=1.0, wave="sine",
+                      encoding="float64", layout="interleaved", compress=False):
+        if compress and "delta" not in self.caps:
+            print("[*] 接收端不支持差分压缩，改为发送未压缩帧")
+            compress = False
+        if compress and encoding not in ("int16", "int24"):
+            print("[*] 差分压缩只用于整数编码，改用 int24")
+            encoding = "int24"
+        pkt_dur = 0.1
+        pkt_size = int(fs * pkt_dur)
+        channels = sorted(channels)
+        print(f"[+] 通道 {channels} 以帧方式发送：编码 {encoding}，布局 {layout}，采样率 {fs} Hz")
+        try:
+            for i in range(100000):
+                if self.stop_evt.is_set():
+                    break
+                t = np.linspace(i * pkt_dur, (i + 1) * pkt_dur, pkt_size, endpoint=False)
+                # 各通道频率依次递增，便于在界面上区分
+                signals = [self.make_signal(t, f_sig * (1 + 0.5 * k), amp, wave)
+                           for k in range(len(channels))]
+                self.send_frame(channels, fs, signals, i * pkt_dur, encoding, layout, compress)
+                time.sleep(pkt_dur)
+        except KeyboardInterrupt:
+            pass
+        print(f"[-] 帧发送停止")
+
 def main():
     ap = argparse.ArgumentParser()
     ap.add_argument("--host", default="localhost")
@@ -88,14 +252,28 @@ def main():
     ap.add_argument("--dual", action="store_true", help="双通道")
     ap.add_argument("--waveform", choices=["sine", "square", "triangle", "noise", "composite"],
                     default="sine", help="波形类型")
+    ap.add_argument("--frame", action="store_true", help="多通道帧模式（FRAM包）")
+    ap.add_argument("--channels", default="1,2", help="帧模式下的通道号，逗号分隔")
+    ap.add_argument("--encoding", choices=list(DataSender.ENCODINGS), default="float64",
+                    help="帧模式样本编码")
+    ap.add_argument("--layout", choices=list(DataSender.LAYOUTS), default="interleaved",
+                    help="帧模式样本布局")
+    ap.add_argument("--compress", action="store_true",
+                    help="帧模式使用差分压缩（需接收端支持）")
+    ap.add_argument("--udp", action="store_true", help="通过UDP发送（带序号）")
+    ap.add_argument("--loss", type=float, default=0.0, help="UDP模式下模拟的丢包率，如 0.01")
     args = ap.parse_args()
 
-    sender = DataSender(args.host, args.port)
+    sender = DataSender(args.host, args.port, args.udp, args.loss)
     if not sender.connect():
         return
 
     try:
-        if args.dual:
+        if args.frame:
+            channels = [int(c) for c in args.channels.split(",") if c.strip()]
+            sender.stream_frames(channels, args.fs, args.freq, args.amp, args.waveform,
+                                 args.encoding, args.layout, args.compress)
+        elif args.dual:
             t1 = Thread(target=sender.stream, args=(1, args.fs, args.freq, args.amp, args.waveform))
             t2 = Thread(target=sender.stream, args=(2, args.fs, args.freq * 1.5, args.amp * 0.8, args.waveform))
             t1.start(); t2.start()
@@ -0,0 +1,369 @@
+#include "tcpmultireceiver.h"
+#include <QDebug>
+#include <QHostAddress>
+#include <QElapsedTimer>
+#include <QMetaObject>
+
+namespace {
+const int SOCKET_RECEIVE_BUFFER_SIZE = 8 * 1024 * 1024;
+const int MAX_IO_THREADS = 8;
+
+// 监听 Any 时 IPv4 发送端的地址形如 "::ffff:192.168.1.5"，统一成 "192.168.1.5"
+QString normalizeAddress(const QHostAddress& address)
+{
+    bool isIpv4 = false;
+    quint32 ipv4 = address.toIPv4Address(&isIpv4);
+    return isIpv4 ? QHostAddress(ipv4).toString() : address.toString();
+}
+}
+
+// ==================== TcpSenderConnection ====================
+
+TcpSenderConnection::TcpSenderConnection(int id, qintptr socketDescriptor, DataBuffer* buffer,
+                                         double sampleRate,
+                                         const SenderChannelMaps& channelMaps)
+    : QObject(nullptr)
+    , m_id(id)
+    , m_socketDescriptor(socketDescriptor)
+    , m_socket(nullptr)
+    , m_dataBuffer(buffer)
+    , m_channelMaps(channelMaps)
+{
+    m_parser.setSampleRate(sampleRate);
+}
+
+TcpSenderConnection::~TcpSenderConnection()
+{
+    delete m_socket;
+}
+
+TcpReceiverStats TcpSenderConnection::getStats() const
+{
+    QMutexLocker locker(&m_statsMutex);
+    return m_stats;
+}
+
+void TcpSenderConnection::start()
+{
+    // socket 在本连接所属的I/O线程中创建
+    m_socket = new QTcpSocket(this);
+    if (!m_socket->setSocketDescriptor(m_socketDescriptor)) {
+        emit errorOccurred(QString("接受连接失败: %1").arg(m_socket->errorString()));
+        emit disconnected(m_id);
+        return;
+    }
+
+    // 内核接收缓冲区已从监听socket继承（见 listenWithReceiveBuffer）
+
+    // 先找按 (地址, 端口) 单独设置的映射，再找整个地址的映射
+    QString address = normalizeAddress(m_socket->peerAddress());
+    SenderKey key(address, m_socket->peerPort());
+    if (!m_channelMaps.contains(key)) {
+        key.second = 0;
+    }
+    m_parser.setChannelMap(m_channelMaps.value(key));
+
+    connect(m_socket, &QTcpSocket::readyRead,
+            this, &TcpSenderConnection::onReadyRead);
+    connect(m_socket, &QTcpSocket::disconnected,
+            this, &TcpSenderConnection::onDisconnected);
+
+    // 声明支持的包格式和编码，发送端据此协商是否压缩
+    m_socket->write(PacketProtocol::capabilityLine());
+    emit connected(m_id, QString("%1:%2").arg(address).arg(m_socket->peerPort()));
+
+    if (m_socket->bytesAvailable() > 0) {
+        onReadyRead();
+    }
+}
+
+void TcpSenderConnection::close()
+{
+    if (m_socket) {
+        m_socket->disconnect(this);
+        m_socket->abort();
+        delete m_socket;
+        m_socket = nullptr;
+    }
+}
+
+void TcpSenderConnection::onReadyRead()
+{
+    if (!m_socket) return;
+
+    qint64 available = m_socket->bytesAvailable();
+    if (available <= 0) return;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    qint64 bytesRead = m_parser.readFrom(m_socket);
+
+    QVector<DataPoint> points;
+    for (int channel = 0; channel < MAX_CHANNELS; ++channel) {
+        if (!m_parser.takeBlock(channel, &points)) {
+            continue;
+        }
+        if (m_dataBuffer) {
+            m_dataBuffer->addDataPoints(channel, points);
+        }
+        emit dataReceived(channel, points.size());
+        emit pointsReceived(channel, points);
+    }
+
+    double elapsedMs = timer.nsecsElapsed() / 1e6;
+
+    QMutexLocker locker(&m_statsMutex);
+    m_stats.bytesReceived += bytesRead;
+    m_stats.packetsReceived = m_parser.getPacketCount();
+    m_stats.pointsReceived = m_parser.getPointCount();
+    m_stats.resyncCount = m_parser.getResyncCount();
+    m_stats.readBufferBytes = available;
+    m_stats.maxReadBufferBytes = qMax(m_stats.maxReadBufferBytes, available);
+    m_stats.pendingBytes = m_parser.getPendingBytes();
+    m_stats.lastParseMs = elapsedMs;
+    m_stats.maxParseMs = qMax(m_stats.maxParseMs, elapsedMs);
+    m_stats.totalParseMs += elapsedMs;
+    ++m_stats.readCount;
+}
+
+void TcpSenderConnection::onDisconnected()
+{
+    m_parser.reset();
+    emit disconnected(m_id);
+}
+
+// ==================== TcpMultiReceiver ====================
+
+// 监听socket留在主线程，新连接的描述符直接交给I/O线程，不在主线程创建 QTcpSocket
+class TcpMultiReceiver::Server : public QTcpServer
+{
+public:
+    explicit Server(TcpMultiReceiver* owner)
+        : QTcpServer(owner), m_owner(owner) {}
+
+protected:
+    void incomingConnection(qintptr socketDescriptor) override
+    {
+        m_owner->handleIncomingConnection(socketDescriptor);
+    }
+
+private:
+    TcpMultiReceiver* m_owner;
+};
+
+TcpMultiReceiver::TcpMultiReceiver(DataBuffer* buffer, QObject *parent)
+    : QObject(parent)
+    , m_server(nullptr)
+    , m_dataBuffer(buffer)
+    , m_ioThreadCount(qBound(1, QThread::idealThreadCount(), MAX_IO_THREADS))
+    , m_nextConnectionId(1)
+    , m_sampleRate(1000.0)
+{
+    qRegisterMetaType<QVector<DataPoint>>("QVector<DataPoint>");
+}
+
+TcpMultiReceiver::~TcpMultiReceiver()
+{
+    stopServer();
+}
+
+void TcpMultiReceiver::setIoThreadCount(int count)
+{
+    if (m_server) {
+        qWarning() << "服务器运行中，I/O线程数在下次启动时生效";
+    }
+    m_ioThreadCount = qMax(1, count);
+}
+
+void TcpMultiReceiver::setChannelMap(const QString& senderAddress, const QHash<int, int>& map,
+                                     quint16 senderPort)
+{
+    m_channelMaps.insert(SenderKey(normalizeAddress(QHostAddress(senderAddress)), senderPort), map);
+}
+
+bool TcpMultiReceiver::startServer(quint16 port)
+{
+    if (m_server) {
+        stopServer();
+    }
+
+    // 接收缓冲区在 listen() 之前设置到监听socket上，accept 得到的连接直接继承
+    m_server = new Server(this);
+    QString listenError;
+    if (!listenWithReceiveBuffer(m_server, port, SOCKET_RECEIVE_BUFFER_SIZE, &listenError)) {
+        QString error = QString("无法启动服务器: %1").arg(listenError);
+        emit errorOccurred(error);
+        delete m_server;
+        m_server = nullptr;
+        return false;
+    }
+
+    startIoThreads();
+
+    emit statusChanged(QString("多发送端服务器监听端口 %1（%2个I/O线程）")
+                       .arg(port).arg(m_ioThreads.size()));
+    qDebug() << "多发送端TCP服务器启动，端口:" << port << "I/O线程:" << m_ioThreads.size();
+    return true;
+}
+
+void TcpMultiReceiver::stopServer()
+{
+    if (!m_server) return;
+
+    m_server->close();
+    delete m_server;
+    m_server = nullptr;
+
+    // 先在各自线程中关闭socket
+    QList<TcpSenderConnection*> objects;
+    for (const Connection& connection : m_connections) {
+        QMetaObject::invokeMethod(connection.object, "close", Qt::BlockingQueuedConnection);
+        objects.append(connection.object);
+    }
+    m_connections.clear();
+
+    // 结束并等待所有I/O线程后再删除连接对象：此时不会再有对象在线程中运行，
+    // 已断开但 deleteLater 尚未执行的连接也一并删除，不会随线程退出而泄漏
+    quitIoThreads();
+    for (const QPointer<TcpSenderConnection>& closing : m_closingConnections) {
+        if (closing) {
+            objects.append(closing.data());
+        }
+    }
+    m_closingConnections.clear();
+    qDeleteAll(objects);
+    deleteIoThreads();
+
+    emit statusChanged("多发送端服务器已停止");
+}
+
+bool TcpMultiReceiver::isRunning() const
+{
+    return m_server && m_server->isListening();
+}
+
+void TcpMultiReceiver::startIoThreads()
+{
+    for (int i = 0; i < m_ioThreadCount; ++i) {
+        QThread* thread = new QThread(this);
+        thread->start();
+        m_ioThreads.append(thread);
+        m_threadLoad.append(0);
+    }
+}
+
+void TcpMultiReceiver::quitIoThreads()
+{
+    for (QThread* thread : m_ioThreads) {
+        thread->quit();
+    }
+    for (QThread* thread : m_ioThreads) {
+        thread->wait();
+    }
+}
+
+void TcpMultiReceiver::deleteIoThreads()
+{
+    qDeleteAll(m_ioThreads);
+    m_ioThreads.clear();
+    m_threadLoad.clear();
+}
+
+void TcpMultiReceiver::handleIncomingConnection(qintptr socketDescriptor)
+{
+    // 分配到连接数最少的I/O线程
+    int threadIndex = 0;
+    for (int i = 1; i < m_threadLoad.size(); ++i) {
+        if (m_threadLoad[i] < m_threadLoad[threadIndex]) {
+            threadIndex = i;
+        }
+    }
+
+    int id = m_nextConnectionId++;
+    TcpSenderConnection* object = new TcpSenderConnection(
+        id, socketDescriptor, m_dataBuffer, m_sampleRate, m_channelMaps);
+    object->moveToThread(m_ioThreads[threadIndex]);
+
+    connect(object, &TcpSenderConnection::connected,
+            this, &TcpMultiReceiver::onConnectionConnected);
+    connect(object, &TcpSenderConnection::disconnected,
+            this, &TcpMultiReceiver::onConnectionDisconnected);
+    connect(object, &TcpSenderConnection::errorOccurred,
+            this, &TcpMultiReceiver::errorOccurred);
+    connect(object, &TcpSenderConnection::dataReceived,
+            this, &TcpMultiReceiver::dataReceived);
+    connect(object, &TcpSenderConnection::pointsReceived,
+            this, &TcpMultiReceiver::pointsReceived);
+
+    Connection connection;
+    connection.object = object;
+    connection.threadIndex = threadIndex;
+    m_connections.insert(id, connection);
+    ++m_threadLoad[threadIndex];
+
+    QMetaObject::invokeMethod(object, "start", Qt::QueuedConnection);
+}
+
+void TcpMultiReceiver::onConnectionConnected(int id, const QString& peerInfo)
+{
+    QHash<int, Connection>::iterator it = m_connections.find(id);
+    if (it == m_connections.end()) return;
+
+    it.value().peerInfo = peerInfo;
+    qDebug() << "发送端已连接:" << peerInfo << "I/O线程:" << it.value().threadIndex;
+    emit connected(peerInfo);
+    emit statusChanged(QString("发送端已连接: %1（共%2个）")
+                       .arg(peerInfo).arg(m_connections.size()));
+}
+
+void TcpMultiReceiver::onConnectionDisconnected(int id)
+{
+    QHash<int, Connection>::iterator it = m_connections.find(id);
+    if (it == m_connections.end()) return;
+
+    Connection connection = it.value();
+    m_connections.erase(it);
+    --m_threadLoad[connection.threadIndex];
+
+    // 在连接所属线程中删除（socket 是它的子对象）；服务器先于删除停止时由 stopServer 删除
+    connection.object->deleteLater();
+    m_closingConnections.removeAll(QPointer<TcpSenderConnection>());
+    m_closingConnections.append(connection.object);
+
+    qDebug() << "发送端已断开:" << connection.peerInfo;
+    emit disconnected(connection.peerInfo);
+    emit statusChanged(QString("发送端已断开: %1（剩余%2个）")
+                       .arg(connection.peerInfo).arg(m_connections.size()));
+}
+
+QStringList TcpMultiReceiver::getConnectionInfo() const
+{
+    QStringList result;
+    for (const Connection& connection : m_connections) {
+        if (!connection.peerInfo.isEmpty()) {
+            result.append(connection.peerInfo);
+        }
+    }
+    return result;
+}
+
+TcpReceiverStats TcpMultiReceiver::getStats() const
+{
+    TcpReceiverStats total;
+    for (const Connection& connection : m_connections) {
+        TcpReceiverStats stats = connection.object->getStats();
+        total.bytesReceived += stats.bytesReceived;
+        total.packetsReceived += stats.packetsReceived;
+        total.pointsReceived += stats.pointsReceived;
+        total.resyncCount += stats.resyncCount;
+        total.readBufferBytes += stats.readBufferBytes;
+        total.maxReadBufferBytes = qMax(total.maxReadBufferBytes, stats.maxReadBufferBytes);
+        total.pendingBytes += stats.pendingBytes;
+        total.lastParseMs = qMax(total.lastParseMs, stats.lastParseMs);
+        total.maxParseMs = qMax(total.maxParseMs, stats.maxParseMs);
+        total.totalParseMs += stats.totalParseMs;
+        total.readCount += stats.readCount;
+    }
+    return total;
+}
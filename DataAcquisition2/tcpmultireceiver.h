@@ -0,0 +1,140 @@
+#ifndef TCPMULTIRECEIVER_H
+#define TCPMULTIRECEIVER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <QMutex>
+#include <QHash>
+#include <QVector>
+#include <QStringList>
+#include <QPair>
+#include <QPointer>
+#include "databuffer.h"
+#include "tcppacketparser.h"
+#include "tcpreceiver.h"
+
+// 通道映射的键：(发送端IP地址, 发送端端口)，端口为0表示该地址的所有连接
+typedef QPair<QString, quint16> SenderKey;
+typedef QHash<SenderKey, QHash<int, int>> SenderChannelMaps;
+
+// 单个发送端连接 - 运行在 TcpMultiReceiver 的某个I/O线程中，独占一个解析器
+class TcpSenderConnection : public QObject
+{
+    Q_OBJECT
+
+public:
+    TcpSenderConnection(int id, qintptr socketDescriptor, DataBuffer* buffer,
+                        double sampleRate, const SenderChannelMaps& channelMaps);
+    ~TcpSenderConnection();
+
+    int getId() const { return m_id; }
+    TcpReceiverStats getStats() const;
+
+public slots:
+    void start();
+    void close();
+
+signals:
+    void connected(int id, const QString& peerInfo);
+    void disconnected(int id);
+    void errorOccurred(const QString& error);
+    void dataReceived(int channel, int pointCount);
+    void pointsReceived(int channel, const QVector<DataPoint>& points);
+
+private slots:
+    void onReadyRead();
+    void onDisconnected();
+
+private:
+    int m_id;
+    qintptr m_socketDescriptor;
+    QTcpSocket* m_socket;
+    DataBuffer* m_dataBuffer;
+    TcpPacketParser m_parser;
+    SenderChannelMaps m_channelMaps;
+
+    TcpReceiverStats m_stats;
+    mutable QMutex m_statsMutex;
+};
+
+// 多发送端TCP接收服务器 - 同时接受多个发送端连接
+// 每个连接分配到I/O线程池中连接数最少的线程，读取和解析在该线程完成，
+// 不同发送端之间互不阻塞；解析出的数据按 (发送端地址, 端口, 通道号) 映射到本地通道
+class TcpMultiReceiver : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TcpMultiReceiver(DataBuffer* buffer, QObject *parent = nullptr);
+    ~TcpMultiReceiver();
+
+    bool startServer(quint16 port);
+    void stopServer();
+    bool isRunning() const;
+
+    // I/O线程数，需在 startServer 之前设置；默认为CPU核数（最多8个）
+    void setIoThreadCount(int count);
+    int getIoThreadCount() const { return m_ioThreadCount; }
+
+    // 设置采样率（包头采样率无效时用于计算时间），对之后建立的连接生效
+    void setSampleRate(double rate) { m_sampleRate = rate; }
+    double getSampleRate() const { return m_sampleRate; }
+
+    // 通道映射：来自 senderAddress:senderPort 的通道号 -> 本地通道号
+    // 同一地址后有多个发送端（如经NAT或同机多进程）时按端口区分；senderPort 为0时
+    // 作用于该地址上没有单独设置映射的所有连接
+    // 未设置映射的发送端或通道直接使用包中的通道号，对之后建立的连接生效
+    void setChannelMap(const QString& senderAddress, const QHash<int, int>& map,
+                       quint16 senderPort = 0);
+    void clearChannelMaps() { m_channelMaps.clear(); }
+
+    int getConnectionCount() const { return m_connections.size(); }
+    QStringList getConnectionInfo() const;
+
+    // 所有连接的统计之和（最大值类字段取最大）
+    TcpReceiverStats getStats() const;
+
+signals:
+    void connected(const QString& peerInfo);
+    void disconnected(const QString& peerInfo);
+    void errorOccurred(const QString& error);
+    void dataReceived(int channel, int pointCount);
+    void pointsReceived(int channel, const QVector<DataPoint>& points);
+    void statusChanged(const QString& status);
+
+private slots:
+    void onConnectionConnected(int id, const QString& peerInfo);
+    void onConnectionDisconnected(int id);
+
+private:
+    class Server;
+    friend class Server;
+
+    struct Connection {
+        TcpSenderConnection* object;
+        int threadIndex;
+        QString peerInfo;
+    };
+
+    void handleIncomingConnection(qintptr socketDescriptor);
+    void startIoThreads();
+    void quitIoThreads();
+    void deleteIoThreads();
+
+    Server* m_server;
+    DataBuffer* m_dataBuffer;
+    QVector<QThread*> m_ioThreads;
+    QVector<int> m_threadLoad;          // 每个I/O线程上的连接数
+    QHash<int, Connection> m_connections;
+    // 已断开、等待在所属I/O线程中 deleteLater 的连接；停止服务器时线程结束后
+    // 仍未删除的由 stopServer 删除（QPointer 在对象删除时自动置空）
+    QList<QPointer<TcpSenderConnection>> m_closingConnections;
+    SenderChannelMaps m_channelMaps;
+    int m_ioThreadCount;
+    int m_nextConnectionId;
+    double m_sampleRate;
+};
+
+#endif // TCPMULTIRECEIVER_H
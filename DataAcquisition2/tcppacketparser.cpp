@@ -0,0 +1,579 @@
+#include "tcppacketparser.h"
+#include <QDebug>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TCPPACKETPARSER_USE_SSE2
+#endif
+
+using namespace PacketProtocol;
+
+namespace {
+// 单包样本数上限，超过视为包头损坏（避免等待一个永远不会到齐的"包"）
+const quint32 MAX_POINTS_PER_PACKET = 4 * 1024 * 1024;
+const quint16 MAX_FRAME_HEADER_SIZE = 1024;
+// zigzag 后的差分最多32位（Int24 实际不超过25位）
+const int MAX_DELTA_WIDTH = 32;
+const int INITIAL_BUFFER_CAPACITY = 1024 * 1024;
+// 读偏移超过该值时才压缩缓冲区
+const int COMPACT_THRESHOLD = 256 * 1024;
+
+// 各编码的样本解码，p 不保证对齐
+struct Float64Sample {
+    static double decode(const char* p) { double v; std::memcpy(&v, p, 8); return v; }
+};
+struct Float32Sample {
+    static double decode(const char* p) { float v; std::memcpy(&v, p, 4); return v; }
+};
+struct Int16Sample {
+    static double decode(const char* p) { qint16 v; std::memcpy(&v, p, 2); return v; }
+};
+struct Int24Sample {
+    static double decode(const char* p)
+    {
+        const uchar* b = reinterpret_cast<const uchar*>(p);
+        quint32 u = b[0] | (b[1] << 8) | (static_cast<quint32>(b[2]) << 16);
+        // 左移到最高字节再算术右移，完成符号扩展
+        return static_cast<qint32>(u << 8) >> 8;
+    }
+};
+
+// 解码一个通道：相邻样本间隔 stride 字节
+template<typename Sample>
+void decodeChannel(const char* src, int stride, int count, double scale,
+                   double startTime, double interval, DataPoint* out)
+{
+    for (int i = 0; i < count; ++i) {
+        out[i].time = startTime + i * interval;
+        out[i].amplitude = Sample::decode(src + i * stride) * scale;
+    }
+}
+
+// 一个通道压缩段的字节数；数据越界或位宽非法时返回 -1
+// 解码前先整体校验，解码循环本身不再做边界检查
+int deltaPackedChannelSize(const uchar* p, const uchar* end, int count)
+{
+    if (count == 0) return 0;
+    const uchar* start = p;
+    if (end - p < 4) return -1;
+    p += 4;
+
+    for (int remaining = count - 1; remaining > 0; remaining -= DELTA_BLOCK_SIZE) {
+        if (p >= end) return -1;
+        int width = *p++;
+        if (width > MAX_DELTA_WIDTH) return -1;
+        int bytes = (qMin(remaining, DELTA_BLOCK_SIZE) * width + 7) / 8;
+        if (end - p < bytes) return -1;
+        p += bytes;
+    }
+    return static_cast<int>(p - start);
+}
+
+#ifdef TCPPACKETPARSER_USE_SSE2
+// 4个32位样本值写成4个 DataPoint，时间和幅值的计算与标量路径逐位一致
+inline void storePoints4(__m128i values, int i, __m128d scale, __m128d startTime,
+                         __m128d interval, DataPoint* out)
+{
+    const __m128i index = _mm_add_epi32(_mm_set1_epi32(i), _mm_setr_epi32(0, 1, 2, 3));
+    const __m128d t01 = _mm_add_pd(startTime, _mm_mul_pd(_mm_cvtepi32_pd(index), interval));
+    const __m128d t23 = _mm_add_pd(startTime, _mm_mul_pd(
+        _mm_cvtepi32_pd(_mm_shuffle_epi32(index, _MM_SHUFFLE(3, 2, 3, 2))), interval));
+    const __m128d a01 = _mm_mul_pd(_mm_cvtepi32_pd(values), scale);
+    const __m128d a23 = _mm_mul_pd(
+        _mm_cvtepi32_pd(_mm_shuffle_epi32(values, _MM_SHUFFLE(3, 2, 3, 2))), scale);
+
+    double* d = &out[i].time;
+    _mm_storeu_pd(d, _mm_unpacklo_pd(t01, a01));
+    _mm_storeu_pd(d + 2, _mm_unpackhi_pd(t01, a01));
+    _mm_storeu_pd(d + 4, _mm_unpacklo_pd(t23, a23));
+    _mm_storeu_pd(d + 6, _mm_unpackhi_pd(t23, a23));
+}
+
+// 4个 zigzag 差分还原为样本值：反 zigzag 后做组内前缀和，再加上前一个样本值
+// running 的4个分量都是前一个样本值，返回后更新为本组最后一个样本值
+inline __m128i accumulateDeltas4(__m128i zigzag, __m128i* running)
+{
+    const __m128i one = _mm_set1_epi32(1);
+    __m128i delta = _mm_xor_si128(_mm_srli_epi32(zigzag, 1),
+                                  _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(zigzag, one)));
+    delta = _mm_add_epi32(delta, _mm_slli_si128(delta, 4));
+    delta = _mm_add_epi32(delta, _mm_slli_si128(delta, 8));
+    const __m128i values = _mm_add_epi32(delta, *running);
+    *running = _mm_shuffle_epi32(values, _MM_SHUFFLE(3, 3, 3, 3));
+    return values;
+}
+
+// 位宽为 0、8、16 的组：样本按字节对齐，每次处理16或8个样本；
+// 返回后 *i、*p、*value 指向未处理的部分，剩余不足一批的样本交给标量路径
+void decodeDeltaBlockSse2(int width, int end, const uchar** p, qint32* value, int* i,
+                          double scale, double startTime, double interval, DataPoint* out)
+{
+    const __m128d scaleVec = _mm_set1_pd(scale);
+    const __m128d startVec = _mm_set1_pd(startTime);
+    const __m128d intervalVec = _mm_set1_pd(interval);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i running = _mm_set1_epi32(*value);
+    int k = *i;
+    const uchar* src = *p;
+
+    if (width == 0) {
+        for (; k + 4 <= end; k += 4) {
+            storePoints4(running, k, scaleVec, startVec, intervalVec, out);
+        }
+    } else if (width == 8) {
+        for (; k + 16 <= end; k += 16, src += 16) {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            const __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+            const __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+            storePoints4(accumulateDeltas4(_mm_unpacklo_epi16(lo, zero), &running),
+                         k, scaleVec, startVec, intervalVec, out);
+            storePoints4(accumulateDeltas4(_mm_unpackhi_epi16(lo, zero), &running),
+                         k + 4, scaleVec, startVec, intervalVec, out);
+            storePoints4(accumulateDeltas4(_mm_unpacklo_epi16(hi, zero), &running),
+                         k + 8, scaleVec, startVec, intervalVec, out);
+            storePoints4(accumulateDeltas4(_mm_unpackhi_epi16(hi, zero), &running),
+                         k + 12, scaleVec, startVec, intervalVec, out);
+        }
+    } else if (width == 16) {
+        // 位流低位在前，16位组即小端16位整数
+        for (; k + 8 <= end; k += 8, src += 16) {
+            const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            storePoints4(accumulateDeltas4(_mm_unpacklo_epi16(words, zero), &running),
+                         k, scaleVec, startVec, intervalVec, out);
+            storePoints4(accumulateDeltas4(_mm_unpackhi_epi16(words, zero), &running),
+                         k + 4, scaleVec, startVec, intervalVec, out);
+        }
+    }
+
+    *value = _mm_cvtsi128_si32(running);
+    *i = k;
+    *p = src;
+}
+#endif
+
+// 解码一个通道的差分压缩段（已由 deltaPackedChannelSize 校验）
+// 用64位累加器一次取一个字节，每个样本只做移位、掩码和加法；位宽为0的组直接填常数
+// 支持 SSE2 时，常见的 0、8、16 位组整批向量化解码，其余位宽和组末尾的零头走标量路径
+void decodeDeltaPacked(const uchar* p, int count, double scale,
+                       double startTime, double interval, DataPoint* out)
+{
+    if (count == 0) return;
+
+    qint32 value;
+    std::memcpy(&value, p, 4);
+    p += 4;
+    out[0].time = startTime;
+    out[0].amplitude = value * scale;
+
+    int i = 1;
+    while (i < count) {
+        const int width = *p++;
+        const int end = i + qMin(count - i, DELTA_BLOCK_SIZE);
+
+#ifdef TCPPACKETPARSER_USE_SSE2
+        if (width == 0 || width == 8 || width == 16) {
+            decodeDeltaBlockSse2(width, end, &p, &value, &i, scale, startTime, interval, out);
+        }
+#endif
+
+        if (width == 0) {
+            const double amplitude = value * scale;
+            for (; i < end; ++i) {
+                out[i].time = startTime + i * interval;
+                out[i].amplitude = amplitude;
+            }
+            continue;
+        }
+
+        const quint64 mask = (quint64(1) << width) - 1;
+        quint64 bitBuffer = 0;
+        int bitCount = 0;
+        for (; i < end; ++i) {
+            while (bitCount < width) {
+                bitBuffer |= quint64(*p++) << bitCount;
+                bitCount += 8;
+            }
+            quint32 zigzag = static_cast<quint32>(bitBuffer & mask);
+            bitBuffer >>= width;
+            bitCount -= width;
+
+            // 无符号加法按2^32回绕，与发送端的差分计算一致
+            value = static_cast<qint32>(static_cast<quint32>(value) + ((zigzag >> 1) ^ (0u - (zigzag & 1))));
+            out[i].time = startTime + i * interval;
+            out[i].amplitude = value * scale;
+        }
+        // 组末尾不足一字节的位是填充，下一组从新字节开始
+    }
+}
+
+// 从 p 开始查找下一个可能的魔数（"DATA" 或 "FRAM"），末尾不足4字节的候选也返回
+const char* findMagic(const char* p, const char* end)
+{
+    const char dataFirst = static_cast<char>(DATA_MAGIC & 0xFF);
+    const char frameFirst = static_cast<char>(FRAME_MAGIC & 0xFF);
+    const char* nextData = static_cast<const char*>(std::memchr(p, dataFirst, end - p));
+    const char* nextFrame = static_cast<const char*>(std::memchr(p, frameFirst, end - p));
+
+    while (nextData || nextFrame) {
+        const char* candidate = !nextData ? nextFrame
+                              : !nextFrame ? nextData
+                              : qMin(nextData, nextFrame);
+        if (end - candidate < 4) {
+            return candidate;
+        }
+        quint32 magic;
+        std::memcpy(&magic, candidate, 4);
+        if (magic == DATA_MAGIC || magic == FRAME_MAGIC) {
+            return candidate;
+        }
+        // 只重新查找刚检查过的那一种首字节
+        if (candidate == nextData) {
+            nextData = static_cast<const char*>(std::memchr(candidate + 1, dataFirst, end - candidate - 1));
+        }
+        if (candidate == nextFrame) {
+            nextFrame = static_cast<const char*>(std::memchr(candidate + 1, frameFirst, end - candidate - 1));
+        }
+    }
+    return nullptr;
+}
+}
+
+int PacketProtocol::bytesPerSample(int encoding)
+{
+    switch (encoding) {
+    case EncodingFloat64: return 8;
+    case EncodingFloat32: return 4;
+    case EncodingInt16: return 2;
+    case EncodingInt24: return 3;
+    default: return 0;
+    }
+}
+
+TcpPacketParser::TcpPacketParser()
+    : m_readOffset(0)
+    , m_sampleRate(1000.0)
+    , m_packetCount(0)
+    , m_pointCount(0)
+    , m_resyncCount(0)
+{
+    // 预留容量后 resize(0) 不释放内存，缓冲区在整个连接期间只分配一次
+    m_buffer.reserve(INITIAL_BUFFER_CAPACITY);
+    for (int i = 0; i < MAX_CHANNELS; ++i) {
+        m_nextTime[i] = 0.0;
+        m_hasNextTime[i] = false;
+    }
+}
+
+qint64 TcpPacketParser::readFrom(QIODevice* device)
+{
+    // 直接读入缓冲区尾部，不经过临时 QByteArray
+    qint64 available = device->bytesAvailable();
+    if (available <= 0) return 0;
+
+    int oldSize = m_buffer.size();
+    m_buffer.resize(oldSize + static_cast<int>(available));
+    qint64 bytesRead = device->read(m_buffer.data() + oldSize, available);
+    bytesRead = qMax<qint64>(bytesRead, 0);
+    m_buffer.resize(oldSize + static_cast<int>(bytesRead));
+
+    process();
+    return bytesRead;
+}
+
+void TcpPacketParser::append(const char* data, int size)
+{
+    m_buffer.append(data, size);
+    process();
+}
+
+void TcpPacketParser::reset()
+{
+    m_buffer.resize(0);
+    m_readOffset = 0;
+    for (int i = 0; i < MAX_CHANNELS; ++i) {
+        m_blocks[i].clear();
+        m_hasNextTime[i] = false;
+    }
+}
+
+int TcpPacketParser::discardPending()
+{
+    int discarded = m_buffer.size() - m_readOffset;
+    m_buffer.resize(0);
+    m_readOffset = 0;
+    return discarded;
+}
+
+int TcpPacketParser::markGap()
+{
+    int count = 0;
+    for (int i = 0; i < MAX_CHANNELS; ++i) {
+        if (m_hasNextTime[i]) {
+            m_blocks[i].append(DataPoint::gapMarker(m_nextTime[i]));
+            ++count;
+        }
+    }
+    return count;
+}
+
+bool TcpPacketParser::takeBlock(int channel, QVector<DataPoint>* points)
+{
+    if (channel < 0 || channel >= MAX_CHANNELS || m_blocks[channel].isEmpty()) {
+        return false;
+    }
+    points->clear();
+    points->swap(m_blocks[channel]);
+    return true;
+}
+
+void TcpPacketParser::process()
+{
+    const char* data = m_buffer.constData();
+    const int size = m_buffer.size();
+    int offset = m_readOffset;
+
+    while (size - offset >= 4) {
+        quint32 magic;
+        std::memcpy(&magic, data + offset, 4);
+
+        int consumed = -1;
+        if (magic == DATA_MAGIC) {
+            consumed = parseDataPacket(data + offset, size - offset);
+        } else if (magic == FRAME_MAGIC) {
+            consumed = parseFramePacket(data + offset, size - offset);
+        }
+
+        if (consumed == 0) {
+            break; // 等待更多数据
+        }
+        if (consumed > 0) {
+            offset += consumed;
+            continue;
+        }
+
+        qWarning() << "无效的数据包头，重新同步";
+        ++m_resyncCount;
+        const char* found = findMagic(data + offset + 1, data + size);
+        offset = found ? static_cast<int>(found - data) : size;
+    }
+
+    // 数据全部处理完时直接复位；否则只在读偏移较大时压缩一次
+    if (offset >= size) {
+        m_buffer.resize(0);
+        m_readOffset = 0;
+    } else if (offset >= COMPACT_THRESHOLD) {
+        std::memmove(m_buffer.data(), data + offset, size - offset);
+        m_buffer.resize(size - offset);
+        m_readOffset = 0;
+    } else {
+        m_readOffset = offset;
+    }
+}
+
+DataPoint* TcpPacketParser::appendPoints(int sourceChannel, int count, double nextTime)
+{
+    int channel = m_channelMap.value(sourceChannel, sourceChannel);
+    if (channel < 0 || channel >= MAX_CHANNELS) {
+        qWarning() << "无效的通道号:" << sourceChannel;
+        return nullptr;
+    }
+
+    // 直接在该通道数据块尾部开出空间，解码结果写入其中
+    QVector<DataPoint>& block = m_blocks[channel];
+    int base = block.size();
+    block.resize(base + count);
+    m_pointCount += count;
+    m_nextTime[channel] = nextTime;
+    m_hasNextTime[channel] = true;
+    return block.data() + base;
+}
+
+QByteArray PacketProtocol::capabilityLine()
+{
+    return QByteArray("CAPS FRAM/1 float64,float32,int16,int24 delta\n");
+}
+
+int TcpPacketParser::parseDataPacket(const char* data, int size)
+{
+    const int headerSize = sizeof(DataPacketHeader);
+    if (size < headerSize) {
+        return 0;
+    }
+
+    // memcpy 避免非对齐访问
+    DataPacketHeader header;
+    std::memcpy(&header, data, headerSize);
+    if (header.pointCount > MAX_POINTS_PER_PACKET) {
+        return -1;
+    }
+
+    int packetSize = headerSize + static_cast<int>(header.pointCount * sizeof(double));
+    if (size < packetSize) {
+        return 0;
+    }
+
+    ++m_packetCount;
+    int pointCount = static_cast<int>(header.pointCount);
+    double sampleRate = header.sampleRate > 0.0 ? header.sampleRate : m_sampleRate;
+
+    DataPoint* out = appendPoints(static_cast<int>(header.channel), pointCount,
+                                  header.startTime + pointCount / sampleRate);
+    if (out) {
+        decodeChannel<Float64Sample>(data + headerSize, sizeof(double), pointCount, 1.0,
+                                     header.startTime, 1.0 / sampleRate, out);
+    }
+    return packetSize;
+}
+
+int TcpPacketParser::parseFramePacket(const char* data, int size)
+{
+    const int headerSize = sizeof(FramePacketHeader);
+    if (size < headerSize) {
+        return 0;
+    }
+
+    FramePacketHeader header;
+    std::memcpy(&header, data, headerSize);
+
+    const int sampleBytes = bytesPerSample(header.encoding);
+    const bool deltaPacked = header.flags & FrameFlagDeltaPacked;
+    int channelCount = 0;
+    for (quint32 mask = header.channelMask; mask; mask &= mask - 1) {
+        ++channelCount;
+    }
+
+    if (header.headerSize < headerSize || header.headerSize > MAX_FRAME_HEADER_SIZE
+        || channelCount == 0
+        || static_cast<quint64>(header.pointCount) * channelCount > MAX_POINTS_PER_PACKET) {
+        return -1;
+    }
+
+    // 未知编码时无法确定包长，只能重新同步
+    if (sampleBytes == 0) {
+        qWarning() << "不支持的样本编码:" << header.encoding;
+        return -1;
+    }
+
+    int payloadSize = static_cast<int>(header.pointCount) * channelCount * sampleBytes;
+    if (deltaPacked) {
+        // 压缩负载的长度在扩展字段中
+        const int extendedSize = headerSize + sizeof(FrameCompressionHeader);
+        if (header.headerSize < extendedSize) {
+            return -1;
+        }
+        if (size < extendedSize) {
+            return 0;
+        }
+        FrameCompressionHeader compression;
+        std::memcpy(&compression, data + headerSize, sizeof(compression));
+        if (compression.payloadSize > MAX_POINTS_PER_PACKET * sizeof(double)) {
+            return -1;
+        }
+        payloadSize = static_cast<int>(compression.payloadSize);
+    }
+
+    int packetSize = header.headerSize + payloadSize;
+    if (size < packetSize) {
+        return 0;
+    }
+
+    // 包长可以确定时，不支持的版本或标志整包跳过，不影响后续数据
+    if (header.version != FRAME_VERSION || (header.flags & ~SUPPORTED_FRAME_FLAGS)
+        || header.layout > LayoutPlanar
+        || (deltaPacked && header.encoding != EncodingInt16 && header.encoding != EncodingInt24)) {
+        qWarning() << "不支持的帧格式 - 版本:" << header.version
+                   << "标志:" << header.flags << "布局:" << header.layout
+                   << "编码:" << header.encoding;
+        return packetSize;
+    }
+
+    if (deltaPacked) {
+        decodeDeltaPackedFrame(header, data + header.headerSize, payloadSize);
+        return packetSize;
+    }
+
+    ++m_packetCount;
+    const int pointCount = static_cast<int>(header.pointCount);
+    const double sampleRate = header.sampleRate > 0.0 ? header.sampleRate : m_sampleRate;
+    const double interval = 1.0 / sampleRate;
+    const double scale = header.encoding == EncodingFloat64 || header.encoding == EncodingFloat32
+                       ? 1.0 : header.scale;
+    const bool interleaved = header.layout == LayoutInterleaved;
+    const int stride = interleaved ? channelCount * sampleBytes : sampleBytes;
+    const char* payload = data + header.headerSize;
+
+    int index = 0;
+    for (int channel = 0; channel < 32; ++channel) {
+        if (!(header.channelMask & (1u << channel))) {
+            continue;
+        }
+
+        const char* src = interleaved ? payload + index * sampleBytes
+                                      : payload + index * pointCount * sampleBytes;
+        ++index;
+
+        DataPoint* out = appendPoints(channel, pointCount, header.startTime + pointCount * interval);
+        if (!out) {
+            continue;
+        }
+
+        switch (header.encoding) {
+        case EncodingFloat64:
+            decodeChannel<Float64Sample>(src, stride, pointCount, scale, header.startTime, interval, out);
+            break;
+        case EncodingFloat32:
+            decodeChannel<Float32Sample>(src, stride, pointCount, scale, header.startTime, interval, out);
+            break;
+        case EncodingInt16:
+            decodeChannel<Int16Sample>(src, stride, pointCount, scale, header.startTime, interval, out);
+            break;
+        case EncodingInt24:
+            decodeChannel<Int24Sample>(src, stride, pointCount, scale, header.startTime, interval, out);
+            break;
+        }
+    }
+    return packetSize;
+}
+
+void TcpPacketParser::decodeDeltaPackedFrame(const FramePacketHeader& header,
+                                             const char* payload, int payloadSize)
+{
+    const int pointCount = static_cast<int>(header.pointCount);
+    const uchar* begin = reinterpret_cast<const uchar*>(payload);
+    const uchar* end = begin + payloadSize;
+
+    // 先校验所有通道段，损坏的帧整体丢弃，不留下半帧数据
+    int offsets[32];
+    int offset = 0;
+    for (int channel = 0; channel < 32; ++channel) {
+        if (!(header.channelMask & (1u << channel))) {
+            continue;
+        }
+        int channelSize = deltaPackedChannelSize(begin + offset, end, pointCount);
+        if (channelSize < 0) {
+            qWarning() << "压缩帧数据损坏，丢弃";
+            return;
+        }
+        offsets[channel] = offset;
+        offset += channelSize;
+    }
+    if (offset != payloadSize) {
+        qWarning() << "压缩帧长度不一致，丢弃 - 声明:" << payloadSize << "实际:" << offset;
+        return;
+    }
+
+    ++m_packetCount;
+    const double sampleRate = header.sampleRate > 0.0 ? header.sampleRate : m_sampleRate;
+
+    for (int channel = 0; channel < 32; ++channel) {
+        if (!(header.channelMask & (1u << channel))) {
+            continue;
+        }
+        DataPoint* out = appendPoints(channel, pointCount, header.startTime + pointCount / sampleRate);
+        if (out) {
+            decodeDeltaPacked(begin + offsets[channel], pointCount, header.scale,
+                              header.startTime, 1.0 / sampleRate, out);
+        }
+    }
+}
@@ -0,0 +1,134 @@
+#ifndef TCPPACKETPARSER_H
+#define TCPPACKETPARSER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QIODevice>
+#include <QVector>
+#include "databuffer.h"
+
+// 数据包头结构
+#pragma pack(push, 1)
+struct DataPacketHeader {
+    quint32 magic;        // 魔数，用于验证数据包：0x44415441 ("DATA")
+    quint32 channel;      // 通道号：0 ~ MAX_CHANNELS-1
+    quint32 pointCount;   // 本包中的数据点数量
+    double sampleRate;    // 采样率
+    double startTime;     // 起始时间
+};
+
+// 多通道帧包头：一个时间片内所有通道的数据放在一个包中
+// 包头之后为 channelCount(channelMask 中置位的个数) × pointCount 个样本，
+// 通道按通道号从小到大排列；interleaved 布局为 [t0c0 t0c1 ... t1c0 ...]，
+// planar 布局为 [c0t0 c0t1 ... c1t0 ...]
+struct FramePacketHeader {
+    quint32 magic;        // 魔数：0x4652414D ("FRAM")
+    quint16 version;      // 协议版本，当前为1
+    quint16 headerSize;   // 包头字节数，样本从该偏移开始（便于以后扩展包头）
+    quint32 channelMask;  // 第i位表示本包包含通道i
+    quint32 pointCount;   // 每个通道的样本数
+    quint8 encoding;      // 样本编码，见 SampleEncoding
+    quint8 layout;        // 样本布局，见 SampleLayout
+    quint16 flags;        // 见 FrameFlags，未知的位必须为0
+    double sampleRate;    // 采样率
+    double startTime;     // 第一个样本的时间
+    double scale;         // 整数编码的幅值 = 原始值 × scale
+};
+
+// 设置 FrameFlagDeltaPacked 时紧跟在 FramePacketHeader 之后的扩展字段
+// 压缩后的负载长度无法由样本数推出，需要显式给出
+struct FrameCompressionHeader {
+    quint32 payloadSize;  // 负载字节数（headerSize 之后）
+};
+#pragma pack(pop)
+
+namespace PacketProtocol {
+const quint32 DATA_MAGIC = 0x44415441;   // "DATA"，单通道包
+const quint32 FRAME_MAGIC = 0x4652414D;  // "FRAM"，多通道帧
+const quint16 FRAME_VERSION = 1;
+
+enum SampleEncoding {
+    EncodingFloat64 = 0,
+    EncodingFloat32 = 1,
+    EncodingInt16 = 2,
+    EncodingInt24 = 3    // 3字节小端有符号整数
+};
+
+enum SampleLayout {
+    LayoutInterleaved = 0,
+    LayoutPlanar = 1
+};
+
+// 帧标志位
+enum FrameFlags {
+    // 负载为差分 + zigzag + 位打包压缩，仅用于 Int16/Int24 编码，按通道分段（planar）：
+    //   每个通道: qint32 首个样本, 之后 pointCount-1 个差分按 DELTA_BLOCK_SIZE 个一组，
+    //   每组: quint8 位宽 w, 之后 ceil(组内个数 × w / 8) 字节，低位在前
+    FrameFlagDeltaPacked = 0x0001
+};
+const quint16 SUPPORTED_FRAME_FLAGS = FrameFlagDeltaPacked;
+const int DELTA_BLOCK_SIZE = 128;
+
+int bytesPerSample(int encoding);
+
+// 接收端在连接建立后发送的能力声明（一行文本），发送端据此选择编码
+// 不读取该行的旧发送端不受影响，继续发送 DATA 包即可
+QByteArray capabilityLine();
+}
+
+// TCP数据流解析器 - 负责分帧和解码，不涉及socket和线程
+// 同一数据流中可以混合单通道包（DataPacketHeader）和多通道帧（FramePacketHeader）
+// 每个连接独占一个实例；解析结果按通道累积，由调用方一次取走
+class TcpPacketParser
+{
+public:
+    TcpPacketParser();
+
+    void setSampleRate(double rate) { m_sampleRate = rate; }
+    // 通道映射：发送端通道号 -> 本地通道号，未映射的通道号原样使用
+    void setChannelMap(const QHash<int, int>& map) { m_channelMap = map; }
+
+    // 把 device 中全部可读数据读入缓冲区尾部并解析，返回读取的字节数
+    qint64 readFrom(QIODevice* device);
+    // 追加一段数据并解析
+    void append(const char* data, int size);
+    void reset();
+    // 丢弃尚未凑成完整包的数据（数据报传输中一个数据报不完整时使用），返回丢弃的字节数
+    int discardPending();
+    // 在每个已收到过数据的通道末尾插入间断标记，时间为该通道下一个样本的预期时间
+    // 返回插入的标记数
+    int markGap();
+
+    // 取出某通道自上次取出以来解析出的数据，没有数据时返回 false
+    bool takeBlock(int channel, QVector<DataPoint>* points);
+
+    quint64 getPacketCount() const { return m_packetCount; }
+    quint64 getPointCount() const { return m_pointCount; }
+    quint64 getResyncCount() const { return m_resyncCount; }
+    int getPendingBytes() const { return m_buffer.size() - m_readOffset; }
+
+private:
+    void process();
+    // 返回消耗的字节数；0 表示数据不完整，-1 表示包头无效需要重新同步
+    int parseDataPacket(const char* data, int size);
+    int parseFramePacket(const char* data, int size);
+    void decodeDeltaPackedFrame(const FramePacketHeader& header, const char* payload, int payloadSize);
+    DataPoint* appendPoints(int sourceChannel, int count, double nextTime);
+
+    // 接收缓冲区：[m_readOffset, size) 为尚未解析的数据
+    // 数据包在缓冲区内原地解析，只在读偏移较大时才把剩余数据移到开头
+    QByteArray m_buffer;
+    int m_readOffset;
+
+    QVector<DataPoint> m_blocks[MAX_CHANNELS];
+    QHash<int, int> m_channelMap;
+    double m_nextTime[MAX_CHANNELS];     // 各通道下一个样本的预期时间
+    bool m_hasNextTime[MAX_CHANNELS];
+    double m_sampleRate;
+
+    quint64 m_packetCount;
+    quint64 m_pointCount;
+    quint64 m_resyncCount;
+};
+
+#endif // TCPPACKETPARSER_H
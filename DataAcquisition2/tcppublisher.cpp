@@ -0,0 +1,270 @@
+#include "tcppublisher.h"
+#include <QDebug>
+#include <QHostAddress>
+#include <cstring>
+
+namespace {
+// 已交给socket但尚未发出的字节数超过该值时，新数据留在客户端自己的队列里
+const qint64 SOCKET_WRITE_WATERMARK = 256 * 1024;
+const qint64 DEFAULT_MAX_QUEUE_BYTES = 8 * 1024 * 1024;
+const int MAX_DECIMATION = 10000;
+const int MAX_COMMAND_LENGTH = 256;
+const quint32 ALL_CHANNELS = (1u << MAX_CHANNELS) - 1;
+}
+
+TcpPublisher::TcpPublisher(QObject *parent)
+    : QObject(parent)
+    , m_server(nullptr)
+    , m_sampleRate(1000.0)
+    , m_maxQueueBytes(DEFAULT_MAX_QUEUE_BYTES)
+{
+    for (int i = 0; i < MAX_CHANNELS; ++i) {
+        m_publishedCount[i] = 0;
+    }
+}
+
+TcpPublisher::~TcpPublisher()
+{
+    stopServer();
+}
+
+bool TcpPublisher::startServer(quint16 port)
+{
+    if (m_server) {
+        stopServer();
+    }
+
+    m_server = new QTcpServer(this);
+    connect(m_server, &QTcpServer::newConnection,
+            this, &TcpPublisher::onNewConnection);
+
+    if (!m_server->listen(QHostAddress::Any, port)) {
+        QString error = QString("无法启动转发服务: %1").arg(m_server->errorString());
+        emit errorOccurred(error);
+        delete m_server;
+        m_server = nullptr;
+        return false;
+    }
+
+    emit statusChanged(QString("转发服务监听端口 %1").arg(port));
+    qDebug() << "TCP转发服务启动，监听端口:" << port;
+    return true;
+}
+
+void TcpPublisher::stopServer()
+{
+    QList<QTcpSocket*> sockets = m_clients.keys();
+    for (QTcpSocket* socket : sockets) {
+        socket->disconnect(this);
+        socket->abort();
+        removeClient(socket);
+    }
+
+    if (m_server) {
+        m_server->close();
+        m_server->deleteLater();
+        m_server = nullptr;
+        emit statusChanged("转发服务已停止");
+    }
+}
+
+bool TcpPublisher::isRunning() const
+{
+    return m_server && m_server->isListening();
+}
+
+QVector<TcpPublisher::ClientInfo> TcpPublisher::getClientInfo() const
+{
+    QVector<ClientInfo> result;
+    result.reserve(m_clients.size());
+    for (const Client* client : m_clients) {
+        ClientInfo info;
+        info.address = client->address;
+        info.decimation = client->decimation;
+        info.sentPackets = client->sentPackets;
+        info.droppedPackets = client->droppedPackets;
+        info.queuedBytes = client->queuedBytes + client->socket->bytesToWrite();
+        result.append(info);
+    }
+    return result;
+}
+
+void TcpPublisher::onNewConnection()
+{
+    if (!m_server) return;
+
+    while (m_server->hasPendingConnections()) {
+        QTcpSocket* socket = m_server->nextPendingConnection();
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+
+        Client* client = new Client;
+        client->socket = socket;
+        client->address = QString("%1:%2").arg(socket->peerAddress().toString())
+                                           .arg(socket->peerPort());
+        client->decimation = 1;
+        client->channelMask = ALL_CHANNELS;
+        client->queuedBytes = 0;
+        client->sentPackets = 0;
+        client->droppedPackets = 0;
+        m_clients.insert(socket, client);
+
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+            Client* c = m_clients.value(socket);
+            if (c) readCommands(c);
+        });
+        connect(socket, &QTcpSocket::bytesWritten, this, [this, socket]() {
+            Client* c = m_clients.value(socket);
+            if (c) flush(c);
+        });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            removeClient(socket);
+        });
+
+        qDebug() << "转发订阅端已连接:" << client->address;
+        emit clientConnected(client->address);
+    }
+}
+
+void TcpPublisher::removeClient(QTcpSocket* socket)
+{
+    Client* client = m_clients.take(socket);
+    if (!client) return;
+
+    qDebug() << "转发订阅端已断开:" << client->address
+             << "已发送:" << client->sentPackets
+             << "已丢弃:" << client->droppedPackets;
+    emit clientDisconnected(client->address);
+
+    socket->deleteLater();
+    delete client;
+}
+
+void TcpPublisher::readCommands(Client* client)
+{
+    QTcpSocket* socket = client->socket;
+
+    while (socket->canReadLine()) {
+        QByteArray line = socket->readLine(MAX_COMMAND_LENGTH).trimmed();
+        if (line.isEmpty()) continue;
+
+        int space = line.indexOf(' ');
+        QByteArray command = (space < 0 ? line : line.left(space)).toUpper();
+        QByteArray argument = space < 0 ? QByteArray() : line.mid(space + 1).trimmed();
+
+        if (command == "DECIMATE") {
+            bool ok = false;
+            int factor = argument.toInt(&ok);
+            if (ok && factor >= 1 && factor <= MAX_DECIMATION) {
+                client->decimation = factor;
+                qDebug() << "订阅端" << client->address << "抽取倍数:" << factor;
+            } else {
+                qWarning() << "无效的抽取倍数:" << argument;
+            }
+        } else if (command == "CHANNELS") {
+            quint32 mask = 0;
+            QList<QByteArray> items = argument.split(',');
+            for (const QByteArray& item : items) {
+                bool ok = false;
+                int channel = item.trimmed().toInt(&ok);
+                if (ok && channel >= 0 && channel < MAX_CHANNELS) {
+                    mask |= 1u << channel;
+                }
+            }
+            client->channelMask = mask ? mask : ALL_CHANNELS;
+        } else {
+            qWarning() << "未知的订阅命令:" << line;
+        }
+    }
+
+    // 没有换行的超长输入直接丢弃，避免无限增长
+    if (socket->bytesAvailable() > MAX_COMMAND_LENGTH) {
+        socket->readAll();
+    }
+}
+
+QByteArray TcpPublisher::encodePacket(int channel, const QVector<DataPoint>& points,
+                                      int first, int step, double sampleRate)
+{
+    const int count = first < points.size() ? (points.size() - first + step - 1) / step : 0;
+
+    DataPacketHeader header;
+    header.magic = PacketProtocol::DATA_MAGIC;
+    header.channel = channel;
+    header.pointCount = count;
+    header.sampleRate = sampleRate / step;
+    header.startTime = count > 0 ? points[first].time : 0.0;
+
+    QByteArray packet(static_cast<int>(sizeof(DataPacketHeader) + count * sizeof(double)),
+                      Qt::Uninitialized);
+    char* out = packet.data();
+    std::memcpy(out, &header, sizeof(header));
+
+    double* amplitudes = reinterpret_cast<double*>(out + sizeof(DataPacketHeader));
+    const DataPoint* source = points.constData() + first;
+    for (int i = 0; i < count; ++i) {
+        amplitudes[i] = source[i * step].amplitude;
+    }
+    return packet;
+}
+
+void TcpPublisher::publish(int channel, const QVector<DataPoint>& points)
+{
+    if (channel < 0 || channel >= MAX_CHANNELS || points.isEmpty()) {
+        return;
+    }
+
+    // 抽取相位按通道累计点数对齐，同一倍数的客户端收到完全相同的数据包
+    const quint64 published = m_publishedCount[channel];
+    m_publishedCount[channel] += points.size();
+
+    if (m_clients.isEmpty()) {
+        return;
+    }
+
+    QHash<int, QByteArray> encoded;
+    for (Client* client : m_clients) {
+        if (!(client->channelMask & (1u << channel))) {
+            continue;
+        }
+
+        const int step = client->decimation;
+        QHash<int, QByteArray>::const_iterator it = encoded.constFind(step);
+        if (it == encoded.constEnd()) {
+            int first = static_cast<int>((step - published % step) % step);
+            if (first >= points.size()) {
+                continue;
+            }
+            it = encoded.insert(step, encodePacket(channel, points, first, step, m_sampleRate));
+        }
+        enqueue(client, it.value());
+    }
+}
+
+void TcpPublisher::enqueue(Client* client, const QByteArray& packet)
+{
+    client->pending.enqueue(packet);
+    client->queuedBytes += packet.size();
+
+    // 丢弃最旧的整包；已交给socket的数据不动，保证包边界完整
+    while (client->queuedBytes > m_maxQueueBytes && client->pending.size() > 1) {
+        client->queuedBytes -= client->pending.dequeue().size();
+        ++client->droppedPackets;
+    }
+
+    flush(client);
+}
+
+void TcpPublisher::flush(Client* client)
+{
+    QTcpSocket* socket = client->socket;
+    if (socket->state() != QAbstractSocket::ConnectedState) {
+        return;
+    }
+
+    while (!client->pending.isEmpty() && socket->bytesToWrite() < SOCKET_WRITE_WATERMARK) {
+        QByteArray packet = client->pending.dequeue();
+        client->queuedBytes -= packet.size();
+        socket->write(packet);
+        ++client->sentPackets;
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef TCPPUBLISHER_H
+#define TCPPUBLISHER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QByteArray>
+#include <QHash>
+#include <QQueue>
+#include <QVector>
+#include "databuffer.h"
+#include "tcppacketparser.h"
+
+// TCP实时数据转发 - 把采集到的数据按 DataPacketHeader 格式转发给多个订阅端
+// 每个数据块对每种抽取倍数只编码一次，所有客户端共享同一个 QByteArray（隐式共享，不复制）
+//
+// 订阅端连接后可以发送文本命令（每行一条，可选）：
+//   "DECIMATE <n>"       每n个点发送1个（默认1，不做抗混叠滤波）
+//   "CHANNELS 1,2,5"     只接收指定通道（默认全部）
+//
+// 慢速客户端不会阻塞采集：每个客户端的待发送队列超过上限时丢弃最旧的整包数据
+//
+// 典型用法：
+//   connect(tcpReceiver, &TcpReceiver::pointsReceived, publisher, &TcpPublisher::publish);
+class TcpPublisher : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct ClientInfo {
+        QString address;
+        int decimation;
+        quint64 sentPackets;
+        quint64 droppedPackets;
+        qint64 queuedBytes;
+    };
+
+    explicit TcpPublisher(QObject *parent = nullptr);
+    ~TcpPublisher();
+
+    bool startServer(quint16 port);
+    void stopServer();
+    bool isRunning() const;
+
+    int getClientCount() const { return m_clients.size(); }
+    QVector<ClientInfo> getClientInfo() const;
+
+    // 设置采样率（写入包头，抽取后按倍数降低）
+    void setSampleRate(double rate) { m_sampleRate = rate; }
+    double getSampleRate() const { return m_sampleRate; }
+
+    // 每个客户端待发送数据的上限（字节）
+    void setMaxQueueBytes(qint64 bytes) { m_maxQueueBytes = bytes; }
+    qint64 getMaxQueueBytes() const { return m_maxQueueBytes; }
+
+    // 编码一个数据包：从 points[first] 开始每 step 个点取一个
+    static QByteArray encodePacket(int channel, const QVector<DataPoint>& points,
+                                   int first, int step, double sampleRate);
+
+public slots:
+    void publish(int channel, const QVector<DataPoint>& points);
+
+signals:
+    void clientConnected(const QString& address);
+    void clientDisconnected(const QString& address);
+    void errorOccurred(const QString& error);
+    void statusChanged(const QString& status);
+
+private slots:
+    void onNewConnection();
+
+private:
+    struct Client {
+        QTcpSocket* socket;
+        QString address;
+        int decimation;
+        quint32 channelMask;        // 第i位对应通道i
+        QQueue<QByteArray> pending; // 尚未交给socket的数据包
+        qint64 queuedBytes;
+        quint64 sentPackets;
+        quint64 droppedPackets;
+    };
+
+    void readCommands(Client* client);
+    void enqueue(Client* client, const QByteArray& packet);
+    void flush(Client* client);
+    void removeClient(QTcpSocket* socket);
+
+    QTcpServer* m_server;
+    QHash<QTcpSocket*, Client*> m_clients;
+    quint64 m_publishedCount[MAX_CHANNELS];  // 各通道已发布的点数，用于对齐抽取相位
+    double m_sampleRate;
+    qint64 m_maxQueueBytes;
+};
+
+#endif // TCPPUBLISHER_H
@@ -1,24 +1,142 @@
 #include "tcpreceiver.h"
 #include <QDebug>
 #include <QHostAddress>
+#include <QElapsedTimer>
+#include <QMetaObject>
+#include <cstring>
+
+#if defined(Q_OS_LINUX)
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <cerrno>
+#elif defined(Q_OS_WIN)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#endif
 
-TcpReceiver::TcpReceiver(DataBuffer* buffer, QObject *parent)
+namespace {
+// 内核socket接收缓冲区，GUI或磁盘短暂卡顿时由它吸收突发数据
+const int SOCKET_RECEIVE_BUFFER_SIZE = 8 * 1024 * 1024;
+}
+
+bool listenWithReceiveBuffer(QTcpServer* server, quint16 port, int receiveBufferSize,
+                             QString* errorString)
+{
+#if defined(Q_OS_LINUX)
+    // IPv6双栈监听，与 QHostAddress::Any 一样同时接受IPv4发送端
+    int fd = ::socket(AF_INET6, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        *errorString = QString("无法创建监听socket: %1").arg(strerror(errno));
+        return false;
+    }
+
+    int size = receiveBufferSize;
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    int reuse = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    int v6Only = 0;
+    ::setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &v6Only, sizeof(v6Only));
+
+    sockaddr_in6 address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin6_family = AF_INET6;
+    address.sin6_addr = in6addr_any;
+    address.sin6_port = htons(port);
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0
+        || ::listen(fd, SOMAXCONN) < 0) {
+        *errorString = QString("无法监听端口 %1: %2").arg(port).arg(strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    if (!server->setSocketDescriptor(fd)) {
+        *errorString = server->errorString();
+        ::close(fd);
+        return false;
+    }
+    return true;
+#elif defined(Q_OS_WIN)
+    // Qt的网络模块同样会初始化Winsock，这里的引用计数只增加一次
+    static const bool winsockReady = [] {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    if (!winsockReady) {
+        *errorString = "Winsock初始化失败";
+        return false;
+    }
+
+    SOCKET fd = ::socket(AF_INET6, SOCK_STREAM, IPPROTO_TCP);
+    if (fd == INVALID_SOCKET) {
+        *errorString = QString("无法创建监听socket: 错误码 %1").arg(WSAGetLastError());
+        return false;
+    }
+
+    int size = receiveBufferSize;
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&size), sizeof(size));
+    DWORD v6Only = 0;
+    ::setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, reinterpret_cast<const char*>(&v6Only),
+                 sizeof(v6Only));
+
+    sockaddr_in6 address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin6_family = AF_INET6;
+    address.sin6_addr = in6addr_any;
+    address.sin6_port = htons(port);
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == SOCKET_ERROR
+        || ::listen(fd, SOMAXCONN) == SOCKET_ERROR) {
+        *errorString = QString("无法监听端口 %1: 错误码 %2").arg(port).arg(WSAGetLastError());
+        ::closesocket(fd);
+        return false;
+    }
+
+    if (!server->setSocketDescriptor(static_cast<qintptr>(fd))) {
+        *errorString = server->errorString();
+        ::closesocket(fd);
+        return false;
+    }
+    return true;
+#else
+    // 其他平台无法在 listen() 之前设置，监听后立即设置，对之后握手的连接生效
+    if (!server->listen(QHostAddress::Any, port)) {
+        *errorString = server->errorString();
+        return false;
+    }
+    Q_UNUSED(receiveBufferSize);
+    return true;
+#endif
+}
+
+// ==================== TcpReceiverWorker ====================
+
+TcpReceiverWorker::TcpReceiverWorker(DataBuffer* buffer, QObject *parent)
     : QObject(parent)
     , m_server(nullptr)
     , m_socket(nullptr)
     , m_dataBuffer(buffer)
-    , m_sampleRate(1000.0)
     , m_isServer(false)
 {
 }
 
-TcpReceiver::~TcpReceiver()
+TcpReceiverWorker::~TcpReceiverWorker()
+{
+    shutdown();
+}
+
+void TcpReceiverWorker::shutdown()
 {
     stopServer();
     disconnectFromHost();
 }
 
-bool TcpReceiver::startServer(quint16 port)
+TcpReceiverStats TcpReceiverWorker::getStats() const
+{
+    QMutexLocker locker(&m_statsMutex);
+    return m_stats;
+}
+
+bool TcpReceiverWorker::startServer(quint16 port)
 {
     if (m_server) {
         stopServer();
@@ -26,10 +144,11 @@ bool TcpReceiver::startServer(quint16 port)
 
     m_server = new QTcpServer(this);
     connect(m_server, &QTcpServer::newConnection,
-            this, &TcpReceiver::onNewConnection);
+            this, &TcpReceiverWorker::onNewConnection);
 
-    if (!m_server->listen(QHostAddress::Any, port)) {
-        QString error = QString("无法启动服务器: %1").arg(m_server->errorString());
+    QString listenError;
+    if (!listenWithReceiveBuffer(m_server, port, SOCKET_RECEIVE_BUFFER_SIZE, &listenError)) {
+        QString error = QString("无法启动服务器: %1").arg(listenError);
         emit errorOccurred(error);
         delete m_server;
         m_server = nullptr;
@@ -42,7 +161,7 @@ bool TcpReceiver::startServer(quint16 port)
     return true;
 }
 
-void TcpReceiver::stopServer()
+void TcpReceiverWorker::stopServer()
 {
     if (m_server) {
         if (m_socket) {
@@ -57,67 +176,53 @@ void TcpReceiver::stopServer()
     }
 }
 
-bool TcpReceiver::connectToHost(const QString& host, quint16 port)
+void TcpReceiverWorker::connectToHost(const QString& host, quint16 port)
 {
     if (m_socket) {
         disconnectFromHost();
     }
 
     m_socket = new QTcpSocket(this);
-
-    connect(m_socket, &QTcpSocket::connected,
-            this, &TcpReceiver::onConnected);
-    connect(m_socket, &QTcpSocket::disconnected,
-            this, &TcpReceiver::onDisconnected);
-    connect(m_socket, &QTcpSocket::readyRead,
-            this, &TcpReceiver::onReadyRead);
-#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
-    connect(m_socket, &QAbstractSocket::errorOccurred,
-            this, &TcpReceiver::onError);
-#else
-    connect(m_socket, QOverload<QAbstractSocket::SocketError>::of(&QAbstractSocket::error),
-            this, &TcpReceiver::onError);
-#endif
+    setupSocket();
 
     m_isServer = false;
     m_socket->connectToHost(host, port);
 
     emit statusChanged(QString("正在连接到 %1:%2").arg(host).arg(port));
     qDebug() << "正在连接到:" << host << ":" << port;
-    return true;
 }
 
-void TcpReceiver::disconnectFromHost()
+void TcpReceiverWorker::disconnectFromHost()
 {
     if (m_socket) {
+        m_socket->disconnect(this);
         m_socket->disconnectFromHost();
         m_socket->deleteLater();
         m_socket = nullptr;
+        m_parser.reset();
+        emit disconnected();
         emit statusChanged("已断开连接");
     }
 }
 
-bool TcpReceiver::isConnected() const
-{
-    return m_socket && m_socket->state() == QAbstractSocket::ConnectedState;
-}
-
-QString TcpReceiver::getConnectionInfo() const
+void TcpReceiverWorker::setupSocket()
 {
-    if (!m_socket || !isConnected()) {
-        return "未连接";
-    }
-
-    if (m_isServer) {
-        return QString("%1:%2").arg(m_socket->peerAddress().toString())
-        .arg(m_socket->peerPort());
-    } else {
-        return QString("%1:%2").arg(m_socket->peerAddress().toString())
-        .arg(m_socket->peerPort());
-    }
+    connect(m_socket, &QTcpSocket::connected,
+            this, &TcpReceiverWorker::onConnected);
+    connect(m_socket, &QTcpSocket::disconnected,
+            this, &TcpReceiverWorker::onDisconnected);
+    connect(m_socket, &QTcpSocket::readyRead,
+            this, &TcpReceiverWorker::onReadyRead);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    connect(m_socket, &QAbstractSocket::errorOccurred,
+            this, &TcpReceiverWorker::onError);
+#else
+    connect(m_socket, QOverload<QAbstractSocket::SocketError>::of(&QAbstractSocket::error),
+            this, &TcpReceiverWorker::onError);
+#endif
 }
 
-void TcpReceiver::onNewConnection()
+void TcpReceiverWorker::onNewConnection()
 {
     if (!m_server) return;
 
@@ -132,37 +237,39 @@ void TcpReceiver::onNewConnection()
     }
 
     m_socket = clientSocket;
-
-    connect(m_socket, &QTcpSocket::connected,
-            this, &TcpReceiver::onConnected);
-    connect(m_socket, &QTcpSocket::disconnected,
-            this, &TcpReceiver::onDisconnected);
-    connect(m_socket, &QTcpSocket::readyRead,
-            this, &TcpReceiver::onReadyRead);
-#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
-    connect(m_socket, &QAbstractSocket::errorOccurred,
-            this, &TcpReceiver::onError);
-#else
-    connect(m_socket, QOverload<QAbstractSocket::SocketError>::of(&QAbstractSocket::error),
-            this, &TcpReceiver::onError);
-#endif
-
-    qDebug() << "客户端已连接:" << m_socket->peerAddress().toString()
-             << ":" << m_socket->peerPort();
-    emit connected();
+    setupSocket();
+
+    QString peerInfo = QString("%1:%2").arg(m_socket->peerAddress().toString())
+                                       .arg(m_socket->peerPort());
+    qDebug() << "客户端已连接:" << peerInfo;
+    // 声明支持的包格式和编码，发送端据此协商是否压缩
+    m_socket->write(PacketProtocol::capabilityLine());
+    emit connected(peerInfo);
+
+    // 连接建立前已到达的数据不会再触发 readyRead
+    if (m_socket->bytesAvailable() > 0) {
+        onReadyRead();
+    }
 }
 
-void TcpReceiver::onConnected()
+void TcpReceiverWorker::onConnected()
 {
     qDebug() << "TCP连接已建立";
-    emit connected();
+    // 客户端模式没有监听socket可继承，只能在连接建立后加大内核接收缓冲区：
+    // I/O线程偶尔被抢占时发送端不会立即被TCP窗口卡住
+    // （服务器模式下 accept 的socket已从监听socket继承，见 listenWithReceiveBuffer）
+    m_socket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption,
+                              SOCKET_RECEIVE_BUFFER_SIZE);
+    m_socket->write(PacketProtocol::capabilityLine());
+    emit connected(QString("%1:%2").arg(m_socket->peerAddress().toString())
+                                   .arg(m_socket->peerPort()));
     emit statusChanged("已连接");
 }
 
-void TcpReceiver::onDisconnected()
+void TcpReceiverWorker::onDisconnected()
 {
     qDebug() << "TCP连接已断开";
-    m_receiveBuffer.clear();
+    m_parser.reset();
 
     if (m_socket) {
         m_socket->deleteLater();
@@ -173,19 +280,37 @@ void TcpReceiver::onDisconnected()
     emit statusChanged("连接已断开");
 }
 
-void TcpReceiver::onReadyRead()
+void TcpReceiverWorker::onReadyRead()
 {
     if (!m_socket) return;
 
-    // 读取所有可用数据
-    QByteArray data = m_socket->readAll();
-    m_receiveBuffer.append(data);
-
-    // 处理接收到的数据
-    processReceivedData();
+    qint64 available = m_socket->bytesAvailable();
+    if (available <= 0) return;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // 读取并解析，再把本次得到的各通道数据整块交出
+    qint64 bytesRead = m_parser.readFrom(m_socket);
+    deliverBlocks();
+
+    double elapsedMs = timer.nsecsElapsed() / 1e6;
+
+    QMutexLocker locker(&m_statsMutex);
+    m_stats.bytesReceived += bytesRead;
+    m_stats.packetsReceived = m_parser.getPacketCount();
+    m_stats.pointsReceived = m_parser.getPointCount();
+    m_stats.resyncCount = m_parser.getResyncCount();
+    m_stats.readBufferBytes = available;
+    m_stats.maxReadBufferBytes = qMax(m_stats.maxReadBufferBytes, available);
+    m_stats.pendingBytes = m_parser.getPendingBytes();
+    m_stats.lastParseMs = elapsedMs;
+    m_stats.maxParseMs = qMax(m_stats.maxParseMs, elapsedMs);
+    m_stats.totalParseMs += elapsedMs;
+    ++m_stats.readCount;
 }
 
-void TcpReceiver::onError(QAbstractSocket::SocketError error)
+void TcpReceiverWorker::onError(QAbstractSocket::SocketError error)
 {
     Q_UNUSED(error);
 
@@ -196,95 +321,117 @@ void TcpReceiver::onError(QAbstractSocket::SocketError error)
     emit errorOccurred(errorString);
 }
 
-void TcpReceiver::processReceivedData()
+void TcpReceiverWorker::deliverBlocks()
 {
-    const int headerSize = sizeof(DataPacketHeader);
-
-    while (m_receiveBuffer.size() >= headerSize) {
-        // 解析包头
-        DataPacketHeader* header = reinterpret_cast<DataPacketHeader*>(
-            m_receiveBuffer.data());
-
-        // 验证魔数
-        if (header->magic != 0x44415441) { // "DATA"
-            qWarning() << "无效的数据包魔数";
-            // 尝试查找下一个有效的魔数
-            bool found = false;
-            for (int i = 1; i < m_receiveBuffer.size() - 3; ++i) {
-                quint32* magic = reinterpret_cast<quint32*>(
-                    m_receiveBuffer.data() + i);
-                if (*magic == 0x44415441) {
-                    m_receiveBuffer.remove(0, i);
-                    found = true;
-                    break;
-                }
-            }
-            if (!found) {
-                m_receiveBuffer.clear();
-            }
+    QVector<DataPoint> points;
+    for (int channel = 0; channel < MAX_CHANNELS; ++channel) {
+        // 取出数据块（信号接收方持有隐式共享的副本）
+        if (!m_parser.takeBlock(channel, &points)) {
             continue;
         }
 
-        // 计算完整数据包大小
-        int dataSize = header->pointCount * sizeof(double);
-        int packetSize = headerSize + dataSize;
-
-        // 检查是否接收到完整数据包
-        if (m_receiveBuffer.size() < packetSize) {
-            break; // 等待更多数据
+        // DataBuffer 内部加锁，在I/O线程中直接写入
+        if (m_dataBuffer) {
+            m_dataBuffer->addDataPoints(channel, points);
         }
 
-        // 提取完整数据包
-        QByteArray packet = m_receiveBuffer.left(packetSize);
-        m_receiveBuffer.remove(0, packetSize);
-
-        // 解析数据包
-        parseDataPacket(packet);
+        emit dataReceived(channel, points.size());
+        emit pointsReceived(channel, points);
     }
 }
 
-void TcpReceiver::parseDataPacket(const QByteArray& data)
+// ==================== TcpReceiver ====================
+
+TcpReceiver::TcpReceiver(DataBuffer* buffer, QObject *parent)
+    : QObject(parent)
+    , m_worker(nullptr)
+    , m_workerThread(nullptr)
+    , m_isConnected(false)
+    , m_sampleRate(1000.0)
 {
-    if (data.size() < static_cast<int>(sizeof(DataPacketHeader))) {
-        return;
-    }
+    qRegisterMetaType<QVector<DataPoint>>("QVector<DataPoint>");
 
-    const DataPacketHeader* header = reinterpret_cast<const DataPacketHeader*>(
-        data.constData());
+    // 创建网络I/O线程
+    m_workerThread = new QThread(this);
+    m_worker = new TcpReceiverWorker(buffer);
+    m_worker->moveToThread(m_workerThread);
 
-    int channel = header->channel;
-    quint32 pointCount = header->pointCount;
-    double startTime = header->startTime;
-    double sampleRate = header->sampleRate;
+    connect(m_workerThread, &QThread::finished, m_worker, &QObject::deleteLater);
 
-    // 验证通道号
-    if (channel < 1 || channel > 2) {
-        qWarning() << "无效的通道号:" << channel;
-        return;
-    }
+    connect(m_worker, &TcpReceiverWorker::connected, this, &TcpReceiver::onWorkerConnected);
+    connect(m_worker, &TcpReceiverWorker::disconnected, this, &TcpReceiver::onWorkerDisconnected);
+    connect(m_worker, &TcpReceiverWorker::errorOccurred, this, &TcpReceiver::errorOccurred);
+    connect(m_worker, &TcpReceiverWorker::statusChanged, this, &TcpReceiver::statusChanged);
+    connect(m_worker, &TcpReceiverWorker::dataReceived, this, &TcpReceiver::dataReceived);
+    connect(m_worker, &TcpReceiverWorker::pointsReceived, this, &TcpReceiver::pointsReceived);
 
-    // 解析数据点
-    const double* amplitudes = reinterpret_cast<const double*>(
-        data.constData() + sizeof(DataPacketHeader));
+    m_workerThread->start();
+}
 
-    QVector<DataPoint> points;
-    points.reserve(pointCount);
+TcpReceiver::~TcpReceiver()
+{
+    // socket 必须在所属线程中关闭
+    QMetaObject::invokeMethod(m_worker, "shutdown", Qt::BlockingQueuedConnection);
+    m_workerThread->quit();
+    m_workerThread->wait();
+}
 
-    for (quint32 i = 0; i < pointCount; ++i) {
-        DataPoint point;
-        point.time = startTime + i / sampleRate;
-        point.amplitude = amplitudes[i];
-        points.append(point);
-    }
+bool TcpReceiver::startServer(quint16 port)
+{
+    // 等待I/O线程完成 listen，保持原来的同步返回值
+    bool ok = false;
+    QMetaObject::invokeMethod(m_worker, "startServer", Qt::BlockingQueuedConnection,
+                              Q_RETURN_ARG(bool, ok), Q_ARG(quint16, port));
+    return ok;
+}
+
+void TcpReceiver::stopServer()
+{
+    QMetaObject::invokeMethod(m_worker, "stopServer", Qt::QueuedConnection);
+}
 
-    // 添加到数据缓冲区
-    if (m_dataBuffer) {
-        m_dataBuffer->addDataPoints(channel, points);
+bool TcpReceiver::connectToHost(const QString& host, quint16 port)
+{
+    QMetaObject::invokeMethod(m_worker, "connectToHost", Qt::QueuedConnection,
+                              Q_ARG(QString, host), Q_ARG(quint16, port));
+    return true;
+}
+
+void TcpReceiver::disconnectFromHost()
+{
+    QMetaObject::invokeMethod(m_worker, "disconnectFromHost", Qt::QueuedConnection);
+}
+
+QString TcpReceiver::getConnectionInfo() const
+{
+    if (!m_isConnected) {
+        return "未连接";
     }
+    return m_connectionInfo;
+}
+
+void TcpReceiver::setSampleRate(double rate)
+{
+    m_sampleRate = rate;
+    QMetaObject::invokeMethod(m_worker, "setSampleRate", Qt::QueuedConnection,
+                              Q_ARG(double, rate));
+}
 
-    emit dataReceived(channel, pointCount);
+TcpReceiverStats TcpReceiver::getStats() const
+{
+    return m_worker->getStats();
+}
+
+void TcpReceiver::onWorkerConnected(const QString& peerInfo)
+{
+    m_isConnected = true;
+    m_connectionInfo = peerInfo;
+    emit connected();
+}
 
-    qDebug() << "接收数据包 - 通道:" << channel
-             << "点数:" << pointCount
-             << "起始时间:" << startTime;
+void TcpReceiver::onWorkerDisconnected()
+{
+    m_isConnected = false;
+    m_connectionInfo.clear();
+    emit disconnected();
 }
@@ -5,20 +5,91 @@
 #include <QTcpSocket>
 #include <QTcpServer>
 #include <QByteArray>
+#include <QThread>
+#include <QMutex>
 #include "databuffer.h"
+#include "tcppacketparser.h"
 #include <iio.h>
 
-// 数据包头结构
-#pragma pack(push, 1)
-struct DataPacketHeader {
-    quint32 magic;        // 魔数，用于验证数据包：0x44415441 ("DATA")
-    quint32 channel;      // 通道号：1或2
-    quint32 pointCount;   // 本包中的数据点数量
-    double sampleRate;    // 采样率
-    double startTime;     // 起始时间
+// 接收统计（由I/O线程更新，任意线程读取）
+struct TcpReceiverStats {
+    quint64 bytesReceived;      // 累计接收字节数
+    quint64 packetsReceived;    // 累计解析的数据包数
+    quint64 pointsReceived;     // 累计数据点数
+    quint64 resyncCount;        // 包头损坏后重新同步的次数
+    // 最近一次 readyRead 时 QTcpSocket 读缓冲区中的字节数（bytesAvailable()），
+    // 即Qt已从内核取出、尚未被解析器读走的数据，不包括内核socket接收队列中的积压
+    qint64 readBufferBytes;
+    qint64 maxReadBufferBytes;
+    qint64 pendingBytes;        // 接收缓冲区中尚未凑成完整包的字节数
+    double lastParseMs;         // 最近一次读取的解析耗时（毫秒）
+    double maxParseMs;
+    double totalParseMs;
+    quint64 readCount;          // readyRead 处理次数
+
+    TcpReceiverStats()
+        : bytesReceived(0), packetsReceived(0), pointsReceived(0), resyncCount(0)
+        , readBufferBytes(0), maxReadBufferBytes(0), pendingBytes(0)
+        , lastParseMs(0.0), maxParseMs(0.0), totalParseMs(0.0), readCount(0) {}
 };
-#pragma pack(pop)
 
+// 在 port 上开始监听，并在 listen() 之前把监听socket的内核接收缓冲区设为 receiveBufferSize
+// accept 得到的socket继承该设置，TCP窗口扩大因子在握手时即按大缓冲区协商；
+// accept 之后再设置只能在已协商的窗口范围内生效
+bool listenWithReceiveBuffer(QTcpServer* server, quint16 port, int receiveBufferSize,
+                             QString* errorString);
+
+// TCP接收工作对象 - 运行在独立的网络I/O线程中，socket读取、解析都不经过GUI线程
+// 每次 readyRead 解析出的数据按通道合并成一个数据块后再交给 DataBuffer
+// 只接受一个发送端；多个发送端同时接入使用 TcpMultiReceiver
+class TcpReceiverWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TcpReceiverWorker(DataBuffer* buffer, QObject *parent = nullptr);
+    ~TcpReceiverWorker();
+
+    TcpReceiverStats getStats() const;
+
+public slots:
+    bool startServer(quint16 port);
+    void stopServer();
+    void connectToHost(const QString& host, quint16 port);
+    void disconnectFromHost();
+    void setSampleRate(double rate) { m_parser.setSampleRate(rate); }
+    void shutdown();
+
+signals:
+    void connected(const QString& peerInfo);
+    void disconnected();
+    void errorOccurred(const QString& error);
+    void dataReceived(int channel, int pointCount);
+    void pointsReceived(int channel, const QVector<DataPoint>& points);
+    void statusChanged(const QString& status);
+
+private slots:
+    void onNewConnection();
+    void onConnected();
+    void onDisconnected();
+    void onReadyRead();
+    void onError(QAbstractSocket::SocketError error);
+
+private:
+    void setupSocket();
+    void deliverBlocks();
+
+    QTcpServer* m_server;
+    QTcpSocket* m_socket;
+    DataBuffer* m_dataBuffer;
+    TcpPacketParser m_parser;
+    bool m_isServer;
+
+    TcpReceiverStats m_stats;
+    mutable QMutex m_statsMutex;
+};
+
+// TCP接收器 - 对外接口，实际的网络I/O在 TcpReceiverWorker 所在的线程中进行
 class TcpReceiver : public QObject
 {
     Q_OBJECT
@@ -35,38 +106,35 @@ public:
     bool connectToHost(const QString& host, quint16 port);
     void disconnectFromHost();
     
-    bool isConnected() const;
+    bool isConnected() const { return m_isConnected; }
     QString getConnectionInfo() const;
     
     // 设置采样率（用于计算时间）
-    void setSampleRate(double rate) { m_sampleRate = rate; }
+    void setSampleRate(double rate);
     double getSampleRate() const { return m_sampleRate; }
+
+    // 接收统计：读缓冲区字节数、解析耗时等
+    TcpReceiverStats getStats() const;
     
 signals:
     void connected();
     void disconnected();
     void errorOccurred(const QString& error);
     void dataReceived(int channel, int pointCount);
+    void pointsReceived(int channel, const QVector<DataPoint>& points);
     void statusChanged(const QString& status);
     
 private slots:
-    void onNewConnection();
-    void onConnected();
-    void onDisconnected();
-    void onReadyRead();
-    void onError(QAbstractSocket::SocketError error);
+    void onWorkerConnected(const QString& peerInfo);
+    void onWorkerDisconnected();
     
 private:
-    void processReceivedData();
-    void parseDataPacket(const QByteArray& data);
-    
-    QTcpServer* m_server;
-    QTcpSocket* m_socket;
-    DataBuffer* m_dataBuffer;
-    QByteArray m_receiveBuffer;
-    
+    TcpReceiverWorker* m_worker;
+    QThread* m_workerThread;
+
+    bool m_isConnected;
+    QString m_connectionInfo;
     double m_sampleRate;
-    bool m_isServer;
 };
 
 #endif // TCPRECEIVER_H
@@ -0,0 +1,556 @@
+#include "udpreceiver.h"
+#include <QDebug>
+#include <QHostAddress>
+#include <QMetaObject>
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace {
+const quint32 UDP_MAGIC = 0x55445053; // "UDPS"
+const int SOCKET_RECEIVE_BUFFER_SIZE = 8 * 1024 * 1024;
+const int MAX_DATAGRAM_SIZE = 65536;
+// 一次 recvmmsg 最多读取的数据报数，以及一次唤醒最多读取的批数（避免独占I/O线程）
+const int RECV_BATCH_SIZE = 32;
+const int MAX_BATCHES_PER_WAKEUP = 16;
+const int MAX_SENDERS = 64;
+// 超过该时间没有数据报的发送端被移除（发送端换了端口重启后旧条目不再占用名额）
+const qint64 SENDER_IDLE_TIMEOUT_MS = 10000;
+// 序号跳变超过该值视为发送端重启，不计为丢包
+const qint64 SEQUENCE_RESET_THRESHOLD = 65536;
+const int DEFAULT_REORDER_WINDOW = 32;
+const int DEFAULT_REORDER_TIMEOUT_MS = 50;
+}
+
+// ==================== UdpReceiverWorker ====================
+
+UdpReceiverWorker::UdpReceiverWorker(DataBuffer* buffer, QObject *parent)
+    : QObject(parent)
+    , m_dataBuffer(buffer)
+    , m_socket(nullptr)
+    , m_notifier(nullptr)
+    , m_nativeSocket(-1)
+    , m_reorderTimer(nullptr)
+    , m_sampleRate(1000.0)
+    , m_reorderWindow(DEFAULT_REORDER_WINDOW)
+    , m_reorderTimeoutMs(DEFAULT_REORDER_TIMEOUT_MS)
+    , m_gapMarkersEnabled(true)
+{
+}
+
+UdpReceiverWorker::~UdpReceiverWorker()
+{
+    stopListening();
+}
+
+void UdpReceiverWorker::setSampleRate(double rate)
+{
+    m_sampleRate = rate;
+    // 已有发送端的解析器同样更新（包头采样率无效时使用）
+    for (Sender* sender : m_senders) {
+        sender->parser.setSampleRate(rate);
+    }
+}
+
+void UdpReceiverWorker::setReorderTimeout(int ms)
+{
+    m_reorderTimeoutMs = qMax(1, ms);
+    // 监听中修改时同步调整检查周期，否则仍按旧超时的一半检查
+    if (m_reorderTimer) {
+        m_reorderTimer->setInterval(qMax(5, m_reorderTimeoutMs / 2));
+    }
+}
+
+UdpReceiverStats UdpReceiverWorker::getStats() const
+{
+    QMutexLocker locker(&m_statsMutex);
+    return m_sharedStats;
+}
+
+bool UdpReceiverWorker::startListening(quint16 port)
+{
+    stopListening();
+
+#ifdef Q_OS_LINUX
+    if (!openNativeSocket(port)) {
+        return false;
+    }
+#else
+    m_socket = new QUdpSocket(this);
+    if (!m_socket->bind(QHostAddress::AnyIPv4, port)) {
+        emit errorOccurred(QString("无法绑定UDP端口: %1").arg(m_socket->errorString()));
+        delete m_socket;
+        m_socket = nullptr;
+        return false;
+    }
+    m_socket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption,
+                              SOCKET_RECEIVE_BUFFER_SIZE);
+    connect(m_socket, &QUdpSocket::readyRead, this, &UdpReceiverWorker::onReadyRead);
+#endif
+
+    m_datagramBuffer.resize(RECV_BATCH_SIZE * MAX_DATAGRAM_SIZE);
+    m_clock.start();
+
+    // 即使没有新数据报到达，缺失的序号也要在超时后判定为丢失
+    m_reorderTimer = new QTimer(this);
+    connect(m_reorderTimer, &QTimer::timeout, this, &UdpReceiverWorker::onReorderTimeout);
+    m_reorderTimer->start(qMax(5, m_reorderTimeoutMs / 2));
+
+    emit statusChanged(QString("UDP监听端口 %1").arg(port));
+    qDebug() << "UDP接收启动，端口:" << port;
+    return true;
+}
+
+void UdpReceiverWorker::stopListening()
+{
+    bool wasListening = m_socket || m_notifier;
+
+    delete m_reorderTimer;
+    m_reorderTimer = nullptr;
+
+    delete m_notifier;
+    m_notifier = nullptr;
+#ifdef Q_OS_LINUX
+    if (m_nativeSocket >= 0) {
+        ::close(m_nativeSocket);
+        m_nativeSocket = -1;
+    }
+#endif
+
+    delete m_socket;
+    m_socket = nullptr;
+
+    qDeleteAll(m_senders);
+    m_senders.clear();
+
+    if (wasListening) {
+        publishStats();
+        emit statusChanged("UDP接收已停止");
+    }
+}
+
+bool UdpReceiverWorker::openNativeSocket(quint16 port)
+{
+#ifdef Q_OS_LINUX
+    int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        emit errorOccurred(QString("无法创建UDP socket: %1").arg(strerror(errno)));
+        return false;
+    }
+
+    int size = SOCKET_RECEIVE_BUFFER_SIZE;
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    int reuse = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        emit errorOccurred(QString("无法绑定UDP端口: %1").arg(strerror(errno)));
+        ::close(fd);
+        return false;
+    }
+
+    m_nativeSocket = fd;
+    m_notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &UdpReceiverWorker::onReadyRead);
+    return true;
+#else
+    Q_UNUSED(port);
+    return false;
+#endif
+}
+
+void UdpReceiverWorker::onReadyRead()
+{
+    if (m_nativeSocket >= 0) {
+        readNative();
+    } else if (m_socket) {
+        readQt();
+    }
+
+    deliverBlocks();
+    publishStats();
+}
+
+void UdpReceiverWorker::readNative()
+{
+#ifdef Q_OS_LINUX
+    char* buffer = m_datagramBuffer.data();
+
+    for (int batch = 0; batch < MAX_BATCHES_PER_WAKEUP; ++batch) {
+        mmsghdr messages[RECV_BATCH_SIZE];
+        iovec vectors[RECV_BATCH_SIZE];
+        sockaddr_in addresses[RECV_BATCH_SIZE];
+        std::memset(messages, 0, sizeof(messages));
+
+        for (int i = 0; i < RECV_BATCH_SIZE; ++i) {
+            vectors[i].iov_base = buffer + i * MAX_DATAGRAM_SIZE;
+            vectors[i].iov_len = MAX_DATAGRAM_SIZE;
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+            messages[i].msg_hdr.msg_name = &addresses[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(addresses[i]);
+        }
+
+        int count = ::recvmmsg(m_nativeSocket, messages, RECV_BATCH_SIZE, MSG_DONTWAIT, nullptr);
+        if (count <= 0) {
+            if (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                emit errorOccurred(QString("UDP接收失败: %1").arg(strerror(errno)));
+            }
+            break;
+        }
+
+        ++m_stats.batchCount;
+        m_stats.maxBatchSize = qMax(m_stats.maxBatchSize, count);
+
+        for (int i = 0; i < count; ++i) {
+            if (messages[i].msg_hdr.msg_flags & MSG_TRUNC) {
+                ++m_stats.datagramsReceived;
+                ++m_stats.invalidDatagrams;
+                continue;
+            }
+            handleDatagram(buffer + i * MAX_DATAGRAM_SIZE, static_cast<int>(messages[i].msg_len),
+                           ntohl(addresses[i].sin_addr.s_addr), ntohs(addresses[i].sin_port));
+        }
+
+        if (count < RECV_BATCH_SIZE) {
+            break; // 已读空
+        }
+    }
+#endif
+}
+
+void UdpReceiverWorker::readQt()
+{
+    char* buffer = m_datagramBuffer.data();
+    int count = 0;
+
+    while (m_socket->hasPendingDatagrams() && count < RECV_BATCH_SIZE * MAX_BATCHES_PER_WAKEUP) {
+        QHostAddress address;
+        quint16 port = 0;
+        qint64 size = m_socket->readDatagram(buffer, MAX_DATAGRAM_SIZE, &address, &port);
+        if (size < 0) {
+            break;
+        }
+        handleDatagram(buffer, static_cast<int>(size), address.toIPv4Address(), port);
+        ++count;
+    }
+
+    if (count > 0) {
+        ++m_stats.batchCount;
+        m_stats.maxBatchSize = qMax(m_stats.maxBatchSize, count);
+    }
+}
+
+UdpReceiverWorker::Sender* UdpReceiverWorker::findSender(quint32 address, quint16 port)
+{
+    quint64 key = (static_cast<quint64>(address) << 16) | port;
+    Sender* sender = m_senders.value(key);
+    if (sender || m_senders.size() >= MAX_SENDERS) {
+        return sender;
+    }
+
+    sender = new Sender;
+    sender->parser.setSampleRate(m_sampleRate);
+    sender->address = QString("%1:%2").arg(QHostAddress(address).toString()).arg(port);
+    sender->started = false;
+    sender->nextSequence = 0;
+    sender->pendingSinceMs = 0;
+    sender->lastSeenMs = m_clock.elapsed();
+    sender->lastPacketCount = 0;
+    sender->lastPointCount = 0;
+    m_senders.insert(key, sender);
+    m_stats.senderCount = m_senders.size();
+
+    qDebug() << "新的UDP发送端:" << sender->address;
+    return sender;
+}
+
+void UdpReceiverWorker::handleDatagram(const char* data, int size, quint32 address, quint16 port)
+{
+    ++m_stats.datagramsReceived;
+    m_stats.bytesReceived += size;
+
+    UdpDatagramHeader header;
+    if (size < static_cast<int>(sizeof(header))) {
+        ++m_stats.invalidDatagrams;
+        return;
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    Sender* sender = header.magic == UDP_MAGIC ? findSender(address, port) : nullptr;
+    if (!sender) {
+        ++m_stats.invalidDatagrams;
+        return;
+    }
+
+    sender->lastSeenMs = m_clock.elapsed();
+
+    const char* payload = data + sizeof(header);
+    const int payloadSize = size - static_cast<int>(sizeof(header));
+
+    if (!sender->started) {
+        sender->started = true;
+        sender->nextSequence = header.sequence;
+    }
+
+    // 与下一个待交付序号的差，按32位回绕解释
+    const qint64 offset = static_cast<qint32>(header.sequence - static_cast<quint32>(sender->nextSequence));
+
+    if (offset < 0 && offset > -SEQUENCE_RESET_THRESHOLD) {
+        // 已交付或已判定丢失的序号
+        ++m_stats.duplicateDatagrams;
+        return;
+    }
+
+    if (offset == 0) {
+        if (!sender->pending.isEmpty()) {
+            ++m_stats.reorderedDatagrams;  // 补上了空缺
+        }
+        deliver(sender, payload, payloadSize);
+        ++sender->nextSequence;
+        drainPending(sender);
+        return;
+    }
+
+    if (offset < 0 || offset >= SEQUENCE_RESET_THRESHOLD) {
+        // 发送端重启或序号异常跳变：交付暂存的数据，从新序号重新开始
+        qWarning() << "UDP发送端序号跳变，重新同步:" << sender->address;
+        while (!sender->pending.isEmpty()) {
+            skipToFirstPending(sender);
+        }
+        if (m_gapMarkersEnabled) {
+            m_stats.gapMarkers += sender->parser.markGap();
+        }
+        sender->nextSequence = header.sequence;
+        deliver(sender, payload, payloadSize);
+        ++sender->nextSequence;
+        return;
+    }
+
+    const quint64 sequence = sender->nextSequence + offset;
+    if (sender->pending.contains(sequence)) {
+        ++m_stats.duplicateDatagrams;
+        return;
+    }
+    if (sender->pending.isEmpty()) {
+        sender->pendingSinceMs = m_clock.elapsed();
+    }
+    sender->pending.insert(sequence, QByteArray(payload, payloadSize));
+
+    // 窗口满或空缺已落后窗口长度：不再等待，跳过缺失的序号
+    while (!sender->pending.isEmpty()
+           && (sender->pending.size() > m_reorderWindow
+               || sender->pending.lastKey() - sender->nextSequence >= static_cast<quint64>(m_reorderWindow))) {
+        skipToFirstPending(sender);
+    }
+}
+
+void UdpReceiverWorker::deliver(Sender* sender, const char* data, int size)
+{
+    TcpPacketParser& parser = sender->parser;
+    parser.append(data, size);
+
+    // 一个数据报必须恰好包含完整的包，剩余的半包不能和下一个数据报拼接
+    if (parser.getPendingBytes() > 0) {
+        parser.discardPending();
+        ++m_stats.invalidDatagrams;
+    }
+
+    m_stats.packetsReceived += parser.getPacketCount() - sender->lastPacketCount;
+    m_stats.pointsReceived += parser.getPointCount() - sender->lastPointCount;
+    sender->lastPacketCount = parser.getPacketCount();
+    sender->lastPointCount = parser.getPointCount();
+}
+
+void UdpReceiverWorker::drainPending(Sender* sender)
+{
+    while (!sender->pending.isEmpty() && sender->pending.firstKey() == sender->nextSequence) {
+        QByteArray datagram = sender->pending.take(sender->nextSequence);
+        deliver(sender, datagram.constData(), datagram.size());
+        ++sender->nextSequence;
+    }
+    if (!sender->pending.isEmpty()) {
+        sender->pendingSinceMs = m_clock.elapsed();
+    }
+}
+
+void UdpReceiverWorker::skipToFirstPending(Sender* sender)
+{
+    const quint64 first = sender->pending.firstKey();
+    m_stats.lostDatagrams += first - sender->nextSequence;
+
+    if (m_gapMarkersEnabled) {
+        m_stats.gapMarkers += sender->parser.markGap();
+    }
+
+    sender->nextSequence = first;
+    drainPending(sender);
+}
+
+void UdpReceiverWorker::onReorderTimeout()
+{
+    const qint64 now = m_clock.elapsed();
+    bool skipped = false;
+
+    for (Sender* sender : m_senders) {
+        if (!sender->pending.isEmpty() && now - sender->pendingSinceMs >= m_reorderTimeoutMs) {
+            skipToFirstPending(sender);
+            skipped = true;
+        }
+    }
+
+    if (skipped) {
+        deliverBlocks();
+    }
+
+    const int senderCount = m_senders.size();
+    expireIdleSenders(now);
+
+    if (skipped || m_senders.size() != senderCount) {
+        publishStats();
+    }
+}
+
+void UdpReceiverWorker::expireIdleSenders(qint64 now)
+{
+    bool flushed = false;
+    for (Sender* sender : m_senders) {
+        if (now - sender->lastSeenMs < SENDER_IDLE_TIMEOUT_MS) {
+            continue;
+        }
+        // 移除前交付暂存的数据报，缺失的序号按丢失计
+        while (!sender->pending.isEmpty()) {
+            skipToFirstPending(sender);
+            flushed = true;
+        }
+    }
+    if (flushed) {
+        deliverBlocks();
+    }
+
+    for (auto it = m_senders.begin(); it != m_senders.end();) {
+        Sender* sender = it.value();
+        if (now - sender->lastSeenMs < SENDER_IDLE_TIMEOUT_MS) {
+            ++it;
+            continue;
+        }
+        qDebug() << "UDP发送端空闲超时，移除:" << sender->address;
+        delete sender;
+        it = m_senders.erase(it);
+        ++m_stats.expiredSenders;
+    }
+    m_stats.senderCount = m_senders.size();
+}
+
+void UdpReceiverWorker::deliverBlocks()
+{
+    QVector<DataPoint> points;
+    for (Sender* sender : m_senders) {
+        for (int channel = 0; channel < MAX_CHANNELS; ++channel) {
+            if (!sender->parser.takeBlock(channel, &points)) {
+                continue;
+            }
+
+            if (m_dataBuffer) {
+                m_dataBuffer->addDataPoints(channel, points);
+            }
+
+            emit dataReceived(channel, points.size());
+            emit pointsReceived(channel, points);
+        }
+    }
+}
+
+void UdpReceiverWorker::publishStats()
+{
+    QMutexLocker locker(&m_statsMutex);
+    m_sharedStats = m_stats;
+}
+
+// ==================== UdpReceiver ====================
+
+UdpReceiver::UdpReceiver(DataBuffer* buffer, QObject *parent)
+    : QObject(parent)
+    , m_worker(nullptr)
+    , m_workerThread(nullptr)
+    , m_isListening(false)
+    , m_sampleRate(1000.0)
+{
+    qRegisterMetaType<QVector<DataPoint>>("QVector<DataPoint>");
+
+    m_workerThread = new QThread(this);
+    m_worker = new UdpReceiverWorker(buffer);
+    m_worker->moveToThread(m_workerThread);
+
+    connect(m_workerThread, &QThread::finished, m_worker, &QObject::deleteLater);
+
+    connect(m_worker, &UdpReceiverWorker::errorOccurred, this, &UdpReceiver::errorOccurred);
+    connect(m_worker, &UdpReceiverWorker::statusChanged, this, &UdpReceiver::statusChanged);
+    connect(m_worker, &UdpReceiverWorker::dataReceived, this, &UdpReceiver::dataReceived);
+    connect(m_worker, &UdpReceiverWorker::pointsReceived, this, &UdpReceiver::pointsReceived);
+
+    m_workerThread->start();
+}
+
+UdpReceiver::~UdpReceiver()
+{
+    // socket 和定时器必须在所属线程中关闭
+    QMetaObject::invokeMethod(m_worker, "stopListening", Qt::BlockingQueuedConnection);
+    m_workerThread->quit();
+    m_workerThread->wait();
+}
+
+bool UdpReceiver::startListening(quint16 port)
+{
+    bool ok = false;
+    QMetaObject::invokeMethod(m_worker, "startListening", Qt::BlockingQueuedConnection,
+                              Q_RETURN_ARG(bool, ok), Q_ARG(quint16, port));
+    m_isListening = ok;
+    return ok;
+}
+
+void UdpReceiver::stopListening()
+{
+    QMetaObject::invokeMethod(m_worker, "stopListening", Qt::QueuedConnection);
+    m_isListening = false;
+}
+
+void UdpReceiver::setSampleRate(double rate)
+{
+    m_sampleRate = rate;
+    QMetaObject::invokeMethod(m_worker, "setSampleRate", Qt::QueuedConnection,
+                              Q_ARG(double, rate));
+}
+
+void UdpReceiver::setReorderWindow(int datagrams)
+{
+    QMetaObject::invokeMethod(m_worker, "setReorderWindow", Qt::QueuedConnection,
+                              Q_ARG(int, datagrams));
+}
+
+void UdpReceiver::setReorderTimeout(int ms)
+{
+    QMetaObject::invokeMethod(m_worker, "setReorderTimeout", Qt::QueuedConnection,
+                              Q_ARG(int, ms));
+}
+
+void UdpReceiver::setGapMarkersEnabled(bool enabled)
+{
+    QMetaObject::invokeMethod(m_worker, "setGapMarkersEnabled", Qt::QueuedConnection,
+                              Q_ARG(bool, enabled));
+}
+
+UdpReceiverStats UdpReceiver::getStats() const
+{
+    return m_worker->getStats();
+}
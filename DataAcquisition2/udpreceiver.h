@@ -0,0 +1,163 @@
+#ifndef UDPRECEIVER_H
+#define UDPRECEIVER_H
+
+#include <QObject>
+#include <QUdpSocket>
+#include <QSocketNotifier>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QMutex>
+#include <QHash>
+#include <QMap>
+#include <QByteArray>
+#include "databuffer.h"
+#include "tcppacketparser.h"
+
+// UDP数据报头：每个数据报 = UdpDatagramHeader + 一个完整的 DATA 包或 FRAM 包
+#pragma pack(push, 1)
+struct UdpDatagramHeader {
+    quint32 magic;        // 魔数：0x55445053 ("UDPS")
+    quint32 sequence;     // 每个发送端独立递增的序号，允许回绕
+};
+#pragma pack(pop)
+
+// UDP接收统计（由I/O线程更新，任意线程读取）
+struct UdpReceiverStats {
+    quint64 datagramsReceived;  // 收到的数据报数（含无效的）
+    quint64 bytesReceived;
+    quint64 packetsReceived;    // 解析出的数据包数
+    quint64 pointsReceived;
+    quint64 lostDatagrams;      // 超出重排窗口或超时仍未到达、被判定丢失的数据报数
+    quint64 reorderedDatagrams; // 晚于后续序号到达、经重排后按序交付的数据报数
+    quint64 duplicateDatagrams; // 重复或在判定丢失之后才到达的数据报数（丢弃）
+    quint64 invalidDatagrams;   // 魔数错误、长度不足或包不完整的数据报数
+    quint64 gapMarkers;         // 插入 DataBuffer 的间断标记数
+    quint64 expiredSenders;     // 长时间没有数据而被移除的发送端数
+    quint64 batchCount;         // 批量读取次数（Linux 下为 recvmmsg 调用次数）
+    int maxBatchSize;           // 单次批量读取的最多数据报数
+    int senderCount;
+
+    UdpReceiverStats()
+        : datagramsReceived(0), bytesReceived(0), packetsReceived(0), pointsReceived(0)
+        , lostDatagrams(0), reorderedDatagrams(0), duplicateDatagrams(0), invalidDatagrams(0)
+        , gapMarkers(0), expiredSenders(0), batchCount(0), maxBatchSize(0), senderCount(0) {}
+};
+
+// UDP接收工作对象 - 运行在独立的I/O线程中
+// Linux 下直接在原生socket上用 recvmmsg 批量读取，其他平台使用 QUdpSocket
+// 每个发送端（地址+端口）独立维护序号和重排窗口：乱序的数据报暂存，按序号交付；
+// 缺失的序号在窗口满或超时后判定为丢失，并在各通道插入间断标记，不等待重传
+class UdpReceiverWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit UdpReceiverWorker(DataBuffer* buffer, QObject *parent = nullptr);
+    ~UdpReceiverWorker();
+
+    UdpReceiverStats getStats() const;
+
+public slots:
+    bool startListening(quint16 port);
+    void stopListening();
+    void setSampleRate(double rate);
+    void setReorderWindow(int datagrams) { m_reorderWindow = qMax(1, datagrams); }
+    void setReorderTimeout(int ms);
+    void setGapMarkersEnabled(bool enabled) { m_gapMarkersEnabled = enabled; }
+
+signals:
+    void errorOccurred(const QString& error);
+    void dataReceived(int channel, int pointCount);
+    void pointsReceived(int channel, const QVector<DataPoint>& points);
+    void statusChanged(const QString& status);
+
+private slots:
+    void onReadyRead();
+    void onReorderTimeout();
+
+private:
+    struct Sender {
+        TcpPacketParser parser;
+        QString address;
+        bool started;
+        quint64 nextSequence;                // 展开为64位的下一个待交付序号，避免回绕比较
+        QMap<quint64, QByteArray> pending;   // 提前到达、等待前面序号的数据报
+        qint64 pendingSinceMs;               // 最早一个暂存数据报的到达时间
+        qint64 lastSeenMs;                   // 最近一个数据报的到达时间，用于移除空闲的发送端
+        quint64 lastPacketCount;
+        quint64 lastPointCount;
+    };
+
+    bool openNativeSocket(quint16 port);
+    void readNative();
+    void readQt();
+    void handleDatagram(const char* data, int size, quint32 address, quint16 port);
+    Sender* findSender(quint32 address, quint16 port);
+    void deliver(Sender* sender, const char* data, int size);
+    void drainPending(Sender* sender);
+    void skipToFirstPending(Sender* sender);
+    void deliverBlocks();
+    void expireIdleSenders(qint64 now);
+    void publishStats();
+
+    DataBuffer* m_dataBuffer;
+    QUdpSocket* m_socket;
+    QSocketNotifier* m_notifier;
+    int m_nativeSocket;
+    QTimer* m_reorderTimer;
+    QElapsedTimer m_clock;
+    QByteArray m_datagramBuffer;
+
+    QHash<quint64, Sender*> m_senders;   // 键：(IPv4地址 << 16) | 端口
+    double m_sampleRate;
+    int m_reorderWindow;
+    int m_reorderTimeoutMs;
+    bool m_gapMarkersEnabled;
+
+    UdpReceiverStats m_stats;           // I/O线程内累加
+    UdpReceiverStats m_sharedStats;     // 每批处理完后复制一次，供其他线程读取
+    mutable QMutex m_statsMutex;
+};
+
+// UDP接收器 - 对外接口，实际的网络I/O在 UdpReceiverWorker 所在的线程中进行
+// 适用于低延迟遥测链路：单个数据报丢失只在数据中留下间断，不会阻塞后续数据
+class UdpReceiver : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit UdpReceiver(DataBuffer* buffer, QObject *parent = nullptr);
+    ~UdpReceiver();
+
+    bool startListening(quint16 port);
+    void stopListening();
+    bool isListening() const { return m_isListening; }
+
+    // 设置采样率（包头采样率无效时用于计算时间）
+    void setSampleRate(double rate);
+    double getSampleRate() const { return m_sampleRate; }
+
+    // 重排窗口：最多暂存多少个乱序数据报；超时：缺失序号最多等待多久（毫秒）
+    void setReorderWindow(int datagrams);
+    void setReorderTimeout(int ms);
+    // 丢包时是否在 DataBuffer 中插入间断标记（DataPoint::gapMarker），默认开启
+    void setGapMarkersEnabled(bool enabled);
+
+    UdpReceiverStats getStats() const;
+
+signals:
+    void errorOccurred(const QString& error);
+    void dataReceived(int channel, int pointCount);
+    void pointsReceived(int channel, const QVector<DataPoint>& points);
+    void statusChanged(const QString& status);
+
+private:
+    UdpReceiverWorker* m_worker;
+    QThread* m_workerThread;
+
+    bool m_isListening;
+    double m_sampleRate;
+};
+
+#endif // UDPRECEIVER_H
@@ -236,13 +236,16 @@ void WaveformWidget::drawWaveform(QPainter& painter, int channel)
     QColor color = getChannelColor(channel);
     painter.setPen(QPen(color, 2));
 
-    // 自动缩放
+    // 自动缩放（间断标记不参与）
     if (m_autoScale && !data.isEmpty()) {
-        double minAmp = data[0].amplitude;
-        double maxAmp = data[0].amplitude;
+        double minAmp = 0.0;
+        double maxAmp = 0.0;
+        bool found = false;
         for (const auto& point : data) {
-            minAmp = qMin(minAmp, point.amplitude);
-            maxAmp = qMax(maxAmp, point.amplitude);
+            if (point.isGapMarker()) continue;
+            minAmp = found ? qMin(minAmp, point.amplitude) : point.amplitude;
+            maxAmp = found ? qMax(maxAmp, point.amplitude) : point.amplitude;
+            found = true;
         }
         double range = maxAmp - minAmp;
         if (range > 0) {
@@ -264,6 +267,12 @@ void WaveformWidget::drawWaveform(QPainter& painter, int channel)
     bool firstPoint = true;
 
     for (const auto& point : data) {
+        // 间断标记处断开曲线，下一个样本重新起笔
+        if (point.isGapMarker()) {
+            firstPoint = true;
+            continue;
+        }
+
         double normalizedTime = (point.time - timeMin) / timeRange;
         double normalizedAmp = (point.amplitude - m_amplitudeMin) /
                                (m_amplitudeMax - m_amplitudeMin);